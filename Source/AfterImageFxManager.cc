@@ -3,8 +3,9 @@
 #include "AfterImageFxManager.h"
 
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/AxUtil.h"
+#include "util/Profiler.h"
 
 using namespace std;
 USING_NS_AX;
@@ -27,7 +28,7 @@ void createAfterImage(const Sprite* sprite,
   afterImage->setColor(color);
   afterImage->setOpacity(80);
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax_util::addChildWithParentCameraMask(gmMgr->getLayer(), afterImage, zOrder);
 
   DelayTime* delay = DelayTime::create(durationInSec);
@@ -51,6 +52,8 @@ void createAfterImage(const Node* node, const Color3B& color, const float durati
 }  // namespace
 
 void AfterImageFxManager::update(const float delta) {
+  VGPROFILE_ZONE("AfterImageFxManager::update");
+
   for (auto& [node, afterImageFxData] : _entries) {
     if (afterImageFxData.timerInSec < afterImageFxData.intervalInSec) {
       afterImageFxData.timerInSec += delta;
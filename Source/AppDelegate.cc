@@ -8,6 +8,8 @@ extern "C" {
 }
 #endif
 
+#include <cstdio>
+#include <filesystem>
 #include <string>
 
 #include <audio/AudioEngine.h>
@@ -15,8 +17,12 @@ extern "C" {
 #include "Assets.h"
 #include "Audio.h"
 #include "Constants.h"
-#include "scene/SceneManager.h"
+#include "gameplay/SaveWorker.h"
+#include "scene/GameScene.h"
 #include "scene/MainMenuScene.h"
+#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
+#include "util/AssetBundle.h"
 
 using namespace std;
 using vigilante::kVirtualWidth;
@@ -37,6 +43,10 @@ auto largeResolutionSize = ax::Size{2048, 1536};
 void AppDelegate::initGLContextAttrs() {
   // set OpenGL context attributes: red,green,blue,alpha,depth,stencil,multisamplesCount
   GLContextAttrs glContextAttrs = {8, 8, 8, 8, 24, 8, 0};
+#ifdef VIGILANTE_HEADLESS
+  // vigilante_headless never renders anything that has to be seen (see CMakeLists.txt).
+  glContextAttrs.visible = false;
+#endif
   GLView::setGLContextAttrs(glContextAttrs);
 }
 
@@ -65,16 +75,111 @@ bool AppDelegate::applicationDidFinishLaunching() {
   // set FPS. the default value is 1.0/60 if you don't call this
   director->setAnimationInterval(1.0f / 60);
 
+  // Finish the pending saves while the Director (which their completion callbacks are
+  // posted to) and SaveJournal are still alive, i.e., before static objects are destroyed.
+  director->getEventDispatcher()->addCustomEventListener(Director::EVENT_RESET, [](EventCustom*) {
+    vigilante::SaveWorker::the().shutdown();
+  });
+
 #ifdef __linux__
   chdir("Resources");
 #endif
 
+  // In dev (debug) builds, always parse the json files under Data/.
+  // In release builds, a stale bundle is detected and ignored by open().
+#ifdef NDEBUG
+  vigilante::asset_bundle::open(vigilante::assets::kDataBundle, vigilante::assets::kDataDir);
+#endif
+
   vigilante::assets::loadSpritesheets();
+
+  if (const auto& options = vigilante::bench::Simulation::options) {
+    runSoakTest(*options);
+    return true;
+  }
+
+  if (const auto& options = vigilante::InputRecorder::options) {
+    startRecording(*options);
+    return true;
+  }
+
+  if (const auto& inputFilePath = vigilante::InputReplayer::inputFilePath) {
+    startReplay(*inputFilePath);
+    return true;
+  }
+
   vigilante::SceneManager::the().runWithScene(vigilante::MainMenuScene::create());
 
   return true;
 }
 
+void AppDelegate::runSoakTest(const vigilante::bench::Simulation::Options& options) {
+  using vigilante::bench::Simulation;
+
+  string tmxMapFilePath = options.tmxMapFilePath;
+  if (tmxMapFilePath.empty()) {
+    std::error_code ec;
+    tmxMapFilePath = (fs::temp_directory_path(ec) / "vigilante_soak.tmx").string();
+    if (ec || !Simulation::writeSyntheticMap(tmxMapFilePath, Simulation::kSyntheticMapNpcJson)) {
+      Director::getInstance()->end();
+      return;
+    }
+  }
+
+  vigilante::SceneManager::the().runWithScene(vigilante::GameScene::create());
+
+  auto gmMgr = vigilante::ServiceRegistry::get<vigilante::GameMapManager>();
+  gmMgr->loadGameMap(tmxMapFilePath, [options]() {
+    Simulation::spawnExtraNpcs(options.numExtraNpcs);
+    const auto report = Simulation::run(options.numTicks);
+    std::printf("%s\n", Simulation::format(report).c_str());
+    std::fflush(stdout);
+    Director::getInstance()->end();
+  });
+}
+
+void AppDelegate::startRecording(const vigilante::InputRecorder::Options& options) {
+  using vigilante::InputRecording;
+
+  vigilante::SceneManager::the().runWithScene(vigilante::GameScene::create());
+
+  auto gameScene = vigilante::ServiceRegistry::get<vigilante::GameScene>();
+  if (options.saveFilePath.empty()) {
+    vigilante::InputRecorder::the().start(options.outputFilePath, InputRecording::StartType::NEW_GAME, "");
+    gameScene->setFixedDelta(vigilante::InputRecorder::the().getDelta());
+    gameScene->startNewGame();
+  } else {
+    vigilante::InputRecorder::the().start(options.outputFilePath, InputRecording::StartType::LOAD_GAME,
+                                          options.saveFilePath);
+    gameScene->setFixedDelta(vigilante::InputRecorder::the().getDelta());
+    gameScene->loadGame(options.saveFilePath);
+  }
+}
+
+void AppDelegate::startReplay(const string& inputFilePath) {
+  using vigilante::InputRecording;
+
+  auto recording = InputRecording::load(inputFilePath);
+  if (!recording) {
+    Director::getInstance()->end();
+    return;
+  }
+
+  vigilante::SceneManager::the().runWithScene(vigilante::GameScene::create());
+
+  const auto startType = recording->startType;
+  const string startPath = recording->startPath;
+  vigilante::InputReplayer::the().start(std::move(*recording));
+
+  auto gameScene = vigilante::ServiceRegistry::get<vigilante::GameScene>();
+  gameScene->setFixedDelta(vigilante::InputReplayer::the().getDelta());
+  if (startType == InputRecording::StartType::NEW_GAME) {
+    gameScene->startNewGame();
+  } else {
+    gameScene->loadGame(startPath);
+  }
+}
+
 // This function will be called when the app is inactive. Note, when receiving a phone call it is invoked.
 void AppDelegate::applicationDidEnterBackground() {
   Director::getInstance()->stopAnimation();
@@ -3,8 +3,13 @@
 #ifndef VIGILANTE_APP_DELEGATE_H_
 #define VIGILANTE_APP_DELEGATE_H_
 
+#include <string>
+
 #include <axmol.h>
 
+#include "bench/Simulation.h"
+#include "input/InputRecording.h"
+
 // The axmol Application.
 // Private inheritance here hides part of interface from Director.
 class AppDelegate final : private ax::Application {
@@ -22,6 +27,16 @@ class AppDelegate final : private ax::Application {
 
   // Called when the application reenters the foreground.
   virtual void applicationWillEnterForeground() override;
+
+ private:
+  // Loads the map, steps its simulation, prints the report and quits.
+  void runSoakTest(const vigilante::bench::Simulation::Options& options);
+
+  // Starts a new game (or loads a save), recording the input until the application quits.
+  void startRecording(const vigilante::InputRecorder::Options& options);
+
+  // Replays an input recording from its start point, then quits.
+  void startReplay(const std::string& inputFilePath);
 };
 
 #endif  // VIGILANTE_APP_DELEGATE_H_
@@ -2,8 +2,12 @@
 
 #include "CallbackManager.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "util/Profiler.h"
+
 using namespace std;
-USING_NS_AX;
 
 namespace vigilante {
 
@@ -12,32 +16,169 @@ CallbackManager& CallbackManager::the() {
   return instance;
 }
 
-uint64_t CallbackManager::runAfter(function<void (const CallbackManager::CallbackId)>&& userCallback, float delay) {
-  if (delay == 0) {
-    userCallback(0);
-    return 0;
+CallbackManager::CallbackManager() : _timers(kNumSentinels) {
+  for (uint32_t i = 0; i < kNumSentinels; i++) {
+    _timers[i].prev = i;
+    _timers[i].next = i;
+  }
+}
+
+CallbackManager::CallbackId CallbackManager::schedule(Callback&& callback, const float delay) {
+  const float ticks = std::clamp(std::ceil(delay / kTickInterval), 1.0f, static_cast<float>(kMaxTicks));
+
+  const uint32_t idx = allocateTimer();
+  Timer& timer = _timers[idx];
+  timer.callback = std::move(callback);
+  // `_currentTick` is the next tick to be processed, so a timer which
+  // should expire after one tick expires at `_currentTick`.
+  timer.expires = _currentTick + static_cast<uint64_t>(ticks) - 1;
+  timer.isActive = true;
+  link(idx);
+
+  _numLiveTimers++;
+  _peakNumLiveTimers = std::max(_peakNumLiveTimers, _numLiveTimers);
+  return toCallbackId(idx, timer.generation);
+}
+
+void CallbackManager::cancel(const CallbackManager::CallbackId callbackId) {
+  const uint32_t idx = static_cast<uint32_t>(callbackId);
+  const uint32_t generation = static_cast<uint32_t>(callbackId >> 32);
+  if (idx < kNumSentinels || idx >= _timers.size()) {
+    return;
+  }
+
+  const Timer& timer = _timers[idx];
+  if (!timer.isActive || timer.generation != generation) {
+    return;
   }
 
-  const CallbackId id = _nextCallbackId++;
-  auto cancellableUserCallback = [this, id, callback = std::move(userCallback)]() {
-    const auto it = _cancelledCallbackIds.find(id);
-    if (it != _cancelledCallbackIds.end()) {
-      _cancelledCallbackIds.erase(it);
-      return;
+  unlink(idx);
+  freeTimer(idx);
+}
+
+void CallbackManager::update(const float delta) {
+  VGPROFILE_ZONE("CallbackManager::update");
+
+  _elapsed += delta;
+  while (_elapsed >= kTickInterval) {
+    _elapsed -= kTickInterval;
+    tick();
+  }
+}
+
+void CallbackManager::clear() {
+  for (uint32_t i = kNumSentinels; i < _timers.size(); i++) {
+    if (_timers[i].isActive) {
+      freeTimer(i);
     }
+  }
+  for (uint32_t i = 0; i < kNumSentinels; i++) {
+    _timers[i].prev = i;
+    _timers[i].next = i;
+  }
+  _elapsed = 0;
+}
+
+void CallbackManager::tick() {
+  // When the lowest level wraps around, move the timers of the next slot
+  // in the higher level(s) down to where they belong.
+  if ((_currentTick & kSlotMask) == 0) {
+    for (int level = 1; level < kNumLevels && cascade(level); level++);
+  }
+
+  // Move the expired timers to the expiring list so that the user callbacks
+  // can schedule or cancel other timers (including the expiring ones) while we run them.
+  const uint32_t sentinel = static_cast<uint32_t>(_currentTick & kSlotMask);
+  if (_timers[sentinel].next != sentinel) {
+    const uint32_t first = _timers[sentinel].next;
+    const uint32_t last = _timers[sentinel].prev;
+    _timers[kExpiringSentinel].next = first;
+    _timers[kExpiringSentinel].prev = last;
+    _timers[first].prev = kExpiringSentinel;
+    _timers[last].next = kExpiringSentinel;
+    _timers[sentinel].next = sentinel;
+    _timers[sentinel].prev = sentinel;
+  }
+  _currentTick++;
+
+  while (_timers[kExpiringSentinel].next != kExpiringSentinel) {
+    const uint32_t idx = _timers[kExpiringSentinel].next;
+    unlink(idx);
+
+    // `_timers` may be reallocated by the user callback, so move it out first.
+    Callback callback = std::move(_timers[idx].callback);
+    const CallbackId id = toCallbackId(idx, _timers[idx].generation);
+    freeTimer(idx);
     callback(id);
-  };
+  }
+}
 
-  _scene->runAction(Sequence::createWithTwoActions(
-    DelayTime::create(delay),
-    CallFunc::create(cancellableUserCallback)
-  ));
+bool CallbackManager::cascade(const int level) {
+  const uint64_t slot = (_currentTick >> (level * kNumSlotsPerLevelBits)) & kSlotMask;
+  const uint32_t sentinel = static_cast<uint32_t>(level * kNumSlotsPerLevel + slot);
 
-  return id;
+  uint32_t idx = _timers[sentinel].next;
+  _timers[sentinel].next = sentinel;
+  _timers[sentinel].prev = sentinel;
+  while (idx != sentinel) {
+    const uint32_t next = _timers[idx].next;
+    link(idx);
+    idx = next;
+  }
+
+  return slot == 0;
 }
 
-void CallbackManager::cancel(const CallbackManager::CallbackId callbackId) {
-  _cancelledCallbackIds.emplace(callbackId);
+void CallbackManager::link(const uint32_t idx) {
+  const uint64_t expires = _timers[idx].expires;
+  const uint64_t delta = expires - std::min(expires, _currentTick);
+
+  int level = 0;
+  while (level < kNumLevels - 1 && delta >= (uint64_t{1} << ((level + 1) * kNumSlotsPerLevelBits))) {
+    level++;
+  }
+
+  // Timers which should have already expired go to the slot to be processed next.
+  const uint64_t tick = std::max(expires, _currentTick);
+  const uint64_t slot = (tick >> (level * kNumSlotsPerLevelBits)) & kSlotMask;
+  linkBefore(static_cast<uint32_t>(level * kNumSlotsPerLevel + slot), idx);
+}
+
+void CallbackManager::linkBefore(const uint32_t sentinel, const uint32_t idx) {
+  const uint32_t last = _timers[sentinel].prev;
+  _timers[idx].prev = last;
+  _timers[idx].next = sentinel;
+  _timers[last].next = idx;
+  _timers[sentinel].prev = idx;
+}
+
+void CallbackManager::unlink(const uint32_t idx) {
+  Timer& timer = _timers[idx];
+  _timers[timer.prev].next = timer.next;
+  _timers[timer.next].prev = timer.prev;
+  timer.prev = idx;
+  timer.next = idx;
+}
+
+uint32_t CallbackManager::allocateTimer() {
+  if (!_freeTimers.empty()) {
+    const uint32_t idx = _freeTimers.back();
+    _freeTimers.pop_back();
+    return idx;
+  }
+
+  _timers.emplace_back();
+  _timers.back().generation = 1;
+  return static_cast<uint32_t>(_timers.size() - 1);
+}
+
+void CallbackManager::freeTimer(const uint32_t idx) {
+  Timer& timer = _timers[idx];
+  timer.callback.reset();
+  timer.isActive = false;
+  timer.generation++;
+  _freeTimers.push_back(idx);
+  _numLiveTimers--;
 }
 
 }  // namespace vigilante
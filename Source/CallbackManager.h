@@ -3,33 +3,97 @@
 #ifndef VIGILANTE_CALLBACK_MANAGER_H_
 #define VIGILANTE_CALLBACK_MANAGER_H_
 
+#include <array>
 #include <cstdint>
-#include <functional>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
-#include <axmol.h>
+#include "util/ds/SmallFunction.h"
 
 namespace vigilante {
 
+// Runs delayed callbacks using a hierarchical timer wheel.
+//
+// The timer wheel is ticked from GameScene::update(), so pending callbacks
+// are frozen while the game is paused. Both scheduling and cancelling
+// a callback are O(1).
+//
+// A CallbackId is a handle consisting of a timer slot index and the
+// generation of that slot, so cancelling a callback which has already
+// been run (or cancelled) is a no-op even if its slot has been reused.
 class CallbackManager final {
  public:
   using CallbackId = uint64_t;
+  using Callback = SmallFunction<void (const CallbackId id)>;
+
   static CallbackManager& the();
 
-  CallbackId runAfter(std::function<void (const CallbackId id)>&& userCallback, float delay);
+  template <typename Fn>
+  CallbackId runAfter(Fn&& userCallback, float delay);
   void cancel(const CallbackId id);
+  void update(const float delta);
+  void clear();
 
-  inline void setScene(ax::Scene* scene) { _scene = scene; }
+  inline int getNumLiveTimers() const { return _numLiveTimers; }
+  inline int getPeakNumLiveTimers() const { return _peakNumLiveTimers; }
+  inline void resetPeakNumLiveTimers() { _peakNumLiveTimers = _numLiveTimers; }
 
  private:
-  CallbackManager() : _scene() {}
+  static inline constexpr float kTickInterval = 1.0f / 60.0f;
+  static inline constexpr int kNumLevels = 4;
+  static inline constexpr int kNumSlotsPerLevelBits = 6;
+  static inline constexpr int kNumSlotsPerLevel = 1 << kNumSlotsPerLevelBits;
+  static inline constexpr uint64_t kSlotMask = kNumSlotsPerLevel - 1;
+  static inline constexpr uint64_t kMaxTicks = (uint64_t{1} << (kNumLevels * kNumSlotsPerLevelBits)) - 1;
+
+  // Timers are kept in intrusive circular doubly linked lists, one per wheel slot.
+  // The first kNumSentinels entries of `_timers` are the sentinels of these lists
+  // (plus one for the list of expiring timers), so unlinking a timer never
+  // needs to know which list it's in.
+  static inline constexpr uint32_t kNumSentinels = kNumLevels * kNumSlotsPerLevel + 1;
+  static inline constexpr uint32_t kExpiringSentinel = kNumSentinels - 1;
+
+  struct Timer final {
+    Callback callback;
+    uint64_t expires{};
+    uint32_t generation{};
+    uint32_t prev{};
+    uint32_t next{};
+    bool isActive{};
+  };
 
-  static inline CallbackId _nextCallbackId{1};
+  CallbackManager();
 
-  ax::Scene* _scene;
-  std::unordered_set<CallbackId> _cancelledCallbackIds;
+  CallbackId schedule(Callback&& callback, const float delay);
+  void tick();
+  bool cascade(const int level);
+  void link(const uint32_t idx);
+  void linkBefore(const uint32_t sentinel, const uint32_t idx);
+  void unlink(const uint32_t idx);
+  uint32_t allocateTimer();
+  void freeTimer(const uint32_t idx);
+
+  static inline CallbackId toCallbackId(const uint32_t idx, const uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | idx;
+  }
+
+  std::vector<Timer> _timers;
+  std::vector<uint32_t> _freeTimers;
+  uint64_t _currentTick{};
+  float _elapsed{};
+  int _numLiveTimers{};
+  int _peakNumLiveTimers{};
 };
 
+template <typename Fn>
+CallbackManager::CallbackId CallbackManager::runAfter(Fn&& userCallback, float delay) {
+  if (delay == 0) {
+    userCallback(0);
+    return 0;
+  }
+  return schedule(Callback{std::forward<Fn>(userCallback)}, delay);
+}
+
 }  // namespace vigilante
 
 #endif  // VIGILANTE_CALLBACK_MANAGER_H_
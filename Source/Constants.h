@@ -87,6 +87,7 @@ inline constexpr int kDialogue = 94;
 inline constexpr int kPauseMenu = 96;
 inline constexpr int kControlHints = 98;
 inline constexpr int kConsole = 99;
+inline constexpr int kProfilerOverlay = kConsole;
 inline constexpr int kShade = 100;
 
 }  // namespace z_order
@@ -8,7 +8,7 @@
 #include "DynamicActor.h"
 #include "character/Character.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/AxUtil.h"
 
 using namespace std;
@@ -82,7 +82,7 @@ Sprite* FxManager::createAnimation(const string& textureResDir,
   spritesheet->addChild(sprite);
   spritesheet->getTexture()->setAliasTexParameters();
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax_util::addChildWithParentCameraMask(gmMgr->getLayer(), spritesheet, z_order::kFx);
 
   const bool shouldRepeatForever = loopCount == static_cast<unsigned int>(-1);
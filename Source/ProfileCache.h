@@ -0,0 +1,66 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_PROFILE_CACHE_H_
+#define VIGILANTE_PROFILE_CACHE_H_
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace vigilante {
+
+// A process-wide cache of the profiles (e.g., Character::Profile, Npc::Profile)
+// parsed from json files. Each json file is parsed at most once per Profile type,
+// and the parsed profile is shared by all instances as read-only data.
+//
+// Instances which mutate their profile at runtime (e.g., a character's health and exp)
+// keep their own copy, which is made from the cached profile instead of the disk,
+// so spawning another instance of the same type costs no file I/O or json parsing.
+//
+// `Profile` must be constructible from a json file path.
+template <typename Profile>
+class ProfileCache final {
+ public:
+  static std::shared_ptr<const Profile> get(const std::string& jsonFilePath) {
+    const std::string key = toKey(jsonFilePath);
+
+    auto it = _profiles.find(key);
+    if (it != _profiles.end()) {
+      return it->second;
+    }
+
+    auto profile = std::make_shared<const Profile>(jsonFilePath);
+    _profiles.emplace(key, profile);
+    return profile;
+  }
+
+  // For profiles which shouldn't be cached unless they've been loaded successfully.
+  // @return the cached profile, or nullptr if it hasn't been cached.
+  static std::shared_ptr<const Profile> find(const std::string& jsonFilePath) {
+    auto it = _profiles.find(toKey(jsonFilePath));
+    return (it != _profiles.end()) ? it->second : nullptr;
+  }
+
+  static void insert(const std::string& jsonFilePath, std::shared_ptr<const Profile> profile) {
+    _profiles.insert_or_assign(toKey(jsonFilePath), std::move(profile));
+  }
+
+  static void clear() {
+    _profiles.clear();
+  }
+
+  static inline std::size_t size() { return _profiles.size(); }
+
+ private:
+  static inline std::string toKey(const std::string& jsonFilePath) {
+    return std::filesystem::path{jsonFilePath}.lexically_normal().string();
+  }
+
+  static inline std::unordered_map<std::string, std::shared_ptr<const Profile>> _profiles;
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_PROFILE_CACHE_H_
@@ -8,7 +8,7 @@
 #include "Constants.h"
 #include "map/GameMapManager.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/AxUtil.h"
 
 namespace fs = std::filesystem;
@@ -26,7 +26,7 @@ bool StaticActor::showOnMap(float x, float y) {
   _bodySprite->setPosition(x, y);
   _node->addChild(_bodySprite, z_order::kDefault);
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax_util::addChildWithParentCameraMask(gmMgr->getLayer(), _node);
 
   return true;
@@ -39,7 +39,7 @@ bool StaticActor::removeFromMap() {
 
   _isShownOnMap = false;
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   gmMgr->getLayer()->removeChild(_node, true);
 
   _bodySpritesheet = nullptr;
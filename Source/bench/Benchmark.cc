@@ -0,0 +1,113 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+
+using namespace std;
+
+namespace vigilante::bench {
+
+namespace {
+
+string escapeJsonString(const string& s) {
+  string ret;
+  for (const char c : s) {
+    if (c == '"' || c == '\\') {
+      ret += '\\';
+    }
+    ret += c;
+  }
+  return ret;
+}
+
+// Same schema as Google Benchmark's --benchmark_format=json, so that
+// the results can be compared with its tools/compare.py.
+bool exportJson(const vector<Result>& results, const string& jsonFilePath) {
+  ofstream fout{jsonFilePath};
+  if (!fout.is_open()) {
+    std::fprintf(stderr, "Failed to open [%s] for writing.\n", jsonFilePath.c_str());
+    return false;
+  }
+
+  char date[32]{};
+  const time_t now = time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  fout << "{\n";
+  fout << "  \"context\": {\n";
+  fout << "    \"date\": \"" << date << "\",\n";
+#ifdef NDEBUG
+  fout << "    \"library_build_type\": \"release\"\n";
+#else
+  fout << "    \"library_build_type\": \"debug\"\n";
+#endif
+  fout << "  },\n";
+  fout << "  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result& result = results[i];
+    fout << "    {\"name\": \"" << escapeJsonString(result.name) << "\", "
+         << "\"run_type\": \"iteration\", "
+         << "\"iterations\": " << result.numIterations << ", "
+         << "\"real_time\": " << result.nsPerIteration << ", "
+         << "\"cpu_time\": " << result.nsPerIteration << ", "
+         << "\"time_unit\": \"ns\"}"
+         << ((i + 1 < results.size()) ? ",\n" : "\n");
+  }
+  fout << "  ]\n";
+  fout << "}\n";
+  return fout.good();
+}
+
+}  // namespace
+
+void Suite::run(const string& name, const function<void (const uint64_t numIterations)>& fn) {
+  if (!matches(name)) {
+    return;
+  }
+
+  uint64_t numIterations = 1;
+  while (true) {
+    const auto begin = chrono::steady_clock::now();
+    fn(numIterations);
+    const auto elapsed = chrono::steady_clock::now() - begin;
+
+    if (elapsed >= kMinDuration || numIterations >= (uint64_t{1} << 40)) {
+      const double ns = chrono::duration<double, nano>(elapsed).count();
+      _results.push_back({name, numIterations, ns / numIterations});
+      std::printf("%-56s %14llu %14.2f ns\n", name.c_str(),
+                  static_cast<unsigned long long>(numIterations), ns / numIterations);
+      std::fflush(stdout);
+      return;
+    }
+    numIterations *= 2;
+  }
+}
+
+int runAll(const string& filter, const string& jsonFilePath) {
+  std::printf("%-56s %14s %14s\n", "Benchmark", "Iterations", "Time/op");
+
+  Suite suite{filter};
+  runSetVectorBenchmarks(suite);
+  runRandBenchmarks(suite);
+  runDsBenchmarks(suite);
+  runUtilBenchmarks(suite);
+  runGameplayBenchmarks(suite);
+  runCommandBenchmarks(suite);
+  runSaveBenchmarks(suite);
+
+  if (suite.getResults().empty()) {
+    std::fprintf(stderr, "No benchmark matches the filter: [%s].\n", filter.c_str());
+    return EXIT_FAILURE;
+  }
+
+  if (!jsonFilePath.empty() && !exportJson(suite.getResults(), jsonFilePath)) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+}  // namespace vigilante::bench
@@ -0,0 +1,72 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_BENCH_BENCHMARK_H_
+#define VIGILANTE_BENCH_BENCHMARK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// A tiny microbenchmark harness for the hot paths which don't need a running
+// scene (e.g., util/ds, json_util). The benchmarks are built into the game
+// executable and are run from the command line with:
+//   vigilante --bench [filter] [--json <outputFilePath>]
+namespace vigilante::bench {
+
+struct Result final {
+  std::string name;
+  uint64_t numIterations;
+  double nsPerIteration;
+};
+
+class Suite final {
+ public:
+  static inline constexpr std::chrono::milliseconds kMinDuration{200};
+
+  explicit Suite(const std::string& filter) : _filter{filter} {}
+
+  // Runs `fn(numIterations)` with an increasing number of iterations
+  // until a single run takes at least kMinDuration, then records the
+  // time per iteration. Skipped if `name` doesn't contain the filter.
+  void run(const std::string& name, const std::function<void (const uint64_t numIterations)>& fn);
+
+  // @return true if `name` contains the filter.
+  inline bool matches(const std::string& name) const { return name.find(_filter) != std::string::npos; }
+
+  inline const std::vector<Result>& getResults() const { return _results; }
+
+ private:
+  std::string _filter;
+  std::vector<Result> _results;
+};
+
+// Prevents the compiler from optimizing away the computation of `value`.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+// Runs all the benchmarks whose name contains `filter`, and prints
+// the results to stdout (and to `jsonFilePath` as json, if not empty).
+// @return the process exit code.
+int runAll(const std::string& filter, const std::string& jsonFilePath = "");
+
+// Benchmark suites.
+void runSetVectorBenchmarks(Suite& suite);
+void runRandBenchmarks(Suite& suite);
+void runDsBenchmarks(Suite& suite);
+void runUtilBenchmarks(Suite& suite);
+void runGameplayBenchmarks(Suite& suite);
+void runCommandBenchmarks(Suite& suite);
+void runSaveBenchmarks(Suite& suite);
+
+}  // namespace vigilante::bench
+
+#endif  // VIGILANTE_BENCH_BENCHMARK_H_
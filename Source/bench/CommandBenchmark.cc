@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Benchmark.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ui/console/CommandHandler.h"
+
+using namespace std;
+
+namespace vigilante::bench {
+
+namespace {
+
+// Command lookup, i.e. name -> opcode. Executing a command needs
+// a running scene, so only the lookup and the arg parsing are measured.
+void runCmdLookupBenchmarks(Suite& suite) {
+  vector<string> names;
+  for (size_t i = 0; i < CommandHandler::getNumCmds(); i++) {
+    names.push_back(CommandHandler::getCmdName(static_cast<uint8_t>(i)));
+  }
+
+  suite.run("cmd/lookup/perfect_hash", [&names](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(CommandHandler::getOpcode(names[i % names.size()]));
+    }
+  });
+
+  // The linear scan over the names which the cmd table used to do.
+  suite.run("cmd/lookup/linear_scan", [&names](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      const string& name = names[i % names.size()];
+      uint8_t opcode = CompiledCmd::kInvalidOpcode;
+      for (size_t j = 0; j < names.size(); j++) {
+        if (name == names[j]) {
+          opcode = static_cast<uint8_t>(j);
+          break;
+        }
+      }
+      doNotOptimize(opcode);
+    }
+  });
+
+  unordered_map<string, uint8_t> opcodes;
+  for (size_t i = 0; i < names.size(); i++) {
+    opcodes.emplace(names[i], static_cast<uint8_t>(i));
+  }
+  suite.run("cmd/lookup/unordered_map", [&names, &opcodes](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(opcodes.find(names[i % names.size()])->second);
+    }
+  });
+
+  suite.run("cmd/lookup/unknown", [](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(CommandHandler::getOpcode("setbgmvolum"));
+    }
+  });
+}
+
+void runCmdCompileBenchmarks(Suite& suite) {
+  const string cmd = "setstage Resources/Database/quest/main/1_main_quest.json 2";
+  const string malformedCmd = "setstage Resources/Database/quest/main/1_main_quest.json two";
+
+  suite.run("cmd/compile", [&cmd](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(CommandHandler::compile(cmd));
+    }
+  });
+
+  suite.run("cmd/compile/malformed", [&malformedCmd](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(CommandHandler::compile(malformedCmd));
+    }
+  });
+}
+
+}  // namespace
+
+void runCommandBenchmarks(Suite& suite) {
+  runCmdLookupBenchmarks(suite);
+  runCmdCompileBenchmarks(suite);
+}
+
+}  // namespace vigilante::bench
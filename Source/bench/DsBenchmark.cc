@@ -0,0 +1,125 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Benchmark.h"
+
+#include <list>
+#include <string>
+#include <utility>
+
+#include "combat/ComboSystem.h"
+#include "util/ds/CircularBuffer.h"
+#include "util/ds/Digraph.h"
+
+using namespace std;
+
+namespace vigilante::bench {
+
+namespace {
+
+void runCircularBufferBenchmarks(Suite& suite) {
+  // Console command history.
+  suite.run("CircularBuffer/push_pop/32", [](const uint64_t numIterations) {
+    CircularBuffer<string> buf{32};
+    const string line = "additem Resources/Database/item/equipment/rusty_axe.json 1";
+    for (uint64_t i = 0; i < numIterations; i++) {
+      buf.push(line);
+      if (buf.full()) {
+        buf.pop();
+      }
+      doNotOptimize(buf);
+    }
+  });
+
+  suite.run("CircularBuffer/push/int/1024", [](const uint64_t numIterations) {
+    CircularBuffer<int> buf{1024};
+    for (uint64_t i = 0; i < numIterations; i++) {
+      buf.push(static_cast<int>(i));
+      doNotOptimize(buf);
+    }
+  });
+}
+
+void runDigraphBenchmarks(Suite& suite) {
+  for (const int numVertices : {8, 256}) {
+    const string suffix = "/" + std::to_string(numVertices);
+
+    suite.run("Digraph/build" + suffix, [numVertices](const uint64_t numIterations) {
+      for (uint64_t i = 0; i < numIterations; i++) {
+        Digraph<int, pair<size_t, int>> g;
+        for (int v = 0; v < numVertices; v++) {
+          g.addVertex(v);
+        }
+        for (int v = 0; v < numVertices; v++) {
+          g.addOutgoingEdge(v, {(v + 1) % numVertices, v});
+          g.addOutgoingEdge(v, {(v + 7) % numVertices, v});
+        }
+        doNotOptimize(g);
+      }
+    });
+
+    Digraph<int, pair<size_t, int>> g;
+    for (int v = 0; v < numVertices; v++) {
+      g.addVertex(v);
+    }
+    for (int v = 0; v < numVertices; v++) {
+      g.addOutgoingEdge(v, {(v + 1) % numVertices, v});
+      g.addOutgoingEdge(v, {(v + 7) % numVertices, v});
+    }
+
+    suite.run("Digraph/get_outgoing_edges" + suffix, [&g, numVertices](const uint64_t numIterations) {
+      for (uint64_t i = 0; i < numIterations; i++) {
+        doNotOptimize(g.getOutgoingEdges(i % numVertices));
+      }
+    });
+  }
+}
+
+void runTimedFiniteStateMachineBenchmarks(Suite& suite) {
+  // The same shape as the player's ComboSystem.
+  using Fsm = TimedFiniteStateMachine<int, list<int>>;
+  Fsm fsm;
+  const auto v0 = fsm.getInitialStateId();
+  const auto v1 = fsm.defineState(1);
+  const auto v2 = fsm.defineState(1);
+  const auto v3 = fsm.defineState(2);
+  const auto v4 = fsm.defineState(3);
+  const auto v5 = fsm.defineState(2);
+  fsm.defineStateTransition(v0, v1, {});
+  fsm.defineStateTransition(v1, v2, {});
+  fsm.defineStateTransition(v2, v4, {1});
+  fsm.defineStateTransition(v2, v3, {2});
+  fsm.defineStateTransition(v2, v3, {3});
+  fsm.defineStateTransition(v4, v5, {2});
+  fsm.defineStateTransition(v4, v5, {3});
+
+  // One combo step: look up the candidate transitions and take the last one.
+  suite.run("TimedFiniteStateMachine/next_state", [&fsm](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      auto reqs = fsm.getAllNextStatesAndTransitionRequirements(fsm.getCurrentStateId());
+      if (reqs.empty()) {
+        fsm.resetCurrentStateId();
+        continue;
+      }
+      fsm.setCurrentStateId(reqs.back().first);
+      fsm.setTimer(1.0f);
+      doNotOptimize(fsm.getState(fsm.getCurrentStateId()));
+    }
+  });
+
+  suite.run("TimedFiniteStateMachine/update", [&fsm](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      fsm.update(1.0f / 60);
+      doNotOptimize(fsm);
+    }
+  });
+}
+
+}  // namespace
+
+void runDsBenchmarks(Suite& suite) {
+  runCircularBufferBenchmarks(suite);
+  runDigraphBenchmarks(suite);
+  runTimedFiniteStateMachineBenchmarks(suite);
+}
+
+}  // namespace vigilante::bench
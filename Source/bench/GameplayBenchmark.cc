@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Benchmark.h"
+
+#include <list>
+#include <string>
+
+#include <box2d/box2d.h>
+
+#include "gameplay/InGameTime.h"
+#include "map/GameMapManager.h"
+#include "map/PathFinder.h"
+#include "util/RandUtil.h"
+
+using namespace std;
+
+namespace vigilante::bench {
+
+namespace {
+
+void runInGameTimeBenchmarks(Suite& suite) {
+  for (const int numCmds : {16, 1024}) {
+    const string suffix = "/" + std::to_string(numCmds);
+
+    suite.run("InGameTime/run_after" + suffix, [numCmds](const uint64_t numIterations) {
+      for (uint64_t i = 0; i < numIterations; i++) {
+        InGameTime inGameTime;
+        for (int j = 0; j < numCmds; j++) {
+          inGameTime.runAfter(0, (j * 7919) % 1440, 0, "rentroomcheckout");
+        }
+        doNotOptimize(inGameTime);
+      }
+    });
+
+    // Ticking while none of the deferred cmds is due, which is the common case.
+    InGameTime inGameTime;
+    for (int j = 0; j < numCmds; j++) {
+      inGameTime.runAfter(100000 + j, 0, 0, "rentroomcheckout");
+    }
+    suite.run("InGameTime/update_idle" + suffix, [&inGameTime](const uint64_t numIterations) {
+      for (uint64_t i = 0; i < numIterations; i++) {
+        inGameTime.update(1.0f / 60);
+        doNotOptimize(inGameTime);
+      }
+    });
+  }
+}
+
+void runPathFinderBenchmarks(Suite& suite) {
+  rand_util::init(0);
+
+  for (const int numPlatforms : {16, 256}) {
+    // Synthetic platforms scattered over a 64m x 32m map.
+    b2World world{{0, -9.8f}};
+    list<b2Body*> platformBodies;
+    for (int i = 0; i < numPlatforms; i++) {
+      b2BodyDef bodyDef;
+      bodyDef.type = b2_staticBody;
+      bodyDef.position = {rand_util::randFloat(rand_util::Stream::MISC, 0, 64),
+                          rand_util::randFloat(rand_util::Stream::MISC, 0, 32)};
+      platformBodies.push_back(world.CreateBody(&bodyDef));
+    }
+
+    suite.run("SimplePathFinder/find_optimal_next_hop/" + std::to_string(numPlatforms),
+              [&platformBodies](const uint64_t numIterations) {
+      for (uint64_t i = 0; i < numIterations; i++) {
+        const b2Vec2 srcPos{static_cast<float>(i % 64), static_cast<float>(i % 8)};
+        const b2Vec2 destPos{srcPos.x + 2, srcPos.y + 4};
+        doNotOptimize(SimplePathFinder::findOptimalNextHop(srcPos, destPos, 1.0f, platformBodies));
+      }
+    });
+  }
+}
+
+void runGameMapManagerBenchmarks(Suite& suite) {
+  const string tmxMapFilePath = "Resources/Map/AbandonedCastlePrison/Main.tmx";
+
+  suite.run("GameMapManager/get_openable_object_query_key", [&tmxMapFilePath](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(GameMapManager::getOpenableObjectQueryKey(
+          tmxMapFilePath, GameMap::OpenableObjectType::PORTAL, static_cast<int>(i % 16)));
+    }
+  });
+}
+
+}  // namespace
+
+void runGameplayBenchmarks(Suite& suite) {
+  runInGameTimeBenchmarks(suite);
+  runPathFinderBenchmarks(suite);
+  runGameMapManagerBenchmarks(suite);
+}
+
+}  // namespace vigilante::bench
@@ -0,0 +1,136 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "SelfTest.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gameplay/InGameTime.h"
+
+using namespace std;
+
+namespace vigilante::bench {
+
+namespace {
+
+// Sets the clock to `hour`:`minute`:00, with no in-game time elapsed.
+void setClock(InGameTime& inGameTime, const int hour, const int minute) {
+  inGameTime.setSecondsElapsed(0);
+  inGameTime.setHour(hour);
+  inGameTime.setMinute(minute);
+  inGameTime.setSecond(0);
+}
+
+}  // namespace
+
+void runInGameTimeSelfTests(SelfTests& tests) {
+  tests.run("in_game_time/subscribe_after", []() {
+    InGameTime inGameTime;
+    vector<uint64_t> firedAt;
+    inGameTime.subscribeAfter(0, 0, 30, [&inGameTime, &firedAt](const InGameTime::SubscriptionId) {
+      firedAt.push_back(inGameTime.getSecondsElapsed());
+    });
+
+    inGameTime.fastForward(0, 0, 29);
+    const bool hasFiredEarly = !firedAt.empty();
+    inGameTime.fastForward(0, 0, 1);
+    inGameTime.fastForward(1, 0, 0);
+    return !hasFiredEarly && firedAt == vector<uint64_t>{30};
+  });
+
+  tests.run("in_game_time/subscribe_every", []() {
+    InGameTime inGameTime;
+    vector<uint64_t> firedAt;
+    inGameTime.subscribeEvery(0, 0, 10, [&inGameTime, &firedAt](const InGameTime::SubscriptionId) {
+      firedAt.push_back(inGameTime.getSecondsElapsed());
+    });
+
+    inGameTime.fastForward(0, 0, 35);
+    inGameTime.fastForward(0, 0, 5);
+    return firedAt == vector<uint64_t>{10, 20, 30, 40};
+  });
+
+  tests.run("in_game_time/subscribe_daily_at", []() {
+    InGameTime inGameTime;
+    setClock(inGameTime, 4, 0);
+    vector<uint64_t> firedAt;
+    bool isFiredAtFive = true;
+    inGameTime.subscribeDailyAt(5, 0, [&inGameTime, &firedAt, &isFiredAtFive](const InGameTime::SubscriptionId) {
+      firedAt.push_back(inGameTime.getSecondsElapsed());
+      isFiredAtFive &= inGameTime.getHour() == 5 && inGameTime.getMinute() == 0 && inGameTime.getSecond() == 0;
+    });
+
+    inGameTime.fastForward(0, 59, 59);
+    const bool hasFiredEarly = !firedAt.empty();
+    inGameTime.fastForward(0, 0, 1);
+    inGameTime.fastForward(24, 0, 0);
+    return !hasFiredEarly && isFiredAtFive && firedAt == vector<uint64_t>{3600, 3600 + InGameTime::kSecondsPerDay};
+  });
+
+  tests.run("in_game_time/subscribe_daily_at_after_setting_time", []() {
+    InGameTime inGameTime;
+    setClock(inGameTime, 4, 0);
+    int numFired = 0;
+    inGameTime.subscribeDailyAt(5, 0, [&numFired](const InGameTime::SubscriptionId) { numFired++; });
+
+    // Setting the time reschedules it rather than firing it.
+    inGameTime.setHour(6);
+    inGameTime.fastForward(12, 0, 0);
+    const bool hasFiredAfterSettingTime = numFired;
+    inGameTime.fastForward(11, 0, 0);
+    return !hasFiredAfterSettingTime && numFired == 1;
+  });
+
+  tests.run("in_game_time/cancel_from_callback", []() {
+    InGameTime inGameTime;
+    int numPeriodicFired = 0;
+    inGameTime.subscribeEvery(0, 0, 10, [&inGameTime, &numPeriodicFired](const InGameTime::SubscriptionId id) {
+      if (++numPeriodicFired == 2) {
+        inGameTime.cancel(id);
+      }
+    });
+
+    // A one-shot subscription which cancels another one due right after it.
+    InGameTime::SubscriptionId victimId{};
+    bool hasVictimFired = false;
+    inGameTime.subscribeAfter(0, 0, 5, [&inGameTime, &victimId](const InGameTime::SubscriptionId) {
+      inGameTime.cancel(victimId);
+    });
+    victimId = inGameTime.subscribeAfter(0, 0, 6, [&hasVictimFired](const InGameTime::SubscriptionId) {
+      hasVictimFired = true;
+    });
+
+    inGameTime.fastForward(0, 1, 0);
+    return numPeriodicFired == 2 && !hasVictimFired;
+  });
+
+  tests.run("in_game_time/fast_forward_past_several_events", []() {
+    InGameTime inGameTime;
+    setClock(inGameTime, 22, 0);
+
+    // <secondsElapsed, hour> of each event as it fires.
+    vector<pair<uint64_t, int>> fired;
+    auto record = [&inGameTime, &fired](const InGameTime::SubscriptionId) {
+      fired.emplace_back(inGameTime.getSecondsElapsed(), inGameTime.getHour());
+    };
+    inGameTime.subscribeAfter(3, 0, 0, record);
+    inGameTime.subscribeAfter(1, 0, 0, record);
+    inGameTime.subscribeDailyAt(5, 0, record);
+    inGameTime.subscribeEvery(2, 0, 0, record);
+
+    // An 8-hour rest, from 22:00 to 06:00.
+    inGameTime.fastForward(8, 0, 0);
+    const vector<pair<uint64_t, int>> expected = {
+      {1 * 3600, 23},
+      {2 * 3600, 0},
+      {3 * 3600, 1},
+      {4 * 3600, 2},
+      {6 * 3600, 4},
+      {7 * 3600, 5},
+      {8 * 3600, 6},
+    };
+    return fired == expected && inGameTime.getSecondsElapsed() == 8 * 3600 && inGameTime.getHour() == 6;
+  });
+}
+
+}  // namespace vigilante::bench
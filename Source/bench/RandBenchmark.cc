@@ -0,0 +1,45 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Benchmark.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "util/RandUtil.h"
+
+using namespace std;
+
+namespace vigilante::bench {
+
+void runRandBenchmarks(Suite& suite) {
+  rand_util::init(0);
+
+  // The generator rand_util used before the streams were introduced.
+  suite.run("rand/libc_rand", [](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize((std::rand() % 101));
+    }
+  });
+
+  suite.run("rand/stream_rand_int", [](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(rand_util::randInt(rand_util::Stream::AI, 0, 100));
+    }
+  });
+
+  suite.run("rand/stream_rand_float", [](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(rand_util::randFloat(rand_util::Stream::FX, -1.0f, 1.0f));
+    }
+  });
+
+  vector<float> values(1024);
+  suite.run("rand/batch_rand_floats/1024", [&values](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      rand_util::randFloats(rand_util::Stream::LOOT, 0.0f, 1.0f, values);
+      doNotOptimize(values);
+    }
+  });
+}
+
+}  // namespace vigilante::bench
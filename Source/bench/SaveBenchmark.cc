@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <string>
+
+#include "SaveSample.h"
+#include "gameplay/BinarySave.h"
+#include "gameplay/GameState.h"
+
+using namespace std;
+
+namespace vigilante::bench {
+
+void runSaveBenchmarks(Suite& suite) {
+  const GameState::Snapshot snapshot = makeSampleSnapshot();
+  const string json = encodeJson(snapshot);
+  const string binary = binary_save::encode(snapshot, binary_save::Compression::NONE);
+  const string compressedBinary = binary_save::encode(snapshot, binary_save::Compression::ZLIB);
+
+  suite.run("save/encode/json", [&snapshot](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(encodeJson(snapshot));
+    }
+  });
+
+  suite.run("save/encode/binary", [&snapshot](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(binary_save::encode(snapshot, binary_save::Compression::NONE));
+    }
+  });
+
+  suite.run("save/encode/binary_zlib", [&snapshot](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(binary_save::encode(snapshot, binary_save::Compression::ZLIB));
+    }
+  });
+
+  suite.run("save/decode/json", [&json](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      GameState::Snapshot s;
+      doNotOptimize(decodeJson(json, s));
+    }
+  });
+
+  suite.run("save/decode/binary", [&binary](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      GameState::Snapshot s{};
+      doNotOptimize(binary_save::decode(binary, s));
+    }
+  });
+
+  suite.run("save/decode/binary_zlib", [&compressedBinary](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      GameState::Snapshot s{};
+      doNotOptimize(binary_save::decode(compressedBinary, s));
+    }
+  });
+
+  // Sections are decoded independently, e.g., only the in-game time.
+  suite.run("save/decode/binary_in_game_time_only", [&binary](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      GameState::Snapshot s{};
+      doNotOptimize(binary_save::decode(binary, s, 1 << binary_save::Section::IN_GAME_TIME));
+    }
+  });
+
+  if (suite.matches("save/size")) {
+    std::printf("%-56s %14zu %14s\n", "save/size/json", json.size(), "bytes");
+    std::printf("%-56s %14zu %14s\n", "save/size/binary", binary.size(), "bytes");
+    std::printf("%-56s %14zu %14s\n", "save/size/binary_zlib", compressedBinary.size(), "bytes");
+  }
+}
+
+}  // namespace vigilante::bench
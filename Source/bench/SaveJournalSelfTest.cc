@@ -0,0 +1,204 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "SelfTest.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+#include "SaveSample.h"
+#include "gameplay/GameState.h"
+#include "gameplay/SaveJournal.h"
+#include "gameplay/SaveWorker.h"
+
+namespace fs = std::filesystem;
+using namespace std;
+
+namespace vigilante::bench {
+
+namespace {
+
+constexpr char kItemJsonFilePath[] = "Resources/Database/item/selftest_item.json";
+constexpr char kNpcJsonFilePath[] = "Resources/Database/character/selftest_npc.json";
+constexpr char kOpenableObjectKey[] = "selftest_chest";
+
+// SaveJournal::reset() and compact() must be called on the SaveWorker.
+bool runOnSaveWorker(const function<bool ()>& fn) {
+  bool result{};
+  SaveWorker::the().post([&result, &fn]() { result = fn(); });
+  SaveWorker::the().waitUntilIdle();
+  return result;
+}
+
+// Saves `base` to `saveFilePath` along with an empty journal.
+bool writeSaveFile(const fs::path& saveFilePath, const GameState::Snapshot& base) {
+  return GameState::write(saveFilePath, base) &&
+         runOnSaveWorker([&saveFilePath]() { return SaveJournal::reset(saveFilePath); });
+}
+
+// Journals a change of each kind on top of `snapshot`, makes the same changes to it,
+// and appends them to the journal with a checkpoint (as autosaving does).
+void journalChanges(const fs::path& saveFilePath, GameState::Snapshot& snapshot) {
+  SaveJournal& journal = SaveJournal::the();
+  journal.open(saveFilePath);
+
+  GameState::Snapshot::Player& p = snapshot.player;
+  p.itemMapper[kItemJsonFilePath] = 2;
+  p.inventory[0].push_back(kItemJsonFilePath);
+  journal.recordItem(kItemJsonFilePath, 0, 2, /*isInInventory=*/true);
+
+  p.equipmentSlots[1] = kItemJsonFilePath;
+  journal.recordEquipmentSlot(1, kItemJsonFilePath);
+
+  p.partyMembers.push_back(kNpcJsonFilePath);
+  journal.recordPartyMember(kNpcJsonFilePath, /*isMember=*/true);
+
+  snapshot.allOpenableObjectStates[kOpenableObjectKey] = true;
+  journal.recordOpenableObject(kOpenableObjectKey, /*isOpened=*/true);
+
+  snapshot.npcSpawningBlacklist.insert(kNpcJsonFilePath);
+  journal.recordNpcSpawning(kNpcJsonFilePath, /*isAllowed=*/false);
+
+  p.level++;
+  snapshot.playerPos.first += 1.5f;
+  snapshot.secondsElapsed += 60;
+  journal.checkpoint(snapshot);
+  SaveWorker::the().waitUntilIdle();
+}
+
+// Reads `saveFilePath` and replays its journal on top of it.
+bool readAndReplay(const fs::path& saveFilePath, GameState::Snapshot& snapshot, bool& isReplayed) {
+  snapshot = {};
+  if (!GameState::read(saveFilePath, snapshot)) {
+    return false;
+  }
+  isReplayed = SaveJournal::replay(saveFilePath, snapshot);
+  return true;
+}
+
+bool checkReplay(const fs::path& saveFilePath, const GameState::Snapshot& base) {
+  GameState::Snapshot expected = base;
+  if (!writeSaveFile(saveFilePath, base)) {
+    return false;
+  }
+  journalChanges(saveFilePath, expected);
+
+  GameState::Snapshot s;
+  bool isReplayed{};
+  return readAndReplay(saveFilePath, s, isReplayed) && isReplayed && s == expected;
+}
+
+// Appends a second checkpoint, truncates the journal at a number of offsets within it,
+// as if the game had crashed in the middle of appending it, and checks that the torn
+// record is dropped while everything before it is still replayed.
+bool checkTornRecord(const fs::path& saveFilePath, const GameState::Snapshot& base) {
+  GameState::Snapshot expected = base;
+  if (!writeSaveFile(saveFilePath, base)) {
+    return false;
+  }
+  journalChanges(saveFilePath, expected);
+
+  const fs::path journalFilePath = SaveJournal::getJournalFilePath(saveFilePath);
+  std::error_code ec;
+  const uintmax_t intactSize = fs::file_size(journalFilePath, ec);
+
+  GameState::Snapshot newer = expected;
+  newer.secondsElapsed += 3600;
+  SaveJournal::the().checkpoint(newer);
+  SaveWorker::the().waitUntilIdle();
+  const uintmax_t size = fs::file_size(journalFilePath, ec);
+  if (ec || size <= intactSize) {
+    return false;
+  }
+
+  for (uintmax_t tornSize = size - 1; tornSize > intactSize; tornSize = intactSize + (tornSize - intactSize) / 2) {
+    fs::resize_file(journalFilePath, tornSize, ec);
+    GameState::Snapshot s;
+    bool isReplayed{};
+    if (ec || !readAndReplay(saveFilePath, s, isReplayed) || isReplayed || s != expected) {
+      std::fprintf(stderr, "Save journal torn at %ju of %ju bytes has not been replayed up to the torn record.\n",
+                   tornSize, size);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Overwrites the save file without resetting its journal, which must no longer be replayed.
+bool checkStaleJournal(const fs::path& saveFilePath, const GameState::Snapshot& base) {
+  GameState::Snapshot changed = base;
+  if (!writeSaveFile(saveFilePath, base)) {
+    return false;
+  }
+  journalChanges(saveFilePath, changed);
+
+  GameState::Snapshot other = base;
+  other.player.level += 10;
+  if (!GameState::write(saveFilePath, other)) {
+    return false;
+  }
+
+  GameState::Snapshot s;
+  bool isReplayed{};
+  return readAndReplay(saveFilePath, s, isReplayed) && !isReplayed && s == other;
+}
+
+// Folds the journal into the save file, which is then loaded as is.
+bool checkCompaction(const fs::path& saveFilePath, const GameState::Snapshot& base) {
+  GameState::Snapshot expected = base;
+  if (!writeSaveFile(saveFilePath, base)) {
+    return false;
+  }
+  journalChanges(saveFilePath, expected);
+
+  GameState::Snapshot s;
+  bool isReplayed{};
+  if (!readAndReplay(saveFilePath, s, isReplayed) || !isReplayed ||
+      !runOnSaveWorker([&saveFilePath, &s]() { return SaveJournal::compact(saveFilePath, s); })) {
+    return false;
+  }
+
+  GameState::Snapshot compacted;
+  if (!GameState::read(saveFilePath, compacted) || compacted != expected) {
+    return false;
+  }
+
+  // The journal has been reset, so replaying it changes nothing.
+  return readAndReplay(saveFilePath, s, isReplayed) && isReplayed && s == expected;
+}
+
+}  // namespace
+
+void runSaveJournalSelfTests(SelfTests& tests) {
+  const GameState::Snapshot snapshot = makeSampleSnapshot();
+
+  std::error_code ec;
+  const fs::path dir = fs::temp_directory_path(ec) / "vigilante_journal_selftest";
+  fs::create_directories(dir, ec);
+  if (ec) {
+    std::fprintf(stderr, "Failed to create [%s]: %s.\n", dir.string().c_str(), ec.message().c_str());
+    return;
+  }
+
+  tests.run("save_journal/replay", [&dir, &snapshot]() {
+    return checkReplay(dir / "replay.vgs", snapshot);
+  });
+
+  tests.run("save_journal/torn_record", [&dir, &snapshot]() {
+    return checkTornRecord(dir / "torn_record.vgs", snapshot);
+  });
+
+  tests.run("save_journal/stale_base_id", [&dir, &snapshot]() {
+    return checkStaleJournal(dir / "stale_base_id.vgs", snapshot);
+  });
+
+  tests.run("save_journal/compaction", [&dir, &snapshot]() {
+    return checkCompaction(dir / "compaction.vgs", snapshot);
+  });
+
+  SaveJournal::the().close();
+  fs::remove_all(dir, ec);
+}
+
+}  // namespace vigilante::bench
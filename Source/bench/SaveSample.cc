@@ -0,0 +1,81 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "SaveSample.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+using namespace std;
+
+namespace vigilante::bench {
+
+GameState::Snapshot makeSampleSnapshot() {
+  const string mapDir = "Resources/Map/AbandonedCastlePrison/";
+  const string itemDir = "Resources/Database/item/";
+
+  GameState::Snapshot snapshot{};
+  snapshot.tmxTiledMapFilePath = mapDir + "Main.tmx";
+  for (int i = 0; i < 32; i++) {
+    snapshot.npcSpawningBlacklist.insert(mapDir + "Main.tmx_npc_" + std::to_string(i));
+  }
+  for (int i = 0; i < 64; i++) {
+    snapshot.allOpenableObjectStates[mapDir + "Main.tmx_p_" + std::to_string(i)] = i % 3;
+  }
+  snapshot.playerPos = {42.5f, 7.25f};
+
+  GameState::Snapshot::Player& p = snapshot.player;
+  p.name = "Aesophor";
+  p.level = 12;
+  p.exp = 3456;
+  p.fullHealth = p.health = 420;
+  p.fullStamina = p.stamina = 180;
+  p.fullMagicka = p.magicka = 150;
+  p.strength = 18;
+  p.dexterity = 14;
+  p.intelligence = 9;
+  p.luck = 6;
+  p.moveSpeed = .75f;
+  p.jumpHeight = 4.2f;
+  p.canDoubleJump = true;
+  p.attackForce = 3.f;
+  p.attackTime = .4f;
+  p.attackRange = .5f;
+  p.baseMeleeDamage = 25;
+  p.inventory.resize(3);
+  for (int i = 0; i < 48; i++) {
+    const string itemJsonFilePath = itemDir + "item_" + std::to_string(i) + ".json";
+    p.itemMapper[itemJsonFilePath] = 1 + i % 5;
+    p.inventory[i % 3].push_back(itemJsonFilePath);
+  }
+  p.equipmentSlots = {itemDir + "item_0.json", "", itemDir + "item_3.json", "", "", itemDir + "item_6.json"};
+  p.partyMembers = {"Resources/Database/character/vlad.json", "Resources/Database/character/castle_guard.json"};
+  p.waitingPartyMembers.push_back({"Resources/Database/character/jack.json", mapDir + "Main.tmx", 12.f, 3.f});
+
+  snapshot.hour = 18;
+  snapshot.minute = 42;
+  snapshot.second = 7;
+  snapshot.secondsElapsed = 1234567;
+  for (int i = 0; i < 8; i++) {
+    snapshot.deferredCmds.emplace_back(1234567 + i * 3600, "rentroomcheckout Inn" + std::to_string(i));
+  }
+  snapshot.checkedInInns = {"Resources/Map/Town/Inn.tmx"};
+  snapshot.rngSeed = 5566;
+  return snapshot;
+}
+
+string encodeJson(const GameState::Snapshot& snapshot) {
+  const rapidjson::Document json = GameState::toJson(snapshot);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+  json.Accept(writer);
+  return {buffer.GetString(), buffer.GetSize()};
+}
+
+bool decodeJson(const string& data, GameState::Snapshot& snapshot) {
+  rapidjson::Document json;
+  json.Parse(data.data(), data.size());
+  return !json.HasParseError() && GameState::fromJson(json, snapshot);
+}
+
+}  // namespace vigilante::bench
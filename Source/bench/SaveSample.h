@@ -0,0 +1,21 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_BENCH_SAVE_SAMPLE_H_
+#define VIGILANTE_BENCH_SAVE_SAMPLE_H_
+
+#include <string>
+
+#include "gameplay/GameState.h"
+
+// The sample save shared by the save benchmarks and the save self-tests.
+namespace vigilante::bench {
+
+// Roughly a mid-game save.
+GameState::Snapshot makeSampleSnapshot();
+
+std::string encodeJson(const GameState::Snapshot& snapshot);
+bool decodeJson(const std::string& data, GameState::Snapshot& snapshot);
+
+}  // namespace vigilante::bench
+
+#endif  // VIGILANTE_BENCH_SAVE_SAMPLE_H_
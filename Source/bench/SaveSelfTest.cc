@@ -0,0 +1,129 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "SelfTest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "SaveSample.h"
+#include "gameplay/BinarySave.h"
+#include "gameplay/GameState.h"
+
+namespace fs = std::filesystem;
+using namespace std;
+
+namespace vigilante::bench {
+
+namespace {
+
+bool writeFile(const fs::path& filePath, const string& data) {
+  ofstream ofs{filePath, ios::binary | ios::trunc};
+  ofs.write(data.data(), data.size());
+  return ofs.good();
+}
+
+string readFile(const fs::path& filePath) {
+  ifstream ifs{filePath, ios::binary};
+  return {istreambuf_iterator<char>{ifs}, istreambuf_iterator<char>{}};
+}
+
+// Writes `snapshot` to a save file through GameState, and reads it back.
+bool checkFileRoundTrip(const fs::path& saveFilePath, const GameState::Snapshot& snapshot,
+                        const GameState::Format format) {
+  GameState::Snapshot s{};
+  return GameState::write(saveFilePath, snapshot, format) &&
+         GameState::read(saveFilePath, s) && s == snapshot;
+}
+
+// Saves `older` and then `newer`, truncates the save file at a number of offsets,
+// as if the game had crashed in the middle of writing it, and checks that each
+// truncated save file is rejected and its backup (`older`) is loaded instead.
+bool checkTruncatedFileRecovery(const fs::path& saveFilePath,
+                                const GameState::Snapshot& older,
+                                const GameState::Snapshot& newer,
+                                const GameState::Format format) {
+  if (!GameState::write(saveFilePath, older, format) || !GameState::write(saveFilePath, newer, format)) {
+    return false;
+  }
+
+  const string data = readFile(saveFilePath);
+  if (data.empty()) {
+    return false;
+  }
+
+  const size_t step = std::max<size_t>(data.size() / 128, 1);
+  for (size_t size = 0; size < data.size(); size += step) {
+    if (!writeFile(saveFilePath, data.substr(0, size))) {
+      return false;
+    }
+
+    GameState::Snapshot s{};
+    bool isSaveFileRead{};
+    if (!GameState::readWithBackup(saveFilePath, s, isSaveFileRead) || isSaveFileRead || s != older) {
+      std::fprintf(stderr, "Save file truncated to %zu of %zu bytes has not been recovered from.\n",
+                   size, data.size());
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void runSaveSelfTests(SelfTests& tests) {
+  const GameState::Snapshot snapshot = makeSampleSnapshot();
+
+  tests.run("save/round_trip/json", [&snapshot]() {
+    GameState::Snapshot s{};
+    return decodeJson(encodeJson(snapshot), s) && s == snapshot;
+  });
+
+  tests.run("save/round_trip/binary", [&snapshot]() {
+    GameState::Snapshot s{};
+    return binary_save::decode(binary_save::encode(snapshot, binary_save::Compression::NONE), s) &&
+           s == snapshot;
+  });
+
+  tests.run("save/round_trip/binary_zlib", [&snapshot]() {
+    GameState::Snapshot s{};
+    return binary_save::decode(binary_save::encode(snapshot, binary_save::Compression::ZLIB), s) &&
+           s == snapshot;
+  });
+
+  std::error_code ec;
+  const fs::path dir = fs::temp_directory_path(ec) / "vigilante_selftest";
+  fs::create_directories(dir, ec);
+  if (ec) {
+    std::fprintf(stderr, "Failed to create [%s]: %s.\n", dir.string().c_str(), ec.message().c_str());
+    return;
+  }
+
+  tests.run("save/round_trip/file_binary", [&dir, &snapshot]() {
+    return checkFileRoundTrip(dir / "round_trip.vgs", snapshot, GameState::Format::BINARY);
+  });
+
+  tests.run("save/round_trip/file_json", [&dir, &snapshot]() {
+    return checkFileRoundTrip(dir / "round_trip.json", snapshot, GameState::Format::JSON);
+  });
+
+  GameState::Snapshot newerSnapshot = snapshot;
+  newerSnapshot.player.level++;
+  newerSnapshot.player.itemMapper.erase(newerSnapshot.player.itemMapper.begin());
+  newerSnapshot.secondsElapsed += 3600;
+
+  tests.run("save/recovery/truncated_binary", [&dir, &snapshot, &newerSnapshot]() {
+    return checkTruncatedFileRecovery(dir / "truncated.vgs", snapshot, newerSnapshot, GameState::Format::BINARY);
+  });
+
+  tests.run("save/recovery/truncated_json", [&dir, &snapshot, &newerSnapshot]() {
+    return checkTruncatedFileRecovery(dir / "truncated.json", snapshot, newerSnapshot, GameState::Format::JSON);
+  });
+
+  fs::remove_all(dir, ec);
+}
+
+}  // namespace vigilante::bench
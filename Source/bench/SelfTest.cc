@@ -0,0 +1,42 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "SelfTest.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+namespace vigilante::bench {
+
+void SelfTests::run(const string& name, const function<bool ()>& fn) {
+  if (name.find(_filter) == string::npos) {
+    return;
+  }
+
+  const bool hasPassed = fn();
+  if (hasPassed) {
+    _numPassed++;
+  } else {
+    _numFailed++;
+  }
+  std::printf("%-56s %s\n", name.c_str(), hasPassed ? "ok" : "FAILED");
+  std::fflush(stdout);
+}
+
+int runAllSelfTests(const string& filter) {
+  SelfTests tests{filter};
+  runInGameTimeSelfTests(tests);
+  runSaveSelfTests(tests);
+  runSaveJournalSelfTests(tests);
+
+  if (tests.getNumPassed() + tests.getNumFailed() == 0) {
+    std::fprintf(stderr, "No self-test matches the filter: [%s].\n", filter.c_str());
+    return EXIT_FAILURE;
+  }
+
+  std::printf("%d passed, %d failed\n", tests.getNumPassed(), tests.getNumFailed());
+  return tests.getNumFailed() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+}  // namespace vigilante::bench
@@ -0,0 +1,44 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_BENCH_SELF_TEST_H_
+#define VIGILANTE_BENCH_SELF_TEST_H_
+
+#include <functional>
+#include <string>
+
+// Correctness checks of the code paths which must never regress silently
+// (e.g., an in-game time subscription has to fire exactly when it's due).
+// Like the benchmarks, they're built into the game executable and don't
+// need a running scene. They're run from the command line with:
+//   vigilante --selftest [filter]
+namespace vigilante::bench {
+
+class SelfTests final {
+ public:
+  explicit SelfTests(const std::string& filter) : _filter{filter} {}
+
+  // Runs `fn()` and prints whether it has passed (returned true).
+  // Skipped if `name` doesn't contain the filter.
+  void run(const std::string& name, const std::function<bool ()>& fn);
+
+  inline int getNumPassed() const { return _numPassed; }
+  inline int getNumFailed() const { return _numFailed; }
+
+ private:
+  std::string _filter;
+  int _numPassed{};
+  int _numFailed{};
+};
+
+// Runs all the self-tests whose name contains `filter`.
+// @return the process exit code, which is non-zero if any of them has failed.
+int runAllSelfTests(const std::string& filter);
+
+// Self-test suites.
+void runInGameTimeSelfTests(SelfTests& tests);
+void runSaveSelfTests(SelfTests& tests);
+void runSaveJournalSelfTests(SelfTests& tests);
+
+}  // namespace vigilante::bench
+
+#endif  // VIGILANTE_BENCH_SELF_TEST_H_
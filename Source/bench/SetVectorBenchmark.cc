@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "util/ds/FlatSetVector.h"
+#include "util/ds/SetVector.h"
+
+using namespace std;
+
+namespace vigilante::bench {
+
+namespace {
+
+// The keys are pointers, just like Character::Inventory and Character::SkillBook.
+struct Object final {
+  int value;
+};
+
+template <typename Container>
+void runSuite(Suite& suite, const string& containerName, const vector<Object*>& keys,
+              const vector<Object*>& shuffledKeys) {
+  const string suffix = "/" + std::to_string(keys.size());
+
+  suite.run(containerName + "/insert" + suffix, [&](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      Container c;
+      for (auto key : keys) {
+        c.insert(key);
+      }
+      doNotOptimize(c);
+    }
+  });
+
+  suite.run(containerName + "/insert_erase" + suffix, [&](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      Container c;
+      for (auto key : keys) {
+        c.insert(key);
+      }
+      for (auto key : shuffledKeys) {
+        c.erase(key);
+      }
+      doNotOptimize(c);
+    }
+  });
+
+  // Loot and trade: an item is removed and another one is added.
+  suite.run(containerName + "/churn" + suffix, [&](const uint64_t numIterations) {
+    Container c;
+    for (auto key : keys) {
+      c.insert(key);
+    }
+    for (uint64_t i = 0; i < numIterations; i++) {
+      Object* key = shuffledKeys[i % shuffledKeys.size()];
+      c.erase(key);
+      c.insert(key);
+    }
+    doNotOptimize(c);
+  });
+
+  suite.run(containerName + "/iterate" + suffix, [&](const uint64_t numIterations) {
+    Container c;
+    for (auto key : keys) {
+      c.insert(key);
+    }
+    for (uint64_t i = 0; i < numIterations; i++) {
+      int sum = 0;
+      for (const auto key : c) {
+        sum += key->value;
+      }
+      doNotOptimize(sum);
+    }
+  });
+}
+
+}  // namespace
+
+void runSetVectorBenchmarks(Suite& suite) {
+  for (const size_t numKeys : {4, 64, 1024}) {
+    vector<Object> objects(numKeys);
+    vector<Object*> keys(numKeys);
+    for (size_t i = 0; i < numKeys; i++) {
+      objects[i].value = static_cast<int>(i);
+      keys[i] = &objects[i];
+    }
+
+    vector<Object*> shuffledKeys = keys;
+    std::shuffle(shuffledKeys.begin(), shuffledKeys.end(), std::mt19937{numKeys});
+
+    runSuite<SetVector<Object*>>(suite, "SetVector", keys, shuffledKeys);
+    runSuite<FlatSetVector<Object*>>(suite, "FlatSetVector", keys, shuffledKeys);
+    runSuite<FlatSetVector<Object*, SwapErase>>(suite, "FlatSetVector<SwapErase>", keys, shuffledKeys);
+  }
+}
+
+}  // namespace vigilante::bench
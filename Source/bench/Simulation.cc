@@ -0,0 +1,246 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Simulation.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "AfterImageFxManager.h"
+#include "CallbackManager.h"
+#include "character/Npc.h"
+#include "gameplay/InGameTime.h"
+#include "map/GameMapManager.h"
+#include "scene/ServiceRegistry.h"
+#include "util/FrameArena.h"
+#include "ui/hud/FloatingDamages.h"
+#include "util/Logger.h"
+#include "util/RandUtil.h"
+#include "util/StringUtil.h"
+
+using namespace std;
+USING_NS_AX;
+
+namespace vigilante::bench {
+
+namespace {
+
+constexpr array<const char*, Simulation::Subsystem::SIZE> kSubsystemNames = {{
+  "world_step",
+  "callbacks",
+  "in_game_time",
+  "game_map",
+  "fx",
+}};
+
+// On Linux, the peak rss (VmHWM) can be reset, so that it's measured from the start of a run.
+// Elsewhere, it's the peak since the process started.
+void resetPeakRss() {
+#ifdef __linux__
+  ofstream ofs{"/proc/self/clear_refs"};
+  ofs << "5";
+#endif
+}
+
+long getPeakRssKb() {
+#ifdef __linux__
+  ifstream ifs{"/proc/self/status"};
+  for (string line; std::getline(ifs, line);) {
+    if (line.starts_with("VmHWM:")) {
+      return std::stol(line.substr(6));
+    }
+  }
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+}  // namespace
+
+bool Simulation::writeSyntheticMap(const string& tmxMapFilePath, const string& npcJsonFilePath) {
+  constexpr int kTileSize = 16;
+  constexpr float kGroundY = 32.0f;
+  constexpr float kSpawnY = 64.0f;
+
+  // Tiled measures y downwards from the top of the map, whereas GameMap
+  // measures it upwards from the bottom. The tileset is never loaded,
+  // since there's no tile layer, but TMXTiledMap requires one.
+  const float h = kSyntheticMapHeight;
+  const float w = kSyntheticMapWidth;
+  const string tmx = string_util::format(
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<map version=\"1.2\" orientation=\"orthogonal\" renderorder=\"right-down\" "
+      "width=\"%d\" height=\"%d\" tilewidth=\"%d\" tileheight=\"%d\" infinite=\"0\">\n"
+      " <properties>\n"
+      "  <property name=\"locationName\" value=\"Synthetic Map\"/>\n"
+      " </properties>\n"
+      " <tileset firstgid=\"1\" name=\"synthetic\" tilewidth=\"%d\" tileheight=\"%d\" tilecount=\"1\" columns=\"1\">\n"
+      "  <image source=\"synthetic.png\" width=\"%d\" height=\"%d\"/>\n"
+      " </tileset>\n"
+      " <objectgroup name=\"Ground\">\n"
+      "  <object id=\"1\" x=\"0\" y=\"%.0f\"><polyline points=\"0,0 %.0f,0\"/></object>\n"
+      " </objectgroup>\n"
+      " <objectgroup name=\"Wall\">\n"
+      "  <object id=\"2\" x=\"0\" y=\"0\"><polyline points=\"0,0 0,%.0f\"/></object>\n"
+      "  <object id=\"3\" x=\"%.0f\" y=\"0\"><polyline points=\"0,0 0,%.0f\"/></object>\n"
+      " </objectgroup>\n"
+      " <objectgroup name=\"Player\">\n"
+      "  <object id=\"4\" x=\"%.0f\" y=\"%.0f\"><point/></object>\n"
+      " </objectgroup>\n"
+      " <objectgroup name=\"Npcs\">\n"
+      "  <object id=\"5\" x=\"%.0f\" y=\"%.0f\">\n"
+      "   <properties><property name=\"json\" value=\"%s\"/></properties>\n"
+      "   <point/>\n"
+      "  </object>\n"
+      " </objectgroup>\n"
+      "</map>\n",
+      static_cast<int>(w) / kTileSize, static_cast<int>(h) / kTileSize, kTileSize, kTileSize,
+      kTileSize, kTileSize, kTileSize, kTileSize,
+      h - kGroundY, w,
+      h,
+      w, h,
+      kSpawnY, h - kSpawnY,
+      w / 2, h - kSpawnY, npcJsonFilePath.c_str());
+
+  ofstream ofs{tmxMapFilePath, ios::trunc};
+  ofs << tmx;
+  if (!ofs.good()) {
+    VGLOG(LOG_ERR, "Failed to write synthetic map [%s].", tmxMapFilePath.c_str());
+    return false;
+  }
+  return true;
+}
+
+int Simulation::spawnExtraNpcs(const int n) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  GameMap* gameMap = gmMgr ? gmMgr->getGameMap() : nullptr;
+  if (!gameMap || n <= 0) {
+    return 0;
+  }
+
+  struct Template final {
+    string jsonFilePath;
+    float y;
+  };
+  vector<Template> templates;
+  for (const auto& actor : gameMap->getDynamicActors()) {
+    auto npc = dynamic_cast<Npc*>(actor.get());
+    if (npc && npc->getBody()) {
+      templates.push_back({npc->getCharacterProfile().jsonFilePath,
+                           npc->getBody()->GetPosition().y * kPpm});
+    }
+  }
+
+  if (templates.empty()) {
+    VGLOG(LOG_WARN, "There are no NPCs on this map to spawn copies of.");
+    return 0;
+  }
+
+  vector<float> xs(n);
+  rand_util::randFloats(rand_util::Stream::MISC, 0.0f, gameMap->getWidth(), xs);
+
+  for (int i = 0; i < n; i++) {
+    const Template& t = templates[i % templates.size()];
+    gameMap->showDynamicActor(std::make_shared<Npc>(t.jsonFilePath), xs[i], t.y);
+  }
+  return n;
+}
+
+Simulation::Report Simulation::run(const uint64_t numTicks, const float delta) {
+  Report report{};
+  report.numTicks = numTicks;
+
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  if (!gmMgr || !gmMgr->getGameMap()) {
+    VGLOG(LOG_ERR, "Unable to run the simulation without a game map.");
+    report.numTicks = 0;
+    return report;
+  }
+
+  auto inGameTime = ServiceRegistry::get<InGameTime>();
+  auto afterImageFxManager = ServiceRegistry::get<AfterImageFxManager>();
+  auto floatingDamages = ServiceRegistry::get<FloatingDamages>();
+  b2World* world = gmMgr->getWorld();
+
+  // Nothing is rendered during the run, so the render commands queued by
+  // Lighting would pile up and inflate the memory usage being measured.
+  gmMgr->setLightingEnabled(false);
+  CallbackManager::the().resetPeakNumLiveTimers();
+  resetPeakRss();
+
+  using Clock = chrono::steady_clock;
+  const auto begin = Clock::now();
+  auto last = begin;
+
+  // Accumulates the time since the last call into `subsystem`.
+  auto lap = [&report, &last](const Subsystem subsystem) {
+    const auto now = Clock::now();
+    report.subsystemSeconds[subsystem] += chrono::duration<double>(now - last).count();
+    last = now;
+  };
+
+  // Same order as GameScene::update(), minus the input, the UI and the camera.
+  for (uint64_t tick = 0; tick < numTicks && gmMgr->getGameMap(); tick++) {
+    world->Step(delta, kVelocityIterations, kPositionIterations);
+    lap(Subsystem::WORLD_STEP);
+
+    CallbackManager::the().update(delta);
+    lap(Subsystem::CALLBACKS);
+
+    inGameTime->update(delta);
+    lap(Subsystem::IN_GAME_TIME);
+
+    gmMgr->update(delta);
+    lap(Subsystem::GAME_MAP);
+
+    afterImageFxManager->update(delta);
+    floatingDamages->update(delta);
+    lap(Subsystem::FX);
+
+    FrameArena::the().reset();
+  }
+
+  gmMgr->setLightingEnabled(true);
+
+  report.seconds = chrono::duration<double>(Clock::now() - begin).count();
+  report.numDynamicActors = gmMgr->getGameMap()
+      ? static_cast<int>(gmMgr->getGameMap()->getDynamicActors().size()) : 0;
+  report.peakNumLiveTimers = CallbackManager::the().getPeakNumLiveTimers();
+  report.peakRssKb = getPeakRssKb();
+  return report;
+}
+
+string Simulation::format(const Report& report) {
+  const double ticksPerSecond = (report.seconds > 0) ? report.numTicks / report.seconds : 0;
+
+  string ret = string_util::format("ticks: %llu, time: %.3f s, ticks/sec: %.1f\n",
+                                   static_cast<unsigned long long>(report.numTicks),
+                                   report.seconds, ticksPerSecond);
+  for (int i = 0; i < Subsystem::SIZE; i++) {
+    const double ms = report.subsystemSeconds[i] * 1000;
+    const double usPerTick = report.numTicks ? ms * 1000 / report.numTicks : 0;
+    ret += string_util::format("  %-14s %10.3f ms %10.2f us/tick\n", kSubsystemNames[i], ms, usPerTick);
+  }
+  ret += string_util::format("dynamic actors: %d, peak live timers: %d, peak rss: %ld KiB",
+                             report.numDynamicActors, report.peakNumLiveTimers, report.peakRssKb);
+  return ret;
+}
+
+}  // namespace vigilante::bench
@@ -0,0 +1,79 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_BENCH_SIMULATION_H_
+#define VIGILANTE_BENCH_SIMULATION_H_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "Constants.h"
+
+// Steps the simulation of the current GameScene (box2d, callbacks,
+// in-game time, NPC AI, combat, projectiles) for a fixed number of ticks
+// at a fixed delta, back to back, without rendering any frame in between.
+//
+// It's used for soak tests and for measuring the simulation cost alone,
+// either from the command line:
+//   vigilante --soak <numTicks> [numExtraNpcs] [tmxMapFilePath]
+// or from the in-game console:
+//   soak <numTicks> [numExtraNpcs]
+//
+// Without a tmxMapFilePath, the soak test runs on a synthetic map (see
+// writeSyntheticMap()) rather than on any of the shipped maps. The
+// vigilante_headless build only runs soak tests, in a hidden window
+// (see CMakeLists.txt), so they can run on machines without a display.
+namespace vigilante::bench {
+
+class Simulation final {
+ public:
+  enum Subsystem {
+    WORLD_STEP,
+    CALLBACKS,
+    IN_GAME_TIME,
+    GAME_MAP,
+    FX,
+    SIZE
+  };
+
+  struct Report final {
+    uint64_t numTicks;
+    double seconds;
+    std::array<double, Subsystem::SIZE> subsystemSeconds;
+    int numDynamicActors;
+    int peakNumLiveTimers;
+    long peakRssKb;  // since the start of the run on Linux, 0 if unsupported on this platform
+  };
+
+  struct Options final {
+    uint64_t numTicks;
+    int numExtraNpcs;
+    std::string tmxMapFilePath;  // empty for a synthetic map
+  };
+
+  static inline constexpr float kDefaultDelta = 1.0f / kFps;
+  static inline constexpr float kSyntheticMapWidth = 4096.0f;
+  static inline constexpr float kSyntheticMapHeight = 512.0f;
+  static inline constexpr char kSyntheticMapNpcJson[] = "Data/character/castle_guard.json";
+
+  // Writes a tmx map without any tile layers: a flat ground between two walls,
+  // the player's spawn point and a single NPC (`npcJsonFilePath`) in the middle,
+  // whose copies can then be spawned by spawnExtraNpcs().
+  static bool writeSyntheticMap(const std::string& tmxMapFilePath, const std::string& npcJsonFilePath);
+
+  // Spawns `n` more copies of the NPCs which are already on the current map,
+  // at random positions, so that the AI and combat are put under more load.
+  // @return the number of NPCs spawned.
+  static int spawnExtraNpcs(const int n);
+
+  static Report run(const uint64_t numTicks, const float delta = kDefaultDelta);
+  static std::string format(const Report& report);
+
+  // Set from the command line before the application starts.
+  static inline std::optional<Options> options;
+};
+
+}  // namespace vigilante::bench
+
+#endif  // VIGILANTE_BENCH_SIMULATION_H_
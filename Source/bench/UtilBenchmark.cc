@@ -0,0 +1,295 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <rapidjson/document.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "Assets.h"
+#include "util/JsonUtil.h"
+#include "util/Reflection.h"
+#include "util/StringUtil.h"
+
+using namespace std;
+
+namespace vigilante::bench {
+
+namespace {
+
+// Roughly what GameState saves for the player.
+struct PlayerState final {
+  string name{"Aesophor"};
+  int level{12};
+  int exp{3456};
+  int health{420};
+  float moveSpeed{.75f};
+  pair<float, float> pos{12.5f, 3.25f};
+  vector<string> party{"Resources/Database/character/vlad.json",
+                       "Resources/Database/character/castle_guard.json"};
+  unordered_map<string, bool> portalStates{
+    {"Resources/Map/AbandonedCastlePrison/Main.tmx_p_0", true},
+    {"Resources/Map/AbandonedCastlePrison/Main.tmx_p_1", false},
+    {"Resources/Map/AbandonedCastlePrison/Main.tmx_c_3", true},
+  };
+
+  static constexpr auto kFields = reflection::fields(
+    reflection::field("name", &PlayerState::name),
+    reflection::field("level", &PlayerState::level),
+    reflection::field("exp", &PlayerState::exp),
+    reflection::field("health", &PlayerState::health),
+    reflection::field("moveSpeed", &PlayerState::moveSpeed),
+    reflection::field("pos", &PlayerState::pos),
+    reflection::field("party", &PlayerState::party),
+    reflection::field("portalStates", &PlayerState::portalStates));
+};
+
+rapidjson::Value serialize(rapidjson::Document::AllocatorType& allocator, const PlayerState& s) {
+  return json_util::serialize(allocator,
+                              make_pair("name", s.name),
+                              make_pair("level", s.level),
+                              make_pair("exp", s.exp),
+                              make_pair("health", s.health),
+                              make_pair("moveSpeed", s.moveSpeed),
+                              make_pair("pos", s.pos),
+                              make_pair("party", s.party),
+                              make_pair("portalStates", s.portalStates));
+}
+
+void deserialize(const rapidjson::Value& obj, PlayerState& s) {
+  json_util::deserialize(obj,
+                         make_pair("name", &s.name),
+                         make_pair("level", &s.level),
+                         make_pair("exp", &s.exp),
+                         make_pair("health", &s.health),
+                         make_pair("moveSpeed", &s.moveSpeed),
+                         make_pair("pos", &s.pos),
+                         make_pair("party", &s.party),
+                         make_pair("portalStates", &s.portalStates));
+}
+
+void runJsonUtilBenchmarks(Suite& suite) {
+  const PlayerState state;
+
+  suite.run("json_util/serialize", [&state](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      rapidjson::Document doc;
+      doNotOptimize(serialize(doc.GetAllocator(), state));
+    }
+  });
+
+  suite.run("json_util/round_trip_dom", [&state](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      rapidjson::Document doc;
+      const rapidjson::Value obj = serialize(doc.GetAllocator(), state);
+      PlayerState out;
+      deserialize(obj, out);
+      doNotOptimize(out);
+    }
+  });
+
+  // Through the text form, like saving to and loading from a save file.
+  suite.run("json_util/round_trip_text", [&state](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      rapidjson::Document doc;
+      doc.SetObject();
+      doc.AddMember("player", serialize(doc.GetAllocator(), state), doc.GetAllocator());
+
+      rapidjson::StringBuffer buf;
+      rapidjson::Writer<rapidjson::StringBuffer> writer{buf};
+      doc.Accept(writer);
+
+      rapidjson::Document parsed;
+      parsed.Parse(buf.GetString(), buf.GetSize());
+      PlayerState out;
+      deserialize(parsed["player"], out);
+      doNotOptimize(out);
+    }
+  });
+
+  suite.run("json_util/serialize_reflected", [&state](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      rapidjson::Document doc;
+      doNotOptimize(json_util::makeJsonObject(doc.GetAllocator(), state));
+    }
+  });
+
+  suite.run("reflection/pack", [&state](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      string out;
+      reflection::pack(state, out);
+      doNotOptimize(out);
+    }
+  });
+
+  string packed;
+  reflection::pack(state, packed);
+  suite.run("reflection/unpack", [&packed](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      string_view in{packed};
+      PlayerState out;
+      doNotOptimize(reflection::unpack(in, out));
+      doNotOptimize(out);
+    }
+  });
+}
+
+// The fields of Item::Profile, which every item json has.
+struct ItemFields final {
+  int itemType;
+  string textureResDir;
+  string name;
+  string desc;
+  int price;
+
+  static constexpr auto kFields = reflection::fields(
+    reflection::field("itemType", &ItemFields::itemType),
+    reflection::field("textureResDir", &ItemFields::textureResDir),
+    reflection::field("name", &ItemFields::name),
+    reflection::field("desc", &ItemFields::desc),
+    reflection::field("price", &ItemFields::price));
+};
+
+vector<fs::path> listJsonFiles(const fs::path& dir) {
+  vector<fs::path> jsonFilePaths;
+  std::error_code ec;
+  for (fs::recursive_directory_iterator it{dir, ec}, end; !ec && it != end; it.increment(ec)) {
+    if (it->is_regular_file(ec) && it->path().extension() == ".json") {
+      jsonFilePaths.push_back(it->path());
+    }
+  }
+  return jsonFilePaths;
+}
+
+// How json_util::loadFromFile() used to read json files.
+rapidjson::Document loadFromFileWithIStream(const fs::path& jsonFilePath) {
+  ifstream ifs{jsonFilePath};
+  rapidjson::IStreamWrapper isw{ifs};
+  rapidjson::Document doc;
+  doc.ParseStream(isw);
+  return doc;
+}
+
+// Loads the json files under the data dir (if any), i.e.,
+// what loading the game does when there's no cooked asset bundle.
+void runJsonFileBenchmarks(Suite& suite) {
+  const fs::path dataDir = fs::path{"Resources"} / assets::kDataDir;
+  const vector<fs::path> jsonFilePaths = listJsonFiles(dataDir);
+  const vector<fs::path> itemJsonFilePaths = listJsonFiles(dataDir / "item");
+  if (jsonFilePaths.empty()) {
+    if (suite.matches("json_util/load")) {
+      std::printf("Skipped json_util/load/*: no json files under [%s].\n", dataDir.c_str());
+    }
+    return;
+  }
+
+  suite.run("json_util/load/dom_istream", [&jsonFilePaths](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      for (const auto& jsonFilePath : jsonFilePaths) {
+        doNotOptimize(loadFromFileWithIStream(jsonFilePath));
+      }
+    }
+  });
+
+  suite.run("json_util/load/dom", [&jsonFilePaths](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      for (const auto& jsonFilePath : jsonFilePaths) {
+        doNotOptimize(json_util::loadFromFile(jsonFilePath));
+      }
+    }
+  });
+
+  // Only tokenizes the json files, which is the lower bound of json_util::parseFile().
+  suite.run("json_util/load/sax", [&jsonFilePaths](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      for (const auto& jsonFilePath : jsonFilePaths) {
+        doNotOptimize(json_util::parseFile(jsonFilePath));
+      }
+    }
+  });
+
+  // Filling the item profiles, before and after.
+  suite.run("json_util/load_items/dom_istream", [&itemJsonFilePaths](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      for (const auto& jsonFilePath : itemJsonFilePaths) {
+        const rapidjson::Document json = loadFromFileWithIStream(jsonFilePath);
+        ItemFields item;
+        json_util::deserialize(json,
+                               make_pair("itemType", &item.itemType),
+                               make_pair("textureResDir", &item.textureResDir),
+                               make_pair("name", &item.name),
+                               make_pair("desc", &item.desc),
+                               make_pair("price", &item.price));
+        doNotOptimize(item);
+      }
+    }
+  });
+
+  suite.run("json_util/load_items/sax", [&itemJsonFilePaths](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      for (const auto& jsonFilePath : itemJsonFilePaths) {
+        ItemFields item;
+        json_util::parseFile(jsonFilePath,
+                             make_pair("itemType", &item.itemType),
+                             make_pair("textureResDir", &item.textureResDir),
+                             make_pair("name", &item.name),
+                             make_pair("desc", &item.desc),
+                             make_pair("price", &item.price));
+        doNotOptimize(item);
+      }
+    }
+  });
+
+  suite.run("json_util/load_items/reflected", [&itemJsonFilePaths](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      for (const auto& jsonFilePath : itemJsonFilePaths) {
+        ItemFields item;
+        json_util::parseFileInto(jsonFilePath, item);
+        doNotOptimize(item);
+      }
+    }
+  });
+}
+
+void runStringUtilBenchmarks(Suite& suite) {
+  const string cmd = "additem Resources/Database/item/equipment/rusty_axe.json 1";
+  const string quotedCmd = "narrate \"The castle gate is locked.\" \"Find the key first.\"";
+
+  suite.run("string_util/split", [&cmd](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(string_util::split(cmd));
+    }
+  });
+
+  suite.run("string_util/parse_args", [&cmd](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(string_util::parseArgs(cmd));
+    }
+  });
+
+  suite.run("string_util/parse_args/quoted", [&quotedCmd](const uint64_t numIterations) {
+    for (uint64_t i = 0; i < numIterations; i++) {
+      doNotOptimize(string_util::parseArgs(quotedCmd));
+    }
+  });
+}
+
+}  // namespace
+
+void runUtilBenchmarks(Suite& suite) {
+  runJsonUtilBenchmarks(suite);
+  runJsonFileBenchmarks(suite);
+  runStringUtilBenchmarks(suite);
+}
+
+}  // namespace vigilante::bench
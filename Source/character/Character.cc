@@ -5,17 +5,21 @@
 #include <algorithm>
 #include <cassert>
 #include <filesystem>
+#include <string>
+#include <unordered_map>
 
 #include "Assets.h"
 #include "Audio.h"
 #include "CallbackManager.h"
 #include "Constants.h"
+#include "ProfileCache.h"
 #include "character/Player.h"
 #include "combat/ComboSystem.h"
 #include "gameplay/ExpPointTable.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/B2BodyBuilder.h"
+#include "util/FrameArena.h"
 #include "util/JsonUtil.h"
 #include "util/MathUtil.h"
 #include "util/RandUtil.h"
@@ -30,7 +34,7 @@ namespace vigilante {
 
 Character::Character(const string& jsonFilePath)
     : DynamicActor{State::STATE_SIZE, FixtureType::FIXTURE_SIZE},
-      _characterProfile{jsonFilePath},
+      _characterProfile{*ProfileCache<Character::Profile>::get(jsonFilePath)},
       _comboSystem{std::make_shared<ComboSystem>(*this)},
       // There will be at least `1` attack animation.
       _kAttackAnimationIdxMax{1 + getExtraAttackAnimationsCount()},
@@ -62,6 +66,10 @@ bool Character::removeFromMap() {
     destroyBody();
   }
 
+  if (auto gmMgr = ServiceRegistry::get<GameMapManager>()) {
+    gmMgr->getProjectileManager()->onUserRemoved(this);
+  }
+
   return true;
 }
 
@@ -99,7 +107,7 @@ void Character::update(const float delta) {
     regenMagicka(_baseRegenDeltaMagicka);
     regenStamina(_baseRegenDeltaStamina);
 
-    auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+    auto hud = ServiceRegistry::get<Hud>();
     hud->updateStatusBars();
   }
 
@@ -164,7 +172,7 @@ void Character::update(const float delta) {
 }
 
 void Character::import(const string& jsonFilePath) {
-  _characterProfile = Character::Profile{jsonFilePath};
+  _characterProfile = *ProfileCache<Character::Profile>::get(jsonFilePath);
 }
 
 void Character::replaceSpritesheet(const string& jsonFilePath) {
@@ -189,7 +197,7 @@ void Character::defineBody(b2BodyType bodyType,
                            short bodyMaskBits,
                            short feetMaskBits,
                            short weaponMaskBits) {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   B2BodyBuilder bodyBuilder{gmMgr->getWorld()};
   _body = bodyBuilder.type(bodyType)
     .position(x, y, kPpm)
@@ -786,12 +794,12 @@ void Character::teleportToTarget(const b2Vec2& targetPos) {
 }
 
 void Character::enableAfterImageFx(const ax::Color3B &color) {
-  auto afterImageFxMgr = SceneManager::the().getCurrentScene<GameScene>()->getAfterImageFxManager();
+  auto afterImageFxMgr = ServiceRegistry::get<AfterImageFxManager>();
   afterImageFxMgr->registerNode(_node, color, 0.15f, 0.05f);
 }
 
 void Character::disableAfterImageFx() {
-  auto afterImageFxMgr = SceneManager::the().getCurrentScene<GameScene>()->getAfterImageFxManager();
+  auto afterImageFxMgr = ServiceRegistry::get<AfterImageFxManager>();
   afterImageFxMgr->unregisterNode(_node);
 }
 
@@ -935,7 +943,7 @@ bool Character::activateSkill(Skill* rawSkill) {
   _activeSkillInstances.emplace(skill);
   skill->activate();
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+  auto hud = ServiceRegistry::get<Hud>();
   hud->updateStatusBars();
 
   return true;
@@ -1063,10 +1071,10 @@ bool Character::receiveDamage(Character *source, int damage, float takeDamageDur
     // TODO: play hurt sound.
   }
 
-  auto fxMgr = SceneManager::the().getCurrentScene<GameScene>()->getFxManager();
+  auto fxMgr = ServiceRegistry::get<FxManager>();
   fxMgr->createHitFx(this);
 
-  auto floatingDamages = SceneManager::the().getCurrentScene<GameScene>()->getFloatingDamages();
+  auto floatingDamages = ServiceRegistry::get<FloatingDamages>();
   floatingDamages->show(this, damage);
 
   if (const auto& sfxFilePath = getSfxFilePath(Character::Sfx::SFX_HURT); sfxFilePath.size()) {
@@ -1186,7 +1194,7 @@ void Character::useItem(Consumable* consumable) {
 
   removeItem(consumable, 1);
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+  auto hud = ServiceRegistry::get<Hud>();
   hud->updateStatusBars();
 }
 
@@ -1229,7 +1237,7 @@ void Character::unequip(Equipment::Type equipmentType, bool audio) {
 }
 
 void Character::pickupItem(Item* item) {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   shared_ptr<Item> i = gmMgr->getGameMap()->removeDynamicActor<Item>(item);
   addItem(std::move(i), item->getAmount());
 }
@@ -1239,7 +1247,7 @@ void Character::discardItem(Item* item, int amount) {
   float x = _body->GetPosition().x;
   float y = _body->GetPosition().y;
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   gmMgr->getGameMap()->createItem(jsonFilePath, x * kPpm, y * kPpm, amount);
 
   removeItem(item, amount);
@@ -1327,12 +1335,13 @@ bool Character::isWaitingForPartyLeader() const {
   return _party && _party->getWaitingMemberLocationInfo(_characterProfile.jsonFilePath);
 }
 
-unordered_set<Character*> Character::getAllies() const {
+pmr::unordered_set<Character*> Character::getAllies() const {
+  pmr::unordered_set<Character*> ret{&FrameArena::the()};
   if (!_party) {
-    return {};
+    return ret;
   }
 
-  unordered_set<Character*> ret;
+  ret.reserve(_party->getMembers().size() + 1);
   for (const auto& member : _party->getMembers()) {
     ret.insert(member.get());
   }
@@ -1348,7 +1357,7 @@ int Character::getDamageOutput() const {
   if (Equipment* weapon = _equipmentSlots[Equipment::Type::WEAPON]) {
     output += weapon->getEquipmentProfile().bonusPhysicalDamage;
   }
-  return output + rand_util::randInt(-5, 5); // temporary
+  return output + rand_util::randInt(rand_util::Stream::COMBAT, -5, 5); // temporary
 }
 
 void Character::regenHealth(int deltaHealth) {
@@ -1358,7 +1367,7 @@ void Character::regenHealth(int deltaHealth) {
   health += deltaHealth;
   health = (health > fullHealth) ? fullHealth : health;
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+  auto hud = ServiceRegistry::get<Hud>();
   hud->updateStatusBars();
 }
 
@@ -1369,7 +1378,7 @@ void Character::regenMagicka(int deltaMagicka) {
   magicka += deltaMagicka;
   magicka = (magicka > fullMagicka) ? fullMagicka : magicka;
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+  auto hud = ServiceRegistry::get<Hud>();
   hud->updateStatusBars();
 }
 
@@ -1380,93 +1389,44 @@ void Character::regenStamina(int deltaStamina) {
   stamina += deltaStamina;
   stamina = (stamina > fullStamina) ? fullStamina : stamina;
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+  auto hud = ServiceRegistry::get<Hud>();
   hud->updateStatusBars();
 }
 
-Character::Profile::Profile(const string& jsonFilePath) : jsonFilePath{jsonFilePath} {
-  loadSpritesheetInfo(jsonFilePath);
-
-  rapidjson::Document json = json_util::loadFromFile(jsonFilePath);
-
-  name = json["name"].GetString();
-  level = json["level"].GetInt();
-  exp = json["exp"].GetInt();
-
-  fullHealth = json["fullHealth"].GetInt();
-  fullStamina = json["fullStamina"].GetInt();
-  fullMagicka = json["fullMagicka"].GetInt();
-
-  health = json["health"].GetInt();
-  stamina = json["stamina"].GetInt();
-  magicka = json["magicka"].GetInt();
-
-  strength = json["strength"].GetInt();
-  dexterity = json["dexterity"].GetInt();
-  intelligence = json["intelligence"].GetInt();
-  luck = json["luck"].GetInt();
-
-  baseMeleeDamage = json["baseMeleeDamage"].GetInt();
-
-  for (const auto& skillJson : json["defaultSkills"].GetArray()) {
-    string skillJsonFilePath = skillJson.GetString();
-    defaultSkills.push_back(std::move(skillJsonFilePath));
-  }
-
-  for (const auto& itemJson : json["defaultInventory"].GetObject()) {
-    string itemJsonFilePath = itemJson.name.GetString();
-    int amount = itemJson.value.GetInt();
-    defaultInventory.push_back({std::move(itemJsonFilePath), amount});
-  }
-}
-
-void Character::Profile::loadSpritesheetInfo(const string& jsonFilePath) {
-  rapidjson::Document json = json_util::loadFromFile(jsonFilePath);
-
-  textureResDir = json["textureResDir"].GetString();
-  spriteOffsetX = json["spriteOffsetX"].GetFloat();
-  spriteOffsetY = json["spriteOffsetY"].GetFloat();
-  spriteScaleX = json["spriteScaleX"].GetFloat();
-  spriteScaleY = json["spriteScaleY"].GetFloat();
-
-  bodyWidth = json["bodyWidth"].GetInt();
-  bodyHeight = json["bodyHeight"].GetInt();
-  moveSpeed = json["moveSpeed"].GetFloat();
-  jumpHeight = json["jumpHeight"].GetFloat();
-  canDoubleJump = json["canDoubleJump"].GetBool();
-
-  attackForce = json["attackForce"].GetFloat();
-  attackTime = json["attackTime"].GetFloat();
-  attackRange = json["attackRange"].GetFloat();
-  attackDelay = json["attackDelay"].GetFloat();
-  if (json.HasMember("forwardAttackNumTimesInflictDamage")) {
-    forwardAttackNumTimesInflictDamage = json["forwardAttackNumTimesInflictDamage"].GetInt();
-  }
+template <typename Fields>
+void Character::Profile::parse(const string& jsonFilePath, const Fields& fields) {
+  unordered_map<string, float> frameIntervalMap;
+  unordered_map<string, string> sfxMap;
+  json_util::parseFileFields(jsonFilePath, *this, fields,
+                             make_pair("frameInterval", &frameIntervalMap),
+                             make_pair("sfx", &sfxMap));
 
   for (int i = 0; i < Character::State::STATE_SIZE; i++) {
-    if (!json["frameInterval"].HasMember(Character::_kCharacterStateStr[i].c_str())) {
+    auto it = frameIntervalMap.find(Character::_kCharacterStateStr[i]);
+    if (it == frameIntervalMap.end()) {
       VGLOG(LOG_ERR, "Failed to get the frame interval of [%s].", Character::_kCharacterStateStr[i].c_str());
       frameIntervals[i] = 10.0f;
       continue;
     }
-    frameIntervals[i] = json["frameInterval"][Character::_kCharacterStateStr[i].c_str()].GetFloat();
+    frameIntervals[i] = it->second;
   }
 
+  extraAttackFrameIntervals.clear();
   for (int i = 0; ; i++) {
-    const string key = "attacking" + to_string(1 + i);
-    if (!json["frameInterval"].HasMember(key.c_str())) {
+    auto it = frameIntervalMap.find("attacking" + to_string(1 + i));
+    if (it == frameIntervalMap.end()) {
       break;
     }
-    extraAttackFrameIntervals.emplace_back(json["frameInterval"][key.c_str()].GetFloat());
+    extraAttackFrameIntervals.emplace_back(it->second);
   }
 
   for (int i = 0; i < Character::Sfx::SFX_SIZE; i++) {
-    const string &sfxKey = Character::_kCharacterSfxStr[i];
-    if (!json["sfx"].HasMember(sfxKey.c_str())) {
+    auto it = sfxMap.find(Character::_kCharacterSfxStr[i]);
+    if (it == sfxMap.end()) {
       continue;
     }
 
-    const fs::path sfxPath = json["sfx"][sfxKey.c_str()].GetString();
+    const fs::path sfxPath = it->second;
     std::error_code ec;
     if (!fs::exists(sfxPath, ec)) {
       continue;
@@ -1475,6 +1435,14 @@ void Character::Profile::loadSpritesheetInfo(const string& jsonFilePath) {
   }
 }
 
+Character::Profile::Profile(const string& jsonFilePath) : jsonFilePath{jsonFilePath} {
+  parse(jsonFilePath, kFields);
+}
+
+void Character::Profile::loadSpritesheetInfo(const string& jsonFilePath) {
+  parse(jsonFilePath, kSpritesheetFields);
+}
+
 optional<Character::State> Character::getCharacterState(const string& frameName) {
   static auto buildCache = []() -> unordered_map<string, Character::State> {
     unordered_map<string, Character::State> cache;
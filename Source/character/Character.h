@@ -7,15 +7,18 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <axmol.h>
 #include <box2d/box2d.h>
+#include <rapidjson/document.h>
 
 #include "CallbackManager.h"
 #include "DynamicActor.h"
@@ -27,7 +30,8 @@
 #include "item/Consumable.h"
 #include "map/GameMap.h"
 #include "skill/Skill.h"
-#include "util/ds/SetVector.h"
+#include "util/ds/FlatSetVector.h"
+#include "util/Reflection.h"
 
 namespace vigilante {
 
@@ -79,9 +83,9 @@ class Character : public DynamicActor, public Importable {
     SFX_SIZE,
   };
 
-  using Inventory = std::array<SetVector<Item*>, Item::Type::SIZE>;
+  using Inventory = std::array<FlatSetVector<Item*>, Item::Type::SIZE>;
   using EquipmentSlots = std::array<Equipment*, Equipment::Type::SIZE>;
-  using SkillBook = std::array<SetVector<Skill*>, Skill::Type::SIZE>;
+  using SkillBook = std::array<FlatSetVector<Skill*>, Skill::Type::SIZE>;
 
   struct Profile final {
     Profile() = default;
@@ -129,6 +133,45 @@ class Character : public DynamicActor, public Importable {
 
     std::vector<std::string> defaultSkills;
     std::vector<std::pair<std::string, int>> defaultInventory;
+
+    // The frame intervals and sfx are derived from the "frameInterval" and "sfx" objects.
+    static constexpr auto kSpritesheetFields = reflection::fields(
+      reflection::field("textureResDir", &Profile::textureResDir),
+      reflection::field("spriteOffsetX", &Profile::spriteOffsetX),
+      reflection::field("spriteOffsetY", &Profile::spriteOffsetY),
+      reflection::field("spriteScaleX", &Profile::spriteScaleX),
+      reflection::field("spriteScaleY", &Profile::spriteScaleY),
+      reflection::field("bodyWidth", &Profile::bodyWidth),
+      reflection::field("bodyHeight", &Profile::bodyHeight),
+      reflection::field("moveSpeed", &Profile::moveSpeed),
+      reflection::field("jumpHeight", &Profile::jumpHeight),
+      reflection::field("canDoubleJump", &Profile::canDoubleJump),
+      reflection::field("attackForce", &Profile::attackForce),
+      reflection::field("attackTime", &Profile::attackTime),
+      reflection::field("attackRange", &Profile::attackRange),
+      reflection::field("attackDelay", &Profile::attackDelay),
+      reflection::optionalField("forwardAttackNumTimesInflictDamage", &Profile::forwardAttackNumTimesInflictDamage));
+    static constexpr auto kFields = std::tuple_cat(kSpritesheetFields, reflection::fields(
+      reflection::field("name", &Profile::name),
+      reflection::field("level", &Profile::level),
+      reflection::field("exp", &Profile::exp),
+      reflection::field("fullHealth", &Profile::fullHealth),
+      reflection::field("fullStamina", &Profile::fullStamina),
+      reflection::field("fullMagicka", &Profile::fullMagicka),
+      reflection::field("health", &Profile::health),
+      reflection::field("stamina", &Profile::stamina),
+      reflection::field("magicka", &Profile::magicka),
+      reflection::field("strength", &Profile::strength),
+      reflection::field("dexterity", &Profile::dexterity),
+      reflection::field("intelligence", &Profile::intelligence),
+      reflection::field("luck", &Profile::luck),
+      reflection::field("baseMeleeDamage", &Profile::baseMeleeDamage),
+      reflection::field("defaultSkills", &Profile::defaultSkills),
+      reflection::field("defaultInventory", &Profile::defaultInventory)));
+
+   private:
+    template <typename Fields>
+    void parse(const std::string& jsonFilePath, const Fields& fields);
   };
 
   // We have a vector of b2Fixtures (declared in DynamicActor abstract class).
@@ -276,7 +319,8 @@ class Character : public DynamicActor, public Importable {
   void removeActiveSkillInstance(Skill* skill);
 
   bool isWaitingForPartyLeader() const;
-  std::unordered_set<Character*> getAllies() const;
+  // The returned set is allocated from the FrameArena, so it must not be kept across frames.
+  std::pmr::unordered_set<Character*> getAllies() const;
   inline std::shared_ptr<Party> getParty() const { return _party; }
   inline void setParty(std::shared_ptr<Party> party) { _party = party; }
 
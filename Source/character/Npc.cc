@@ -9,12 +9,13 @@
 #include "Assets.h"
 #include "CallbackManager.h"
 #include "Constants.h"
+#include "ProfileCache.h"
 #include "character/Player.h"
 #include "item/Item.h"
 #include "quest/KillTargetObjective.h"
 #include "quest/CollectItemObjective.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/AxUtil.h"
 #include "ui/trade/TradeWindow.h"
 #include "util/B2BodyBuilder.h"
@@ -45,7 +46,7 @@ constexpr auto kEnemyWeaponMaskBits = kPlayer | kNpc;
 
 Npc::Npc(const string& jsonFilePath)
     : Character{jsonFilePath},
-      _npcProfile{jsonFilePath},
+      _npcProfile{*ProfileCache<Npc::Profile>::get(jsonFilePath)},
       _dialogueTree{_npcProfile.dialogueTreeJsonFile, this},
       _disposition{_npcProfile.disposition},
       _npcController(*this) {
@@ -64,7 +65,8 @@ void Npc::update(const float delta) {
   const b2Vec2& b2bodyPos = _body->GetPosition();
 
   // Sync the floating health bar with Npc's b2body if it exists.
-  if (_floatingHealthBar->isVisible()) {
+  // If this npc has been culled (see map/Culling.h), its health bar won't be drawn anyway.
+  if (_floatingHealthBar->isVisible() && _node->isVisible()) {
     const float floatingHealthBarX = b2bodyPos.x * kPpm - _floatingHealthBar->getMaxLength() / 2;
     const float floatingHealthBarY = b2bodyPos.y * kPpm + _characterProfile.bodyHeight / 2 + 10.0f;
     _floatingHealthBar->setPosition({floatingHealthBarX, floatingHealthBarY});
@@ -78,7 +80,7 @@ void Npc::update(const float delta) {
     _hintBubbleFxSprite->setPosition(hintBubbleX, hintBubbleY);
   }
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   if (gmMgr->areNpcsAllowedToAct()) {
     act(delta);
   }
@@ -105,7 +107,7 @@ bool Npc::showOnMap(float x, float y) {
   _node->addChild(_bodySpritesheet, z_order::kNpcBody);
   _node->addChild(_floatingHealthBar->getLayout(), z_order::kHud);
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax_util::addChildWithParentCameraMask(gmMgr->getLayer(), _node, z_order::kNpcBody);
 
   return true;
@@ -151,14 +153,14 @@ void Npc::defineBody(b2BodyType bodyType, float x, float y,
 
 void Npc::import(const string& jsonFilePath) {
   Character::import(jsonFilePath);
-  _npcProfile = Npc::Profile{jsonFilePath};
+  _npcProfile = *ProfileCache<Npc::Profile>::get(jsonFilePath);
 }
 
 void Npc::onSetToKill() {
   Character::onSetToKill();
 
   if (!_npcProfile.isRespawnable) {
-    auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+    auto gmMgr = ServiceRegistry::get<GameMapManager>();
     gmMgr->setNpcAllowedToSpawn(_characterProfile.jsonFilePath, false);
   }
 
@@ -248,14 +250,14 @@ void Npc::showHintUI() {
 
   createHintBubbleFx();
 
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->insert({EventKeyboard::KeyCode::KEY_CAPITAL_E}, "Talk");
 }
 
 void Npc::hideHintUI() {
   removeHintBubbleFx();
 
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->remove({EventKeyboard::KeyCode::KEY_CAPITAL_E});
 }
 
@@ -264,7 +266,7 @@ void Npc::createHintBubbleFx() {
     return;
   }
 
-  auto fxMgr = SceneManager::the().getCurrentScene<GameScene>()->getFxManager();
+  auto fxMgr = ServiceRegistry::get<FxManager>();
   _hintBubbleFxSprite = fxMgr->createHintBubbleFx(_body, "dialogue_available");
 }
 
@@ -273,7 +275,7 @@ void Npc::removeHintBubbleFx() {
     return;
   }
 
-  auto fxMgr = SceneManager::the().getCurrentScene<GameScene>()->getFxManager();
+  auto fxMgr = ServiceRegistry::get<FxManager>();
   fxMgr->removeFx(_hintBubbleFxSprite);
   _hintBubbleFxSprite = nullptr;
 }
@@ -282,15 +284,15 @@ void Npc::dropItems() {
   // We'll use a callback to drop items since creating fixtures during collision callback
   // will cause the game to crash. Ref: https://github.com/libgdx/libgdx/issues/2730
   CallbackManager::the().runAfter([this](const CallbackManager::CallbackId) {
-    auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+    auto gmMgr = ServiceRegistry::get<GameMapManager>();
 
     for (const auto& i : _npcProfile.droppedItems) {
       const string& itemJson = i.first;
       const float dropChance = i.second.chance;
 
-      const float randChance = rand_util::randInt(0, 100);
+      const float randChance = rand_util::randInt(rand_util::Stream::LOOT, 0, 100);
       if (randChance <= dropChance) {
-        int amount = rand_util::randInt(i.second.minAmount, i.second.maxAmount);
+        int amount = rand_util::randInt(rand_util::Stream::LOOT, i.second.minAmount, i.second.maxAmount);
         gmMgr->getGameMap()->createItem(itemJson, _killedPos.x * kPpm, _killedPos.y * kPpm, amount);
       }
     }
@@ -298,24 +300,24 @@ void Npc::dropItems() {
 }
 
 void Npc::updateDialogueTreeIfNeeded() {
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
   string latestDialogueTreeJsonFilePath = dialogueMgr->getLatestNpcDialogueTree(_characterProfile.jsonFilePath);
   if (latestDialogueTreeJsonFilePath.empty()) {
     return;
   }
 
-  VGLOG(LOG_INFO, "Loading dialogue tree from file: [%s], character: [%s]",
+  VGLOG(LOG_DEBUG, "Loading dialogue tree from file: [%s], character: [%s]",
                   latestDialogueTreeJsonFilePath.c_str(), _characterProfile.jsonFilePath.c_str());
   _dialogueTree = DialogueTree{latestDialogueTreeJsonFilePath, this};
 }
 
 void Npc::onDialogueBegin() {
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->setVisible(false);
 }
 
 void Npc::onDialogueEnd() {
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->setVisible(true);
 }
 
@@ -326,7 +328,7 @@ void Npc::beginDialogue() {
 
   onDialogueBegin();
 
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
   dialogueMgr->setTargetNpc(this);
   for (const auto& line : _dialogueTree.getCurrentNode()->getLines()) {
     dialogueMgr->getSubtitles()->addSubtitle(line);
@@ -335,8 +337,8 @@ void Npc::beginDialogue() {
 }
 
 void Npc::beginTrade() {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto wm = SceneManager::the().getCurrentScene<GameScene>()->getWindowManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto wm = ServiceRegistry::get<WindowManager>();
 
   wm->push(std::make_unique<TradeWindow>(/*buyer=*/gmMgr->getPlayer(), /*seller=*/this));
 }
@@ -385,28 +387,7 @@ void Npc::setDisposition(Npc::Disposition disposition) {
 }
 
 Npc::Profile::Profile(const string& jsonFilePath) {
-  rapidjson::Document json = json_util::loadFromFile(jsonFilePath);
-
-  const auto& droppedItemsMap = json["droppedItems"].GetObject();
-  if (!droppedItemsMap.ObjectEmpty()) {
-    for (const auto& keyValue : droppedItemsMap) {
-      const auto& droppedItemDataJson = keyValue.value.GetObject();
-
-      DroppedItemData droppedItemData;
-      droppedItemData.chance = droppedItemDataJson["chance"].GetInt();
-      droppedItemData.minAmount = droppedItemDataJson["minAmount"].GetInt();
-      droppedItemData.maxAmount = droppedItemDataJson["maxAmount"].GetInt();
-
-      droppedItems.insert({keyValue.name.GetString(), droppedItemData});
-    }
-  }
-
-  dialogueTreeJsonFile = json["dialogueTree"].GetString();
-  disposition = static_cast<Npc::Disposition>(json["disposition"].GetInt());
-  isRespawnable = json["isRespawnable"].GetBool();
-  isRecruitable = json["isRecruitable"].GetBool();
-  isTradable = json["isTradable"].GetBool();
-  shouldSandbox = json["shouldSandbox"].GetBool();
+  json_util::parseFileInto(jsonFilePath, *this);
 }
 
 }  // namespace vigilante
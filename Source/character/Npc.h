@@ -13,6 +13,7 @@
 #include "character/NpcController.h"
 #include "gameplay/DialogueTree.h"
 #include "ui/hud/StatusBar.h"
+#include "util/Reflection.h"
 
 namespace vigilante {
 
@@ -44,6 +45,11 @@ class Npc final : public Character, public Interactable {
       int chance;
       int minAmount;
       int maxAmount;
+
+      static constexpr auto kFields = reflection::fields(
+        reflection::field("chance", &DroppedItemData::chance),
+        reflection::field("minAmount", &DroppedItemData::minAmount),
+        reflection::field("maxAmount", &DroppedItemData::maxAmount));
     };
     // <json, {chance, minAmount, maxAmount}>
     std::unordered_map<std::string, DroppedItemData> droppedItems;
@@ -54,6 +60,15 @@ class Npc final : public Character, public Interactable {
     bool isRecruitable;
     bool isTradable;
     bool shouldSandbox;
+
+    static constexpr auto kFields = reflection::fields(
+      reflection::field("droppedItems", &Profile::droppedItems),
+      reflection::field("dialogueTree", &Profile::dialogueTreeJsonFile),
+      reflection::field("disposition", &Profile::disposition),
+      reflection::field("isRespawnable", &Profile::isRespawnable),
+      reflection::field("isRecruitable", &Profile::isRecruitable),
+      reflection::field("isTradable", &Profile::isTradable),
+      reflection::field("shouldSandbox", &Profile::shouldSandbox));
   };
 
   explicit Npc(const std::string& jsonFilePath);
@@ -5,7 +5,7 @@
 #include "Constants.h"
 #include "character/Npc.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/RandUtil.h"
 
 using namespace std;
@@ -108,7 +108,7 @@ void NpcController::moveToTarget(const float delta, const b2Vec2& targetPos, con
     return;
   }
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   PathFinder* pathFinder = gmMgr->getGameMap()->getPathFinder();
   if (auto nextHop = pathFinder->findOptimalNextHop(thisPos, targetPos, followDist)) {
     _moveDest = *nextHop;
@@ -130,9 +130,9 @@ void NpcController::moveRandomly(const float delta,
   // If the character has finished moving and waiting, regenerate random values for
   // _moveDuration and _waitDuration within the specified range.
   if (_moveTimer >= _moveDuration && _waitTimer >= _waitDuration) {
-    _isMovingRight = static_cast<bool>(rand_util::randInt(0, 1));
-    _moveDuration = rand_util::randInt(minMoveDuration, maxMoveDuration);
-    _waitDuration = rand_util::randInt(minWaitDuration, maxWaitDuration);
+    _isMovingRight = static_cast<bool>(rand_util::randInt(rand_util::Stream::AI, 0, 1));
+    _moveDuration = rand_util::randInt(rand_util::Stream::AI, minMoveDuration, maxMoveDuration);
+    _waitDuration = rand_util::randInt(rand_util::Stream::AI, minWaitDuration, maxWaitDuration);
     _moveTimer = 0;
     _waitTimer = 0;
   }
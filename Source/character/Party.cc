@@ -7,8 +7,11 @@
 #include "Constants.h"
 #include "character/Character.h"
 #include "character/Npc.h"
+#include "character/Player.h"
+#include "gameplay/SaveJournal.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
+#include "util/FrameArena.h"
 #include "util/StringUtil.h"
 
 using namespace std;
@@ -27,7 +30,7 @@ bool Party::hasMember(const string& characterJsonFilePath) const {
 }
 
 void Party::recruit(Character* targetCharacter) {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   const b2Vec2 targetPos = targetCharacter->getBody()->GetPosition();
 
   auto target = gmMgr->getGameMap()->removeDynamicActor<Character>(targetCharacter);
@@ -49,13 +52,13 @@ void Party::recruit(Character* targetCharacter) {
   target->showOnMap(targetPos.x * kPpm, targetPos.y * kPpm);
   addMember(std::move(target));
 
-  auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+  auto notifications = ServiceRegistry::get<Notifications>();
   notifications->show(string_util::format("%s is now following you.",
                                           targetCharacter->getCharacterProfile().name.c_str()));
 }
 
 void Party::dismiss(Character* targetCharacter, bool addToMap) {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
 
   b2Body* body = targetCharacter->getBody();
   b2Vec2 targetPos = (body) ? body->GetPosition() : b2Vec2{0, 0};
@@ -78,12 +81,12 @@ void Party::dismiss(Character* targetCharacter, bool addToMap) {
   gmMgr->setNpcAllowedToSpawn(targetNpc->getCharacterProfile().jsonFilePath, true);
 
   if (addToMap && body) {
-    auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+    auto gmMgr = ServiceRegistry::get<GameMapManager>();
     gmMgr->getGameMap()->showDynamicActor(
         std::move(target), targetPos.x * kPpm, targetPos.y * kPpm);
   }
 
-  auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+  auto notifications = ServiceRegistry::get<Notifications>();
   notifications->show(string_util::format("%s has left your party.",
                                           targetCharacter->getCharacterProfile().name.c_str()));
 }
@@ -97,7 +100,7 @@ void Party::dismissAll(bool addToMap) {
 }
 
 void Party::askMemberToWait(Character* targetCharacter) {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   const b2Vec2 targetPos = targetCharacter->getBody()->GetPosition();
 
   addWaitingMember(targetCharacter->getCharacterProfile().jsonFilePath,
@@ -105,7 +108,7 @@ void Party::askMemberToWait(Character* targetCharacter) {
                    targetPos.x,
                    targetPos.y);
 
-  auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+  auto notifications = ServiceRegistry::get<Notifications>();
   notifications->show(string_util::format("%s will be waiting for you.",
                                           targetCharacter->getCharacterProfile().name.c_str()));
 }
@@ -113,7 +116,7 @@ void Party::askMemberToWait(Character* targetCharacter) {
 void Party::askMemberToFollow(Character* targetCharacter) {
   removeWaitingMember(targetCharacter->getCharacterProfile().jsonFilePath);
 
-  auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+  auto notifications = ServiceRegistry::get<Notifications>();
   notifications->show(string_util::format("%s is now following you.",
                                           targetCharacter->getCharacterProfile().name.c_str()));
 }
@@ -128,11 +131,21 @@ void Party::addWaitingMember(const string& characterJsonFilePath,
     return;
   }
   _waitingMembersLocationInfos.insert({characterJsonFilePath, {currentTmxMapFilePath, x, y}});
+
+  if (isLedByPlayer()) {
+    SaveJournal::the().recordWaitingPartyMember(characterJsonFilePath,
+        GameState::Snapshot::WaitingPartyMember{characterJsonFilePath, currentTmxMapFilePath, x, y});
+  }
 }
 
 void Party::removeWaitingMember(const string& characterJsonFilePath) {
   if (_waitingMembersLocationInfos.erase(characterJsonFilePath) == 0) {
     VGLOG(LOG_ERR, "This member is not a waiting member of the party.");
+    return;
+  }
+
+  if (isLedByPlayer()) {
+    SaveJournal::the().recordWaitingPartyMember(characterJsonFilePath, std::nullopt);
   }
 }
 
@@ -145,8 +158,9 @@ Party::getWaitingMemberLocationInfo(const std::string& characterJsonFilePath) co
   return it->second;
 }
 
-unordered_set<Character*> Party::getLeaderAndMembers() const {
-  unordered_set<Character*> allMembers;
+pmr::unordered_set<Character*> Party::getLeaderAndMembers() const {
+  pmr::unordered_set<Character*> allMembers{&FrameArena::the()};
+  allMembers.reserve(_members.size() + 1);
 
   allMembers.insert(_leader);
   for (const auto& member : _members) {
@@ -168,6 +182,9 @@ void Party::dump() {
 
 void Party::addMember(shared_ptr<Character> character) {
   character->setParty(_leader->getParty());
+  if (isLedByPlayer()) {
+    SaveJournal::the().recordPartyMember(character->getCharacterProfile().jsonFilePath, /*isMember=*/true);
+  }
   _members.insert(std::move(character));
 }
 
@@ -185,7 +202,15 @@ shared_ptr<Character> Party::removeMember(Character* character) {
 
   removedMember = std::move(*it);
   _members.erase(it);
+
+  if (isLedByPlayer()) {
+    SaveJournal::the().recordPartyMember(character->getCharacterProfile().jsonFilePath, /*isMember=*/false);
+  }
   return removedMember;
 }
 
+bool Party::isLedByPlayer() const {
+  return dynamic_cast<Player*>(_leader) != nullptr;
+}
+
 }  // namespace vigilante
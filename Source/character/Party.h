@@ -4,6 +4,7 @@
 #define VIGILANTE_CHARACTER_PARTY_H_
 
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -46,7 +47,8 @@ class Party final {
 
   inline const std::unordered_set<std::shared_ptr<Character>>& getMembers() const { return _members; }
   inline Character* getLeader() const { return _leader; }
-  std::unordered_set<Character*> getLeaderAndMembers() const;
+  // The returned set is allocated from the FrameArena, so it must not be kept across frames.
+  std::pmr::unordered_set<Character*> getLeaderAndMembers() const;
 
   inline const std::unordered_map<std::string, Party::WaitingLocationInfo>&
   getWaitingMembersLocationInfos() const {
@@ -58,6 +60,8 @@ class Party final {
  protected:
   void addMember(std::shared_ptr<Character> character);
   std::shared_ptr<Character> removeMember(Character* character);
+  // Only the player's party is saved (and journaled).
+  bool isLedByPlayer() const;
 
   // `_leader` will NOT be in `_members`.
   Character* _leader{};
@@ -10,8 +10,9 @@
 #include "CallbackManager.h"
 #include "Constants.h"
 #include "character/Party.h"
+#include "gameplay/SaveJournal.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "skill/Skill.h"
 #include "skill/ForwardSlash.h"
 #include "skill/MagicalMissile.h"
@@ -59,7 +60,7 @@ bool Player::showOnMap(float x, float y) {
   _node->removeAllChildren();
   _node->addChild(_bodySpritesheet, z_order::kPlayerBody);
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax_util::addChildWithParentCameraMask(gmMgr->getLayer(), _node, z_order::kPlayerBody);
 
   return true;
@@ -68,7 +69,7 @@ bool Player::showOnMap(float x, float y) {
 void Player::onKilled() {
   Character::onKilled();
 
-  SceneManager::the().getCurrentScene<GameScene>()->setRunning(false);
+  ServiceRegistry::get<GameScene>()->setRunning(false);
 }
 
 bool Player::inflictDamage(Character* target, int damage) {
@@ -78,7 +79,7 @@ bool Player::inflictDamage(Character* target, int damage) {
   }
 
   if (target->isSetToKill()) {
-    auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+    auto notifications = ServiceRegistry::get<Notifications>();
     notifications->show(string_util::format("Acquired %d exp", target->getCharacterProfile().exp));
 
     updateKillTargetObjectives(target);
@@ -100,7 +101,7 @@ bool Player::receiveDamage(Character* source, int damage) {
     _isInvincible = false;
   }, 1.0f);
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+  auto hud = ServiceRegistry::get<Hud>();
   hud->updateStatusBars();
 
   camera_util::shake(8, .1f);
@@ -112,8 +113,9 @@ bool Player::addItem(shared_ptr<Item> item, int amount) {
     VGLOG(LOG_ERR, "Failed to add item to player.");
     return false;
   }
+  journalItem(item->getItemProfile().jsonFilePath, item->getItemProfile().itemType);
 
-  auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+  auto notifications = ServiceRegistry::get<Notifications>();
   notifications->show((amount > 1) ?
       string_util::format("Acquired item: %s (%d).", item->getName().c_str(), amount) :
       string_util::format("Acquired item: %s.", item->getName().c_str()));
@@ -122,13 +124,17 @@ bool Player::addItem(shared_ptr<Item> item, int amount) {
 }
 
 bool Player::removeItem(Item* item, int amount) {
+  // `item` may be deleted by Character::removeItem().
   const string itemName = item->getName();
+  const string itemJsonFilePath = item->getItemProfile().jsonFilePath;
+  const Item::Type itemType = item->getItemProfile().itemType;
   if (!Character::removeItem(item, amount)) {
     VGLOG(LOG_ERR, "Failed to remove item from player.");
     return false;
   }
+  journalItem(itemJsonFilePath, itemType);
 
-  auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+  auto notifications = ServiceRegistry::get<Notifications>();
   notifications->show((amount > 1) ?
       string_util::format("Removed item: %s (%d).", itemName.c_str(), amount) :
       string_util::format("Removed item: %s.", itemName.c_str()));
@@ -138,15 +144,18 @@ bool Player::removeItem(Item* item, int amount) {
 
 void Player::equip(Equipment* equipment, bool audio) {
   Character::equip(equipment, audio);
+  SaveJournal::the().recordEquipmentSlot(equipment->getEquipmentProfile().equipmentType,
+                                         equipment->getItemProfile().jsonFilePath);
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+  auto hud = ServiceRegistry::get<Hud>();
   hud->updateEquippedWeapon();
 }
 
 void Player::unequip(Equipment::Type equipmentType, bool audio) {
   Character::unequip(equipmentType, audio);
+  SaveJournal::the().recordEquipmentSlot(equipmentType, "");
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+  auto hud = ServiceRegistry::get<Hud>();
   hud->updateEquippedWeapon();
 }
 
@@ -174,7 +183,7 @@ void Player::addExp(const int exp) {
   Character::addExp(exp);
 
   if (_characterProfile.level > originalLevel) {
-    auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+    auto notifications = ServiceRegistry::get<Notifications>();
     notifications->show(string_util::format("Congrats! You are now level %d.", _characterProfile.level));
   }
 }
@@ -197,4 +206,15 @@ void Player::updateKillTargetObjectives(Character* killedCharacter) {
   _questBook.update(Quest::Objective::Type::KILL);
 }
 
+void Player::journalItem(const string& itemJsonFilePath, const Item::Type itemType) const {
+  auto it = _items.find(itemJsonFilePath);
+  if (it == _items.end()) {
+    SaveJournal::the().recordItem(itemJsonFilePath, itemType, std::nullopt, /*isInInventory=*/false);
+    return;
+  }
+
+  Item* item = it->second.get();
+  SaveJournal::the().recordItem(itemJsonFilePath, itemType, item->getAmount(), _inventory[itemType].contains(item));
+}
+
 }  // namespace vigilante
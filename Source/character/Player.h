@@ -43,6 +43,9 @@ class Player final : public Character, public Controllable {
   inline QuestBook& getQuestBook() { return _questBook; }
 
  private:
+  // Records the current state of an item in the save journal.
+  void journalItem(const std::string& itemJsonFilePath, const Item::Type itemType) const;
+
   PlayerController _playerController;
   QuestBook _questBook{assets::kQuestsList};
 };
@@ -7,6 +7,7 @@
 #include "combat/ComboSystem.h"
 #include "input/InputManager.h"
 #include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/Logger.h"
 
 using namespace std;
@@ -129,7 +130,7 @@ void PlayerController::handleAttackInput() {
 }
 
 void PlayerController::handleHotkeyInput() {
-  auto hotkeyMgr = SceneManager::the().getCurrentScene<GameScene>()->getHotkeyManager();
+  auto hotkeyMgr = ServiceRegistry::get<HotkeyManager>();
   for (auto keyCode : HotkeyManager::kBindableKeys) {
     Keybindable* action = hotkeyMgr->getHotkeyAction(keyCode);
     if (IS_KEY_JUST_PRESSED(keyCode) && action) {
@@ -0,0 +1,570 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "BinarySave.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#if __has_include(<zlib.h>)
+#include <zlib.h>
+#define VIGILANTE_BINARY_SAVE_ZLIB
+#endif
+
+#include "util/ByteUtil.h"
+#include "util/Logger.h"
+
+using namespace std;
+
+namespace vigilante::binary_save {
+
+namespace {
+
+constexpr char kMagic[4] = {'V', 'G', 'S', 'V'};
+constexpr uint16_t kVersion = 1;
+constexpr uint32_t kMaxBodySize = 64 * 1024 * 1024;
+
+struct Header final {
+  char magic[4];
+  uint16_t version;
+  uint8_t compression;
+  uint8_t numSections;
+  uint32_t bodySize;  // uncompressed
+  uint32_t storedBodySize;  // as stored in the file
+  uint32_t checksum;  // of everything after the header
+  uint32_t reserved;
+};
+
+struct SectionEntry final {
+  uint32_t offset;  // in the uncompressed body
+  uint32_t size;
+};
+
+// The encoded sizes, which don't depend on the host's struct padding.
+constexpr size_t kHeaderSize = 24;
+constexpr size_t kSectionEntrySize = 8;
+
+void writeHeader(byte_util::Writer& out, const Header& header) {
+  out.writeBytes(header.magic, sizeof(header.magic));
+  out.writeU16(header.version);
+  out.writeU8(header.compression);
+  out.writeU8(header.numSections);
+  out.writeU32(header.bodySize);
+  out.writeU32(header.storedBodySize);
+  out.writeU32(header.checksum);
+  out.writeU32(header.reserved);
+}
+
+bool readHeader(byte_util::Reader& in, Header& header) {
+  return in.readBytes(header.magic, sizeof(header.magic)) &&
+         in.readU16(header.version) &&
+         in.readU8(header.compression) &&
+         in.readU8(header.numSections) &&
+         in.readU32(header.bodySize) &&
+         in.readU32(header.storedBodySize) &&
+         in.readU32(header.checksum) &&
+         in.readU32(header.reserved);
+}
+
+// Upgrades a snapshot decoded from a version `i + 1` save file to version `i + 2`.
+//
+// To change the layout of a section: bump kVersion, make the section's
+// decoder branch on ByteReader::getVersion(), and append a migration here
+// which fills in (or converts) whatever the older save files don't have.
+// New sections are appended to Section, and are simply missing from older save files.
+using Migration = void (*)(GameState::Snapshot& snapshot);
+constexpr array<Migration, kVersion - 1> kMigrations{};
+
+class StringTable final {
+ public:
+  uint32_t intern(const string& str) {
+    auto [it, inserted] = _indices.emplace(str, static_cast<uint32_t>(_strings.size()));
+    if (inserted) {
+      _strings.push_back(&it->first);
+    }
+    return it->second;
+  }
+
+  inline const vector<const string*>& getStrings() const { return _strings; }
+
+ private:
+  unordered_map<string, uint32_t> _indices;
+  vector<const string*> _strings;  // keys of `_indices`, in the order of their indices
+};
+
+class ByteWriter final {
+ public:
+  explicit ByteWriter(StringTable& strings) : _strings{strings} {}
+
+  void writeVarint(const uint64_t value) {
+    _out.writeVarint(value);
+  }
+
+  void writeInt(const int64_t value) {
+    writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+
+  void writeFloat(const float value) {
+    _out.writeFloat(value);
+  }
+
+  void writeBool(const bool value) {
+    _out.writeU8(value);
+  }
+
+  void writeString(const string& str) {
+    writeVarint(_strings.intern(str));
+  }
+
+  template <typename Container>
+  void writeStrings(const Container& strs) {
+    writeVarint(strs.size());
+    for (const auto& str : strs) {
+      writeString(str);
+    }
+  }
+
+  void writeRaw(const string_view bytes) {
+    _out.writeBytes(bytes.data(), bytes.size());
+  }
+
+  inline const string& getBuffer() const { return _out.getBuffer(); }
+
+ private:
+  StringTable& _strings;
+  byte_util::Writer _out;
+};
+
+// Reads until the end of its data. Once a read fails (i.e., the data
+// is truncated or malformed), all the subsequent reads return zeros.
+class ByteReader final {
+ public:
+  ByteReader(const string_view data, const uint16_t version, const vector<string_view>& strings)
+      : _in{data},
+        _version{version},
+        _strings{strings} {}
+
+  uint64_t readVarint() {
+    uint64_t value;
+    return (_ok && _in.readVarint(value)) ? value : fail();
+  }
+
+  int64_t readInt() {
+    const uint64_t value = readVarint();
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+  }
+
+  float readFloat() {
+    float value;
+    return (_ok && _in.readFloat(value)) ? value : fail();
+  }
+
+  bool readBool() {
+    bool value;
+    return (_ok && _in.readBool(value)) ? value : fail();
+  }
+
+  string readString() {
+    const uint64_t idx = readVarint();
+    if (idx >= _strings.size()) {
+      fail();
+      return "";
+    }
+    return string{_strings[idx]};
+  }
+
+  string_view readRaw(const size_t size) {
+    string_view bytes;
+    if (!_ok || !_in.readView(size, bytes)) {
+      fail();
+      return {};
+    }
+    return bytes;
+  }
+
+  // Every element takes at least one byte, so a count larger than the
+  // remaining data is corrupted, and is rejected before anything is allocated.
+  size_t readCount() {
+    const uint64_t count = readVarint();
+    if (count > _in.getNumBytesLeft()) {
+      return fail();
+    }
+    return count;
+  }
+
+  template <typename Container>
+  void readStrings(Container& strs) {
+    const size_t count = readCount();
+    for (size_t i = 0; i < count && _ok; i++) {
+      strs.insert(strs.end(), readString());
+    }
+  }
+
+  inline bool ok() const { return _ok; }
+  inline uint16_t getVersion() const { return _version; }
+
+ private:
+  uint64_t fail() {
+    _ok = false;
+    return 0;
+  }
+
+  byte_util::Reader _in;
+  const uint16_t _version;
+  const vector<string_view>& _strings;
+  bool _ok{true};
+};
+
+void encodeGameMap(ByteWriter& out, const GameState::Snapshot& snapshot) {
+  out.writeString(snapshot.tmxTiledMapFilePath);
+  out.writeStrings(snapshot.npcSpawningBlacklist);
+  out.writeVarint(snapshot.allOpenableObjectStates.size());
+  for (const auto& [key, isOpened] : snapshot.allOpenableObjectStates) {
+    out.writeString(key);
+    out.writeBool(isOpened);
+  }
+  out.writeFloat(snapshot.playerPos.first);
+  out.writeFloat(snapshot.playerPos.second);
+}
+
+void decodeGameMap(ByteReader& in, GameState::Snapshot& snapshot) {
+  snapshot.tmxTiledMapFilePath = in.readString();
+  snapshot.npcSpawningBlacklist.clear();
+  in.readStrings(snapshot.npcSpawningBlacklist);
+  snapshot.allOpenableObjectStates.clear();
+  const size_t numOpenableObjects = in.readCount();
+  for (size_t i = 0; i < numOpenableObjects && in.ok(); i++) {
+    string key = in.readString();
+    snapshot.allOpenableObjectStates[std::move(key)] = in.readBool();
+  }
+  snapshot.playerPos.first = in.readFloat();
+  snapshot.playerPos.second = in.readFloat();
+}
+
+void encodePlayer(ByteWriter& out, const GameState::Snapshot::Player& p) {
+  out.writeString(p.name);
+  out.writeInt(p.level);
+  out.writeInt(p.exp);
+  out.writeInt(p.fullHealth);
+  out.writeInt(p.fullStamina);
+  out.writeInt(p.fullMagicka);
+  out.writeInt(p.health);
+  out.writeInt(p.stamina);
+  out.writeInt(p.magicka);
+  out.writeInt(p.strength);
+  out.writeInt(p.dexterity);
+  out.writeInt(p.intelligence);
+  out.writeInt(p.luck);
+  out.writeFloat(p.moveSpeed);
+  out.writeFloat(p.jumpHeight);
+  out.writeBool(p.canDoubleJump);
+  out.writeFloat(p.attackForce);
+  out.writeFloat(p.attackTime);
+  out.writeFloat(p.attackRange);
+  out.writeInt(p.baseMeleeDamage);
+
+  out.writeVarint(p.itemMapper.size());
+  for (const auto& [itemJsonFilePath, amount] : p.itemMapper) {
+    out.writeString(itemJsonFilePath);
+    out.writeInt(amount);
+  }
+  out.writeVarint(p.inventory.size());
+  for (const auto& items : p.inventory) {
+    out.writeStrings(items);
+  }
+  out.writeStrings(p.equipmentSlots);
+
+  out.writeStrings(p.partyMembers);
+  out.writeVarint(p.waitingPartyMembers.size());
+  for (const auto& member : p.waitingPartyMembers) {
+    out.writeString(member.npcJsonFilePath);
+    out.writeString(member.tmxMapFilePath);
+    out.writeFloat(member.x);
+    out.writeFloat(member.y);
+  }
+}
+
+void decodePlayer(ByteReader& in, GameState::Snapshot::Player& p) {
+  p = {};
+  p.name = in.readString();
+  p.level = static_cast<int>(in.readInt());
+  p.exp = static_cast<int>(in.readInt());
+  p.fullHealth = static_cast<int>(in.readInt());
+  p.fullStamina = static_cast<int>(in.readInt());
+  p.fullMagicka = static_cast<int>(in.readInt());
+  p.health = static_cast<int>(in.readInt());
+  p.stamina = static_cast<int>(in.readInt());
+  p.magicka = static_cast<int>(in.readInt());
+  p.strength = static_cast<int>(in.readInt());
+  p.dexterity = static_cast<int>(in.readInt());
+  p.intelligence = static_cast<int>(in.readInt());
+  p.luck = static_cast<int>(in.readInt());
+  p.moveSpeed = in.readFloat();
+  p.jumpHeight = in.readFloat();
+  p.canDoubleJump = in.readBool();
+  p.attackForce = in.readFloat();
+  p.attackTime = in.readFloat();
+  p.attackRange = in.readFloat();
+  p.baseMeleeDamage = static_cast<int>(in.readInt());
+
+  const size_t numItems = in.readCount();
+  for (size_t i = 0; i < numItems && in.ok(); i++) {
+    string itemJsonFilePath = in.readString();
+    p.itemMapper[std::move(itemJsonFilePath)] = static_cast<int>(in.readInt());
+  }
+  p.inventory.resize(in.readCount());
+  for (auto& items : p.inventory) {
+    in.readStrings(items);
+  }
+  in.readStrings(p.equipmentSlots);
+
+  in.readStrings(p.partyMembers);
+  p.waitingPartyMembers.resize(in.readCount());
+  for (auto& member : p.waitingPartyMembers) {
+    member.npcJsonFilePath = in.readString();
+    member.tmxMapFilePath = in.readString();
+    member.x = in.readFloat();
+    member.y = in.readFloat();
+  }
+}
+
+void encodeInGameTime(ByteWriter& out, const GameState::Snapshot& snapshot) {
+  out.writeInt(snapshot.hour);
+  out.writeInt(snapshot.minute);
+  out.writeInt(snapshot.second);
+  out.writeVarint(snapshot.secondsElapsed);
+  out.writeVarint(snapshot.deferredCmds.size());
+  for (const auto& [secondsElapsedRequired, cmd] : snapshot.deferredCmds) {
+    out.writeVarint(secondsElapsedRequired);
+    out.writeString(cmd);
+  }
+}
+
+void decodeInGameTime(ByteReader& in, GameState::Snapshot& snapshot) {
+  snapshot.hour = static_cast<int>(in.readInt());
+  snapshot.minute = static_cast<int>(in.readInt());
+  snapshot.second = static_cast<int>(in.readInt());
+  snapshot.secondsElapsed = in.readVarint();
+  snapshot.deferredCmds.resize(in.readCount());
+  for (auto& [secondsElapsedRequired, cmd] : snapshot.deferredCmds) {
+    secondsElapsedRequired = in.readVarint();
+    cmd = in.readString();
+  }
+}
+
+void encodeRoomRentalTracker(ByteWriter& out, const GameState::Snapshot& snapshot) {
+  out.writeStrings(snapshot.checkedInInns);
+}
+
+void decodeRoomRentalTracker(ByteReader& in, GameState::Snapshot& snapshot) {
+  snapshot.checkedInInns.clear();
+  in.readStrings(snapshot.checkedInInns);
+}
+
+void encodeRng(ByteWriter& out, const GameState::Snapshot& snapshot) {
+  out.writeBool(snapshot.rngSeed.has_value());
+  if (snapshot.rngSeed) {
+    out.writeVarint(*snapshot.rngSeed);
+  }
+}
+
+void decodeRng(ByteReader& in, GameState::Snapshot& snapshot) {
+  snapshot.rngSeed.reset();
+  if (in.readBool()) {
+    snapshot.rngSeed = in.readVarint();
+  }
+}
+
+bool compress(const string& body, string& out) {
+#ifdef VIGILANTE_BINARY_SAVE_ZLIB
+  uLongf size = ::compressBound(body.size());
+  out.resize(size);
+  if (::compress2(reinterpret_cast<Bytef*>(out.data()), &size,
+                  reinterpret_cast<const Bytef*>(body.data()), body.size(), Z_BEST_SPEED) != Z_OK) {
+    return false;
+  }
+  out.resize(size);
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool decompress(const string_view storedBody, const size_t bodySize, string& out) {
+#ifdef VIGILANTE_BINARY_SAVE_ZLIB
+  uLongf size = bodySize;
+  out.resize(bodySize);
+  return ::uncompress(reinterpret_cast<Bytef*>(out.data()), &size,
+                      reinterpret_cast<const Bytef*>(storedBody.data()), storedBody.size()) == Z_OK &&
+         size == bodySize;
+#else
+  VGLOG(LOG_ERR, "Compressed save files are not supported in this build.");
+  return false;
+#endif
+}
+
+}  // namespace
+
+Compression getDefaultCompression() {
+#ifdef VIGILANTE_BINARY_SAVE_ZLIB
+  return Compression::ZLIB;
+#else
+  return Compression::NONE;
+#endif
+}
+
+bool isBinarySave(const char* data, const size_t size) {
+  return size >= sizeof(kMagic) && std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+string encode(const GameState::Snapshot& snapshot, Compression compression) {
+  StringTable strings;
+  array<string, Section::SIZE> sections;
+
+  auto encodeSection = [&strings, &sections](const Section section, auto encodeFn, const auto& value) {
+    ByteWriter out{strings};
+    encodeFn(out, value);
+    sections[section] = out.getBuffer();
+  };
+
+  encodeSection(Section::GAME_MAP, encodeGameMap, snapshot);
+  encodeSection(Section::PLAYER, encodePlayer, snapshot.player);
+  encodeSection(Section::IN_GAME_TIME, encodeInGameTime, snapshot);
+  encodeSection(Section::ROOM_RENTAL_TRACKER, encodeRoomRentalTracker, snapshot);
+  encodeSection(Section::RNG, encodeRng, snapshot);
+
+  // The string table is built while encoding the other sections, so it's encoded last.
+  ByteWriter stringTable{strings};
+  stringTable.writeVarint(strings.getStrings().size());
+  for (const string* str : strings.getStrings()) {
+    stringTable.writeVarint(str->size());
+    stringTable.writeRaw(*str);
+  }
+  sections[Section::STRING_TABLE] = stringTable.getBuffer();
+
+  byte_util::Writer sectionEntries;
+  string body;
+  for (int i = 0; i < Section::SIZE; i++) {
+    sectionEntries.writeU32(body.size());
+    sectionEntries.writeU32(sections[i].size());
+    body += sections[i];
+  }
+
+  // Small save files may not get any smaller, in which case they're stored as is.
+  string compressedBody;
+  if (compression == Compression::ZLIB && (!compress(body, compressedBody) || compressedBody.size() >= body.size())) {
+    compression = Compression::NONE;
+  }
+  const string& storedBody = (compression == Compression::NONE) ? body : compressedBody;
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.compression = static_cast<uint8_t>(compression);
+  header.numSections = Section::SIZE;
+  header.bodySize = body.size();
+  header.storedBodySize = storedBody.size();
+
+  string payload = sectionEntries.getBuffer();
+  payload.append(storedBody);
+  header.checksum = byte_util::fnv1a32(payload);
+
+  byte_util::Writer data;
+  writeHeader(data, header);
+  data.writeBytes(payload.data(), payload.size());
+  return data.getBuffer();
+}
+
+bool decode(const string_view data, GameState::Snapshot& snapshot, const uint32_t sectionMask) {
+  if (!isBinarySave(data.data(), data.size())) {
+    return false;
+  }
+
+  byte_util::Reader headerReader{data};
+  Header header;
+  if (!readHeader(headerReader, header)) {
+    return false;
+  }
+  if (header.version == 0 || header.version > kVersion) {
+    VGLOG(LOG_ERR, "Unsupported save file version: %d (expected <= %d).", header.version, kVersion);
+    return false;
+  }
+
+  const size_t bodyOffset = kHeaderSize + header.numSections * kSectionEntrySize;
+  if (header.numSections == 0 ||
+      header.bodySize > kMaxBodySize ||
+      data.size() != bodyOffset + header.storedBodySize) {
+    return false;
+  }
+
+  if (byte_util::fnv1a32(data.substr(kHeaderSize)) != header.checksum) {
+    return false;
+  }
+  const string_view storedBody = data.substr(bodyOffset);
+
+  string decompressedBody;
+  string_view body;
+  switch (static_cast<Compression>(header.compression)) {
+    case Compression::NONE:
+      body = storedBody;
+      break;
+    case Compression::ZLIB:
+      if (!decompress(storedBody, header.bodySize, decompressedBody)) {
+        return false;
+      }
+      body = decompressedBody;
+      break;
+    default:
+      return false;
+  }
+  if (body.size() != header.bodySize) {
+    return false;
+  }
+
+  // Sections from a newer version (if any) are never read, since newer versions are rejected above.
+  array<string_view, Section::SIZE> sections{};
+  for (int i = 0; i < std::min<int>(header.numSections, Section::SIZE); i++) {
+    SectionEntry entry;
+    if (!headerReader.readU32(entry.offset) || !headerReader.readU32(entry.size) ||
+        uint64_t{entry.offset} + entry.size > body.size()) {
+      return false;
+    }
+    sections[i] = body.substr(entry.offset, entry.size);
+  }
+
+  vector<string_view> strings;
+  ByteReader stringTable{sections[Section::STRING_TABLE], header.version, strings};
+  strings.resize(stringTable.readCount());
+  for (auto& str : strings) {
+    str = stringTable.readRaw(stringTable.readVarint());
+  }
+  if (!stringTable.ok()) {
+    return false;
+  }
+
+  auto decodeSection = [&](const Section section, auto decodeFn, auto& value) {
+    if (!(sectionMask & (1 << section)) || section >= header.numSections) {
+      return true;
+    }
+    ByteReader in{sections[section], header.version, strings};
+    decodeFn(in, value);
+    return in.ok();
+  };
+
+  if (!decodeSection(Section::GAME_MAP, decodeGameMap, snapshot) ||
+      !decodeSection(Section::PLAYER, decodePlayer, snapshot.player) ||
+      !decodeSection(Section::IN_GAME_TIME, decodeInGameTime, snapshot) ||
+      !decodeSection(Section::ROOM_RENTAL_TRACKER, decodeRoomRentalTracker, snapshot) ||
+      !decodeSection(Section::RNG, decodeRng, snapshot)) {
+    return false;
+  }
+
+  for (uint16_t version = header.version; version < kVersion; version++) {
+    kMigrations[version - 1](snapshot);
+  }
+  return true;
+}
+
+}  // namespace vigilante::binary_save
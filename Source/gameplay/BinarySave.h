@@ -0,0 +1,66 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_GAMEPLAY_BINARY_SAVE_H_
+#define VIGILANTE_GAMEPLAY_BINARY_SAVE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "gameplay/GameState.h"
+
+// The compact binary save format, which GameState writes by default.
+// Json saves can still be loaded, and the two formats can be converted
+// into each other with: vigilante --convert-save <inputFilePath> <outputFilePath>
+//
+// Save file layout (all fixed-size integers are little-endian):
+//
+// +--------+-----------------------------+-----------------------------------+
+// | Header | SectionEntry[numSections]   | Body (optionally compressed)      |
+// +--------+-----------------------------+-----------------------------------+
+//
+// - The body is the string table followed by the sections, each of which
+//   can be decoded independently, given its (offset, size) in the body.
+// - The string table holds every (deduplicated) path, id and name,
+//   which are referenced by their index in the sections.
+// - Counters and integers are LEB128 varints (zigzag-encoded if signed),
+//   and floats are stored as their 4 IEEE 754 bytes (little-endian).
+// - The header holds a checksum of everything after it, so a corrupted
+//   or truncated save file is rejected instead of being half-loaded.
+namespace vigilante::binary_save {
+
+enum class Compression : uint8_t {
+  NONE,
+  ZLIB,
+};
+
+enum Section : uint8_t {
+  STRING_TABLE,
+  GAME_MAP,
+  PLAYER,
+  IN_GAME_TIME,
+  ROOM_RENTAL_TRACKER,
+  RNG,
+  SIZE
+};
+
+inline constexpr uint32_t kAllSections = (1 << Section::SIZE) - 1;
+
+// ZLIB if zlib is available, otherwise NONE.
+Compression getDefaultCompression();
+
+// @return true if `data` starts with the magic of a binary save file.
+bool isBinarySave(const char* data, const size_t size);
+
+std::string encode(const GameState::Snapshot& snapshot, const Compression compression = getDefaultCompression());
+
+// Decodes the sections in `sectionMask` (a bitmask of (1 << Section)) into
+// `snapshot`, leaving the other fields untouched. Save files written by
+// an older version are migrated to the current version afterwards.
+// @return false if `data` is corrupted or is from a newer version.
+bool decode(std::string_view data, GameState::Snapshot& snapshot, const uint32_t sectionMask = kAllSections);
+
+}  // namespace vigilante::binary_save
+
+#endif  // VIGILANTE_GAMEPLAY_BINARY_SAVE_H_
@@ -12,6 +12,7 @@
 #include "util/ds/Algorithm.h"
 #include "util/JsonUtil.h"
 #include "util/Logger.h"
+#include "util/StringUtil.h"
 
 using namespace std;
 
@@ -43,7 +44,7 @@ void DialogueTree::import(const string& jsonFilePath) {
     return;
   }
 
-  VGLOG(LOG_INFO, "Loading dialogue tree...");
+  VGLOG(LOG_DEBUG, "Loading dialogue tree...");
   rapidjson::Document json = json_util::loadFromFile(jsonFilePath);
 
   // Convert rapidjson tree into our DialogueTree using tree DFS.
@@ -68,9 +69,14 @@ void DialogueTree::import(const string& jsonFilePath) {
     for (const auto& line : jsonNode["lines"].GetArray()) {
       node->_lines.push_back(line.GetString());
     }
+    vector<string> cmds;
     for (const auto& cmd : jsonNode["exec"].GetArray()) {
-      node->_cmds.push_back(cmd.GetString());
+      cmds.push_back(cmd.GetString());
     }
+    if (jsonNode.HasMember("script")) {
+      cmds.push_back(string_util::format("%s \"%s\"", cmd::kRunScript, jsonNode["script"].GetString()));
+    }
+    node->_cmds = CommandHandler::compile(cmds);
 
     if (jsonNode.HasMember("childrenRef")) {
       node->_childrenRef = jsonNode["childrenRef"].GetString();
@@ -142,7 +148,7 @@ void DialogueTree::addAllyDialogueToRootNode() {
 void DialogueTree::addTradingDialogue() {
   auto tradeNode = std::make_unique<DialogueTree::Node>(this);
   tradeNode->_lines.push_back("Trade.");
-  tradeNode->_cmds.push_back(cmd::kTrade);
+  tradeNode->_cmds.push_back(CommandHandler::compile(cmd::kTrade));
 
   _tradeNode = tradeNode.get();
   _rootNode->_children.push_back(std::move(tradeNode));
@@ -152,20 +158,20 @@ void DialogueTree::update() {
   if (_toggleJoinPartyNode) {
     if (!_owner->isPlayerLeaderOfParty()) {
       _toggleJoinPartyNode->_lines.front() = "Follow me.";
-      _toggleJoinPartyNode->_cmds.front() = cmd::kJoinPlayerParty;
+      _toggleJoinPartyNode->_cmds.front() = CommandHandler::compile(cmd::kJoinPlayerParty);
     } else {
       _toggleJoinPartyNode->_lines.front() = "It's time for us to part ways";
-      _toggleJoinPartyNode->_cmds.front() = cmd::kLeavePlayerParty;
+      _toggleJoinPartyNode->_cmds.front() = CommandHandler::compile(cmd::kLeavePlayerParty);
     }
   }
 
   if (_toggleWaitNode) {
     if (!_owner->isWaitingForPlayer()) {
       _toggleWaitNode->_lines.front() = "Wait here.";
-      _toggleWaitNode->_cmds.front() = cmd::kPartyMemberWait;
+      _toggleWaitNode->_cmds.front() = CommandHandler::compile(cmd::kPartyMemberWait);
     } else {
       _toggleWaitNode->_lines.front() = "Continue to follow me.";
-      _toggleWaitNode->_cmds.front() = cmd::kPartyMemberFollow;
+      _toggleWaitNode->_cmds.front() = CommandHandler::compile(cmd::kPartyMemberFollow);
     }
   }
 }
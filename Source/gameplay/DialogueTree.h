@@ -9,6 +9,7 @@
 #include <unordered_map>
 
 #include "Importable.h"
+#include "ui/console/CommandHandler.h"
 
 namespace vigilante {
 
@@ -41,7 +42,7 @@ class DialogueTree : public Importable {
 
     inline const std::string& getNodeName() const { return _nodeName; }
     inline const std::vector<std::string>& getLines() const { return _lines; }
-    inline const std::vector<std::string>& getCmds() const { return _cmds; }
+    inline const std::vector<CompiledCmd>& getCmds() const { return _cmds; }
     inline const std::string& getChildrenRef() const { return _childrenRef; }
     std::vector<Node*> getChildren() const;
     std::vector<Node*> getChildrenOnExecFail() const;
@@ -51,7 +52,7 @@ class DialogueTree : public Importable {
 
     std::string _nodeName;  // only required when `childrenRef` exists. See comment below.
     std::vector<std::string> _lines;
-    std::vector<std::string> _cmds;  // the command to execute after all lines are shown.
+    std::vector<CompiledCmd> _cmds;  // the command to execute after all lines are shown.
 
     // We have two (mutually exclusive) methods for keeping children:
     //
@@ -2,208 +2,594 @@
 
 #include "GameState.h"
 
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include <vector>
 
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
 #include "character/Npc.h"
+#include "gameplay/BinarySave.h"
+#include "gameplay/SaveJournal.h"
+#include "gameplay/SaveWorker.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/JsonUtil.h"
+#include "util/Logger.h"
+#include "util/Profiler.h"
+#include "util/RandUtil.h"
 
 using namespace std;
+USING_NS_AX;
 
 namespace vigilante {
 
-void GameState::save() {
-  _json.SetObject();
+namespace {
+
+// Writes `data` to a temporary file, makes sure it has reached the disk,
+// and then renames it over `filePath`, which is either fully replaced or
+// left untouched. The file being replaced is kept as `backupFilePath`.
+bool writeFileAtomically(const fs::path& filePath, const fs::path& backupFilePath,
+                         const char* data, const size_t size) {
+  fs::path tmpFilePath = filePath;
+  tmpFilePath += ".tmp";
+
+  FILE* file = std::fopen(tmpFilePath.string().c_str(), "wb");
+  if (!file) {
+    VGLOG(LOG_ERR, "Failed to open [%s].", tmpFilePath.string().c_str());
+    return false;
+  }
+
+  bool ok = std::fwrite(data, 1, size, file) == size && std::fflush(file) == 0 && syncFile(file);
+  ok = (std::fclose(file) == 0) && ok;
+
+  error_code ec;
+  if (!ok) {
+    VGLOG(LOG_ERR, "Failed to write [%s].", tmpFilePath.string().c_str());
+    fs::remove(tmpFilePath, ec);
+    return false;
+  }
+
+  if (fs::exists(filePath, ec)) {
+    fs::copy_file(filePath, backupFilePath, fs::copy_options::overwrite_existing, ec);
+    if (ec) {
+      VGLOG(LOG_WARN, "Failed to back up [%s]: %s.", filePath.string().c_str(), ec.message().c_str());
+    }
+  }
+
+  fs::rename(tmpFilePath, filePath, ec);
+  if (ec) {
+    VGLOG(LOG_ERR, "Failed to rename [%s]: %s.", tmpFilePath.string().c_str(), ec.message().c_str());
+    fs::remove(tmpFilePath, ec);
+    return false;
+  }
+  return true;
+}
 
-  _json.AddMember("gameMap", serializeGameMapState(), _allocator);
-  _json.AddMember("player", serializePlayerState(), _allocator);
-  _json.AddMember("inGameTime", serializeInGameTime(), _allocator);
-  _json.AddMember("roomRentalTracker", serializeRoomRentalTrackerState(), _allocator);
+}  // namespace
 
+void GameState::save(OnSaved onSaved) {
   VGLOG(LOG_INFO, "Saving to save file [%s].", _saveFilePath.c_str());
-  json_util::saveToFile(_saveFilePath, _json);
+
+  SaveWorker::the().post([snapshot = capture(), saveFilePath = _saveFilePath, onSaved = std::move(onSaved)]() {
+    // The journal is folded into the new save file.
+    const bool success = write(saveFilePath, snapshot) && SaveJournal::reset(saveFilePath);
+    if (!success) {
+      VGLOG(LOG_ERR, "Failed to save to save file [%s].", saveFilePath.c_str());
+    }
+    if (onSaved) {
+      Director::getInstance()->getScheduler()->runOnAxmolThread([onSaved, success]() {
+        onSaved(success);
+      });
+    }
+  });
+
+  // The changes made until now are in the snapshot.
+  SaveJournal::the().open(_saveFilePath);
 }
 
-void GameState::load() {
+bool GameState::load() {
+  const auto beginTime = chrono::steady_clock::now();
+  SaveWorker::the().waitUntilIdle();
+
   VGLOG(LOG_INFO, "Loading from save file [%s].", _saveFilePath.c_str());
-  _json = json_util::loadFromFile(_saveFilePath);
+  Snapshot snapshot;
+  bool isSaveFileLoaded{};
+  if (!readWithBackup(_saveFilePath, snapshot, isSaveFileLoaded)) {
+    return false;
+  }
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  gmMgr->setNpcsAllowedToAct(false);
+  // A missing, stale or torn journal is folded into the save file
+  // (as far as it goes), so that the new records are appended to a valid one.
+  if (isSaveFileLoaded && !SaveJournal::replay(_saveFilePath, snapshot)) {
+    SaveWorker::the().post([snapshot, saveFilePath = _saveFilePath]() {
+      SaveJournal::compact(saveFilePath, snapshot);
+    });
+  }
 
-  deserializePlayerState(_json["player"].GetObject());
-  deserializeGameMapState(_json["gameMap"].GetObject());
-  deserializeInGameTime(_json["inGameTime"].GetObject());
-  deserializeRoomRentalTrackerState(_json["roomRentalTracker"].GetObject());
+  const auto readEndTime = chrono::steady_clock::now();
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
-  hud->updateEquippedWeapon();
-  hud->updateStatusBars();
+  // Nothing is journaled until the snapshot has been applied. The journal belongs
+  // to the save file rather than its backup, so autosaving is disabled until the game
+  // is saved again if the backup has been loaded.
+  SaveJournal::the().close();
+  apply(snapshot, [saveFilePath = _saveFilePath, isSaveFileLoaded, beginTime, readEndTime]() {
+    if (isSaveFileLoaded) {
+      SaveJournal::the().open(saveFilePath);
+    }
+
+    const auto endTime = chrono::steady_clock::now();
+    VGLOG(LOG_INFO, "Loaded save file [%s] in %.1f ms (reading: %.1f ms).", saveFilePath.c_str(),
+          chrono::duration<double, milli>(endTime - beginTime).count(),
+          chrono::duration<double, milli>(readEndTime - beginTime).count());
+  });
+  return true;
 }
 
-rapidjson::Value GameState::serializeGameMapState() const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto gameMap = gmMgr->getGameMap();
+GameState::Snapshot GameState::capture(const bool includeJournaledState) {
+  VGPROFILE_ZONE("GameState::capture");
+
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   auto player = gmMgr->getPlayer();
+  auto inGameTime = ServiceRegistry::get<InGameTime>();
+  auto roomRentalTracker = ServiceRegistry::get<RoomRentalTracker>();
+
+  Snapshot snapshot{};
 
+  // Game map.
   const b2Vec2& playerPos = player->getBody()->GetPosition();
-  pair<float, float> playerPosPair{playerPos.x, playerPos.y};
+  snapshot.tmxTiledMapFilePath = gmMgr->getGameMap()->getTmxTiledMapFilePath();
+  snapshot.playerPos = {playerPos.x, playerPos.y};
+
+  // Player.
+  const auto& profile = player->getCharacterProfile();
+  Snapshot::Player& p = snapshot.player;
+  p.name = profile.name;
+  p.level = profile.level;
+  p.exp = profile.exp;
+  p.fullHealth = profile.fullHealth;
+  p.fullStamina = profile.fullStamina;
+  p.fullMagicka = profile.fullMagicka;
+  p.health = profile.health;
+  p.stamina = profile.stamina;
+  p.magicka = profile.magicka;
+  p.strength = profile.strength;
+  p.dexterity = profile.dexterity;
+  p.intelligence = profile.intelligence;
+  p.luck = profile.luck;
+  p.moveSpeed = profile.moveSpeed;
+  p.jumpHeight = profile.jumpHeight;
+  p.canDoubleJump = profile.canDoubleJump;
+  p.attackForce = profile.attackForce;
+  p.attackTime = profile.attackTime;
+  p.attackRange = profile.attackRange;
+  p.baseMeleeDamage = profile.baseMeleeDamage;
+
+  // In-game time.
+  snapshot.hour = inGameTime->getHour();
+  snapshot.minute = inGameTime->getMinute();
+  snapshot.second = inGameTime->getSecond();
+  snapshot.secondsElapsed = inGameTime->getSecondsElapsed();
+  snapshot.deferredCmds = inGameTime->getDeferredCmds();
+
+  snapshot.checkedInInns = roomRentalTracker->getCheckedInInns();
+  snapshot.rngSeed = rand_util::getSeed();
+
+  if (!includeJournaledState) {
+    return snapshot;
+  }
+
+  // Game map.
+  snapshot.npcSpawningBlacklist = gmMgr->_npcSpawningBlacklist;
+  snapshot.allOpenableObjectStates = gmMgr->_allOpenableObjectStates;
+
+  // Player inventory.
+  for (const auto& [itemJsonFilePath, item] : player->_items) {
+    p.itemMapper.insert(std::make_pair(itemJsonFilePath, item->getAmount()));
+  }
+
+  p.inventory.resize(Item::Type::SIZE);
+  for (int type = 0; type < Item::Type::SIZE; type++) {
+    p.inventory[type].reserve(player->_inventory[type].size());
+    for (const auto item : player->_inventory[type]) {
+      p.inventory[type].push_back(item->getItemProfile().jsonFilePath);
+    }
+  }
+
+  p.equipmentSlots.reserve(Equipment::Type::SIZE);
+  for (int type = 0; type < Equipment::Type::SIZE; type++) {
+    Equipment* equipment = player->_equipmentSlots[type];
+    p.equipmentSlots.push_back(equipment ? equipment->getItemProfile().jsonFilePath : "");
+  }
+
+  // Player party.
+  for (const auto& member : player->getParty()->getMembers()) {
+    p.partyMembers.push_back(member->getCharacterProfile().jsonFilePath);
+  }
+  for (const auto& [npcJsonFilePath, locInfo] : player->getParty()->getWaitingMembersLocationInfos()) {
+    p.waitingPartyMembers.push_back({npcJsonFilePath, locInfo.tmxMapFilePath, locInfo.x, locInfo.y});
+  }
 
-  return json_util::serialize(_allocator,
-                              make_pair("tmxTiledMapFilePath", gameMap->getTmxTiledMapFilePath()),
-                              make_pair("npcSpawningBlacklist", gmMgr->_npcSpawningBlacklist),
-                              make_pair("allPortalStates", gmMgr->_allOpenableObjectStates),
-                              make_pair("playerPos", playerPosPair));
+  return snapshot;
 }
 
-void GameState::deserializeGameMapState(const rapidjson::Value& obj) const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto player = gmMgr->getPlayer();
+void GameState::apply(const Snapshot& snapshot, const function<void ()>& afterApplying) {
+  VGPROFILE_ZONE("GameState::apply");
 
-  string tmxTiledMapFilePath;
-  pair<float, float> playerPos{0, 0};
+  // Older save files don't have a seed, in which case the RNG stays time-seeded.
+  if (snapshot.rngSeed) {
+    rand_util::init(static_cast<uint32_t>(*snapshot.rngSeed));
+  }
 
-  json_util::deserialize(obj,
-                         make_pair("tmxTiledMapFilePath", &tmxTiledMapFilePath),
-                         make_pair("npcSpawningBlacklist", &gmMgr->_npcSpawningBlacklist),
-                         make_pair("allPortalStates", &gmMgr->_allOpenableObjectStates),
-                         make_pair("playerPos", &playerPos));
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  gmMgr->setNpcsAllowedToAct(false);
+
+  // When continuing from the main menu, there's neither a game map nor a player yet.
+  // Only the saved game map is loaded then (rather than the initial map of a new game
+  // which would be thrown away right after), the player is created along with it,
+  // and the saved player state is applied to it afterwards.
+  optional<Snapshot::Player> pendingPlayerState;
+  if (gmMgr->getPlayer()) {
+    applyPlayerState(snapshot.player);
+  } else {
+    pendingPlayerState = snapshot.player;
+  }
+  applyGameMapState(snapshot);
+  applyInGameTime(snapshot);
+  applyRoomRentalTrackerState(snapshot);
+
+  const string tmxTiledMapFilePath = snapshot.tmxTiledMapFilePath;
+  const pair<float, float> playerPos = snapshot.playerPos;
 
   gmMgr->loadGameMap(tmxTiledMapFilePath, [=]() {
-    player->setPosition(playerPos.first, playerPos.second);
-
-    const auto& playerParty = player->getParty();
-    for (const auto ally : player->getAllies()) {
-      const string& jsonFilePath = ally->getCharacterProfile().jsonFilePath;
-      if (auto waitLoc = playerParty->getWaitingMemberLocationInfo(jsonFilePath)) {
-        if (waitLoc->tmxMapFilePath == tmxTiledMapFilePath) {
-          ally->showOnMap(waitLoc->x * kPpm, waitLoc->y * kPpm);
-        }
-      } else {
-        ally->showOnMap(playerPos.first * kPpm, playerPos.second * kPpm);
-      }
+    if (pendingPlayerState) {
+      applyPlayerState(*pendingPlayerState);
     }
+    showPlayerAndAllies(tmxTiledMapFilePath, playerPos);
+
+    auto hud = ServiceRegistry::get<Hud>();
+    hud->updateEquippedWeapon();
+    hud->updateStatusBars();
+
+    afterApplying();
   });
 }
 
-rapidjson::Value GameState::serializePlayerState() const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  const auto &profile = gmMgr->getPlayer()->getCharacterProfile();
-
-  return json_util::serialize(_allocator,
-                              make_pair("name", profile.name),
-                              make_pair("level", profile.level),
-                              make_pair("exp", profile.exp),
-                              make_pair("fullHealth", profile.fullHealth),
-                              make_pair("fullStamina", profile.fullStamina),
-                              make_pair("fullMagicka", profile.fullMagicka),
-                              make_pair("health", profile.health),
-                              make_pair("stamina", profile.stamina),
-                              make_pair("magicka", profile.magicka),
-                              make_pair("strength", profile.strength),
-                              make_pair("dexterity", profile.dexterity),
-                              make_pair("intelligence", profile.intelligence),
-                              make_pair("luck", profile.luck),
-                              make_pair("moveSpeed", profile.moveSpeed),
-                              make_pair("jumpHeight", profile.jumpHeight),
-                              make_pair("canDoubleJump", profile.canDoubleJump),
-                              make_pair("attackForce", profile.attackForce),
-                              make_pair("attackTime", profile.attackTime),
-                              make_pair("attackRange", profile.attackRange),
-                              make_pair("baseMeleeDamage", profile.baseMeleeDamage),
-                              make_pair("inventory", serializePlayerInventory()),
-                              make_pair("party", serializePlayerParty()));
+rapidjson::Document GameState::toJson(const Snapshot& snapshot) {
+  rapidjson::Document json;
+  auto& allocator = json.GetAllocator();
+  json.SetObject();
+
+  json.AddMember("gameMap", serializeGameMapState(allocator, snapshot), allocator);
+  json.AddMember("player", serializePlayerState(allocator, snapshot.player), allocator);
+  json.AddMember("inGameTime", serializeInGameTime(allocator, snapshot), allocator);
+  json.AddMember("roomRentalTracker", serializeRoomRentalTrackerState(allocator, snapshot), allocator);
+  if (snapshot.rngSeed) {
+    json.AddMember("rngSeed", *snapshot.rngSeed, allocator);
+  }
+  return json;
 }
 
-void GameState::deserializePlayerState(const rapidjson::Value& obj) const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto &profile = gmMgr->getPlayer()->getCharacterProfile();
+bool GameState::fromJson(const rapidjson::Value& json, Snapshot& snapshot) {
+  auto isObject = [](const rapidjson::Value& obj, const char* key) {
+    return obj.HasMember(key) && obj[key].IsObject();
+  };
+
+  if (!json.IsObject() ||
+      !isObject(json, "gameMap") ||
+      !isObject(json, "player") ||
+      !isObject(json["player"], "inventory") ||
+      !isObject(json["player"], "party") ||
+      !isObject(json, "inGameTime") ||
+      !isObject(json, "roomRentalTracker")) {
+    return false;
+  }
 
-  rapidjson::Value inventoryJsonObject;
-  rapidjson::Value partyJsonObject;
+  snapshot = {};
+  deserializePlayerState(json["player"], snapshot.player);
+  deserializeGameMapState(json["gameMap"], snapshot);
+  deserializeInGameTime(json["inGameTime"], snapshot);
+  deserializeRoomRentalTrackerState(json["roomRentalTracker"], snapshot);
+  if (json.HasMember("rngSeed")) {
+    snapshot.rngSeed = json["rngSeed"].GetUint64();
+  }
+  return true;
+}
 
-  json_util::deserialize(obj,
-                         make_pair("name", &profile.name),
-                         make_pair("level", &profile.level),
-                         make_pair("exp", &profile.exp),
-                         make_pair("fullHealth", &profile.fullHealth),
-                         make_pair("fullStamina", &profile.fullStamina),
-                         make_pair("fullMagicka", &profile.fullMagicka),
-                         make_pair("health", &profile.health),
-                         make_pair("stamina", &profile.stamina),
-                         make_pair("magicka", &profile.magicka),
-                         make_pair("strength", &profile.strength),
-                         make_pair("dexterity", &profile.dexterity),
-                         make_pair("intelligence", &profile.intelligence),
-                         make_pair("luck", &profile.luck),
-                         make_pair("moveSpeed", &profile.moveSpeed),
-                         make_pair("jumpHeight", &profile.jumpHeight),
-                         make_pair("canDoubleJump", &profile.canDoubleJump),
-                         make_pair("attackForce", &profile.attackForce),
-                         make_pair("attackTime", &profile.attackTime),
-                         make_pair("attackRange", &profile.attackRange),
-                         make_pair("baseMeleeDamage", &profile.baseMeleeDamage),
-                         make_pair("inventory", &inventoryJsonObject),
-                         make_pair("party", &partyJsonObject));
-
-  deserializePlayerInventory(inventoryJsonObject);
-  deserializePlayerParty(partyJsonObject);
+bool GameState::write(const fs::path& saveFilePath, const Snapshot& snapshot, const Format format) {
+  VGPROFILE_ZONE("GameState::write");
+
+  const fs::path backupFilePath = getBackupFilePath(saveFilePath);
+
+  if (format == Format::JSON) {
+    const rapidjson::Document json = toJson(snapshot);
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+    json.Accept(writer);
+    return writeFileAtomically(saveFilePath, backupFilePath, buffer.GetString(), buffer.GetSize());
+  }
+
+  const string data = binary_save::encode(snapshot);
+  return writeFileAtomically(saveFilePath, backupFilePath, data.data(), data.size());
 }
 
-rapidjson::Value GameState::serializePlayerInventory() const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto player = gmMgr->getPlayer();
+bool GameState::read(const fs::path& saveFilePath, Snapshot& snapshot) {
+  VGPROFILE_ZONE("GameState::read");
 
-  map<string, int> itemMapper;
-  for (const auto& [itemJsonFilePath, item] : player->_items) {
-    itemMapper.insert(std::make_pair(itemJsonFilePath, item->getAmount()));
+  ifstream ifs{saveFilePath, ios::binary};
+  if (!ifs.is_open()) {
+    return false;
   }
+  const string data{istreambuf_iterator<char>{ifs}, istreambuf_iterator<char>{}};
 
-  vector<vector<string>> inventory(Item::Type::SIZE);
-  for (int type = 0; type < Item::Type::SIZE; type++) {
-    inventory[type].reserve(player->_inventory[type].size());
-    for (const auto item : player->_inventory[type]) {
-      inventory[type].push_back(item->getItemProfile().jsonFilePath);
+  if (binary_save::isBinarySave(data.data(), data.size())) {
+    snapshot = {};
+    if (!binary_save::decode(data, snapshot)) {
+      VGLOG(LOG_ERR, "Save file [%s] is corrupted.", saveFilePath.c_str());
+      return false;
     }
+    return true;
   }
 
-  vector<string> equipmentSlots;
-  equipmentSlots.reserve(Equipment::Type::SIZE);
-  for (int type = 0; type < Equipment::Type::SIZE; type++) {
-    Equipment* equipment = player->_equipmentSlots[type];
-    if (equipment) {
-      equipmentSlots.push_back(equipment->getItemProfile().jsonFilePath);
-    } else {
-      equipmentSlots.push_back("");
-    }
+  rapidjson::Document json;
+  json.Parse(data.data(), data.size());
+  if (json.HasParseError()) {
+    VGLOG(LOG_ERR, "Save file [%s] is corrupted at offset %zu.", saveFilePath.c_str(), json.GetErrorOffset());
+    return false;
   }
 
-  return json_util::serialize(_allocator,
-                              make_pair("itemMapper", itemMapper),
-                              make_pair("inventory", inventory),
-                              make_pair("equipmentSlots", equipmentSlots));
+  snapshot = {};
+  if (!fromJson(json, snapshot)) {
+    VGLOG(LOG_ERR, "Save file [%s] is incomplete.", saveFilePath.c_str());
+    return false;
+  }
+  return true;
 }
 
-void GameState::deserializePlayerInventory(const rapidjson::Value& obj) const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto player = gmMgr->getPlayer();
+bool GameState::readWithBackup(const fs::path& saveFilePath, Snapshot& snapshot, bool& isSaveFileRead) {
+  isSaveFileRead = read(saveFilePath, snapshot);
+  if (isSaveFileRead) {
+    return true;
+  }
 
-  map<string, int> itemMapper;
-  vector<vector<string>> inventory;
-  vector<string> equipmentSlots;
+  const fs::path backupFilePath = getBackupFilePath(saveFilePath);
+  VGLOG(LOG_WARN, "Failed to load save file [%s], loading its backup instead.", saveFilePath.c_str());
+  if (!read(backupFilePath, snapshot)) {
+    VGLOG(LOG_ERR, "Failed to load the backup save file [%s].", backupFilePath.c_str());
+    return false;
+  }
+  return true;
+}
 
+bool GameState::convert(const fs::path& inputFilePath, const fs::path& outputFilePath) {
+  Snapshot snapshot;
+  if (!read(inputFilePath, snapshot)) {
+    VGLOG(LOG_ERR, "Failed to read save file [%s].", inputFilePath.c_str());
+    return false;
+  }
+
+  const Format format = (outputFilePath.extension() == ".json") ? Format::JSON : Format::BINARY;
+  if (!write(outputFilePath, snapshot, format)) {
+    VGLOG(LOG_ERR, "Failed to write save file [%s].", outputFilePath.c_str());
+    return false;
+  }
+  return true;
+}
+
+fs::path GameState::getBackupFilePath(const fs::path& saveFilePath) {
+  fs::path backupFilePath = saveFilePath;
+  backupFilePath += ".bak";
+  return backupFilePath;
+}
+
+rapidjson::Value GameState::serializeGameMapState(AllocatorType& allocator, const Snapshot& snapshot) {
+  return json_util::serialize(allocator,
+                              make_pair("tmxTiledMapFilePath", snapshot.tmxTiledMapFilePath),
+                              make_pair("npcSpawningBlacklist", snapshot.npcSpawningBlacklist),
+                              make_pair("allPortalStates", snapshot.allOpenableObjectStates),
+                              make_pair("playerPos", snapshot.playerPos));
+}
+
+void GameState::deserializeGameMapState(const rapidjson::Value& obj, Snapshot& snapshot) {
+  json_util::deserialize(obj,
+                         make_pair("tmxTiledMapFilePath", &snapshot.tmxTiledMapFilePath),
+                         make_pair("npcSpawningBlacklist", &snapshot.npcSpawningBlacklist),
+                         make_pair("allPortalStates", &snapshot.allOpenableObjectStates),
+                         make_pair("playerPos", &snapshot.playerPos));
+}
+
+rapidjson::Value GameState::serializePlayerState(AllocatorType& allocator, const Snapshot::Player& player) {
+  return json_util::serialize(allocator,
+                              make_pair("name", player.name),
+                              make_pair("level", player.level),
+                              make_pair("exp", player.exp),
+                              make_pair("fullHealth", player.fullHealth),
+                              make_pair("fullStamina", player.fullStamina),
+                              make_pair("fullMagicka", player.fullMagicka),
+                              make_pair("health", player.health),
+                              make_pair("stamina", player.stamina),
+                              make_pair("magicka", player.magicka),
+                              make_pair("strength", player.strength),
+                              make_pair("dexterity", player.dexterity),
+                              make_pair("intelligence", player.intelligence),
+                              make_pair("luck", player.luck),
+                              make_pair("moveSpeed", player.moveSpeed),
+                              make_pair("jumpHeight", player.jumpHeight),
+                              make_pair("canDoubleJump", player.canDoubleJump),
+                              make_pair("attackForce", player.attackForce),
+                              make_pair("attackTime", player.attackTime),
+                              make_pair("attackRange", player.attackRange),
+                              make_pair("baseMeleeDamage", player.baseMeleeDamage),
+                              make_pair("inventory", serializePlayerInventory(allocator, player)),
+                              make_pair("party", serializePlayerParty(allocator, player)));
+}
+
+void GameState::deserializePlayerState(const rapidjson::Value& obj, Snapshot::Player& player) {
+  json_util::deserialize(obj,
+                         make_pair("name", &player.name),
+                         make_pair("level", &player.level),
+                         make_pair("exp", &player.exp),
+                         make_pair("fullHealth", &player.fullHealth),
+                         make_pair("fullStamina", &player.fullStamina),
+                         make_pair("fullMagicka", &player.fullMagicka),
+                         make_pair("health", &player.health),
+                         make_pair("stamina", &player.stamina),
+                         make_pair("magicka", &player.magicka),
+                         make_pair("strength", &player.strength),
+                         make_pair("dexterity", &player.dexterity),
+                         make_pair("intelligence", &player.intelligence),
+                         make_pair("luck", &player.luck),
+                         make_pair("moveSpeed", &player.moveSpeed),
+                         make_pair("jumpHeight", &player.jumpHeight),
+                         make_pair("canDoubleJump", &player.canDoubleJump),
+                         make_pair("attackForce", &player.attackForce),
+                         make_pair("attackTime", &player.attackTime),
+                         make_pair("attackRange", &player.attackRange),
+                         make_pair("baseMeleeDamage", &player.baseMeleeDamage));
+
+  deserializePlayerInventory(obj["inventory"], player);
+  deserializePlayerParty(obj["party"], player);
+}
+
+rapidjson::Value GameState::serializePlayerInventory(AllocatorType& allocator, const Snapshot::Player& player) {
+  return json_util::serialize(allocator,
+                              make_pair("itemMapper", player.itemMapper),
+                              make_pair("inventory", player.inventory),
+                              make_pair("equipmentSlots", player.equipmentSlots));
+}
+
+void GameState::deserializePlayerInventory(const rapidjson::Value& obj, Snapshot::Player& player) {
+  json_util::deserialize(obj,
+                         make_pair("itemMapper", &player.itemMapper),
+                         make_pair("inventory", &player.inventory),
+                         make_pair("equipmentSlots", &player.equipmentSlots));
+}
+
+rapidjson::Value GameState::serializePlayerParty(AllocatorType& allocator, const Snapshot::Player& player) {
+  vector<rapidjson::Value> waitingMembersLocationInfos;
+  for (const auto& member : player.waitingPartyMembers) {
+    auto obj = json_util::serialize(allocator,
+                                    make_pair("npcJsonFilePath", member.npcJsonFilePath),
+                                    make_pair("tmxMapFilePath", member.tmxMapFilePath),
+                                    make_pair("x", member.x),
+                                    make_pair("y", member.y));
+    waitingMembersLocationInfos.push_back(std::move(obj));
+  }
+
+  return json_util::serialize(allocator,
+                              make_pair("members", player.partyMembers),
+                              make_pair("waitingMembersLocationInfo", std::move(waitingMembersLocationInfos)));
+}
+
+void GameState::deserializePlayerParty(const rapidjson::Value& obj, Snapshot::Player& player) {
+  json_util::deserialize(obj, make_pair("members", &player.partyMembers));
+
+  for (const auto& locInfo : obj["waitingMembersLocationInfo"].GetArray()) {
+    Snapshot::WaitingPartyMember member;
+    json_util::deserialize(locInfo,
+        make_pair("npcJsonFilePath", &member.npcJsonFilePath),
+        make_pair("tmxMapFilePath", &member.tmxMapFilePath),
+        make_pair("x", &member.x),
+        make_pair("y", &member.y));
+    player.waitingPartyMembers.push_back(std::move(member));
+  }
+}
+
+rapidjson::Value GameState::serializeInGameTime(AllocatorType& allocator, const Snapshot& snapshot) {
+  return json_util::serialize(allocator,
+                              make_pair("hour", snapshot.hour),
+                              make_pair("minute", snapshot.minute),
+                              make_pair("second", snapshot.second),
+                              make_pair("secondsElapsed", snapshot.secondsElapsed),
+                              make_pair("deferredCmdsMinHeap", snapshot.deferredCmds));
+}
+
+void GameState::deserializeInGameTime(const rapidjson::Value& obj, Snapshot& snapshot) {
   json_util::deserialize(obj,
-                         make_pair("itemMapper", &itemMapper),
-                         make_pair("inventory", &inventory),
-                         make_pair("equipmentSlots", &equipmentSlots));
+                         make_pair("hour", &snapshot.hour),
+                         make_pair("minute", &snapshot.minute),
+                         make_pair("second", &snapshot.second),
+                         make_pair("secondsElapsed", &snapshot.secondsElapsed),
+                         make_pair("deferredCmdsMinHeap", &snapshot.deferredCmds));
+}
+
+rapidjson::Value GameState::serializeRoomRentalTrackerState(AllocatorType& allocator, const Snapshot& snapshot) {
+  return json_util::serialize(allocator,
+                              make_pair("checkedInInns", snapshot.checkedInInns));
+}
+
+void GameState::deserializeRoomRentalTrackerState(const rapidjson::Value& obj, Snapshot& snapshot) {
+  json_util::deserialize(obj, make_pair("checkedInInns", &snapshot.checkedInInns));
+}
+
+void GameState::applyGameMapState(const Snapshot& snapshot) {
+  // These must be applied before the saved game map is loaded,
+  // since they decide which NPCs are spawned and which portals are locked.
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  gmMgr->_npcSpawningBlacklist = snapshot.npcSpawningBlacklist;
+  gmMgr->_allOpenableObjectStates = snapshot.allOpenableObjectStates;
+}
+
+void GameState::showPlayerAndAllies(const string& tmxTiledMapFilePath, const pair<float, float>& playerPos) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto player = gmMgr->getPlayer();
+  player->setPosition(playerPos.first, playerPos.second);
+
+  const auto& playerParty = player->getParty();
+  for (const auto ally : player->getAllies()) {
+    const string& jsonFilePath = ally->getCharacterProfile().jsonFilePath;
+    if (auto waitLoc = playerParty->getWaitingMemberLocationInfo(jsonFilePath)) {
+      if (waitLoc->tmxMapFilePath == tmxTiledMapFilePath) {
+        ally->showOnMap(waitLoc->x * kPpm, waitLoc->y * kPpm);
+      }
+    } else {
+      ally->showOnMap(playerPos.first * kPpm, playerPos.second * kPpm);
+    }
+  }
+}
+
+void GameState::applyPlayerState(const Snapshot::Player& p) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto& profile = gmMgr->getPlayer()->getCharacterProfile();
+
+  profile.name = p.name;
+  profile.level = p.level;
+  profile.exp = p.exp;
+  profile.fullHealth = p.fullHealth;
+  profile.fullStamina = p.fullStamina;
+  profile.fullMagicka = p.fullMagicka;
+  profile.health = p.health;
+  profile.stamina = p.stamina;
+  profile.magicka = p.magicka;
+  profile.strength = p.strength;
+  profile.dexterity = p.dexterity;
+  profile.intelligence = p.intelligence;
+  profile.luck = p.luck;
+  profile.moveSpeed = p.moveSpeed;
+  profile.jumpHeight = p.jumpHeight;
+  profile.canDoubleJump = p.canDoubleJump;
+  profile.attackForce = p.attackForce;
+  profile.attackTime = p.attackTime;
+  profile.attackRange = p.attackRange;
+  profile.baseMeleeDamage = p.baseMeleeDamage;
+
+  applyPlayerInventory(p);
+  applyPlayerParty(p);
+}
+
+void GameState::applyPlayerInventory(const Snapshot::Player& p) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto player = gmMgr->getPlayer();
 
   for (int type = 0; type < Equipment::Type::SIZE; type++) {
     player->unequip(static_cast<Equipment::Type>(type), /*audio=*/false);
   }
 
   player->_items.clear();
-  for (const auto& [itemJsonFilePath, amount] : itemMapper) {
+  for (const auto& [itemJsonFilePath, amount] : p.itemMapper) {
     shared_ptr<Item> item = Item::create(itemJsonFilePath);
     item->setAmount(amount);
     player->_items.insert(make_pair(itemJsonFilePath, std::move(item)));
@@ -211,7 +597,10 @@ void GameState::deserializePlayerInventory(const rapidjson::Value& obj) const {
 
   for (int type = 0; type < Item::Type::SIZE; type++) {
     player->_inventory[type].clear();
-    for (const auto& itemJsonFilePath : inventory[type]) {
+    if (static_cast<size_t>(type) >= p.inventory.size()) {
+      continue;
+    }
+    for (const auto& itemJsonFilePath : p.inventory[type]) {
       auto it = player->_items.find(itemJsonFilePath);
       if (it == player->_items.end()) {
         VGLOG(LOG_ERR, "Failed to find [%s] in player's itemMapper.", itemJsonFilePath.c_str());
@@ -222,7 +611,7 @@ void GameState::deserializePlayerInventory(const rapidjson::Value& obj) const {
   }
 
   for (int type = 0; type < Equipment::Type::SIZE; type++) {
-    const auto& equipmentJsonFilePath = equipmentSlots[type];
+    const string equipmentJsonFilePath = (static_cast<size_t>(type) < p.equipmentSlots.size()) ? p.equipmentSlots[type] : "";
     if (equipmentJsonFilePath == "") {
       player->_equipmentSlots[type] = nullptr;
       continue;
@@ -242,107 +631,34 @@ void GameState::deserializePlayerInventory(const rapidjson::Value& obj) const {
   }
 }
 
-rapidjson::Value GameState::serializePlayerParty() const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto player = gmMgr->getPlayer();
-
-  list<string> alliesProfilesFilePaths;
-  for (const auto &member : player->getParty()->getMembers()) {
-    alliesProfilesFilePaths.push_back(member->getCharacterProfile().jsonFilePath);
-  }
-  auto alliesJsonObject
-    = json_util::makeJsonObject(_allocator, alliesProfilesFilePaths);
-
-  vector<rapidjson::Value> waitingMembersLocationInfos;
-  for (const auto& [npcJsonFilePath, locInfo] : player->getParty()->getWaitingMembersLocationInfos()) {
-    auto obj = json_util::serialize(_allocator,
-                                    make_pair("npcJsonFilePath", npcJsonFilePath),
-                                    make_pair("tmxMapFilePath", locInfo.tmxMapFilePath),
-                                    make_pair("x", locInfo.x),
-                                    make_pair("y", locInfo.y));
-    waitingMembersLocationInfos.push_back(std::move(obj));
-  }
-
-  return json_util::serialize(_allocator,
-                              make_pair("members", std::move(alliesJsonObject)),
-                              make_pair("waitingMembersLocationInfo", std::move(waitingMembersLocationInfos)));
-}
-
-void GameState::deserializePlayerParty(const rapidjson::Value& obj) const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+void GameState::applyPlayerParty(const Snapshot::Player& p) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   auto playerParty = gmMgr->getPlayer()->getParty();
 
-  list<string> alliesProfilesFilePaths;
-  json_util::deserialize(obj, make_pair("members", &alliesProfilesFilePaths));
-
   playerParty->dismissAll(/*addToMap=*/false);
-  for (const auto& jsonFilePath : alliesProfilesFilePaths) {
+  for (const auto& jsonFilePath : p.partyMembers) {
     playerParty->addMember(std::make_shared<Npc>(jsonFilePath));
   }
 
-  list<rapidjson::Value> waitingMembersLocationInfo;
-  json_util::deserialize(obj,
-      make_pair("waitingMembersLocationInfo", &waitingMembersLocationInfo));
-
   playerParty->_waitingMembersLocationInfos.clear();
-  for (const auto& locInfo : waitingMembersLocationInfo) {
-    string npcJsonFilePath;
-    Party::WaitingLocationInfo info;
-    json_util::deserialize(locInfo,
-        make_pair("npcJsonFilePath", &npcJsonFilePath),
-        make_pair("tmxMapFilePath", &info.tmxMapFilePath),
-        make_pair("x", &info.x),
-        make_pair("y", &info.y));
-    playerParty->_waitingMembersLocationInfos.insert(make_pair(npcJsonFilePath, info));
+  for (const auto& member : p.waitingPartyMembers) {
+    Party::WaitingLocationInfo info{member.tmxMapFilePath, member.x, member.y};
+    playerParty->_waitingMembersLocationInfos.insert(make_pair(member.npcJsonFilePath, info));
   }
 }
 
-rapidjson::Value GameState::serializeInGameTime() const {
-  auto inGameTime = SceneManager::the().getCurrentScene<GameScene>()->getInGameTime();
-
-  return json_util::serialize(_allocator,
-                              make_pair("hour", inGameTime->getHour()),
-                              make_pair("minute", inGameTime->getMinute()),
-                              make_pair("second", inGameTime->getSecond()),
-                              make_pair("secondsElapsed", inGameTime->getSecondsElapsed()),
-                              make_pair("deferredCmdsMinHeap", inGameTime->getDeferredCmdsMinHeap()));
+void GameState::applyInGameTime(const Snapshot& snapshot) {
+  auto inGameTime = ServiceRegistry::get<InGameTime>();
+  inGameTime->setHour(snapshot.hour);
+  inGameTime->setMinute(snapshot.minute);
+  inGameTime->setSecond(snapshot.second);
+  inGameTime->setSecondsElapsed(snapshot.secondsElapsed);
+  inGameTime->setDeferredCmds(snapshot.deferredCmds);
 }
 
-void GameState::deserializeInGameTime(const rapidjson::Value& obj) const {
-  int hour{};
-  int minute{};
-  int second{};
-  uint64_t secondsElapsed{};
-  vector<InGameTime::DeferredCmd> deferredCmdsMinHeap;
-
-  json_util::deserialize(obj,
-                         make_pair("hour", &hour),
-                         make_pair("minute", &minute),
-                         make_pair("second", &second),
-                         make_pair("secondsElapsed", &secondsElapsed),
-                         make_pair("deferredCmdsMinHeap", &deferredCmdsMinHeap));
-
-  auto inGameTime = SceneManager::the().getCurrentScene<GameScene>()->getInGameTime();
-  inGameTime->setHour(hour);
-  inGameTime->setMinute(minute);
-  inGameTime->setSecond(second);
-  inGameTime->setSecondsElapsed(secondsElapsed);
-  inGameTime->setdDeferredCmdsMinHeap(std::move(deferredCmdsMinHeap));
-}
-
-rapidjson::Value GameState::serializeRoomRentalTrackerState() const {
-  auto roomRentalTracker = SceneManager::the().getCurrentScene<GameScene>()->getRoomRentalTracker();
-
-  return json_util::serialize(_allocator,
-                              make_pair("checkedInInns", roomRentalTracker->getCheckedInInns()));
-}
-
-void GameState::deserializeRoomRentalTrackerState(const rapidjson::Value& obj) const {
-  unordered_set<string> checkedInInns;
-
-  json_util::deserialize(obj, make_pair("checkedInInns", &checkedInInns));
-
-  auto roomRentalTracker = SceneManager::the().getCurrentScene<GameScene>()->getRoomRentalTracker();
+void GameState::applyRoomRentalTrackerState(const Snapshot& snapshot) {
+  unordered_set<string> checkedInInns = snapshot.checkedInInns;
+  auto roomRentalTracker = ServiceRegistry::get<RoomRentalTracker>();
   roomRentalTracker->setCheckedInInns(std::move(checkedInInns));
 }
 
@@ -3,7 +3,17 @@
 #ifndef VIGILANTE_GAMEPLAY_GAME_STATE_H_
 #define VIGILANTE_GAMEPLAY_GAME_STATE_H_
 
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <list>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <rapidjson/document.h>
 
@@ -11,39 +21,159 @@ namespace fs = std::filesystem;
 
 namespace vigilante {
 
+// Saving is done in two phases:
+// (1) capture(): copies everything that's saved into a Snapshot on the main thread.
+// (2) the snapshot is serialized and written on a background thread, first to
+//     a temporary file, which is fsync'ed and then renamed over the save file,
+//     so a crash in the middle of saving never leaves a partially written save.
+//
+// The previous save file is kept as a backup (*.bak), which is loaded instead
+// if the save file is missing or corrupted.
+//
+// The changes made after saving or loading are autosaved to the save file's
+// journal (see gameplay/SaveJournal.h), which is replayed on top of it when loaded.
 class GameState final {
  public:
-  explicit GameState(const fs::path& saveFilePath)
-    : _saveFilePath{saveFilePath},
-      _allocator{_json.GetAllocator()} {}
-
-  void save();
-  void load();
+  // A plain copy of the game state, which doesn't reference any live object.
+  struct Snapshot final {
+    struct WaitingPartyMember final {
+      std::string npcJsonFilePath;
+      std::string tmxMapFilePath;
+      float x;
+      float y;
+
+      bool operator==(const WaitingPartyMember&) const = default;
+    };
+
+    struct Player final {
+      // The saved fields of Character::Profile.
+      std::string name;
+      int level;
+      int exp;
+      int fullHealth;
+      int fullStamina;
+      int fullMagicka;
+      int health;
+      int stamina;
+      int magicka;
+      int strength;
+      int dexterity;
+      int intelligence;
+      int luck;
+      float moveSpeed;
+      float jumpHeight;
+      bool canDoubleJump;
+      float attackForce;
+      float attackTime;
+      float attackRange;
+      int baseMeleeDamage;
+
+      std::map<std::string, int> itemMapper;  // <itemJsonFilePath, amount>
+      std::vector<std::vector<std::string>> inventory;  // item json file paths per Item::Type
+      std::vector<std::string> equipmentSlots;  // per Equipment::Type, empty if unequipped
+      std::list<std::string> partyMembers;
+      std::vector<WaitingPartyMember> waitingPartyMembers;
+
+      bool operator==(const Player&) const = default;
+    };
+
+    // Game map.
+    std::string tmxTiledMapFilePath;
+    std::unordered_set<std::string> npcSpawningBlacklist;
+    std::unordered_map<std::string, bool> allOpenableObjectStates;
+    std::pair<float, float> playerPos;
+
+    Player player;
+
+    // In-game time.
+    int hour;
+    int minute;
+    int second;
+    uint64_t secondsElapsed;
+    std::vector<std::pair<uint64_t, std::string>> deferredCmds;
+
+    std::unordered_set<std::string> checkedInInns;
+    std::optional<uint64_t> rngSeed;  // older save files don't have it
+
+    bool operator==(const Snapshot&) const = default;
+  };
+
+  enum class Format {
+    BINARY,  // see gameplay/BinarySave.h
+    JSON,  // for debugging
+  };
+
+  // Called on the main thread once the save file has been written (or has failed to).
+  using OnSaved = std::function<void (const bool success)>;
+
+  explicit GameState(const fs::path& saveFilePath) : _saveFilePath{saveFilePath} {}
+
+  // Returns right after the snapshot is captured.
+  void save(OnSaved onSaved = nullptr);
+  // Waits for the pending saves (if any) to finish first. The saved game map
+  // is loaded asynchronously, and the player is created along with it if
+  // there isn't one yet (i.e., when continuing from the main menu).
+  // @return false if neither the save file nor its backup can be loaded.
+  bool load();
+
+  // @param includeJournaledState: false to leave out the state which
+  //                               SaveJournal journals as it changes.
+  static Snapshot capture(const bool includeJournaledState = true);
+  // Loads the saved game map, which is asynchronous.
+  // @param afterApplying: called once the whole snapshot has been applied (optional).
+  static void apply(const Snapshot& snapshot, const std::function<void ()>& afterApplying = []() {});
+
+  static rapidjson::Document toJson(const Snapshot& snapshot);
+  // @return false if `json` isn't a (complete) save.
+  static bool fromJson(const rapidjson::Value& json, Snapshot& snapshot);
+
+  // Writes `snapshot` to `saveFilePath` atomically. Thread-safe.
+  static bool write(const fs::path& saveFilePath, const Snapshot& snapshot, const Format format = Format::BINARY);
+  // Reads a save file of either format.
+  // @return false if `saveFilePath` can't be read or is corrupted.
+  static bool read(const fs::path& saveFilePath, Snapshot& snapshot);
+  // Reads `saveFilePath`, or its backup if it's missing or corrupted (e.g., truncated).
+  // @param isSaveFileRead: set to whether `saveFilePath` itself has been read.
+  // @return false if neither can be read.
+  static bool readWithBackup(const fs::path& saveFilePath, Snapshot& snapshot, bool& isSaveFileRead);
+  // Converts a save file of either format into json if `outputFilePath` ends with .json,
+  // or into binary otherwise.
+  static bool convert(const fs::path& inputFilePath, const fs::path& outputFilePath);
+
+  static fs::path getBackupFilePath(const fs::path& saveFilePath);
 
   inline const fs::path& getSaveFilePath() const { return _saveFilePath; }
 
  private:
-  rapidjson::Value serializeGameMapState() const;
-  void deserializeGameMapState(const rapidjson::Value& obj) const;
+  using AllocatorType = rapidjson::Document::AllocatorType;
+
+  static rapidjson::Value serializeGameMapState(AllocatorType& allocator, const Snapshot& snapshot);
+  static void deserializeGameMapState(const rapidjson::Value& obj, Snapshot& snapshot);
+
+  static rapidjson::Value serializePlayerState(AllocatorType& allocator, const Snapshot::Player& player);
+  static void deserializePlayerState(const rapidjson::Value& obj, Snapshot::Player& player);
 
-  rapidjson::Value serializePlayerState() const;
-  void deserializePlayerState(const rapidjson::Value& obj) const;
+  static rapidjson::Value serializePlayerInventory(AllocatorType& allocator, const Snapshot::Player& player);
+  static void deserializePlayerInventory(const rapidjson::Value& obj, Snapshot::Player& player);
 
-  rapidjson::Value serializePlayerInventory() const;
-  void deserializePlayerInventory(const rapidjson::Value& obj) const;
+  static rapidjson::Value serializePlayerParty(AllocatorType& allocator, const Snapshot::Player& player);
+  static void deserializePlayerParty(const rapidjson::Value& obj, Snapshot::Player& player);
 
-  rapidjson::Value serializePlayerParty() const;
-  void deserializePlayerParty(const rapidjson::Value& obj) const;
+  static rapidjson::Value serializeInGameTime(AllocatorType& allocator, const Snapshot& snapshot);
+  static void deserializeInGameTime(const rapidjson::Value& obj, Snapshot& snapshot);
 
-  rapidjson::Value serializeInGameTime() const;
-  void deserializeInGameTime(const rapidjson::Value& obj) const;
+  static rapidjson::Value serializeRoomRentalTrackerState(AllocatorType& allocator, const Snapshot& snapshot);
+  static void deserializeRoomRentalTrackerState(const rapidjson::Value& obj, Snapshot& snapshot);
 
-  rapidjson::Value serializeRoomRentalTrackerState() const;
-  void deserializeRoomRentalTrackerState(const rapidjson::Value& obj) const;
+  static void applyGameMapState(const Snapshot& snapshot);
+  static void showPlayerAndAllies(const std::string& tmxTiledMapFilePath, const std::pair<float, float>& playerPos);
+  static void applyPlayerState(const Snapshot::Player& player);
+  static void applyPlayerInventory(const Snapshot::Player& player);
+  static void applyPlayerParty(const Snapshot::Player& player);
+  static void applyInGameTime(const Snapshot& snapshot);
+  static void applyRoomRentalTrackerState(const Snapshot& snapshot);
 
   const fs::path _saveFilePath;
-  rapidjson::Document _json;
-  rapidjson::Document::AllocatorType& _allocator;
 };
 
 }  // namespace vigilante
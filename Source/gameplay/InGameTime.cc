@@ -5,7 +5,8 @@
 #include <algorithm>
 
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
+#include "util/Profiler.h"
 
 using namespace std;
 
@@ -16,6 +17,8 @@ InGameTime::InGameTime() {
 }
 
 void InGameTime::update(const float delta) {
+  VGPROFILE_ZONE("InGameTime::update");
+
   updateTime(delta);
   executeCallbacks();
 }
@@ -33,40 +36,191 @@ void InGameTime::updateTime(const float delta) {
 
 void InGameTime::fastForward(const int hourDelta, const int minuteDelta, const int secondDelta) {
   const int totalSecondDelta = hourDelta * 3600 + minuteDelta * 60 + secondDelta;
-  _secondsElapsed += totalSecondDelta;
-  _second += totalSecondDelta;
-  while (_second > 59) {
-    _minute++;
-    _second -= 60;
-  }
-  while (_minute > 59) {
-    _hour++;
-    _minute -= 60;
+  if (totalSecondDelta <= 0) {
+    return;
   }
-  while (_hour > 23) {
-    _hour -= 24;
+
+  // Jump from one due event to the next instead of stepping through the time in between.
+  const uint64_t secondsElapsedRequired = _secondsElapsed + totalSecondDelta;
+  for (uint64_t due = getNextDueSecondsElapsed(); due <= secondsElapsedRequired; due = getNextDueSecondsElapsed()) {
+    advance((due > _secondsElapsed) ? due - _secondsElapsed : 0);
+    executeCallbacks();
   }
+  advance(secondsElapsedRequired - _secondsElapsed);
+}
+
+void InGameTime::advance(const uint64_t seconds) {
+  _secondsElapsed += seconds;
+
+  const uint64_t secondOfDay = (getSecondOfDay() + seconds) % kSecondsPerDay;
+  _hour = secondOfDay / 3600;
+  _minute = secondOfDay / 60 % 60;
+  _second = secondOfDay % 60;
 }
 
 void InGameTime::runAfter(const int hours, const int minutes, const int seconds, const string& cmd) {
   const uint64_t timestamp = _secondsElapsed + seconds + 60 * minutes + 3600 * hours;
 
-  _deferredCmdsMinHeap.emplace_back(timestamp, cmd);
+  _deferredCmdsMinHeap.push_back({timestamp, cmd, CommandHandler::compile(cmd)});
   std::push_heap(_deferredCmdsMinHeap.begin(), _deferredCmdsMinHeap.end(), cmdsMinHeapCmp);
 }
 
+InGameTime::SubscriptionId InGameTime::subscribeAfter(const int hours, const int minutes, const int seconds,
+                                                      Callback&& callback) {
+  const uint64_t delay = std::max(hours * 3600 + minutes * 60 + seconds, 0);
+  return subscribe({std::move(callback), _secondsElapsed + delay, 0, -1});
+}
+
+InGameTime::SubscriptionId InGameTime::subscribeEvery(const int hours, const int minutes, const int seconds,
+                                                      Callback&& callback) {
+  const uint64_t period = std::max(hours * 3600 + minutes * 60 + seconds, 1);
+  return subscribe({std::move(callback), _secondsElapsed + period, period, -1});
+}
+
+InGameTime::SubscriptionId InGameTime::subscribeDailyAt(const int hour, const int minute, Callback&& callback) {
+  int64_t secondOfDay = (hour * 3600 + minute * 60) % static_cast<int64_t>(kSecondsPerDay);
+  if (secondOfDay < 0) {
+    secondOfDay += kSecondsPerDay;
+  }
+  return subscribe({std::move(callback), _secondsElapsed + getSecondsUntil(secondOfDay), kSecondsPerDay, secondOfDay});
+}
+
+void InGameTime::cancel(const SubscriptionId id) {
+  // Its entry in the min-heap is skipped when popped.
+  _subscriptions.erase(id);
+}
+
+InGameTime::SubscriptionId InGameTime::subscribe(Subscription&& subscription) {
+  const SubscriptionId id = _nextSubscriptionId++;
+  const uint64_t secondsElapsedRequired = subscription.secondsElapsedRequired;
+  _subscriptions.emplace(id, std::move(subscription));
+  schedule(id, secondsElapsedRequired);
+  return id;
+}
+
+void InGameTime::schedule(const SubscriptionId id, const uint64_t secondsElapsedRequired) {
+  _subscriptionsMinHeap.push_back({secondsElapsedRequired, id});
+  std::push_heap(_subscriptionsMinHeap.begin(), _subscriptionsMinHeap.end(), subscriptionsMinHeapCmp);
+}
+
+void InGameTime::rescheduleDailySubscriptions() {
+  for (auto& [id, subscription] : _subscriptions) {
+    if (subscription.secondOfDay >= 0) {
+      subscription.secondsElapsedRequired = _secondsElapsed + getSecondsUntil(subscription.secondOfDay);
+      schedule(id, subscription.secondsElapsedRequired);
+    }
+  }
+}
+
+uint64_t InGameTime::getNextDueSecondsElapsed() const {
+  uint64_t due = UINT64_MAX;
+  if (!_deferredCmdsMinHeap.empty()) {
+    due = _deferredCmdsMinHeap.front().secondsElapsedRequired;
+  }
+  if (!_subscriptionsMinHeap.empty()) {
+    due = std::min(due, _subscriptionsMinHeap.front().secondsElapsedRequired);
+  }
+  return due;
+}
+
+uint64_t InGameTime::getSecondsUntil(const int64_t secondOfDay) const {
+  // In (0, kSecondsPerDay], i.e. if it's that time now, then it's a day later.
+  const int64_t delta = (secondOfDay - getSecondOfDay()) % static_cast<int64_t>(kSecondsPerDay);
+  return (delta > 0) ? delta : delta + kSecondsPerDay;
+}
+
+void InGameTime::setHour(const int hour) {
+  _hour = hour;
+  rescheduleDailySubscriptions();
+}
+
+void InGameTime::setMinute(const int minute) {
+  _minute = minute;
+  rescheduleDailySubscriptions();
+}
+
+void InGameTime::setSecond(const int second) {
+  _second = second;
+  rescheduleDailySubscriptions();
+}
+
+void InGameTime::setSecondsElapsed(const uint64_t secondsElapsed) {
+  _secondsElapsed = secondsElapsed;
+  rescheduleDailySubscriptions();
+}
+
+vector<InGameTime::DeferredCmd> InGameTime::getDeferredCmds() const {
+  vector<DeferredCmd> deferredCmds;
+  deferredCmds.reserve(_deferredCmdsMinHeap.size());
+  for (const auto& deferredCmd : _deferredCmdsMinHeap) {
+    deferredCmds.emplace_back(deferredCmd.secondsElapsedRequired, deferredCmd.cmd);
+  }
+  return deferredCmds;
+}
+
+void InGameTime::setDeferredCmds(const vector<DeferredCmd>& deferredCmds) {
+  _deferredCmdsMinHeap.clear();
+  for (const auto& [secondsElapsedRequired, cmd] : deferredCmds) {
+    _deferredCmdsMinHeap.push_back({secondsElapsedRequired, cmd, CommandHandler::compile(cmd)});
+  }
+  std::make_heap(_deferredCmdsMinHeap.begin(), _deferredCmdsMinHeap.end(), cmdsMinHeapCmp);
+}
+
 void InGameTime::executeCallbacks() {
-  while (_deferredCmdsMinHeap.size()) {
-    const auto& [secondsElapsedRequired, cmd] = _deferredCmdsMinHeap.front();
-    if (secondsElapsedRequired > _secondsElapsed) {
+  while (true) {
+    const bool hasDueCmd = !_deferredCmdsMinHeap.empty() &&
+                           _deferredCmdsMinHeap.front().secondsElapsedRequired <= _secondsElapsed;
+    const bool hasDueSubscription = !_subscriptionsMinHeap.empty() &&
+                                    _subscriptionsMinHeap.front().secondsElapsedRequired <= _secondsElapsed;
+    if (!hasDueCmd && !hasDueSubscription) {
       return;
     }
 
-    auto console = SceneManager::the().getCurrentScene<GameScene>()->getConsole();
-    console->executeCmd(cmd);
+    if (hasDueCmd && (!hasDueSubscription ||
+                      _deferredCmdsMinHeap.front().secondsElapsedRequired <=
+                      _subscriptionsMinHeap.front().secondsElapsedRequired)) {
+      // Pop it before executing it, since the cmd itself may defer another cmd.
+      std::pop_heap(_deferredCmdsMinHeap.begin(), _deferredCmdsMinHeap.end(), cmdsMinHeapCmp);
+      const CompiledDeferredCmd deferredCmd = std::move(_deferredCmdsMinHeap.back());
+      _deferredCmdsMinHeap.pop_back();
+
+      auto console = ServiceRegistry::get<Console>();
+      console->executeCmd(deferredCmd.compiledCmd);
+      continue;
+    }
+
+    std::pop_heap(_subscriptionsMinHeap.begin(), _subscriptionsMinHeap.end(), subscriptionsMinHeapCmp);
+    const ScheduledSubscription scheduled = _subscriptionsMinHeap.back();
+    _subscriptionsMinHeap.pop_back();
+
+    auto it = _subscriptions.find(scheduled.id);
+    if (it == _subscriptions.end() ||
+        it->second.secondsElapsedRequired != scheduled.secondsElapsedRequired) {
+      continue;  // cancelled or rescheduled
+    }
+
+    Subscription& subscription = it->second;
+    const uint64_t period = subscription.period;
+    if (period) {
+      subscription.secondsElapsedRequired += period;
+      schedule(scheduled.id, subscription.secondsElapsedRequired);
+    }
+
+    // It's already running, i.e. its callback has fast forwarded the time.
+    if (!subscription.callback) {
+      continue;
+    }
 
-    std::pop_heap(_deferredCmdsMinHeap.begin(), _deferredCmdsMinHeap.end(), cmdsMinHeapCmp);
-    _deferredCmdsMinHeap.pop_back();
+    // Move the callback out while it's running, so it can cancel itself.
+    Callback callback = std::move(subscription.callback);
+    if (!period) {
+      _subscriptions.erase(it);
+    }
+    callback(scheduled.id);
+
+    if (period && (it = _subscriptions.find(scheduled.id)) != _subscriptions.end()) {
+      it->second.callback = std::move(callback);
+    }
   }
 }
 
@@ -3,14 +3,35 @@
 #ifndef VIGILANTE_GAMEPLAY_IN_GAME_TIME_H_
 #define VIGILANTE_GAMEPLAY_IN_GAME_TIME_H_
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "ui/console/CommandHandler.h"
+#include "util/ds/SmallFunction.h"
+
 namespace vigilante {
 
+// The in-game clock, plus two kinds of events scheduled against it:
+//
+// (1) Deferred cmds, which are saved along with the game (e.g. checking out
+//     of an inn the next day).
+// (2) Subscriptions, i.e. one-shot, periodic and daily callbacks, which
+//     aren't saved, so their owners should subscribe again when they're
+//     created (e.g. the phases of the day in Lighting).
+//
+// Both are kept in min-heaps keyed by `_secondsElapsed`. Fast forwarding
+// jumps from one due event to the next, so an 8-hour rest costs O(events)
+// rather than O(seconds). The clock is set to each event's due time before
+// it fires.
 class InGameTime final {
  public:
+  // <secondsElapsedRequired, cmd>, which is how deferred cmds are saved.
   using DeferredCmd = std::pair<uint64_t, std::string>;
+  using SubscriptionId = uint64_t;
+  using Callback = SmallFunction<void (const SubscriptionId id)>;
 
   InGameTime();
 
@@ -18,6 +39,13 @@ class InGameTime final {
   void fastForward(const int hourDelta, const int minuteDelta, const int secondDelta);
   void runAfter(const int hours, const int minutes, const int seconds, const std::string& cmd);
 
+  // Subscriptions. The returned id is never 0, and cancelling a subscription
+  // which has already fired (or been cancelled) is a no-op.
+  SubscriptionId subscribeAfter(const int hours, const int minutes, const int seconds, Callback&& callback);
+  SubscriptionId subscribeEvery(const int hours, const int minutes, const int seconds, Callback&& callback);
+  SubscriptionId subscribeDailyAt(const int hour, const int minute, Callback&& callback);
+  void cancel(const SubscriptionId id);
+
   inline bool isDawn() const { return _hour >= 5 && _hour <= 6; }
   inline bool isDay() const { return _hour > 6 && _hour < 18; }
   inline bool isDusk() const { return _hour >= 18 && _hour <= 19; }
@@ -27,17 +55,17 @@ class InGameTime final {
   inline int getMinute() const { return _minute; }
   inline int getSecond() const { return _second; }
   inline uint64_t getSecondsElapsed() const { return _secondsElapsed; }
-  inline const std::vector<DeferredCmd>& getDeferredCmdsMinHeap() const { return _deferredCmdsMinHeap; }
-
-  inline void setHour(const int hour) { _hour = hour; }
-  inline void setMinute(const int minute) { _minute = minute; }
-  inline void setSecond(const int second) { _second = second; }
-  inline void setSecondsElapsed(const uint64_t secondsElapsed) { _secondsElapsed = secondsElapsed; }
-  inline void setdDeferredCmdsMinHeap(std::vector<DeferredCmd>&& deferredCmdsMinHeap) {
-    _deferredCmdsMinHeap = std::move(deferredCmdsMinHeap);
-  }
+  std::vector<DeferredCmd> getDeferredCmds() const;
+
+  // These reschedule the daily subscriptions.
+  void setHour(const int hour);
+  void setMinute(const int minute);
+  void setSecond(const int second);
+  void setSecondsElapsed(const uint64_t secondsElapsed);
+  void setDeferredCmds(const std::vector<DeferredCmd>& deferredCmds);
 
   static constexpr int kTimeScale = 20;
+  static constexpr uint64_t kSecondsPerDay = 24 * 3600;
 
   // Dawn: [05:00, 06:59]
   static constexpr int kDawnBeginHour = 5;
@@ -48,11 +76,42 @@ class InGameTime final {
   static constexpr int kDuskEndHour = 20;
 
  private:
+  struct CompiledDeferredCmd final {
+    uint64_t secondsElapsedRequired;
+    std::string cmd;
+    CompiledCmd compiledCmd;
+  };
+
+  struct Subscription final {
+    Callback callback;
+    uint64_t secondsElapsedRequired;
+    uint64_t period;  // 0 if it's one-shot
+    int64_t secondOfDay;  // -1 if it's not daily
+  };
+
+  // A subscription's entry in the min-heap. Cancelled or rescheduled subscriptions
+  // leave their entries behind, and they are skipped when popped.
+  struct ScheduledSubscription final {
+    uint64_t secondsElapsedRequired;
+    SubscriptionId id;
+  };
+
   void updateTime(const float delta);
+  void advance(const uint64_t seconds);
   void executeCallbacks();
+  SubscriptionId subscribe(Subscription&& subscription);
+  void schedule(const SubscriptionId id, const uint64_t secondsElapsedRequired);
+  void rescheduleDailySubscriptions();
+  uint64_t getNextDueSecondsElapsed() const;
+  uint64_t getSecondsUntil(const int64_t secondOfDay) const;
+  inline int64_t getSecondOfDay() const { return _hour * 3600 + _minute * 60 + _second; }
+
+  static constexpr bool cmdsMinHeapCmp(const CompiledDeferredCmd& c1, const CompiledDeferredCmd& c2) {
+    return c1.secondsElapsedRequired > c2.secondsElapsedRequired;
+  }
 
-  static constexpr bool cmdsMinHeapCmp(const DeferredCmd& p1, const DeferredCmd& p2) {
-    return p1.first > p2.first;
+  static constexpr bool subscriptionsMinHeapCmp(const ScheduledSubscription& s1, const ScheduledSubscription& s2) {
+    return s1.secondsElapsedRequired > s2.secondsElapsedRequired;
   }
 
   float _updateDeltaThreshold{1.0f / kTimeScale};
@@ -67,7 +126,11 @@ class InGameTime final {
   uint64_t _secondsElapsed{};
 
   // The vector of cmds to be executed after a specific value of `_secondsElapsed`.
-  std::vector<DeferredCmd> _deferredCmdsMinHeap;
+  std::vector<CompiledDeferredCmd> _deferredCmdsMinHeap;
+
+  std::unordered_map<SubscriptionId, Subscription> _subscriptions;
+  std::vector<ScheduledSubscription> _subscriptionsMinHeap;
+  SubscriptionId _nextSubscriptionId{1};
 };
 
 }  // namespace vigilante
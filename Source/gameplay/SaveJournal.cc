@@ -0,0 +1,409 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "SaveJournal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include "gameplay/BinarySave.h"
+#include "gameplay/SaveWorker.h"
+#include "util/ByteUtil.h"
+#include "util/Logger.h"
+#include "util/Profiler.h"
+
+using namespace std;
+
+namespace vigilante {
+
+namespace {
+
+constexpr char kMagic[4] = {'V', 'G', 'S', 'J'};
+constexpr uint32_t kVersion = 1;
+
+using byte_util::Reader;
+using byte_util::Writer;
+
+bool readFile(const fs::path& filePath, string& data) {
+  ifstream ifs{filePath, ios::binary};
+  if (!ifs.is_open()) {
+    return false;
+  }
+  data.assign(istreambuf_iterator<char>{ifs}, istreambuf_iterator<char>{});
+  return !ifs.bad();
+}
+
+// The id of a save file is the hash of its content.
+bool getBaseId(const fs::path& saveFilePath, uint64_t& baseId) {
+  string data;
+  if (!readFile(saveFilePath, data)) {
+    return false;
+  }
+  baseId = byte_util::fnv1a64(data);
+  return true;
+}
+
+bool appendToFile(const fs::path& filePath, const string& data) {
+  FILE* file = std::fopen(filePath.string().c_str(), "ab");
+  if (!file) {
+    return false;
+  }
+  bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size() && std::fflush(file) == 0 && syncFile(file);
+  ok = (std::fclose(file) == 0) && ok;
+  return ok;
+}
+
+template <typename Container>
+void eraseValue(Container& c, const typename Container::value_type& value) {
+  c.erase(std::remove(c.begin(), c.end(), value), c.end());
+}
+
+}  // namespace
+
+SaveJournal& SaveJournal::the() {
+  static SaveJournal instance;
+  return instance;
+}
+
+void SaveJournal::open(const fs::path& saveFilePath) {
+  _saveFilePath = saveFilePath;
+  _pendingRecords.clear();
+}
+
+void SaveJournal::close() {
+  _saveFilePath.clear();
+  _pendingRecords.clear();
+}
+
+void SaveJournal::recordItem(const string& itemJsonFilePath, const int itemType,
+                             const optional<int> amount, const bool isInInventory) {
+  if (!isOpen()) {
+    return;
+  }
+  Writer writer;
+  writer.writeString(itemJsonFilePath);
+  writer.writeVarint(itemType);
+  writer.writeU8(amount.has_value());
+  writer.writeVarint(std::max(0, amount.value_or(0)));
+  writer.writeU8(isInInventory);
+  appendRecord(_pendingRecords, RecordType::ITEM, writer.getBuffer());
+}
+
+void SaveJournal::recordEquipmentSlot(const int equipmentType, const string& itemJsonFilePath) {
+  if (!isOpen()) {
+    return;
+  }
+  Writer writer;
+  writer.writeVarint(equipmentType);
+  writer.writeString(itemJsonFilePath);
+  appendRecord(_pendingRecords, RecordType::EQUIPMENT_SLOT, writer.getBuffer());
+}
+
+void SaveJournal::recordPartyMember(const string& npcJsonFilePath, const bool isMember) {
+  if (!isOpen()) {
+    return;
+  }
+  Writer writer;
+  writer.writeString(npcJsonFilePath);
+  writer.writeU8(isMember);
+  appendRecord(_pendingRecords, RecordType::PARTY_MEMBER, writer.getBuffer());
+}
+
+void SaveJournal::recordWaitingPartyMember(const string& npcJsonFilePath,
+                                           const optional<GameState::Snapshot::WaitingPartyMember>& member) {
+  if (!isOpen()) {
+    return;
+  }
+  Writer writer;
+  writer.writeString(npcJsonFilePath);
+  writer.writeU8(member.has_value());
+  if (member) {
+    writer.writeString(member->tmxMapFilePath);
+    writer.writeFloat(member->x);
+    writer.writeFloat(member->y);
+  }
+  appendRecord(_pendingRecords, RecordType::WAITING_PARTY_MEMBER, writer.getBuffer());
+}
+
+void SaveJournal::recordOpenableObject(const string& key, const bool isOpened) {
+  if (!isOpen()) {
+    return;
+  }
+  Writer writer;
+  writer.writeString(key);
+  writer.writeU8(isOpened);
+  appendRecord(_pendingRecords, RecordType::OPENABLE_OBJECT, writer.getBuffer());
+}
+
+void SaveJournal::recordNpcSpawning(const string& npcJsonFilePath, const bool isAllowed) {
+  if (!isOpen()) {
+    return;
+  }
+  Writer writer;
+  writer.writeString(npcJsonFilePath);
+  writer.writeU8(isAllowed);
+  appendRecord(_pendingRecords, RecordType::NPC_SPAWNING, writer.getBuffer());
+}
+
+void SaveJournal::checkpoint() {
+  if (!isOpen()) {
+    return;
+  }
+
+  VGPROFILE_ZONE("SaveJournal::checkpoint");
+
+  // Only the small part of the game state is captured here. It's
+  // encoded (along with everything else) on the SaveWorker.
+  checkpoint(GameState::capture(/*includeJournaledState=*/false));
+}
+
+void SaveJournal::checkpoint(GameState::Snapshot checkpoint) {
+  if (!isOpen()) {
+    return;
+  }
+
+  SaveWorker::the().post([saveFilePath = _saveFilePath,
+                          records = std::move(_pendingRecords),
+                          checkpoint = std::move(checkpoint)]() mutable {
+    appendRecord(records, RecordType::CHECKPOINT,
+                 binary_save::encode(checkpoint, binary_save::Compression::NONE));
+
+    const fs::path journalFilePath = getJournalFilePath(saveFilePath);
+    if (!appendToFile(journalFilePath, records)) {
+      VGLOG(LOG_ERR, "Failed to append to save journal [%s].", journalFilePath.c_str());
+      return;
+    }
+
+    error_code ec;
+    if (fs::file_size(journalFilePath, ec) < kCompactionThreshold || ec) {
+      return;
+    }
+
+    GameState::Snapshot snapshot;
+    if (GameState::read(saveFilePath, snapshot)) {
+      replay(saveFilePath, snapshot);
+      compact(saveFilePath, snapshot);
+    }
+  });
+  _pendingRecords.clear();
+}
+
+bool SaveJournal::replay(const fs::path& saveFilePath, GameState::Snapshot& snapshot) {
+  VGPROFILE_ZONE("SaveJournal::replay");
+
+  const fs::path journalFilePath = getJournalFilePath(saveFilePath);
+  string data;
+  if (!readFile(journalFilePath, data)) {
+    return false;
+  }
+
+  Reader reader{data};
+  char magic[sizeof(kMagic)];
+  uint32_t version;
+  uint64_t baseId;
+  uint64_t saveFileId;
+  if (!reader.readBytes(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) ||
+      !reader.readU32(version) || version != kVersion ||
+      !reader.readU64(baseId) ||
+      !getBaseId(saveFilePath, saveFileId) || baseId != saveFileId) {
+    VGLOG(LOG_WARN, "Ignoring stale or corrupted save journal [%s].", journalFilePath.c_str());
+    return false;
+  }
+
+  int numRecords = 0;
+  while (!reader.isEof()) {
+    uint32_t size;
+    uint32_t checksum;
+    string_view record;
+    if (!reader.readU32(size) || !reader.readU32(checksum) ||
+        size == 0 || !reader.readView(size, record)) {
+      VGLOG(LOG_WARN, "Save journal [%s] is torn after %d records.", journalFilePath.c_str(), numRecords);
+      return false;
+    }
+
+    if (static_cast<uint32_t>(byte_util::fnv1a64(record)) != checksum ||
+        !applyRecord(static_cast<RecordType>(record[0]), record.substr(1), snapshot)) {
+      VGLOG(LOG_WARN, "Save journal [%s] is corrupted after %d records.", journalFilePath.c_str(), numRecords);
+      return false;
+    }
+    numRecords++;
+  }
+
+  VGLOG(LOG_INFO, "Replayed %d records from save journal [%s].", numRecords, journalFilePath.c_str());
+  return true;
+}
+
+bool SaveJournal::reset(const fs::path& saveFilePath) {
+  uint64_t baseId;
+  if (!getBaseId(saveFilePath, baseId)) {
+    return false;
+  }
+
+  Writer writer;
+  writer.writeBytes(kMagic, sizeof(kMagic));
+  writer.writeU32(kVersion);
+  writer.writeU64(baseId);
+
+  const fs::path journalFilePath = getJournalFilePath(saveFilePath);
+  error_code ec;
+  fs::remove(journalFilePath, ec);
+  if (!appendToFile(journalFilePath, writer.getBuffer())) {
+    VGLOG(LOG_ERR, "Failed to reset save journal [%s].", journalFilePath.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool SaveJournal::compact(const fs::path& saveFilePath, const GameState::Snapshot& snapshot) {
+  VGPROFILE_ZONE("SaveJournal::compact");
+
+  // If the game crashes in between, the old journal is replayed on top of
+  // the compacted save file, which is harmless since the records are idempotent.
+  return GameState::write(saveFilePath, snapshot) && reset(saveFilePath);
+}
+
+fs::path SaveJournal::getJournalFilePath(const fs::path& saveFilePath) {
+  fs::path journalFilePath = saveFilePath;
+  journalFilePath += ".journal";
+  return journalFilePath;
+}
+
+void SaveJournal::appendRecord(string& out, const RecordType type, const string_view payload) {
+  Writer writer;
+  writer.writeU8(static_cast<uint8_t>(type));
+  writer.writeBytes(payload.data(), payload.size());
+  const string& record = writer.getBuffer();
+
+  Writer header;
+  header.writeU32(record.size());
+  header.writeU32(static_cast<uint32_t>(byte_util::fnv1a64(record)));
+  out += header.getBuffer();
+  out += record;
+}
+
+bool SaveJournal::applyRecord(const RecordType type, const string_view payload, GameState::Snapshot& snapshot) {
+  Reader reader{payload};
+  GameState::Snapshot::Player& p = snapshot.player;
+
+  switch (type) {
+    case RecordType::ITEM: {
+      string itemJsonFilePath;
+      uint64_t itemType;
+      bool hasAmount;
+      uint64_t amount;
+      bool isInInventory;
+      if (!reader.readString(itemJsonFilePath) || !reader.readVarint(itemType) ||
+          !reader.readBool(hasAmount) || !reader.readVarint(amount) || !reader.readBool(isInInventory)) {
+        return false;
+      }
+      if (hasAmount) {
+        p.itemMapper[itemJsonFilePath] = static_cast<int>(amount);
+      } else {
+        p.itemMapper.erase(itemJsonFilePath);
+      }
+      if (itemType >= p.inventory.size()) {
+        p.inventory.resize(itemType + 1);
+      }
+      eraseValue(p.inventory[itemType], itemJsonFilePath);
+      if (isInInventory) {
+        p.inventory[itemType].push_back(std::move(itemJsonFilePath));
+      }
+      return true;
+    }
+
+    case RecordType::EQUIPMENT_SLOT: {
+      uint64_t equipmentType;
+      string itemJsonFilePath;
+      if (!reader.readVarint(equipmentType) || !reader.readString(itemJsonFilePath)) {
+        return false;
+      }
+      if (equipmentType >= p.equipmentSlots.size()) {
+        p.equipmentSlots.resize(equipmentType + 1);
+      }
+      p.equipmentSlots[equipmentType] = std::move(itemJsonFilePath);
+      return true;
+    }
+
+    case RecordType::PARTY_MEMBER: {
+      string npcJsonFilePath;
+      bool isMember;
+      if (!reader.readString(npcJsonFilePath) || !reader.readBool(isMember)) {
+        return false;
+      }
+      eraseValue(p.partyMembers, npcJsonFilePath);
+      if (isMember) {
+        p.partyMembers.push_back(std::move(npcJsonFilePath));
+      }
+      return true;
+    }
+
+    case RecordType::WAITING_PARTY_MEMBER: {
+      GameState::Snapshot::WaitingPartyMember member{};
+      bool isWaiting;
+      if (!reader.readString(member.npcJsonFilePath) || !reader.readBool(isWaiting)) {
+        return false;
+      }
+      if (isWaiting && (!reader.readString(member.tmxMapFilePath) ||
+                        !reader.readFloat(member.x) || !reader.readFloat(member.y))) {
+        return false;
+      }
+      auto& members = p.waitingPartyMembers;
+      members.erase(std::remove_if(members.begin(), members.end(), [&member](const auto& m) {
+        return m.npcJsonFilePath == member.npcJsonFilePath;
+      }), members.end());
+      if (isWaiting) {
+        members.push_back(std::move(member));
+      }
+      return true;
+    }
+
+    case RecordType::OPENABLE_OBJECT: {
+      string key;
+      bool isOpened;
+      if (!reader.readString(key) || !reader.readBool(isOpened)) {
+        return false;
+      }
+      snapshot.allOpenableObjectStates[std::move(key)] = isOpened;
+      return true;
+    }
+
+    case RecordType::NPC_SPAWNING: {
+      string npcJsonFilePath;
+      bool isAllowed;
+      if (!reader.readString(npcJsonFilePath) || !reader.readBool(isAllowed)) {
+        return false;
+      }
+      if (isAllowed) {
+        snapshot.npcSpawningBlacklist.erase(npcJsonFilePath);
+      } else {
+        snapshot.npcSpawningBlacklist.insert(std::move(npcJsonFilePath));
+      }
+      return true;
+    }
+
+    case RecordType::CHECKPOINT: {
+      // A checkpoint holds everything but the journaled state, which is carried over.
+      GameState::Snapshot checkpoint{};
+      if (!binary_save::decode(payload, checkpoint)) {
+        return false;
+      }
+      checkpoint.npcSpawningBlacklist = std::move(snapshot.npcSpawningBlacklist);
+      checkpoint.allOpenableObjectStates = std::move(snapshot.allOpenableObjectStates);
+      checkpoint.player.itemMapper = std::move(p.itemMapper);
+      checkpoint.player.inventory = std::move(p.inventory);
+      checkpoint.player.equipmentSlots = std::move(p.equipmentSlots);
+      checkpoint.player.partyMembers = std::move(p.partyMembers);
+      checkpoint.player.waitingPartyMembers = std::move(p.waitingPartyMembers);
+      snapshot = std::move(checkpoint);
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+}  // namespace vigilante
@@ -0,0 +1,112 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_GAMEPLAY_SAVE_JOURNAL_H_
+#define VIGILANTE_GAMEPLAY_SAVE_JOURNAL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "gameplay/GameState.h"
+
+namespace fs = std::filesystem;
+
+namespace vigilante {
+
+// An append-only journal of the changes made on top of a save file,
+// so that autosaving doesn't have to rewrite the whole save file.
+//
+// - The state which grows over the course of the game (items, equipment,
+//   party, openable objects and the NPC spawning blacklist) is journaled
+//   as it changes. Each record holds the new value of a single key,
+//   so replaying a record more than once is harmless.
+// - The rest of the state (player stats and position, in-game time, ...)
+//   is small, and is journaled as a whole by checkpoint().
+//
+// Records are buffered in memory, and are appended to the journal on the
+// SaveWorker at each checkpoint(). Once the journal grows past
+// kCompactionThreshold, it's folded into the save file and truncated.
+//
+// Loading a save file replays its journal on top of it, up to the first torn
+// or corrupted record (e.g., if the game crashed while appending to it).
+//
+// Journal file layout (all fixed-size integers are little-endian):
+//
+// +---------+---------+--------+--------+--------+-----
+// | "VGSJ"  | version | baseId | Record | Record | ...
+// | char[4] | u32     | u64    |        |        |
+// +---------+---------+--------+--------+--------+-----
+//
+// - baseId is a hash of the save file the journal applies to,
+//   so a stale journal is never replayed on top of another save file.
+// - Each record is: size (u32), checksum (u32), type (u8) and the payload,
+//   in which strings are prefixed with their (LEB128 varint) length.
+class SaveJournal final {
+ public:
+  static SaveJournal& the();
+
+  // Starts journaling the changes made on top of `saveFilePath`, dropping the
+  // records which haven't been appended yet. Called after the game is saved or loaded.
+  void open(const fs::path& saveFilePath);
+  void close();
+  inline bool isOpen() const { return !_saveFilePath.empty(); }
+
+  // These are no-ops unless the journal is open.
+  void recordItem(const std::string& itemJsonFilePath, const int itemType,
+                  const std::optional<int> amount, const bool isInInventory);
+  void recordEquipmentSlot(const int equipmentType, const std::string& itemJsonFilePath);
+  void recordPartyMember(const std::string& npcJsonFilePath, const bool isMember);
+  void recordWaitingPartyMember(const std::string& npcJsonFilePath,
+                                const std::optional<GameState::Snapshot::WaitingPartyMember>& member);
+  void recordOpenableObject(const std::string& key, const bool isOpened);
+  void recordNpcSpawning(const std::string& npcJsonFilePath, const bool isAllowed);
+
+  // Autosaves, i.e., appends the buffered records along with
+  // a checkpoint of the rest of the game state to the journal.
+  void checkpoint();
+  // Same as above, with the given `checkpoint` of the rest of the game state
+  // (its journaled state is ignored, since it's carried over when replaying).
+  void checkpoint(GameState::Snapshot checkpoint);
+
+  // Replays the journal of `saveFilePath` on top of `snapshot`, which has been read from it.
+  // @return false if the journal is missing, stale or torn, in which case
+  //         it should be folded into the save file (see compact()).
+  static bool replay(const fs::path& saveFilePath, GameState::Snapshot& snapshot);
+
+  // The following must be called on the SaveWorker.
+  // Starts an empty journal for `saveFilePath`.
+  static bool reset(const fs::path& saveFilePath);
+  // Writes `snapshot` (which the journal has been replayed on top of) to `saveFilePath`,
+  // and then starts an empty journal for it.
+  static bool compact(const fs::path& saveFilePath, const GameState::Snapshot& snapshot);
+
+  static fs::path getJournalFilePath(const fs::path& saveFilePath);
+
+ private:
+  static inline constexpr size_t kCompactionThreshold = 256 * 1024;
+
+  enum class RecordType : uint8_t {
+    ITEM,
+    EQUIPMENT_SLOT,
+    PARTY_MEMBER,
+    WAITING_PARTY_MEMBER,
+    OPENABLE_OBJECT,
+    NPC_SPAWNING,
+    CHECKPOINT,
+  };
+
+  SaveJournal() = default;
+
+  static void appendRecord(std::string& out, const RecordType type, const std::string_view payload);
+  static bool applyRecord(const RecordType type, const std::string_view payload, GameState::Snapshot& snapshot);
+
+  fs::path _saveFilePath;
+  std::string _pendingRecords;
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_GAMEPLAY_SAVE_JOURNAL_H_
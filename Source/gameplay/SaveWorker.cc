@@ -0,0 +1,84 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "SaveWorker.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace vigilante {
+
+SaveWorker& SaveWorker::the() {
+  static SaveWorker instance;
+  return instance;
+}
+
+SaveWorker::SaveWorker() : _thread{[this]() { run(); }} {}
+
+SaveWorker::~SaveWorker() {
+  shutdown();
+}
+
+void SaveWorker::post(function<void ()>&& job) {
+  {
+    lock_guard<mutex> lock{_mutex};
+    if (_isRunning) {
+      _jobs.push_back(std::move(job));
+      _cv.notify_all();
+      return;
+    }
+  }
+  job();
+}
+
+void SaveWorker::waitUntilIdle() {
+  unique_lock<mutex> lock{_mutex};
+  _idleCv.wait(lock, [this]() { return _jobs.empty() && !_isBusy; });
+}
+
+void SaveWorker::shutdown() {
+  {
+    lock_guard<mutex> lock{_mutex};
+    if (!_isRunning) {
+      return;
+    }
+    _isRunning = false;
+  }
+  _cv.notify_all();
+  _thread.join();
+}
+
+void SaveWorker::run() {
+  unique_lock<mutex> lock{_mutex};
+  while (true) {
+    _cv.wait(lock, [this]() { return !_jobs.empty() || !_isRunning; });
+    if (_jobs.empty()) {
+      return;
+    }
+
+    function<void ()> job = std::move(_jobs.front());
+    _jobs.pop_front();
+    _isBusy = true;
+
+    lock.unlock();
+    job();
+    lock.lock();
+
+    _isBusy = false;
+    _idleCv.notify_all();
+  }
+}
+
+bool syncFile(FILE* file) {
+#ifdef _WIN32
+  return ::_commit(::_fileno(file)) == 0;
+#else
+  return ::fsync(::fileno(file)) == 0;
+#endif
+}
+
+}  // namespace vigilante
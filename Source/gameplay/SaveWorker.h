@@ -0,0 +1,53 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_GAMEPLAY_SAVE_WORKER_H_
+#define VIGILANTE_GAMEPLAY_SAVE_WORKER_H_
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace vigilante {
+
+// Runs the save jobs (e.g., writing a save file, appending to the save journal)
+// one at a time on a background thread, in the order they're posted, so that
+// an older snapshot never overwrites a newer one.
+//
+// AppDelegate shuts it down before the Director is torn down, so that the pending
+// jobs are finished while everything they use (e.g., the Director, SaveJournal)
+// is still alive, rather than during the destruction of static objects.
+class SaveWorker final {
+ public:
+  static SaveWorker& the();
+
+  ~SaveWorker();
+
+  // Jobs posted after shutdown() are run on the calling thread.
+  void post(std::function<void ()>&& job);
+  void waitUntilIdle();
+  // Finishes the pending jobs and stops the background thread.
+  void shutdown();
+
+ private:
+  SaveWorker();
+
+  void run();
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::condition_variable _idleCv;
+  std::deque<std::function<void ()>> _jobs;
+  bool _isBusy{};
+  bool _isRunning{true};
+  std::thread _thread;  // must be initialized last
+};
+
+// Makes sure everything written to `file` has reached the disk.
+bool syncFile(std::FILE* file);
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_GAMEPLAY_SAVE_WORKER_H_
@@ -2,6 +2,7 @@
 
 #include "input/InputManager.h"
 
+#include "input/InputRecording.h"
 #include "ui/TextField.h"
 #include "util/Logger.h"
 
@@ -20,25 +21,15 @@ void InputManager::activate(Scene* scene) {
   _keyboardEvLstnr = EventListenerKeyboard::create();
 
   _keyboardEvLstnr->onKeyPressed = [this](EventKeyboard::KeyCode keyCode, Event* e) {
-    if (keyCode == EventKeyboard::KeyCode::KEY_CAPS_LOCK) {
-      _isCapsLocked = !_isCapsLocked;
+    if (_isKeyboardEnabled) {
+      onKeyPressed(keyCode, e);
     }
-    
-    if (_specialOnKeyPressed) {
-      // Execute the additional onKeyPressed handler for special events.
-      // (e.g., prompting for a hotkey, receiving TextField input, etc)
-      _specialOnKeyPressed(keyCode, e);
-      return;
-    }
-
-    // We keep track of which keys have been pressed only when there is no active
-    // _specialOnKeyPressed event listener, because _specialOnKeyPressed will do
-    // whatever it needs to do with these keys.
-    _pressedKeys.insert(keyCode);
   };
 
   _keyboardEvLstnr->onKeyReleased = [this](EventKeyboard::KeyCode keyCode, Event*) {
-    _pressedKeys.erase(keyCode);
+    if (_isKeyboardEnabled) {
+      onKeyReleased(keyCode);
+    }
   };
 
   _scene->getEventDispatcher()->addEventListenerWithSceneGraphPriority(_keyboardEvLstnr, scene);
@@ -56,4 +47,30 @@ void InputManager::deactivate() {
   _pressedKeys.clear();
 }
 
+void InputManager::onKeyPressed(EventKeyboard::KeyCode keyCode, Event* e) {
+  InputRecorder::the().onKeyEvent(keyCode, /*isPressed=*/true);
+
+  if (keyCode == EventKeyboard::KeyCode::KEY_CAPS_LOCK) {
+    _isCapsLocked = !_isCapsLocked;
+  }
+
+  if (_specialOnKeyPressed) {
+    // Execute the additional onKeyPressed handler for special events.
+    // (e.g., prompting for a hotkey, receiving TextField input, etc)
+    _specialOnKeyPressed(keyCode, e);
+    return;
+  }
+
+  // We keep track of which keys have been pressed only when there is no active
+  // _specialOnKeyPressed event listener, because _specialOnKeyPressed will do
+  // whatever it needs to do with these keys.
+  _pressedKeys.insert(keyCode);
+}
+
+void InputManager::onKeyReleased(EventKeyboard::KeyCode keyCode) {
+  InputRecorder::the().onKeyEvent(keyCode, /*isPressed=*/false);
+
+  _pressedKeys.erase(keyCode);
+}
+
 }  // namespace vigilante
@@ -60,6 +60,15 @@ class InputManager final {
     _specialOnKeyPressed = nullptr;
   }
 
+  // Handles a key event from the keyboard, or one replayed by InputReplayer.
+  void onKeyPressed(ax::EventKeyboard::KeyCode keyCode, ax::Event* e);
+  void onKeyReleased(ax::EventKeyboard::KeyCode keyCode);
+
+  // If disabled, the key events from the keyboard are ignored (e.g., during a replay).
+  inline void setKeyboardEnabled(bool isKeyboardEnabled) {
+    _isKeyboardEnabled = isKeyboardEnabled;
+  }
+
  private:
   InputManager() = default;
 
@@ -67,6 +76,7 @@ class InputManager final {
   ax::EventListenerKeyboard* _keyboardEvLstnr{};
 
   bool _isCapsLocked{};
+  bool _isKeyboardEnabled{true};
 
   // Pressed Keys are stored in this set.
   // Relevant method: isKeyPressed(), isKeyJustPressed()
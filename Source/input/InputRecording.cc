@@ -0,0 +1,234 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "InputRecording.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "input/InputManager.h"
+#include "util/ByteUtil.h"
+#include "util/Logger.h"
+#include "util/RandUtil.h"
+
+using namespace std;
+USING_NS_AX;
+
+namespace vigilante {
+
+namespace {
+
+constexpr char kMagic[4] = {'V', 'G', 'I', 'R'};
+constexpr uint32_t kVersion = 1;
+
+using byte_util::Reader;
+using byte_util::Writer;
+
+}  // namespace
+
+bool InputRecording::save(const string& filePath) const {
+  Writer writer;
+  writer.writeBytes(kMagic, sizeof(kMagic));
+  writer.writeU32(kVersion);
+  writer.writeU32(seed);
+  writer.writeFloat(delta);
+
+  writer.writeU8(static_cast<uint8_t>(startType));
+  writer.writeString(startPath);
+  writer.writeVarint(numTicks);
+
+  uint32_t prevTick = 0;
+  for (const auto& event : events) {
+    writer.writeVarint(event.tick - prevTick);
+    writer.writeVarint((static_cast<uint64_t>(event.keyCode) << 1) | event.isPressed);
+    prevTick = event.tick;
+  }
+
+  ofstream fout{filePath, ios::binary | ios::trunc};
+  if (!fout.is_open()) {
+    VGLOG(LOG_ERR, "Failed to open [%s] for writing.", filePath.c_str());
+    return false;
+  }
+
+  const auto& buf = writer.getBuffer();
+  fout.write(buf.data(), buf.size());
+  return fout.good();
+}
+
+optional<InputRecording> InputRecording::load(const string& filePath) {
+  ifstream fin{filePath, ios::binary};
+  if (!fin.is_open()) {
+    VGLOG(LOG_ERR, "Failed to open [%s].", filePath.c_str());
+    return std::nullopt;
+  }
+
+  const string buf{istreambuf_iterator<char>{fin}, istreambuf_iterator<char>{}};
+  Reader reader{buf};
+  InputRecording recording;
+
+  char magic[4];
+  uint32_t version;
+  if (!reader.readBytes(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) ||
+      !reader.readU32(version) || version != kVersion) {
+    VGLOG(LOG_ERR, "[%s] is not an input recording (version %u).", filePath.c_str(), kVersion);
+    return std::nullopt;
+  }
+
+  uint8_t startType;
+  uint64_t numTicks;
+  if (!reader.readU32(recording.seed) ||
+      !reader.readFloat(recording.delta) ||
+      !reader.readU8(startType) ||
+      !reader.readString(recording.startPath) ||
+      !reader.readVarint(numTicks)) {
+    VGLOG(LOG_ERR, "Truncated input recording header: [%s].", filePath.c_str());
+    return std::nullopt;
+  }
+  recording.startType = static_cast<StartType>(startType);
+  recording.numTicks = static_cast<uint32_t>(numTicks);
+
+  uint64_t tick = 0;
+  while (!reader.isEof()) {
+    uint64_t tickDelta;
+    uint64_t key;
+    if (!reader.readVarint(tickDelta) || !reader.readVarint(key)) {
+      VGLOG(LOG_ERR, "Truncated input recording events: [%s].", filePath.c_str());
+      return std::nullopt;
+    }
+    tick += tickDelta;
+    recording.events.push_back({static_cast<uint32_t>(tick),
+                                static_cast<EventKeyboard::KeyCode>(key >> 1),
+                                static_cast<bool>(key & 1)});
+  }
+
+  return recording;
+}
+
+InputRecorder& InputRecorder::the() {
+  static InputRecorder instance;
+  return instance;
+}
+
+void InputRecorder::start(const string& outputFilePath,
+                          const InputRecording::StartType startType,
+                          const string& startPath) {
+  _isRecording = true;
+  _outputFilePath = outputFilePath;
+  _recording = InputRecording{};
+  _recording.seed = rand_util::getSeed();
+  _recording.startType = startType;
+  _recording.startPath = startPath;
+  VGLOG(LOG_INFO, "Recording input to [%s], seed: %u.", outputFilePath.c_str(), _recording.seed);
+}
+
+void InputRecorder::stop() {
+  if (!_isRecording) {
+    return;
+  }
+
+  _isRecording = false;
+  if (_recording.save(_outputFilePath)) {
+    VGLOG(LOG_INFO, "Recorded %u ticks, %zu key events to [%s].",
+          _recording.numTicks, _recording.events.size(), _outputFilePath.c_str());
+  }
+}
+
+void InputRecorder::tick() {
+  if (!_isRecording) {
+    return;
+  }
+  _recording.numTicks++;
+}
+
+void InputRecorder::onKeyEvent(const EventKeyboard::KeyCode keyCode, const bool isPressed) {
+  if (!_isRecording) {
+    return;
+  }
+  // The events received between two ticks are consumed by the next tick.
+  _recording.events.push_back({_recording.numTicks, keyCode, isPressed});
+}
+
+InputReplayer& InputReplayer::the() {
+  static InputReplayer instance;
+  return instance;
+}
+
+void InputReplayer::start(InputRecording recording) {
+  _isReplaying = true;
+  _recording = std::move(recording);
+  _tick = 0;
+  _nextEventIdx = 0;
+  _frameTimesMs.clear();
+  _frameTimesMs.reserve(_recording.numTicks);
+
+  rand_util::init(_recording.seed);
+  InputManager::the().setKeyboardEnabled(false);
+  VGLOG(LOG_INFO, "Replaying %u ticks, %zu key events, seed: %u.",
+        _recording.numTicks, _recording.events.size(), _recording.seed);
+}
+
+void InputReplayer::stop() {
+  if (!_isReplaying) {
+    return;
+  }
+
+  _isReplaying = false;
+  InputManager::the().setKeyboardEnabled(true);
+  printFrameTimes();
+}
+
+void InputReplayer::tick() {
+  if (!_isReplaying) {
+    return;
+  }
+
+  const auto now = chrono::steady_clock::now();
+  if (_tick > 0) {
+    _frameTimesMs.push_back(chrono::duration<float, milli>(now - _lastTickTime).count());
+  }
+  _lastTickTime = now;
+
+  if (_tick >= _recording.numTicks) {
+    stop();
+    Director::getInstance()->end();
+    return;
+  }
+
+  const auto& events = _recording.events;
+  for (; _nextEventIdx < events.size() && events[_nextEventIdx].tick == _tick; _nextEventIdx++) {
+    const auto& event = events[_nextEventIdx];
+    if (event.isPressed) {
+      InputManager::the().onKeyPressed(event.keyCode, nullptr);
+    } else {
+      InputManager::the().onKeyReleased(event.keyCode);
+    }
+  }
+  _tick++;
+}
+
+void InputReplayer::printFrameTimes() const {
+  if (_frameTimesMs.empty()) {
+    return;
+  }
+
+  vector<float> sorted = _frameTimesMs;
+  std::sort(sorted.begin(), sorted.end());
+  auto percentile = [&sorted](const double p) {
+    return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+  };
+
+  double totalMs = 0;
+  for (const auto ms : sorted) {
+    totalMs += ms;
+  }
+
+  std::printf("ticks: %u, time: %.3f s\n", _tick, totalMs / 1000);
+  std::printf("frame time (ms): avg %.3f, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f\n",
+              totalMs / sorted.size(), percentile(0.5), percentile(0.95), percentile(0.99),
+              sorted.back());
+  std::fflush(stdout);
+}
+
+}  // namespace vigilante
@@ -0,0 +1,124 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_INPUT_INPUT_RECORDING_H_
+#define VIGILANTE_INPUT_INPUT_RECORDING_H_
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <axmol.h>
+
+#include "Constants.h"
+
+namespace vigilante {
+
+// A recorded play session: where it started, the RNG seed,
+// and every key event along with the tick it was received at.
+//
+// File layout (all integers are little-endian, `varint` is LEB128):
+//
+// +---------+---------+-------+------------+-----------+----------+----------+---------+
+// | "VGIR"  | version | seed  | delta      | startType | startPath| numTicks | events  |
+// | char[4] | u32     | u32   | f32        | u8        | varint+s | varint   | ...     |
+// +---------+---------+-------+------------+-----------+----------+----------+---------+
+//
+// Each event is two varints: the number of ticks since the previous event,
+// and (keyCode << 1 | isPressed).
+struct InputRecording final {
+  enum class StartType : uint8_t {
+    NEW_GAME,
+    LOAD_GAME
+  };
+
+  struct Event final {
+    uint32_t tick;
+    ax::EventKeyboard::KeyCode keyCode;
+    bool isPressed;
+  };
+
+  bool save(const std::string& filePath) const;
+  static std::optional<InputRecording> load(const std::string& filePath);
+
+  uint32_t seed{};
+  float delta{1.0f / kFps};
+  StartType startType{StartType::NEW_GAME};
+  std::string startPath;  // the save file path if startType is LOAD_GAME
+  uint32_t numTicks{};
+  std::vector<Event> events;
+};
+
+// Records the key events received by InputManager.
+//
+// While recording, GameScene is stepped at InputRecording::delta
+// so that the session can be replayed tick by tick.
+class InputRecorder final {
+ public:
+  struct Options final {
+    std::string outputFilePath;
+    std::string saveFilePath;  // empty to start a new game
+  };
+
+  static InputRecorder& the();
+
+  void start(const std::string& outputFilePath,
+             const InputRecording::StartType startType,
+             const std::string& startPath);
+  // Writes the recording to the output file.
+  void stop();
+
+  void tick();
+  void onKeyEvent(const ax::EventKeyboard::KeyCode keyCode, const bool isPressed);
+
+  inline bool isRecording() const { return _isRecording; }
+  inline float getDelta() const { return _recording.delta; }
+
+  // Set from the command line before the application starts.
+  static inline std::optional<Options> options;
+
+ private:
+  InputRecorder() = default;
+
+  bool _isRecording{};
+  std::string _outputFilePath;
+  InputRecording _recording;
+};
+
+// Feeds a recorded session back through InputManager, tick by tick,
+// and prints the frame timing once it has been fully replayed.
+class InputReplayer final {
+ public:
+  static InputReplayer& the();
+
+  // Seeds the RNG with the recorded seed. The caller should then
+  // start the game from InputRecording::startType and startPath.
+  void start(InputRecording recording);
+  void stop();
+
+  // Injects the key events of the current tick.
+  void tick();
+
+  inline bool isReplaying() const { return _isReplaying; }
+  inline float getDelta() const { return _recording.delta; }
+
+  // Set from the command line before the application starts.
+  static inline std::optional<std::string> inputFilePath;
+
+ private:
+  InputReplayer() = default;
+
+  void printFrameTimes() const;
+
+  bool _isReplaying{};
+  InputRecording _recording;
+  uint32_t _tick{};
+  size_t _nextEventIdx{};
+  std::chrono::steady_clock::time_point _lastTickTime;
+  std::vector<float> _frameTimesMs;
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_INPUT_INPUT_RECORDING_H_
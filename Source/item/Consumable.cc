@@ -2,6 +2,7 @@
 
 #include "Consumable.h"
 
+#include "ProfileCache.h"
 #include "util/JsonUtil.h"
 
 using namespace std;
@@ -11,40 +12,23 @@ namespace vigilante {
 
 Consumable::Consumable(const string& jsonFilePath)
     : Item{jsonFilePath},
-      _consumableProfile{jsonFilePath} {}
+      _consumableProfile{ProfileCache<Consumable::Profile>::get(jsonFilePath)} {}
 
 void Consumable::import(const string& jsonFilePath) {
   Item::import(jsonFilePath);
-  _consumableProfile = Consumable::Profile{jsonFilePath};
+  _consumableProfile = ProfileCache<Consumable::Profile>::get(jsonFilePath);
 }
 
 EventKeyboard::KeyCode Consumable::getHotkey() const {
-  return _consumableProfile.hotkey;
+  return _hotkey;
 }
 
 void Consumable::setHotkey(EventKeyboard::KeyCode hotkey) {
-  _consumableProfile.hotkey = hotkey;
+  _hotkey = hotkey;
 }
 
-Consumable::Profile::Profile(const string& jsonFilePath) : hotkey{} {
-  rapidjson::Document json = json_util::loadFromFile(jsonFilePath);
-
-  duration = json["duration"].GetFloat();
-
-  restoreHealth = json["restoreHealth"].GetInt();
-  restoreMagicka = json["restoreMagicka"].GetInt();
-  restoreStamina = json["restoreStamina"].GetInt();
-
-  bonusPhysicalDamage = json["bonusPhysicalDamage"].GetInt();
-  bonusMagicalDamage = json["bonusMagicalDamage"].GetInt();
-
-  bonusStr = json["bonusStr"].GetInt();
-  bonusDex = json["bonusDex"].GetInt();
-  bonusInt = json["bonusInt"].GetInt();
-  bonusLuk = json["bonusLuk"].GetInt();
-
-  bonusMoveSpeed = json["bonusMoveSpeed"].GetInt();
-  bonusJumpHeight = json["bonusJumpHeight"].GetInt();
+Consumable::Profile::Profile(const string& jsonFilePath) {
+  json_util::parseFileInto(jsonFilePath, *this);
 }
 
 }  // namespace vigilante
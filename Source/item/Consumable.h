@@ -3,12 +3,14 @@
 #ifndef VIGILANTE_ITEM_CONSUMABLE_H_
 #define VIGILANTE_ITEM_CONSUMABLE_H_
 
+#include <memory>
 #include <string>
 
 #include <axmol.h>
 
 #include "item/Item.h"
 #include "input/Keybindable.h"
+#include "util/Reflection.h"
 
 namespace vigilante {
 
@@ -34,7 +36,19 @@ class Consumable : public Item, public Keybindable {
     int bonusMoveSpeed;
     int bonusJumpHeight;
 
-    ax::EventKeyboard::KeyCode hotkey;
+    static constexpr auto kFields = reflection::fields(
+      reflection::field("duration", &Profile::duration),
+      reflection::field("restoreHealth", &Profile::restoreHealth),
+      reflection::field("restoreMagicka", &Profile::restoreMagicka),
+      reflection::field("restoreStamina", &Profile::restoreStamina),
+      reflection::field("bonusPhysicalDamage", &Profile::bonusPhysicalDamage),
+      reflection::field("bonusMagicalDamage", &Profile::bonusMagicalDamage),
+      reflection::field("bonusStr", &Profile::bonusStr),
+      reflection::field("bonusDex", &Profile::bonusDex),
+      reflection::field("bonusInt", &Profile::bonusInt),
+      reflection::field("bonusLuk", &Profile::bonusLuk),
+      reflection::field("bonusMoveSpeed", &Profile::bonusMoveSpeed),
+      reflection::field("bonusJumpHeight", &Profile::bonusJumpHeight));
   };
 
   explicit Consumable(const std::string& jsonFilePath);
@@ -45,10 +59,11 @@ class Consumable : public Item, public Keybindable {
   virtual ax::EventKeyboard::KeyCode getHotkey() const override;  // Keybindable
   virtual void setHotkey(ax::EventKeyboard::KeyCode hotkey) override;  // Keybindable
 
-  Consumable::Profile& getConsumableProfile() { return _consumableProfile; }
+  const Consumable::Profile& getConsumableProfile() const { return *_consumableProfile; }
 
  protected:
-  Consumable::Profile _consumableProfile;
+  std::shared_ptr<const Consumable::Profile> _consumableProfile;
+  ax::EventKeyboard::KeyCode _hotkey{};
 };
 
 }  // namespace vigilante
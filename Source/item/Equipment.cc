@@ -2,6 +2,10 @@
 
 #include "Equipment.h"
 
+#include <string>
+#include <unordered_map>
+
+#include "ProfileCache.h"
 #include "util/JsonUtil.h"
 #include "util/Logger.h"
 
@@ -11,23 +15,24 @@ namespace vigilante {
 
 Equipment::Equipment(const string& jsonFilePath)
     : Item{jsonFilePath},
-      _equipmentProfile{jsonFilePath} {}
+      _equipmentProfile{ProfileCache<Equipment::Profile>::get(jsonFilePath)} {}
 
 void Equipment::import(const string& jsonFilePath) {
   Item::import(jsonFilePath);
-  _equipmentProfile = Equipment::Profile{jsonFilePath};
+  _equipmentProfile = ProfileCache<Equipment::Profile>::get(jsonFilePath);
 }
 
 Equipment::Profile::Profile(const string& jsonFilePath) {
-  rapidjson::Document json = json_util::loadFromFile(jsonFilePath);
+  unordered_map<string, string> sfx;
+  json_util::parseFileInto(jsonFilePath, *this, make_pair("sfx", &sfx));
 
   for (int i = 0; i < Equipment::Sfx::SFX_SIZE; i++) {
-    const string &sfxKey = Equipment::_kEquipmentSfxStr[i];
-    if (!json["sfx"].HasMember(sfxKey.c_str())) {
+    auto it = sfx.find(Equipment::_kEquipmentSfxStr[i]);
+    if (it == sfx.end()) {
       continue;
     }
 
-    const fs::path sfxPath = json["sfx"][sfxKey.c_str()].GetString();
+    const fs::path sfxPath = it->second;
     std::error_code ec;
     if (!fs::exists(sfxPath, ec)) {
       VGLOG(LOG_ERR, "sfx [%s] file doesnt exist.", sfxPath.c_str());
@@ -35,18 +40,6 @@ Equipment::Profile::Profile(const string& jsonFilePath) {
     }
     sfxFilePaths[i] = sfxPath;
   }
-
-  equipmentType = static_cast<Equipment::Type>(json["equipmentType"].GetInt());
-  bonusPhysicalDamage = json["bonusPhysicalDamage"].GetInt();
-  bonusMagicalDamage = json["bonusMagicalDamage"].GetInt();
-
-  bonusStr = json["bonusStr"].GetInt();
-  bonusDex = json["bonusDex"].GetInt();
-  bonusInt = json["bonusInt"].GetInt();
-  bonusLuk = json["bonusLuk"].GetInt();
-
-  bonusMoveSpeed = json["bonusMoveSpeed"].GetInt();
-  bonusJumpHeight = json["bonusJumpHeight"].GetInt();
 }
 
 }  // namespace vigilante
@@ -4,9 +4,11 @@
 #define VIGILANTE_ITEM_EQUIPMENT_H_
 
 #include <array>
+#include <memory>
 #include <string>
 
 #include "Item.h"
+#include "util/Reflection.h"
 
 namespace vigilante {
 
@@ -55,6 +57,17 @@ class Equipment : public Item {
 
     int bonusMoveSpeed;
     int bonusJumpHeight;
+
+    static constexpr auto kFields = reflection::fields(
+      reflection::field("equipmentType", &Profile::equipmentType),
+      reflection::field("bonusPhysicalDamage", &Profile::bonusPhysicalDamage),
+      reflection::field("bonusMagicalDamage", &Profile::bonusMagicalDamage),
+      reflection::field("bonusStr", &Profile::bonusStr),
+      reflection::field("bonusDex", &Profile::bonusDex),
+      reflection::field("bonusInt", &Profile::bonusInt),
+      reflection::field("bonusLuk", &Profile::bonusLuk),
+      reflection::field("bonusMoveSpeed", &Profile::bonusMoveSpeed),
+      reflection::field("bonusJumpHeight", &Profile::bonusJumpHeight));
   };
 
   explicit Equipment(const std::string& jsonFilePath);
@@ -62,13 +75,12 @@ class Equipment : public Item {
 
   virtual void import(const std::string& jsonFilePath) override;  // Importable
 
-  inline Equipment::Profile& getEquipmentProfile() { return _equipmentProfile; }
   inline const Equipment::Profile& getEquipmentProfile() const {
-    return _equipmentProfile;
+    return *_equipmentProfile;
   }
 
   const std::string& getSfxFilePath(const Equipment::Sfx sfx) const {
-    return _equipmentProfile.sfxFilePaths[sfx];
+    return _equipmentProfile->sfxFilePaths[sfx];
   }
 
  private:
@@ -77,7 +89,7 @@ class Equipment : public Item {
     "hit",
   }};
 
-  Equipment::Profile _equipmentProfile;
+  std::shared_ptr<const Equipment::Profile> _equipmentProfile;
 };
 
 }  // namespace vigilante
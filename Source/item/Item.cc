@@ -6,12 +6,13 @@
 
 #include "Assets.h"
 #include "Constants.h"
+#include "ProfileCache.h"
 #include "item/Equipment.h"
 #include "item/Consumable.h"
 #include "item/MiscItem.h"
 #include "item/Key.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/AxUtil.h"
 #include "util/B2BodyBuilder.h"
 #include "util/JsonUtil.h"
@@ -54,10 +55,7 @@ unique_ptr<Item> Item::create(const string& jsonFilePath) {
 
 Item::Item(const string& jsonFilePath)
     : DynamicActor{kItemNumAnimations, kItemNumFixtures},
-      _itemProfile{jsonFilePath} {
-  _bodySprite = Sprite::create(getIconPath());
-  _bodySprite->getTexture()->setAliasTexParameters();
-}
+      _itemProfile{ProfileCache<Item::Profile>::get(jsonFilePath)} {}
 
 bool Item::showOnMap(float x, float y) {
   if (_isShownOnMap) {
@@ -75,12 +73,25 @@ bool Item::showOnMap(float x, float y) {
   _bodySprite->setScale(0.8f);
   _node->addChild(_bodySprite, z_order::kItem);
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax_util::addChildWithParentCameraMask(gmMgr->getLayer(), _node, z_order::kItem);
 
   return true;
 }
 
+bool Item::removeFromMap() {
+  Sprite* bodySprite = _bodySprite;
+  if (!DynamicActor::removeFromMap()) {
+    return false;
+  }
+
+  // The sprite is created again the next time this item is shown on the map.
+  if (bodySprite) {
+    _node->removeChild(bodySprite, true);
+  }
+  return true;
+}
+
 void Item::update(const float delta) {
   DynamicActor::update(delta);
 
@@ -88,7 +99,7 @@ void Item::update(const float delta) {
 }
 
 void Item::import(const string& jsonFilePath) {
-  _itemProfile = Item::Profile{jsonFilePath};
+  _itemProfile = ProfileCache<Item::Profile>::get(jsonFilePath);
 }
 
 void Item::defineBody(b2BodyType bodyType,
@@ -96,7 +107,7 @@ void Item::defineBody(b2BodyType bodyType,
                       float y,
                       short categoryBits,
                       short maskBits) {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   B2BodyBuilder bodyBuilder(gmMgr->getWorld());
 
   _body = bodyBuilder.type(bodyType)
@@ -119,11 +130,11 @@ void Item::defineBody(b2BodyType bodyType,
 }
 
 string Item::getIconPath() const {
-  return fs::path{_itemProfile.textureResDir} / kIconPng;
+  return fs::path{_itemProfile->textureResDir} / kIconPng;
 }
 
 bool Item::isGold() const {
-  return _itemProfile.jsonFilePath == assets::kGoldCoin;
+  return _itemProfile->jsonFilePath == assets::kGoldCoin;
 }
 
 void Item::handleVerticalFloatingMovement(const float delta) {
@@ -134,13 +145,7 @@ void Item::handleVerticalFloatingMovement(const float delta) {
 }
 
 Item::Profile::Profile(const string& jsonFilePath) : jsonFilePath(jsonFilePath) {
-  rapidjson::Document json = json_util::loadFromFile(jsonFilePath);
-
-  itemType = static_cast<Item::Type>(json["itemType"].GetInt());
-  textureResDir = json["textureResDir"].GetString();
-  name = json["name"].GetString();
-  desc = json["desc"].GetString();
-  price = json["price"].GetInt();
+  json_util::parseFileInto(jsonFilePath, *this);
 }
 
 }  // namespace vigilante
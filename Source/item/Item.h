@@ -11,6 +11,7 @@
 
 #include "DynamicActor.h"
 #include "Importable.h"
+#include "util/Reflection.h"
 
 namespace vigilante {
 
@@ -32,22 +33,33 @@ class Item : public DynamicActor, public Importable {
     std::string name;
     std::string desc;
     int price;
+
+    static constexpr auto kFields = reflection::fields(
+      reflection::field("itemType", &Profile::itemType),
+      reflection::field("textureResDir", &Profile::textureResDir),
+      reflection::field("name", &Profile::name),
+      reflection::field("desc", &Profile::desc),
+      reflection::field("price", &Profile::price));
   };
 
   // Create an item by automatically deducing its concrete type
   // based on the json passed in.
+  //
+  // The item's profile is a flyweight shared by all items created from the same json,
+  // and its sprite and b2Body only exist while the item is shown on the map,
+  // so items kept in an inventory are cheap.
   static std::unique_ptr<Item> create(const std::string& jsonFilePath);
 
   virtual ~Item() override = default;
 
   virtual bool showOnMap(float x, float y) override;  // DynamicActor
+  virtual bool removeFromMap() override;  // DynamicActor
   virtual void update(const float delta) override;  // DynamicActor
   virtual void import(const std::string& jsonFilePath) override;  // Importable
 
-  inline Item::Profile& getItemProfile() { return _itemProfile; }
-  inline const Item::Profile& getItemProfile() const { return _itemProfile; }
-  inline const std::string& getName() const { return _itemProfile.name; }
-  inline const std::string& getDesc() const { return _itemProfile.desc; }
+  inline const Item::Profile& getItemProfile() const { return *_itemProfile; }
+  inline const std::string& getName() const { return _itemProfile->name; }
+  inline const std::string& getDesc() const { return _itemProfile->desc; }
   std::string getIconPath() const;
   bool isGold() const;
 
@@ -65,7 +77,7 @@ class Item : public DynamicActor, public Importable {
 
   void handleVerticalFloatingMovement(const float delta);
 
-  Item::Profile _itemProfile;
+  std::shared_ptr<const Item::Profile> _itemProfile;
   int _amount{1};
   float _accumulatedDelta{};  // used for in-game-map up & down floating.
 };
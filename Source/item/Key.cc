@@ -2,6 +2,7 @@
 
 #include "Key.h"
 
+#include "ProfileCache.h"
 #include "util/JsonUtil.h"
 
 using namespace std;
@@ -10,13 +11,10 @@ namespace vigilante {
 
 Key::Key(const string& jsonFilePath)
     : MiscItem{jsonFilePath},
-      _keyProfile{jsonFilePath} {}
+      _keyProfile{ProfileCache<Key::Profile>::get(jsonFilePath)} {}
 
 Key::Profile::Profile(const string& jsonFilePath) {
-  rapidjson::Document json = json_util::loadFromFile(jsonFilePath);
-
-  targetTmxFilePath = json["targetTmxMapFilePath"].GetString();
-  targetPortalId = json["targetPortalId"].GetInt();
+  json_util::parseFileInto(jsonFilePath, *this);
 }
 
 }  // namespace vigilante
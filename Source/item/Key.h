@@ -3,9 +3,11 @@
 #ifndef VIGILANTE_ITEM_KEY_H_
 #define VIGILANTE_ITEM_KEY_H_
 
+#include <memory>
 #include <string>
 
 #include "MiscItem.h"
+#include "util/Reflection.h"
 
 namespace vigilante {
 
@@ -16,15 +18,19 @@ class Key : public MiscItem {
 
     std::string targetTmxFilePath;
     int targetPortalId;
+
+    static constexpr auto kFields = reflection::fields(
+      reflection::field("targetTmxMapFilePath", &Profile::targetTmxFilePath),
+      reflection::field("targetPortalId", &Profile::targetPortalId));
   };
 
   explicit Key(const std::string& jsonFilePath);
   virtual ~Key() override = default;
 
-  inline const Key::Profile& getKeyProfile() const { return _keyProfile; }
+  inline const Key::Profile& getKeyProfile() const { return *_keyProfile; }
 
  private:
-  Key::Profile _keyProfile;
+  std::shared_ptr<const Key::Profile> _keyProfile;
 };
 
 }  // namespace vigilante
@@ -0,0 +1,105 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Culling.h"
+
+#include "util/Profiler.h"
+
+using namespace std;
+USING_NS_AX;
+
+namespace vigilante {
+
+namespace {
+
+inline void setNodeVisible(StaticActor* actor, const bool isVisible) {
+  Node* node = actor->getNode();
+  if (node->isVisible() != isVisible) {
+    node->setVisible(isVisible);
+  }
+}
+
+}  // namespace
+
+void Culling::update(const Rect& viewRect) {
+  VGPROFILE_ZONE("Culling::update");
+
+  _nextVisibleActors.clear();
+  query(viewRect, [this](StaticActor* actor) {
+    setNodeVisible(actor, true);
+    _nextVisibleActors.insert(actor);
+  });
+
+  // Hide the actors which have left the view since the previous frame.
+  for (const auto actor : _visibleActors) {
+    if (!_nextVisibleActors.contains(actor)) {
+      setNodeVisible(actor, false);
+    }
+  }
+  _visibleActors.swap(_nextVisibleActors);
+
+  _stats.numVisibleNodes = _visibleActors.size();
+  _stats.numCulledNodes = _actorCells.size() - _visibleActors.size();
+}
+
+void Culling::add(StaticActor* actor) {
+  // Actors without a body sprite have nothing to be culled.
+  const Sprite* bodySprite = actor->getBodySprite();
+  if (!bodySprite || _actorCells.contains(actor)) {
+    return;
+  }
+
+  const int cellX = _grid.toCell(bodySprite->getPositionX());
+  const int cellY = _grid.toCell(bodySprite->getPositionY());
+  _grid.insertAt(cellX, cellY, actor);
+  _actorCells.insert({actor, {cellX, cellY}});
+
+  // Its node may have been hidden while it was shown on a previous map.
+  // If it's off-screen, it'll be hidden again in the next update().
+  setNodeVisible(actor, true);
+  _visibleActors.insert(actor);
+}
+
+void Culling::remove(StaticActor* actor) {
+  auto it = _actorCells.find(actor);
+  if (it == _actorCells.end()) {
+    return;
+  }
+
+  const auto [cellX, cellY] = it->second;
+  _grid.eraseAt(cellX, cellY, actor);
+  _actorCells.erase(it);
+  _visibleActors.erase(actor);
+}
+
+void Culling::updateCell(StaticActor* actor) {
+  auto it = _actorCells.find(actor);
+  if (it == _actorCells.end()) {
+    return;
+  }
+
+  // DynamicActor::update() keeps the body sprite in sync with its b2Body,
+  // so the body sprite's position is all we need here.
+  const Sprite* bodySprite = actor->getBodySprite();
+  const int cellX = _grid.toCell(bodySprite->getPositionX());
+  const int cellY = _grid.toCell(bodySprite->getPositionY());
+  auto& [oldCellX, oldCellY] = it->second;
+  if (cellX == oldCellX && cellY == oldCellY) {
+    return;
+  }
+
+  _grid.eraseAt(oldCellX, oldCellY, actor);
+  _grid.insertAt(cellX, cellY, actor);
+  oldCellX = cellX;
+  oldCellY = cellY;
+}
+
+void Culling::clear() {
+  _grid.clear();
+  _actorCells.clear();
+  _visibleActors.clear();
+  _nextVisibleActors.clear();
+  _stats.numVisibleNodes = 0;
+  _stats.numCulledNodes = 0;
+}
+
+}  // namespace vigilante
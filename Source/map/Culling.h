@@ -0,0 +1,79 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_MAP_CULLING_H_
+#define VIGILANTE_MAP_CULLING_H_
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <axmol.h>
+
+#include "DynamicActor.h"
+#include "StaticActor.h"
+#include "util/ds/UniformGrid.h"
+
+namespace vigilante {
+
+// Hides the nodes of the actors which are outside of the game camera's view.
+//
+// The actors shown on the game map are bucketed into a uniform grid of
+// kCellSize x kCellSize cells (by the position of their body sprite),
+// so each frame only the cells overlapping the view rect (expanded by kMargin)
+// are visited, and only the actors which were visible in the previous frame
+// are tested for leaving the view. Off-screen actors are never touched.
+//
+// GameMap adds and removes actors as they're shown and removed, and
+// re-buckets its DynamicActors after updating them (see updateCell()).
+// StaticActors never move, so they're bucketed once.
+//
+// Only the game camera's layer is culled, the parallax background (USER1)
+// and the hud (USER3) are always rendered as is. Since an actor's floating
+// health bar and other attachments are children of its `_node`, they are
+// culled together with the actor.
+class Culling final {
+ public:
+  static inline constexpr float kCellSize = 256.0f;
+  static inline constexpr float kMargin = 128.0f;
+
+  struct Stats final {
+    int numVisibleNodes;
+    int numCulledNodes;
+    int numVisibleLightSources;
+    int numCulledLightSources;
+  };
+
+  Culling() : _grid{kCellSize} {}
+
+  void update(const ax::Rect& viewRect);
+
+  // Must be called after `actor` is shown on the map, and before it's removed from the map.
+  void add(StaticActor* actor);
+  void remove(StaticActor* actor);
+  // Moves `actor` to the cell it's in now, if it has left its old cell.
+  void updateCell(StaticActor* actor);
+  void clear();
+
+  // Visits the actors in the cells overlapping `rect`.
+  template <typename Fn>
+  void query(const ax::Rect& rect, Fn&& fn) const {
+    _grid.query(rect.getMinX(), rect.getMinY(), rect.getMaxX(), rect.getMaxY(), std::forward<Fn>(fn));
+  }
+
+  inline const Culling::Stats& getStats() const { return _stats; }
+  inline void setLightSourceStats(const int numVisible, const int numCulled) {
+    _stats.numVisibleLightSources = numVisible;
+    _stats.numCulledLightSources = numCulled;
+  }
+
+ private:
+  UniformGrid<StaticActor*> _grid;
+  std::unordered_map<StaticActor*, std::pair<int, int>> _actorCells;
+  std::unordered_set<StaticActor*> _visibleActors;
+  std::unordered_set<StaticActor*> _nextVisibleActors;
+  Culling::Stats _stats{};
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_MAP_CULLING_H_
@@ -16,18 +16,20 @@
 #include "character/Player.h"
 #include "character/Npc.h"
 #include "character/Party.h"
+#include "gameplay/SaveJournal.h"
 #include "item/Equipment.h"
 #include "item/Consumable.h"
 #include "item/Key.h"
 #include "map/object/Chest.h"
 #include "map/object/StaticObject.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "ui/Colorscheme.h"
 #include "util/AxUtil.h"
 #include "util/B2BodyBuilder.h"
 #include "util/Logger.h"
 #include "util/MathUtil.h"
+#include "util/Profiler.h"
 #include "util/StringUtil.h"
 #include "util/RandUtil.h"
 
@@ -38,9 +40,10 @@ USING_NS_AX;
 
 namespace vigilante {
 
-GameMap::GameMap(b2World* world, Lighting* lighting, const string& tmxMapFilePath)
+GameMap::GameMap(b2World* world, Lighting* lighting, Culling* culling, const string& tmxMapFilePath)
     : _world{world},
       _lighting{lighting},
+      _culling{culling},
       _tmxTiledMap{TMXTiledMap::create(tmxMapFilePath)},
       _tmxTiledMapFilePath{tmxMapFilePath},
       _bgmFilePath{_tmxTiledMap->getProperty("bgm").asString()},
@@ -61,13 +64,17 @@ GameMap::~GameMap() {
   }
 
   _lighting->clear();
+  _culling->clear();
 }
 
 void GameMap::update(const float delta) {
+  VGPROFILE_ZONE("GameMap::update");
+
   _parallaxBackground->update(delta);
 
   for (auto& actor : _dynamicActors) {
     actor->update(delta);
+    _culling->updateCell(actor.get());
   }
 }
 
@@ -123,7 +130,7 @@ Item* GameMap::createItem(const string& itemJson, float x, float y, int amount)
   Item* item = showDynamicActor<Item>(Item::create(itemJson), x, y);
   item->setAmount(amount);
 
-  float offsetX = rand_util::randFloat(-.3f, .3f);
+  float offsetX = rand_util::randFloat(rand_util::Stream::LOOT, -.3f, .3f);
   float offsetY = 3.0f;
   item->getBody()->ApplyLinearImpulse({offsetX, offsetY},
                                       item->getBody()->GetWorldCenter(),
@@ -271,6 +278,9 @@ void GameMap::createTriggers() {
     float w = valMap.at("width").asFloat();
     float h = valMap.at("height").asFloat();
     vector<string> cmds = string_util::split(valMap.at("cmds").asString(), ';');
+    if (valMap.contains("script")) {
+      cmds.push_back(string_util::format("%s \"%s\"", cmd::kRunScript, valMap.at("script").asString().c_str()));
+    }
     bool canBeTriggeredOnlyOnce = valMap.at("canBeTriggeredOnlyOnce").asBool();
     bool canBeTriggeredOnlyByPlayer = valMap.at("canBeTriggeredOnlyByPlayer").asBool();
     bool shouldBlockWhileInBossFight = valMap.at("shouldBlockWhileInBossFight").asBool();
@@ -335,7 +345,7 @@ void GameMap::createPortals() {
 }
 
 void GameMap::createNpcs() {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
 
   for (const auto& rectObj : getObjects("Npcs")) {
     const auto& valMap = rectObj.asValueMap();
@@ -395,7 +405,7 @@ void GameMap::createLightSources() {
     _ambientLightLevelNight = ambientLightLevelNight.asFloat();
   }
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax::ValueVector objects = getObjects("LightSources");
   for (int i = 0; i < objects.size(); i++) {
     const auto& valMap = objects[i].asValueMap();
@@ -438,7 +448,7 @@ void GameMap::createParallaxBackground() {
     return;
   }
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax_util::addChildWithParentCameraMask(gmMgr->getParallaxLayer(), _parallaxBackground->getParallaxNode());
 }
 
@@ -449,7 +459,7 @@ GameMap::Trigger::Trigger(const vector<string>& cmds,
                           const string& controlHintText,
                           const int damage,
                           b2Body* body)
-    : _cmds{cmds},
+    : _cmds{CommandHandler::compile(cmds)},
       _canBeTriggeredOnlyOnce{canBeTriggeredOnlyOnce},
       _canBeTriggeredOnlyByPlayer{canBeTriggeredOnlyByPlayer},
       _shouldBlockWhileInBossFight{shouldBlockWhileInBossFight},
@@ -472,7 +482,7 @@ void GameMap::Trigger::onInteract(Character* user) {
 
   _hasTriggered = true;
 
-  auto console = SceneManager::the().getCurrentScene<GameScene>()->getConsole();
+  auto console = ServiceRegistry::get<Console>();
   for (const auto& cmd : _cmds) {
     console->executeCmd(cmd);
   }
@@ -506,7 +516,7 @@ void GameMap::Trigger::showHintUI() {
   }
 
   const Color4B textColor{colorscheme::kWhite};
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->insert({EventKeyboard::KeyCode::KEY_CAPITAL_E}, _controlHintText, textColor);
 }
 
@@ -515,7 +525,7 @@ void GameMap::Trigger::hideHintUI() {
     return;
   }
 
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->remove({EventKeyboard::KeyCode::KEY_CAPITAL_E});
 }
 
@@ -533,7 +543,7 @@ GameMap::Portal::Portal(const string& tmxMapFilePath, const int portalId,
       _width{width},
       _height{height},
       _body{body} {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   constexpr auto kType = OpenableObjectType::PORTAL;
   if (gmMgr->hasSavedOpenedClosedState(destTmxMapFilePath, kType, destPortalId)) {
     _isLocked = !gmMgr->isOpened(destTmxMapFilePath, kType, destPortalId);
@@ -557,7 +567,7 @@ void GameMap::Portal::onInteract(Character* user) {
   const bool shouldAdjustOffsetX = _shouldAdjustOffsetX;
   const float offsetXPercentage = (user->getBody()->GetPosition().x - _body->GetPosition().x) / _width;
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   auto afterLoadingGameMap = [user, destMapFilePath, destPortalId, shouldAdjustOffsetX, offsetXPercentage, gmMgr]() {
     const auto& portals = gmMgr->getGameMap()->_portals;
     assert(destPortalId < portals.size());
@@ -575,6 +585,8 @@ void GameMap::Portal::onInteract(Character* user) {
         ally->removeFromMap();
       }
     }
+
+    SaveJournal::the().checkpoint();
   };
 
   gmMgr->loadGameMap(destMapFilePath, afterLoadingGameMap);
@@ -588,18 +600,18 @@ void GameMap::Portal::showHintUI() {
   string text = "Open";
   Color4B textColor = colorscheme::kWhite;
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   if (_isLocked && !canBeUnlockedBy(gmMgr->getPlayer())) {
     text += " (Locked)";
     textColor = colorscheme::kRed;
   }
 
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->insert({EventKeyboard::KeyCode::KEY_CAPITAL_F}, text, textColor);
 }
 
 void GameMap::Portal::hideHintUI() {
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->remove({EventKeyboard::KeyCode::KEY_CAPITAL_F});
 }
 
@@ -608,7 +620,7 @@ void GameMap::Portal::createHintBubbleFx() {
     removeHintBubbleFx();
   }
 
-  auto fxMgr = SceneManager::the().getCurrentScene<GameScene>()->getFxManager();
+  auto fxMgr = ServiceRegistry::get<FxManager>();
   _hintBubbleFxSprite = fxMgr->createHintBubbleFx(_body, "portal_available");
 }
 
@@ -617,7 +629,7 @@ void GameMap::Portal::removeHintBubbleFx() {
     return;
   }
 
-  auto fxMgr = SceneManager::the().getCurrentScene<GameScene>()->getFxManager();
+  auto fxMgr = ServiceRegistry::get<FxManager>();
   fxMgr->removeFx(_hintBubbleFxSprite);
   _hintBubbleFxSprite = nullptr;
 }
@@ -627,7 +639,7 @@ void GameMap::Portal::maybeUnlockPortalAs(Character *user) {
     return;
   }
 
-  auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+  auto notifications = ServiceRegistry::get<Notifications>();
   if (!canBeUnlockedBy(user)) {
     notifications->show("This door is locked.");
     Audio::the().playSfx(kSfxDoorLocked);
@@ -639,7 +651,7 @@ void GameMap::Portal::maybeUnlockPortalAs(Character *user) {
 }
 
 bool GameMap::Portal::canBeUnlockedBy(Character* user) const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   auto gameMap = gmMgr->getGameMap();
   const auto& miscItems = user->getInventory()[Item::Type::MISC];
 
@@ -664,12 +676,12 @@ void GameMap::Portal::unlock() {
 }
 
 void GameMap::Portal::saveLockUnlockState() const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   gmMgr->setOpened(_tmxMapFilePath, OpenableObjectType::PORTAL, _portalId, !_isLocked);
 }
 
 int GameMap::Portal::getPortalId() const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   const auto& portals = gmMgr->getGameMap()->_portals;
 
   for (size_t i = 0; i < portals.size(); i++) {
@@ -17,9 +17,11 @@
 #include "gameplay/InGameTime.h"
 #include "Interactable.h"
 #include "item/Item.h"
+#include "map/Culling.h"
 #include "map/Lighting.h"
 #include "map/ParallaxBackground.h"
 #include "map/PathFinder.h"
+#include "ui/console/CommandHandler.h"
 #include "util/Logger.h"
 
 namespace vigilante {
@@ -80,7 +82,7 @@ class GameMap final {
     virtual void createHintBubbleFx() override {}  // Interactable
     virtual void removeHintBubbleFx() override {}  // Interactable
 
-    std::vector<std::string> _cmds;
+    std::vector<CompiledCmd> _cmds;
     bool _canBeTriggeredOnlyOnce{};
     bool _canBeTriggeredOnlyByPlayer{};
     bool _shouldBlockWhileInBossFight{};
@@ -139,7 +141,7 @@ class GameMap final {
     ax::Sprite* _hintBubbleFxSprite{};
   };
 
-  GameMap(b2World* world, Lighting* lighting, const std::string& tmxMapFilePath);
+  GameMap(b2World* world, Lighting* lighting, Culling* culling, const std::string& tmxMapFilePath);
   ~GameMap();
 
   void update(const float delta);
@@ -172,7 +174,7 @@ class GameMap final {
   inline ParallaxBackground* getParallaxBackground() const { return _parallaxBackground.get(); }
   inline PathFinder* getPathFinder() const { return _pathFinder.get(); }
   inline const std::unordered_set<std::shared_ptr<DynamicActor>>& getDynamicActors() const { return _dynamicActors; }
-  inline const std::list<b2Body*> getTmxTiledMapPlatformBodies() const { return _tmxTiledMapPlatformBodies; }
+  inline const std::list<b2Body*>& getTmxTiledMapPlatformBodies() const { return _tmxTiledMapPlatformBodies; }
 
   float getWidth() const;
   float getHeight() const;
@@ -194,6 +196,7 @@ class GameMap final {
 
   b2World* _world{};
   Lighting* _lighting{};
+  Culling* _culling{};
   ax::TMXTiledMap* _tmxTiledMap{};
   std::string _tmxTiledMapFilePath;
   std::string _bgmFilePath;
@@ -222,6 +225,7 @@ ReturnType* GameMap::showStaticActor(std::shared_ptr<StaticActor> actor, float x
   }
 
   actor->showOnMap(x, y);
+  _culling->add(actor.get());
   _staticActors.insert(std::move(actor));
   return shownActor;
 }
@@ -238,6 +242,7 @@ std::shared_ptr<ReturnType> GameMap::removeStaticActor(StaticActor* actor) {
   }
 
   removedActor = std::move(std::dynamic_pointer_cast<ReturnType>(*it));
+  _culling->remove(actor);
   removedActor->removeFromMap();
   _staticActors.erase(it);
   return removedActor;
@@ -255,6 +260,7 @@ ReturnType* GameMap::showDynamicActor(std::shared_ptr<DynamicActor> actor, float
   }
 
   actor->showOnMap(x, y);
+  _culling->add(actor.get());
   _dynamicActors.insert(std::move(actor));
   return shownActor;
 }
@@ -271,6 +277,7 @@ std::shared_ptr<ReturnType> GameMap::removeDynamicActor(DynamicActor* actor) {
   }
 
   removedActor = std::move(std::dynamic_pointer_cast<ReturnType>(*it));
+  _culling->remove(actor);
   removedActor->removeFromMap();
   _dynamicActors.erase(it);
   return removedActor;
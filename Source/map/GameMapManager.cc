@@ -10,13 +10,15 @@
 #include "Constants.h"
 #include "character/Npc.h"
 #include "character/Player.h"
+#include "gameplay/SaveJournal.h"
 #include "item/Equipment.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
-#include "skill/MagicalMissile.h"
+#include "scene/ServiceRegistry.h"
 #include "util/AxUtil.h"
 #include "util/B2BodyBuilder.h"
 #include "util/B2RayCastUtil.h"
+#include "util/CameraUtil.h"
+#include "util/Profiler.h"
 #include "util/StringUtil.h"
 
 using namespace std;
@@ -29,7 +31,9 @@ GameMapManager::GameMapManager(const b2Vec2& gravity)
       _layer{Layer::create()},
       _worldContactListener{std::make_unique<WorldContactListener>()},
       _world{std::make_unique<b2World>(gravity)},
-      _lighting{std::make_unique<Lighting>()} {
+      _lighting{std::make_unique<Lighting>()},
+      _culling{std::make_unique<Culling>()},
+      _projectileManager{std::make_unique<ProjectileManager>(_world.get(), _layer)} {
   _world->SetAllowSleeping(true);
   _world->SetContinuousPhysics(true);
   _world->SetContactListener(_worldContactListener.get());
@@ -38,6 +42,8 @@ GameMapManager::GameMapManager(const b2Vec2& gravity)
 }
 
 void GameMapManager::update(const float delta) {
+  VGPROFILE_ZONE("GameMapManager::update");
+
   if (!_gameMap) {
     return;
   }
@@ -50,13 +56,23 @@ void GameMapManager::update(const float delta) {
   for (const auto& ally : _player->getAllies()) {
     ally->update(delta);
   }
-
-  _lighting->update();
+  _projectileManager->update(delta, {_gameMap->getWidth(), _gameMap->getHeight()});
+
+  // The game camera is moved after this in GameScene::update(),
+  // so this rect lags behind by a frame, which is covered by the margin.
+  auto gameCamera = ServiceRegistry::get<GameScene>()->getGameCamera();
+  const Rect viewRect = camera_util::getViewRect(gameCamera, Culling::kMargin);
+  _culling->update(viewRect);
+  if (_isLightingEnabled) {
+    _lighting->update(viewRect, *_culling);
+    _culling->setLightSourceStats(_lighting->getNumVisibleLightSources(),
+                                  _lighting->getNumCulledLightSources());
+  }
 }
 
 void GameMapManager::loadGameMap(const string& tmxMapFilePath,
                                  const function<void ()>& afterLoadingGameMap) {
-  auto shade = SceneManager::the().getCurrentScene<GameScene>()->getShade();
+  auto shade = ServiceRegistry::get<Shade>();
   shade->getImageView()->runAction(Sequence::create(
       FadeIn::create(Shade::kFadeInTime),
       CallFunc::create([this, shade, tmxMapFilePath, afterLoadingGameMap]() {
@@ -78,6 +94,8 @@ void GameMapManager::destroyGameMap() {
     }
   }
 
+  _projectileManager->clear();
+
   if (_gameMap) {
     _parallaxLayer->removeAllChildren();
     _layer->removeChild(_gameMap->getTmxTiledMap());
@@ -86,10 +104,12 @@ void GameMapManager::destroyGameMap() {
 }
 
 GameMap* GameMapManager::doLoadGameMap(const string& tmxMapFilePath) {
+  VGPROFILE_ZONE("GameMapManager::doLoadGameMap");
+
   const string oldBgmFilePath = (_gameMap) ? _gameMap->getBgmFilePath() : "";
 
   destroyGameMap();
-  _gameMap = std::make_unique<GameMap>(_world.get(), _lighting.get(), tmxMapFilePath);
+  _gameMap = std::make_unique<GameMap>(_world.get(), _lighting.get(), _culling.get(), tmxMapFilePath);
   _gameMap->createObjects();
   ax_util::addChildWithParentCameraMask(_layer, _gameMap->getTmxTiledMap(), z_order::kTmxTiledMap);
 
@@ -133,8 +153,10 @@ bool GameMapManager::isNpcAllowedToSpawn(const string& jsonFilePath) const {
 void GameMapManager::setNpcAllowedToSpawn(const string& jsonFilePath, bool canSpawn) {
   if (!canSpawn && isNpcAllowedToSpawn(jsonFilePath)) {
     _npcSpawningBlacklist.insert(jsonFilePath);
+    SaveJournal::the().recordNpcSpawning(jsonFilePath, canSpawn);
   } else if (canSpawn && !isNpcAllowedToSpawn(jsonFilePath)) {
     _npcSpawningBlacklist.erase(jsonFilePath);
+    SaveJournal::the().recordNpcSpawning(jsonFilePath, canSpawn);
   }
 }
 
@@ -166,11 +188,12 @@ void GameMapManager::setOpened(const string& tmxMapFilePath,
                                const bool locked) {
   const string key = getOpenableObjectQueryKey(tmxMapFilePath, type, targetPortalId);
   _allOpenableObjectStates[key] = locked;
+  SaveJournal::the().recordOpenableObject(key, locked);
 }
 
 string GameMapManager::getOpenableObjectQueryKey(const string& tmxMapFilePath,
                                                  const GameMap::OpenableObjectType type,
-                                                 const int targetObjectId) const {
+                                                 const int targetObjectId) {
   string typeStr;
   switch (type) {
     case GameMap::OpenableObjectType::PORTAL:
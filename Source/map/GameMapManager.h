@@ -17,9 +17,11 @@
 #include "character/Character.h"
 #include "character/Player.h"
 #include "item/Item.h"
+#include "map/Culling.h"
 #include "map/GameMap.h"
 #include "map/Lighting.h"
 #include "map/WorldContactListener.h"
+#include "skill/ProjectileManager.h"
 
 namespace vigilante {
 
@@ -43,6 +45,10 @@ class GameMapManager final {
   bool isNpcAllowedToSpawn(const std::string& jsonFilePath) const;
   void setNpcAllowedToSpawn(const std::string& jsonFilePath, bool canSpawn);
 
+  // Lighting renders into its darkness overlay every update, so it's disabled
+  // when the map is updated without rendering any frame (see bench::Simulation).
+  inline void setLightingEnabled(const bool isLightingEnabled) { _isLightingEnabled = isLightingEnabled; }
+
   inline bool areNpcsAllowedToAct() const { return _areNpcsAllowedToAct; }
   inline void setNpcsAllowedToAct(bool npcsAllowedToAct) {
     _areNpcsAllowedToAct = npcsAllowedToAct;
@@ -59,29 +65,36 @@ class GameMapManager final {
                  const int targetPortalId,
                  const bool locked);
 
+  // @return the key of an openable object in `_allOpenableObjectStates`.
+  static std::string getOpenableObjectQueryKey(const std::string& tmxMapFilePath,
+                                               const GameMap::OpenableObjectType type,
+                                               const int targetObjectId);
+
   inline ax::Layer* getParallaxLayer() const { return _parallaxLayer; }
   inline ax::Layer* getLayer() const { return _layer; }
   inline b2World* getWorld() const { return _world.get(); }
   inline Lighting* getLighting() const { return _lighting.get(); }
+  inline Culling* getCulling() const { return _culling.get(); }
+  inline ProjectileManager* getProjectileManager() const { return _projectileManager.get(); }
   inline GameMap* getGameMap() const { return _gameMap.get(); }
   inline Player* getPlayer() const { return _player.get(); }
 
  private:
   GameMap* doLoadGameMap(const std::string& tmxMapFilePath);
-  std::string getOpenableObjectQueryKey(const std::string& tmxMapFilePath,
-                                        const GameMap::OpenableObjectType type,
-                                        const int targetObjectId) const;
 
   ax::Layer* _parallaxLayer{};
   ax::Layer* _layer{};
   std::unique_ptr<WorldContactListener> _worldContactListener;
   std::unique_ptr<b2World> _world;
   std::unique_ptr<Lighting> _lighting;
+  std::unique_ptr<Culling> _culling;
+  std::unique_ptr<ProjectileManager> _projectileManager;
   std::unique_ptr<GameMap> _gameMap;
   std::unique_ptr<Player> _player;
 
   std::unordered_set<std::string> _npcSpawningBlacklist;
   std::atomic<bool> _areNpcsAllowedToAct{true};
+  bool _isLightingEnabled{true};
 
   // This includes:
   // 1. The unlock/lock state of all portals in all maps.
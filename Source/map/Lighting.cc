@@ -7,9 +7,7 @@
 #include "Assets.h"
 #include "Constants.h"
 #include "map/GameMap.h"
-#include "scene/GameScene.h"
-#include "scene/SceneManager.h"
-#include "util/Logger.h"
+#include "util/Profiler.h"
 
 using namespace std;
 using namespace vigilante::assets;
@@ -17,64 +15,123 @@ USING_NS_AX;
 
 namespace vigilante {
 
+namespace {
+
+constexpr float kLightSourceGridCellSize = 256.0f;
+constexpr float kLightSourceCullingMargin = 128.0f;
+
+}  // namespace
+
 Lighting::Lighting()
     : _layer{Layer::create()},
-      _darknessOverlay{RenderTexture::create(1, 1)} {
+      _darknessOverlay{RenderTexture::create(1, 1)},
+      _staticLightSourceGrid{kLightSourceGridCellSize} {
   _layer->addChild(_darknessOverlay);
 }
 
-void Lighting::update() {
-  const auto inGameTime = SceneManager::the().getCurrentScene<GameScene>()->getInGameTime();
-  const float brightnessPercentage = getBrightnessPercentage(inGameTime);
-  updateAmbientLightLevel(inGameTime, brightnessPercentage);
-  updateParallaxLightLevel(inGameTime, brightnessPercentage);
-  updateLightSources();
+void Lighting::update(const Rect& viewRect, const Culling& culling) {
+  VGPROFILE_ZONE("Lighting::update");
+
+  updateLightSources(viewRect, culling);
 }
 
-float Lighting::getBrightnessPercentage(const InGameTime* inGameTime) const {
-  if (inGameTime->isDay() || inGameTime->isNight()) {
-    return 1.0f;  // no lerping needed.
-  }
+void Lighting::setInGameTime(InGameTime* inGameTime) {
+  _inGameTime = inGameTime;
+
+  const auto onPhaseBegin = [this](const Lighting::Phase phase) {
+    return [this, phase](const InGameTime::SubscriptionId) { setPhase(phase); };
+  };
+  _inGameTime->subscribeDailyAt(InGameTime::kDawnBeginHour, 0, onPhaseBegin(Phase::DAWN));
+  _inGameTime->subscribeDailyAt(InGameTime::kDawnEndHour, 0, onPhaseBegin(Phase::DAY));
+  _inGameTime->subscribeDailyAt(InGameTime::kDuskBeginHour, 0, onPhaseBegin(Phase::DUSK));
+  _inGameTime->subscribeDailyAt(InGameTime::kDuskEndHour, 0, onPhaseBegin(Phase::NIGHT));
+  syncWithInGameTime();
+}
 
-  const int hour = inGameTime->getHour();
-  const int minute = inGameTime->getMinute();
-  if (inGameTime->isDawn()) {
-    const float totalMins = (InGameTime::kDawnEndHour - InGameTime::kDawnBeginHour) * 60;
-    const float passedMins = (hour - InGameTime::kDawnBeginHour) * 60 + minute;
-    return passedMins / totalMins;
+void Lighting::syncWithInGameTime() {
+  if (!_inGameTime) {
+    return;
   }
-  if (inGameTime->isDusk()) {
-    const float totalMins = (InGameTime::kDuskEndHour - InGameTime::kDuskBeginHour) * 60;
-    const float passedMins = (hour - InGameTime::kDuskBeginHour) * 60 + minute;
-    return 1.0f - passedMins / totalMins;
+
+  const int hour = _inGameTime->getHour();
+  if (hour >= InGameTime::kDawnBeginHour && hour < InGameTime::kDawnEndHour) {
+    setPhase(Phase::DAWN);
+  } else if (hour >= InGameTime::kDawnEndHour && hour < InGameTime::kDuskBeginHour) {
+    setPhase(Phase::DAY);
+  } else if (hour >= InGameTime::kDuskBeginHour && hour < InGameTime::kDuskEndHour) {
+    setPhase(Phase::DUSK);
+  } else {
+    setPhase(Phase::NIGHT);
   }
+}
 
-  VGLOG(LOG_ERR, "Failed to get brightness percentage.");
-  return 1.0f;
+void Lighting::setGameMap(GameMap* gameMap) {
+  _gameMap = gameMap;
+  syncWithInGameTime();
 }
 
-void Lighting::updateAmbientLightLevel(const InGameTime* inGameTime, const float brightnessPercentage) {
-  if (inGameTime->isDay()) {
-    setAmbientLightLevel(_gameMap->getAmbientLightLevelDay());
-    return;
-  }
-  if (inGameTime->isNight()) {
-    setAmbientLightLevel(_gameMap->getAmbientLightLevelNight());
-    return;
+void Lighting::setPhase(const Lighting::Phase phase) {
+  _phase = phase;
+
+  const bool shouldLerp = phase == Phase::DAWN || phase == Phase::DUSK;
+  if (shouldLerp && !_lerpSubscriptionId) {
+    _lerpSubscriptionId = _inGameTime->subscribeEvery(0, 1, 0, [this](const InGameTime::SubscriptionId) {
+      updateLightLevels();
+    });
+  } else if (!shouldLerp && _lerpSubscriptionId) {
+    _inGameTime->cancel(_lerpSubscriptionId);
+    _lerpSubscriptionId = 0;
   }
-  if (inGameTime->isDawn()) {
-    setAmbientLightLevel(std::lerp(_gameMap->getAmbientLightLevelNight(), _gameMap->getAmbientLightLevelDay(), brightnessPercentage));
+
+  updateLightLevels();
+}
+
+void Lighting::updateLightLevels() {
+  if (!_gameMap) {
     return;
   }
-  if (inGameTime->isDusk()) {
-    setAmbientLightLevel(std::lerp(_gameMap->getAmbientLightLevelNight(), _gameMap->getAmbientLightLevelDay(), brightnessPercentage));
-    return;
+
+  const float brightnessPercentage = getBrightnessPercentage();
+  updateAmbientLightLevel(brightnessPercentage);
+  updateParallaxLightLevel(brightnessPercentage);
+}
+
+float Lighting::getBrightnessPercentage() const {
+  const int hour = _inGameTime->getHour();
+  const int minute = _inGameTime->getMinute();
+
+  switch (_phase) {
+    case Phase::DAWN: {
+      const float totalMins = (InGameTime::kDawnEndHour - InGameTime::kDawnBeginHour) * 60;
+      const float passedMins = (hour - InGameTime::kDawnBeginHour) * 60 + minute;
+      return passedMins / totalMins;
+    }
+    case Phase::DUSK: {
+      const float totalMins = (InGameTime::kDuskEndHour - InGameTime::kDuskBeginHour) * 60;
+      const float passedMins = (hour - InGameTime::kDuskBeginHour) * 60 + minute;
+      return 1.0f - passedMins / totalMins;
+    }
+    default:
+      return 1.0f;  // no lerping needed.
   }
+}
 
-  VGLOG(LOG_ERR, "Failed to update ambient light level.");
+void Lighting::updateAmbientLightLevel(const float brightnessPercentage) {
+  switch (_phase) {
+    case Phase::DAY:
+      setAmbientLightLevel(_gameMap->getAmbientLightLevelDay());
+      break;
+    case Phase::NIGHT:
+      setAmbientLightLevel(_gameMap->getAmbientLightLevelNight());
+      break;
+    case Phase::DAWN:
+    case Phase::DUSK:
+      setAmbientLightLevel(std::lerp(_gameMap->getAmbientLightLevelNight(), _gameMap->getAmbientLightLevelDay(), brightnessPercentage));
+      break;
+  }
 }
 
-void Lighting::updateParallaxLightLevel(const InGameTime* inGameTime, const float brightnessPercentage) {
+void Lighting::updateParallaxLightLevel(const float brightnessPercentage) {
   if (!_gameMap->getParallaxBackground()->getParallaxNode()) {
     return;
   }
@@ -83,14 +140,17 @@ void Lighting::updateParallaxLightLevel(const InGameTime* inGameTime, const floa
   constexpr uint8_t kMaxParallaxBgLightLevel{255};
 
   uint8_t level{};
-  if (inGameTime->isDay()) {
-    level = kMaxParallaxBgLightLevel;
-  } else if (inGameTime->isNight()) {
-    level = kMinParallaxBgLightLevel;
-  } else if (inGameTime->isDawn() || inGameTime->isDusk()) {
-    level = std::lerp(kMinParallaxBgLightLevel, kMaxParallaxBgLightLevel, brightnessPercentage);
-  } else {
-    VGLOG(LOG_ERR, "Failed to determine brightness level for parallax bg.");
+  switch (_phase) {
+    case Phase::DAY:
+      level = kMaxParallaxBgLightLevel;
+      break;
+    case Phase::NIGHT:
+      level = kMinParallaxBgLightLevel;
+      break;
+    case Phase::DAWN:
+    case Phase::DUSK:
+      level = std::lerp(kMinParallaxBgLightLevel, kMaxParallaxBgLightLevel, brightnessPercentage);
+      break;
   }
 
   const Color3B newColor{level, level, level};
@@ -101,20 +161,48 @@ void Lighting::updateParallaxLightLevel(const InGameTime* inGameTime, const floa
   }
 }
 
-void Lighting::updateLightSources() {
+void Lighting::updateLightSources(const Rect& viewRect, const Culling& culling) {
+  // A light source's glow reaches beyond its center,
+  // so don't cull it until its glow is out of view as well.
+  const Rect lightRect{viewRect.getMinX() - kLightSourceCullingMargin,
+                       viewRect.getMinY() - kLightSourceCullingMargin,
+                       viewRect.size.width + kLightSourceCullingMargin * 2,
+                       viewRect.size.height + kLightSourceCullingMargin * 2};
+
   _darknessOverlay->beginWithClear(0, 0, 0, 1.f - _ambientLightLevel);
+  _numVisibleLightSources = 0;
 
-  for (const auto& [dynamicActor, lightSourceSprite] : _dynamicLightSources) {
-    lightSourceSprite->setPosition(dynamicActor->getBody()->GetPosition().x * kPpm, dynamicActor->getBody()->GetPosition().y * kPpm);
-    lightSourceSprite->visit();
+  // Dynamic light sources move with their actors, so look for them among
+  // the actors in the cells overlapping `lightRect` (see Culling).
+  if (!_dynamicLightSources.empty()) {
+    culling.query(lightRect, [this, &lightRect](StaticActor* actor) {
+      auto it = _dynamicLightSources.find(actor);
+      if (it == _dynamicLightSources.end()) {
+        return;
+      }
+      const Vec2& position = actor->getBodySprite()->getPosition();
+      if (!lightRect.containsPoint(position)) {
+        return;
+      }
+      it->second->setPosition(position);
+      it->second->visit();
+      _numVisibleLightSources++;
+    });
   }
 
-  for (const auto& [pos, lightSourceSprite] : _staticLightSources) {
-    lightSourceSprite->setPosition(pos.first, pos.second);
+  // Static light sources never move, so their positions are set once in addLightSource(),
+  // and only those in the cells overlapping `lightRect` have to be visited.
+  const auto visitLightSource = [this](Sprite* lightSourceSprite) {
     lightSourceSprite->visit();
-  }
+    _numVisibleLightSources++;
+  };
+  _staticLightSourceGrid.query(lightRect.getMinX(), lightRect.getMinY(),
+                               lightRect.getMaxX(), lightRect.getMaxY(), visitLightSource);
 
   _darknessOverlay->end();
+
+  const int numLightSources = _dynamicLightSources.size() + _staticLightSources.size();
+  _numCulledLightSources = numLightSources - _numVisibleLightSources;
 }
 
 void Lighting::addLightSource(DynamicActor* dynamicActor) {
@@ -122,7 +210,7 @@ void Lighting::addLightSource(DynamicActor* dynamicActor) {
   lightSourceSprite->setBlendFunc({backend::BlendFactor::ZERO, backend::BlendFactor::ONE_MINUS_SRC_ALPHA});
   lightSourceSprite->retain();
 
-  _dynamicLightSources.push_back({dynamicActor, lightSourceSprite});
+  _dynamicLightSources.insert({dynamicActor, lightSourceSprite});
 }
 
 void Lighting::addLightSource(StaticActor *staticActor) {
@@ -132,15 +220,19 @@ void Lighting::addLightSource(StaticActor *staticActor) {
 
   const float x = staticActor->getBodySprite()->getPosition().x;
   const float y = staticActor->getBodySprite()->getPosition().y;
+  lightSourceSprite->setPosition(x, y);
   _staticLightSources.push_back({{x, y}, lightSourceSprite});
+  _staticLightSourceGrid.insert(x, y, lightSourceSprite);
 }
 
 void Lighting::addLightSource(const float x, const float y) {
   Sprite* lightSourceSprite = Sprite::create(kLightSource.c_str());
   lightSourceSprite->setBlendFunc({backend::BlendFactor::ZERO, backend::BlendFactor::ONE_MINUS_SRC_ALPHA});
   lightSourceSprite->retain();
+  lightSourceSprite->setPosition(x, y);
 
   _staticLightSources.push_back({{x, y}, lightSourceSprite});
+  _staticLightSourceGrid.insert(x, y, lightSourceSprite);
 }
 
 void Lighting::setDarknessOverlaySize(const float width, const float height) const {
@@ -159,6 +251,7 @@ void Lighting::clear() {
     lightSourceSprite->release();
   }
   _staticLightSources.clear();
+  _staticLightSourceGrid.clear();
 }
 
 }  // namespace vigilante
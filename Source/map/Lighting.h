@@ -4,23 +4,47 @@
 #define VIGILANTE_MAP_LIGHTING_H_
 
 #include <list>
+#include <unordered_map>
 
 #include <axmol.h>
 
 #include "DynamicActor.h"
 #include "gameplay/InGameTime.h"
+#include "map/Culling.h"
 #include "StaticActor.h"
+#include "util/ds/UniformGrid.h"
 
 namespace vigilante {
 
 class GameMap;
 
+// The ambient light level (and that of the parallax background) only changes
+// with the phase of the day, so rather than checking the in-game time every frame,
+// Lighting subscribes to the beginning of each phase, and to every in-game minute
+// during dawn and dusk, when the light levels are lerped.
 class Lighting final {
  public:
+  enum class Phase {
+    DAWN,  // [kDawnBeginHour, kDawnEndHour)
+    DAY,
+    DUSK,  // [kDuskBeginHour, kDuskEndHour)
+    NIGHT
+  };
+
   Lighting();
   ~Lighting() { clear(); }
 
-  void update();
+  // @param viewRect: light sources outside of this rect won't be drawn.
+  // @param culling: the actors of dynamic light sources are looked up in its grid.
+  void update(const ax::Rect& viewRect, const Culling& culling);
+
+  // Subscribes to the phases of the day. `inGameTime` must outlive this object's use,
+  // and its subscriptions are never cancelled here, since it's destroyed first (see GameScene).
+  void setInGameTime(InGameTime* inGameTime);
+  // Updates the phase after the in-game time has been set rather than advanced,
+  // since setting it doesn't fire the subscriptions in between.
+  void syncWithInGameTime();
+  // `dynamicActor` must be shown on the game map, i.e., be bucketed by Culling.
   void addLightSource(DynamicActor* dynamicActor);
   void addLightSource(StaticActor* staticActor);
   void addLightSource(const float x, const float y);
@@ -28,21 +52,32 @@ class Lighting final {
   void clear();
 
   inline ax::Layer* getLayer() const { return _layer; }
-  inline void setGameMap(GameMap* gameMap) { _gameMap = gameMap; }
+  inline int getNumVisibleLightSources() const { return _numVisibleLightSources; }
+  inline int getNumCulledLightSources() const { return _numCulledLightSources; }
+  inline Lighting::Phase getPhase() const { return _phase; }
+  void setGameMap(GameMap* gameMap);
   inline void setAmbientLightLevel(const float level) { _ambientLightLevel = level; }
 
  private:
-  float getBrightnessPercentage(const InGameTime* inGameTime) const;
-  void updateAmbientLightLevel(const InGameTime* inGameTime, const float brightnessPercentage);
-  void updateParallaxLightLevel(const InGameTime* inGameTime, const float brightnessPercentage);
-  void updateLightSources();
+  void setPhase(const Lighting::Phase phase);
+  void updateLightLevels();
+  float getBrightnessPercentage() const;
+  void updateAmbientLightLevel(const float brightnessPercentage);
+  void updateParallaxLightLevel(const float brightnessPercentage);
+  void updateLightSources(const ax::Rect& viewRect, const Culling& culling);
 
   ax::Layer* _layer{};
   ax::RenderTexture* _darknessOverlay{};
-  std::list<std::pair<DynamicActor*, ax::Sprite*>> _dynamicLightSources;
+  std::unordered_map<const StaticActor*, ax::Sprite*> _dynamicLightSources;
   std::list<std::pair<std::pair<float, float>, ax::Sprite*>> _staticLightSources;
+  UniformGrid<ax::Sprite*> _staticLightSourceGrid;
+  int _numVisibleLightSources{};
+  int _numCulledLightSources{};
 
   GameMap* _gameMap{};
+  InGameTime* _inGameTime{};
+  Lighting::Phase _phase{Lighting::Phase::DAY};
+  InGameTime::SubscriptionId _lerpSubscriptionId{};  // 0 unless it's dawn or dusk
   float _ambientLightLevel{0.3f};
 };
 
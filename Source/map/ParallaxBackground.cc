@@ -3,6 +3,7 @@
 #include "ParallaxBackground.h"
 
 #include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 
 namespace fs = std::filesystem;
 using namespace std;
@@ -44,7 +45,7 @@ void InfiniteParallaxNode::addLayer(const string &filePath,
 }
 
 void InfiniteParallaxNode::update(const float delta) {
-  const auto gameCamera = SceneManager::the().getCurrentScene<GameScene>()->getGameCamera();
+  const auto gameCamera = ServiceRegistry::get<GameScene>()->getGameCamera();
   if (!gameCamera) {
     VGLOG(LOG_ERR, "GameScene's game camera not present.");
     return;
@@ -5,7 +5,7 @@
 #include <limits>
 
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 
 using namespace std;
 
@@ -14,6 +14,14 @@ namespace vigilante {
 optional<b2Vec2> SimplePathFinder::findOptimalNextHop(const b2Vec2& srcPos,
                                                       const b2Vec2& destPos,
                                                       const float followDist) {
+  GameMap* gameMap = ServiceRegistry::get<GameMapManager>()->getGameMap();
+  return findOptimalNextHop(srcPos, destPos, followDist, gameMap->getTmxTiledMapPlatformBodies());
+}
+
+optional<b2Vec2> SimplePathFinder::findOptimalNextHop(const b2Vec2& srcPos,
+                                                      const b2Vec2& destPos,
+                                                      const float followDist,
+                                                      const list<b2Body*>& platformBodies) {
   if (destPos.y - srcPos.y < followDist) {
     return std::nullopt;
   }
@@ -21,10 +29,7 @@ optional<b2Vec2> SimplePathFinder::findOptimalNextHop(const b2Vec2& srcPos,
   const b2Body* closestPlatformBody = nullptr;
   float minDist = numeric_limits<float>::max();
 
-  GameMap* gameMap = SceneManager::the().getCurrentScene<GameScene>()->
-      getGameMapManager()->getGameMap();
-
-  for (auto platformBody : gameMap->getTmxTiledMapPlatformBodies()) {
+  for (auto platformBody : platformBodies) {
     const b2Vec2& platformPos = platformBody->GetPosition();
     if (platformPos.y < srcPos.y) {
       continue;
@@ -3,6 +3,7 @@
 #ifndef VIGILANTE_MAP_PATH_FINDER_H_
 #define VIGILANTE_MAP_PATH_FINDER_H_
 
+#include <list>
 #include <optional>
 
 #include <box2d/box2d.h>
@@ -22,6 +23,12 @@ class SimplePathFinder final : public PathFinder {
   virtual std::optional<b2Vec2> findOptimalNextHop(const b2Vec2& srcPos,
                                                    const b2Vec2& destPos,
                                                    const float followDist) override;
+
+  // Searches the given platforms instead of those of the current GameMap.
+  static std::optional<b2Vec2> findOptimalNextHop(const b2Vec2& srcPos,
+                                                  const b2Vec2& destPos,
+                                                  const float followDist,
+                                                  const std::list<b2Body*>& platformBodies);
 };
 
 }  // namespace vigilante
@@ -8,7 +8,6 @@
 
 #include "CallbackManager.h"
 #include "Constants.h"
-#include "Projectile.h"
 #include "character/Character.h"
 #include "character/Player.h"
 #include "character/Npc.h"
@@ -213,42 +212,6 @@ void WorldContactListener::BeginContact(b2Contact* contact) {
       }
       break;
     }
-    // When a project tile hits the player, play onHitAnimation and inflict damage.
-    case category_bits::kProjectile | category_bits::kPlayer: {
-      b2Fixture* projectileFixture = GetTargetFixture(category_bits::kProjectile, fixtureA, fixtureB);
-      b2Fixture* playerFixture = GetTargetFixture(category_bits::kPlayer, fixtureA, fixtureB);
-
-      if (projectileFixture && playerFixture) {
-        DynamicActor* p = reinterpret_cast<DynamicActor*>(projectileFixture->GetUserData().pointer);
-        Character* c = reinterpret_cast<Character*>(playerFixture->GetUserData().pointer);
-
-        Projectile* missile = dynamic_cast<Projectile*>(p);
-        if (missile->getUser() == c) {
-          contact->SetEnabled(false);
-          return;
-        }
-        missile->onHit(c);
-      }
-      break;
-    }
-    // When a project tile hits an enemy, play onHitAnimation and inflict damage.
-    case category_bits::kProjectile | category_bits::kEnemy: {
-      b2Fixture* projectileFixture = GetTargetFixture(category_bits::kProjectile, fixtureA, fixtureB);
-      b2Fixture* enemyFixture = GetTargetFixture(category_bits::kEnemy, fixtureA, fixtureB);
-
-      if (projectileFixture && enemyFixture) {
-        DynamicActor* p = reinterpret_cast<DynamicActor*>(projectileFixture->GetUserData().pointer);
-        Character* c = reinterpret_cast<Character*>(enemyFixture->GetUserData().pointer);
-
-        Projectile* missile = dynamic_cast<Projectile*>(p);
-        if (missile->getUser() == c) {
-          contact->SetEnabled(false);
-          return;
-        }
-        missile->onHit(c);
-      }
-      break;
-    }
     default:
       break;
   }
@@ -6,7 +6,7 @@
 #include "Audio.h"
 #include "Constants.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/AxUtil.h"
 #include "util/B2BodyBuilder.h"
 #include "util/JsonUtil.h"
@@ -37,7 +37,7 @@ Chest::Chest(const string& tmxMapFilePath,
       _chestId{chestId},
       _itemJsons{string_util::split(itemJsons)} {
   constexpr auto kType = GameMap::OpenableObjectType::CHEST;
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   _isOpened = gmMgr->isOpened(tmxMapFilePath, kType, chestId);
 }
 
@@ -60,7 +60,7 @@ bool Chest::showOnMap(float x, float y) {
   _bodySprite->getTexture()->setAliasTexParameters();
   _node->addChild(_bodySprite, z_order::kChest);
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax_util::addChildWithParentCameraMask(gmMgr->getLayer(), _node, z_order::kChest);
 
   return true;
@@ -71,7 +71,7 @@ void Chest::defineBody(b2BodyType bodyType,
                        float y,
                        short categoryBits,
                        short maskBits) {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   B2BodyBuilder bodyBuilder(gmMgr->getWorld());
 
   _body = bodyBuilder.type(bodyType)
@@ -101,7 +101,7 @@ void Chest::onInteract(Character*) {
   _bodySprite->setTexture("Texture/interactable_object/chest/chest_open.png");
   _bodySprite->getTexture()->setAliasTexParameters();
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   for (const auto& item : _itemJsons) {
     float x = _body->GetPosition().x;
     float y = _body->GetPosition().y;
@@ -121,14 +121,14 @@ void Chest::showHintUI() {
 
   createHintBubbleFx();
 
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->insert({EventKeyboard::KeyCode::KEY_CAPITAL_E}, "Open");
 }
 
 void Chest::hideHintUI() {
   removeHintBubbleFx();
 
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->remove({EventKeyboard::KeyCode::KEY_CAPITAL_E});
 }
 
@@ -141,7 +141,7 @@ void Chest::createHintBubbleFx() {
     return;
   }
 
-  auto fxMgr = SceneManager::the().getCurrentScene<GameScene>()->getFxManager();
+  auto fxMgr = ServiceRegistry::get<FxManager>();
   _hintBubbleFxSprite = fxMgr->createHintBubbleFx(_body, "dialogue_available");
 }
 
@@ -150,7 +150,7 @@ void Chest::removeHintBubbleFx() {
     return;
   }
 
-  auto fxMgr = SceneManager::the().getCurrentScene<GameScene>()->getFxManager();
+  auto fxMgr = ServiceRegistry::get<FxManager>();
   fxMgr->removeFx(_hintBubbleFxSprite);
   _hintBubbleFxSprite = nullptr;
 }
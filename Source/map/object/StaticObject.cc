@@ -5,7 +5,7 @@
 #include "Assets.h"
 #include "Constants.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/AxUtil.h"
 
 using namespace std;
@@ -25,7 +25,7 @@ bool StaticObject::showOnMap(float x, float y) {
   _node->removeAllChildren();
   _node->addChild(_bodySpritesheet);
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   ax_util::addChildWithParentCameraMask(gmMgr->getLayer(), _node, _zOrder);
 
   return true;
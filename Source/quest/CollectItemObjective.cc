@@ -3,14 +3,14 @@
 #include "CollectItemObjective.h"
 
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 
 using namespace std;
 
 namespace vigilante {
 
 bool CollectItemObjective::isCompleted() const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   return gmMgr->getPlayer()->getItemAmount(_itemJsonFilePath) >= _amount;
 }
 
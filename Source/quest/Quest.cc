@@ -9,7 +9,7 @@
 #include "quest/InteractWithTargetObjective.h"
 #include "quest/KillTargetObjective.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "ui/console/Console.h"
 #include "util/JsonUtil.h"
 #include "util/StringUtil.h"
@@ -30,7 +30,7 @@ void Quest::advanceStage() {
   // Execute the commands that are supposed to run after
   // this stage is completed.
   if (_currentStageIdx >= 0) {
-    auto console = SceneManager::the().getCurrentScene<GameScene>()->getConsole();
+    auto console = ServiceRegistry::get<Console>();
     for (const auto& cmd : getCurrentStage().cmds) {
       console->executeCmd(cmd);
     }
@@ -123,9 +123,14 @@ Quest::Profile::Profile(const string& jsonFilePath) : jsonFilePath{jsonFilePath}
       stage.questDesc = stageJson["questDesc"].GetString();;
     }
 
+    vector<string> cmds;
     for (const auto& cmd : stageJson["exec"].GetArray()) {
-      stage.cmds.push_back(cmd.GetString());
+      cmds.push_back(cmd.GetString());
     }
+    if (stageJson.HasMember("script")) {
+      cmds.push_back(string_util::format("%s \"%s\"", cmd::kRunScript, stageJson["script"].GetString()));
+    }
+    stage.cmds = CommandHandler::compile(cmds);
 
     stages.emplace_back(std::move(stage));
   }
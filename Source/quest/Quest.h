@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "Importable.h"
+#include "ui/console/CommandHandler.h"
 
 namespace vigilante {
 
@@ -50,7 +51,7 @@ class Quest final : public Importable {
     bool isFinished;
     std::string questDesc;  // optionally update questDesc when this stage is reached.
     std::unique_ptr<Objective> objective;
-    std::vector<std::string> cmds;
+    std::vector<CompiledCmd> cmds;
   };
 
   struct Profile final {
@@ -8,7 +8,7 @@
 
 #include "quest/KillTargetObjective.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "ui/console/Console.h"
 #include "util/ds/Algorithm.h"
 #include "util/StringUtil.h"
@@ -33,9 +33,9 @@ QuestBook::QuestBook(const string& questsListFilePath) {
 }
 
 void QuestBook::update(Quest::Objective::Type objectiveType) {
-  auto questHints = SceneManager::the().getCurrentScene<GameScene>()->getQuestHints();
+  auto questHints = ServiceRegistry::get<QuestHints>();
 
-  VGLOG(LOG_INFO, "Updating quests");
+  VGLOG(LOG_DEBUG, "Updating quests");
   for (const auto quest : _inProgressQuests) {
     if (quest->getCurrentStage().objective->getObjectiveType() != objectiveType) {
       continue;
@@ -77,7 +77,7 @@ bool QuestBook::startQuest(Quest* quest) {
   _inProgressQuests.push_back(quest);
   quest->advanceStage();
 
-  auto questHints = SceneManager::the().getCurrentScene<GameScene>()->getQuestHints();
+  auto questHints = ServiceRegistry::get<QuestHints>();
   questHints->show("Started: " + quest->getQuestProfile().title);
   questHints->show(quest->getCurrentStage().objective->getDesc());
 
@@ -99,7 +99,7 @@ bool QuestBook::setStage(Quest* quest, const int stageIdx) {
   }
 
   const Quest::Stage &prevStage = quest->getCurrentStage();
-  auto console = SceneManager::the().getCurrentScene<GameScene>()->getConsole();
+  auto console = ServiceRegistry::get<Console>();
   for (const auto& cmd : prevStage.cmds) {
     console->executeCmd(cmd);
   }
@@ -108,7 +108,7 @@ bool QuestBook::setStage(Quest* quest, const int stageIdx) {
     return markCompleted(quest);
   }
 
-  auto questHints = SceneManager::the().getCurrentScene<GameScene>()->getQuestHints();
+  auto questHints = ServiceRegistry::get<QuestHints>();
   quest->setCurrentStageIdx(stageIdx);
   questHints->show("Completed: " + prevStage.objective->getDesc());
   questHints->show(quest->getCurrentStage().objective->getDesc());
@@ -127,7 +127,7 @@ bool QuestBook::markCompleted(Quest* quest) {
   _inProgressQuests.erase(std::remove(_inProgressQuests.begin(), _inProgressQuests.end(), quest), _inProgressQuests.end());
   _completedQuests.push_back(quest);
 
-  auto questHints = SceneManager::the().getCurrentScene<GameScene>()->getQuestHints();
+  auto questHints = ServiceRegistry::get<QuestHints>();
   questHints->show("Completed: " + quest->getQuestProfile().title);
 
   return true;
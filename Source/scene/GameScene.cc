@@ -8,11 +8,15 @@
 #include "character/Player.h"
 #include "gameplay/ExpPointTable.h"
 #include "gameplay/GameState.h"
+#include "input/InputRecording.h"
 #include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "skill/Skill.h"
 #include "quest/Quest.h"
 #include "util/CameraUtil.h"
+#include "util/FrameArena.h"
 #include "util/KeyCodeUtil.h"
+#include "util/Profiler.h"
 #include "util/RandUtil.h"
 #include "util/Logger.h"
 
@@ -22,6 +26,13 @@ USING_NS_AX;
 
 namespace vigilante {
 
+GameScene::~GameScene() {
+  if (_fixedDelta > 0) {
+    auto director = Director::getInstance();
+    director->getScheduler()->scheduleUpdate(director->getActionManager(), Scheduler::PRIORITY_SYSTEM, false);
+  }
+}
+
 bool GameScene::init() {
   if (!Scene::init()) {
     return false;
@@ -41,7 +52,8 @@ bool GameScene::init() {
   _hotkeyManager = std::make_unique<HotkeyManager>();
 
   // Initialize CallbackManager.
-  CallbackManager::the().setScene(this);
+  // Discard the pending callbacks left by the previous GameScene (if any).
+  CallbackManager::the().clear();
 
   // Initialize Vigilante's utils.
   vigilante::keycode_util::init();
@@ -111,6 +123,11 @@ bool GameScene::init() {
   _notifications->getLayer()->setCameraMask(camera::kHudCameraMask);
   addChild(_notifications->getLayer(), z_order::kNotification);
 
+  // Initialize profiler overlay.
+  _profilerOverlay = std::make_unique<ProfilerOverlay>();
+  _profilerOverlay->getLayer()->setCameraMask(camera::kHudCameraMask);
+  addChild(_profilerOverlay->getLayer(), z_order::kProfilerOverlay);
+
   // Initialize quest hints.
   _questHints = std::make_unique<QuestHints>();
   _questHints->getLayer()->setCameraMask(camera::kHudCameraMask);
@@ -157,6 +174,7 @@ bool GameScene::init() {
 
   // Initialize in-game time.
   _inGameTime = std::make_unique<InGameTime>();
+  _gameMapManager->getLighting()->setInGameTime(_inGameTime.get());
 
   // Initialize room rental tracker.
   _roomRentalTracker = std::make_unique<RoomRentalTracker>();
@@ -182,7 +200,22 @@ bool GameScene::init() {
   return true;
 }
 
-void GameScene::update(const float delta) {
+void GameScene::update(float delta) {
+  VGPROFILE_FRAME();
+  VGPROFILE_ZONE("GameScene::update");
+
+  // Everything allocated from the frame arena since the last update() is dead by now,
+  // including what the input event handlers in between have allocated.
+  FrameArena::the().reset();
+
+  // The actions are stepped along with the rest of the scene, so that GameMap transitions
+  // (and thus the ticks at which the b2World is stepped below) take the same number of ticks
+  // regardless of the frame rate. The scheduler steps the action manager first, so do we.
+  if (_fixedDelta > 0) {
+    delta = _fixedDelta;
+    Director::getInstance()->getActionManager()->update(delta);
+  }
+
   if (!_isRunning) {
     if (_isTerminating) {
       return;
@@ -199,6 +232,14 @@ void GameScene::update(const float delta) {
     return;
   }
 
+  // Recorded sessions are stepped at a fixed delta (see setFixedDelta()),
+  // so that they can be replayed tick by tick.
+  if (InputRecorder::the().isRecording()) {
+    InputRecorder::the().tick();
+  } else if (InputReplayer::the().isReplaying()) {
+    InputReplayer::the().tick();
+  }
+
   handleInput();
 
   if (_pauseMenu->isVisible()) {
@@ -207,9 +248,12 @@ void GameScene::update(const float delta) {
 
   // If there are no ongoing GameMap transitions, then step the box2d world.
   if (_shade->getImageView()->getNumberOfRunningActions() == 0) {
+    VGPROFILE_ZONE("b2World::Step");
     _gameMapManager->getWorld()->Step(1.0f / kFps, kVelocityIterations, kPositionIterations);
   }
 
+  // Pending callbacks are only ticked here, so they're frozen while the game is paused.
+  CallbackManager::the().update(delta);
   _inGameTime->update(delta);
   _timeLocationInfo->update();
   _gameMapManager->update(delta);
@@ -220,17 +264,30 @@ void GameScene::update(const float delta) {
   _dialogueManager->update(delta);
   _console->update(delta);
   _windowManager->update(delta);
+  _profilerOverlay->update();
 
   if (_drawBox2D->isVisible()) {
+    VGPROFILE_ZONE("b2World::DebugDraw");
     _drawBox2D->clear();
     _gameMapManager->getWorld()->DebugDraw();
   }
 
+  VGPROFILE_ZONE("camera_util");
   camera_util::lerpToTarget(_gameCamera, _gameMapManager->getPlayer()->getBody()->GetPosition());
   camera_util::boundCamera(_gameCamera, _gameMapManager->getGameMap());
   camera_util::updateShake(_gameCamera, delta);
 }
 
+void GameScene::setFixedDelta(const float delta) {
+  auto director = Director::getInstance();
+  if (delta > 0 && _fixedDelta == 0) {
+    director->getScheduler()->unscheduleUpdate(director->getActionManager());
+  } else if (delta == 0 && _fixedDelta > 0) {
+    director->getScheduler()->scheduleUpdate(director->getActionManager(), Scheduler::PRIORITY_SYSTEM, false);
+  }
+  _fixedDelta = delta;
+}
+
 void GameScene::handleInput() {
   // First thing first: If there is a specialOnKeyPressed Event Listener, then we should simply
   // let it do its job, and return immediately so that we won't interfere with it.
@@ -245,6 +302,13 @@ void GameScene::handleInput() {
     return;
   }
 
+  if (IS_KEY_JUST_PRESSED(EventKeyboard::KeyCode::KEY_9)) {
+    bool isVisible = !_profilerOverlay->isVisible();
+    _profilerOverlay->setVisible(isVisible);
+    _notifications->show(string("Profiler: ") + ((isVisible) ? "on" : "off"));
+    return;
+  }
+
   if (IS_KEY_JUST_PRESSED(EventKeyboard::KeyCode::KEY_ESCAPE)) {
     if (!_windowManager->isEmpty()) {
       _windowManager->pop();
@@ -288,13 +352,36 @@ void GameScene::startNewGame() {
 }
 
 void GameScene::loadGame(const string& gameSaveFilePath) {
-  _gameMapManager->loadGameMap(kNewGameInitialMap, [gameSaveFilePath]() {
-    GameState(gameSaveFilePath).load();
-  });
+  // Only the saved game map is loaded, along with the player (see GameState::apply()).
+  if (!GameState(gameSaveFilePath).load()) {
+    VGLOG(LOG_ERR, "Failed to load [%s], starting a new game instead.", gameSaveFilePath.c_str());
+    startNewGame();
+  }
 }
 
 void GameScene::quit() {
   _gameMapManager->destroyGameMap();
 }
 
+void GameScene::bindServices() {
+  ServiceRegistry::bind(this);
+  ServiceRegistry::bind(_hotkeyManager.get());
+  ServiceRegistry::bind(_shade.get());
+  ServiceRegistry::bind(_hud.get());
+  ServiceRegistry::bind(_timeLocationInfo.get());
+  ServiceRegistry::bind(_console.get());
+  ServiceRegistry::bind(_pauseMenu.get());
+  ServiceRegistry::bind(_windowManager.get());
+  ServiceRegistry::bind(_controlHints.get());
+  ServiceRegistry::bind(_dialogueManager.get());
+  ServiceRegistry::bind(_floatingDamages.get());
+  ServiceRegistry::bind(_questHints.get());
+  ServiceRegistry::bind(_notifications.get());
+  ServiceRegistry::bind(_gameMapManager.get());
+  ServiceRegistry::bind(_fxManager.get());
+  ServiceRegistry::bind(_afterImageFxManager.get());
+  ServiceRegistry::bind(_inGameTime.get());
+  ServiceRegistry::bind(_roomRentalTracker.get());
+}
+
 }  // namespace vigilante
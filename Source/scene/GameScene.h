@@ -27,6 +27,7 @@
 #include "ui/hud/Hud.h"
 #include "ui/hud/TimeLocationInfo.h"
 #include "ui/hud/Notifications.h"
+#include "ui/hud/ProfilerOverlay.h"
 #include "ui/pause_menu/PauseMenu.h"
 #include "ui/quest_hints/QuestHints.h"
 #include "ui/Shade.h"
@@ -37,10 +38,10 @@ namespace vigilante {
 class GameScene final : public ax::Scene, public Controllable {
  public:
   CREATE_FUNC(GameScene);
-  virtual ~GameScene() override = default;
+  virtual ~GameScene() override;
 
   virtual bool init() override;  // ax::Scene
-  virtual void update(const float delta) override;  // ax::Scene
+  virtual void update(float delta) override;  // ax::Scene
 
   virtual void handleInput() override;  // Controllable
 
@@ -48,6 +49,15 @@ class GameScene final : public ax::Scene, public Controllable {
   void loadGame(const std::string& gameSaveFilePath);
   void quit();
 
+  // Binds this scene and the subsystems it owns to ServiceRegistry.
+  void bindServices();
+
+  // Steps this scene at `delta` each frame instead of at the wall-clock delta,
+  // including the actions (e.g., the shade's fading during GameMap transitions
+  // and the character animations), which are no longer stepped by the scheduler.
+  // Used while recording or replaying an input session (see input/InputRecording.h).
+  void setFixedDelta(const float delta);
+
   inline bool isRunning() const { return _isRunning; }
   inline void setRunning(bool running) { _isRunning = running; }
 
@@ -74,6 +84,7 @@ class GameScene final : public ax::Scene, public Controllable {
  private:
   bool _isRunning;
   bool _isTerminating;
+  float _fixedDelta{};  // 0 if stepped at the wall-clock delta
 
   ax::Camera* _parallaxCamera;
   ax::Camera* _gameCamera;
@@ -87,6 +98,7 @@ class GameScene final : public ax::Scene, public Controllable {
   std::unique_ptr<TimeLocationInfo> _timeLocationInfo;
   std::unique_ptr<Console> _console;
   std::unique_ptr<Notifications> _notifications;
+  std::unique_ptr<ProfilerOverlay> _profilerOverlay;
   std::unique_ptr<QuestHints> _questHints;
   std::unique_ptr<FloatingDamages> _floatingDamages;
   std::unique_ptr<ControlHints> _controlHints;
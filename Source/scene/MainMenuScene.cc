@@ -8,6 +8,7 @@
 #include "Audio.h"
 #include "scene/GameScene.h"
 #include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "ui/Colorscheme.h"
 
 using namespace std;
@@ -82,14 +83,14 @@ void MainMenuScene::handleInput() {
         Audio::the().stopBgm();
         InputManager::the().deactivate();
         SceneManager::the().pushScene(GameScene::create());
-        SceneManager::the().getCurrentScene<GameScene>()->startNewGame();
+        ServiceRegistry::get<GameScene>()->startNewGame();
         break;
       }
       case Option::LOAD_GAME: {
         Audio::the().stopBgm();
         InputManager::the().deactivate();
         SceneManager::the().pushScene(GameScene::create());
-        SceneManager::the().getCurrentScene<GameScene>()->loadGame("quicksave.vgs");
+        ServiceRegistry::get<GameScene>()->loadGame("quicksave.vgs");
         break;
       }
       case Option::OPTIONS:
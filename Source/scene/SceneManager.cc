@@ -4,6 +4,7 @@
 
 #include "input/InputManager.h"
 #include "scene/GameScene.h"
+#include "scene/ServiceRegistry.h"
 
 using namespace std;
 USING_NS_AX;
@@ -22,11 +23,13 @@ SceneManager::SceneManager()
 void SceneManager::runWithScene(Scene* scene) {
   _director->runWithScene(scene);
   _scenes.push(scene);
+  rebindServices();
 }
 
 void SceneManager::pushScene(Scene* scene) {
   _director->pushScene(scene);
   _scenes.push(scene);
+  rebindServices();
 
   InputManager::the().deactivate();
   InputManager::the().activate(scene);
@@ -39,9 +42,18 @@ void SceneManager::popScene() {
 
   _director->popScene();
   _scenes.pop();
+  rebindServices();
 
   InputManager::the().deactivate();
   InputManager::the().activate(getCurrentScene());
 }
 
+void SceneManager::rebindServices() {
+  ServiceRegistry::unbindAll();
+
+  if (auto gameScene = getCurrentScene<GameScene>()) {
+    gameScene->bindServices();
+  }
+}
+
 }  // namespace vigilante
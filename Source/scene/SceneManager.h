@@ -31,6 +31,9 @@ class SceneManager final {
  private:
   SceneManager();
 
+  // Binds the services of the scene on top of the stack to ServiceRegistry.
+  void rebindServices();
+
   ax::Director* _director;
   std::stack<ax::Scene*> _scenes;
 };
@@ -0,0 +1,48 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_SCENE_SERVICE_REGISTRY_H_
+#define VIGILANTE_SCENE_SERVICE_REGISTRY_H_
+
+#include <vector>
+
+namespace vigilante {
+
+// Typed access to the subsystems (e.g., GameMapManager, Hud, FxManager)
+// owned by the current scene.
+//
+// Each service type has its own static slot, so ServiceRegistry::get<T>()
+// is a single load, without the dynamic_cast and the getter chain of
+// SceneManager::the().getCurrentScene<GameScene>()->getXXX().
+//
+// SceneManager rebinds the services whenever the current scene changes,
+// so get<T>() returns nullptr if the current scene doesn't provide a T.
+class ServiceRegistry final {
+ public:
+  template <typename T>
+  static inline T* get() { return _service<T>; }
+
+  template <typename T>
+  static void bind(T* service) {
+    [[maybe_unused]] static const bool isRegistered = (_unbinders.push_back(&unbind<T>), true);
+    _service<T> = service;
+  }
+
+  static void unbindAll() {
+    for (const auto unbinder : _unbinders) {
+      unbinder();
+    }
+  }
+
+ private:
+  template <typename T>
+  static void unbind() { _service<T> = nullptr; }
+
+  template <typename T>
+  static inline T* _service{};
+
+  static inline std::vector<void (*)()> _unbinders;
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_SCENE_SERVICE_REGISTRY_H_
@@ -7,7 +7,7 @@
 #include "CallbackManager.h"
 #include "character/Character.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/CameraUtil.h"
 
 using namespace std;
@@ -51,7 +51,7 @@ void ForwardSlash::activate() {
   _user->setInvincible(true);
   _user->getFixtures()[Character::FixtureType::BODY]->SetSensor(true);
 
-  auto afterImageFxMgr = SceneManager::the().getCurrentScene<GameScene>()->getAfterImageFxManager();
+  auto afterImageFxMgr = ServiceRegistry::get<AfterImageFxManager>();
   afterImageFxMgr->registerNode(_user->getNode(), AfterImageFxManager::kPlayerAfterImageColor, 0.15f, 0.05f);
 
   CallbackManager::the().runAfter([=](const CallbackManager::CallbackId) {
@@ -59,7 +59,7 @@ void ForwardSlash::activate() {
   }, _skillProfile.framesDuration / 4);
 
   CallbackManager::the().runAfter([=](const CallbackManager::CallbackId) {
-    auto afterImageFxMgr = SceneManager::the().getCurrentScene<GameScene>()->getAfterImageFxManager();
+    auto afterImageFxMgr = ServiceRegistry::get<AfterImageFxManager>();
     afterImageFxMgr->unregisterNode(_user->getNode());
 
     _user->getBody()->SetLinearDamping(oldBodyDamping);
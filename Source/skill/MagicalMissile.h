@@ -6,35 +6,21 @@
 #include <string>
 
 #include <axmol.h>
-#include <box2d/box2d.h>
 
-#include "DynamicActor.h"
 #include "Skill.h"
-#include "Projectile.h"
 
 namespace vigilante {
 
 class Character;
 
-class MagicalMissile final : public DynamicActor, public Skill, public Projectile {
+// The missiles themselves are simulated by ProjectileManager, so a single
+// MagicalMissile instance can have any number of missiles in flight
+// and is never forked on activation.
+class MagicalMissile final : public Skill {
  public:
-  enum AnimationType {
-    LAUNCH_FX,
-    FLYING,
-    ON_HIT,
-    SIZE
-  };
-
   MagicalMissile(const std::string& jsonFilePath, Character* user, const bool onGround);
   virtual ~MagicalMissile() = default;
 
-  virtual bool showOnMap(float x, float y) override;  // DynamicActor
-  virtual void update(const float delta) override;  // DynamicActor
-
-  virtual Character* getUser() const override { return _user; }  // Projectile
-  virtual int getDamage() const override;  // Projectile
-  virtual void onHit(Character* target) override;  // Projectile
-
   virtual void import(const std::string& jsonFilePath) override;  // Skill
   virtual ax::EventKeyboard::KeyCode getHotkey() const override { return _skillProfile.hotkey; }  // Skill
   virtual void setHotkey(ax::EventKeyboard::KeyCode hotkey) override { _skillProfile.hotkey = hotkey; }  // Skill
@@ -46,23 +32,13 @@ class MagicalMissile final : public DynamicActor, public Skill, public Projectil
   virtual const std::string& getName() const override { return _skillProfile.name; }  // Skill
   virtual const std::string& getDesc() const override { return _skillProfile.desc; }  // Skill
   virtual std::string getIconPath() const override;  // Skill
-  
- private:
-  virtual void defineBody(b2BodyType bodyType,
-                          float x,
-                          float y,
-                          short categoryBits,
-                          short maskBits);
 
-  virtual void defineTexture(const std::string& textureResPath, float x, float y);
+ private:
+  void launch();
 
   Skill::Profile _skillProfile;
   Character* _user{};
   bool _isOnGround{};
-  float _flyingSpeed{};
-  bool _hasActivated{};
-  bool _hasHit{};
-  ax::Sprite* _launchFxSprite{};
 };
 
 }  // namespace vigilante
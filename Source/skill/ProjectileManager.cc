@@ -0,0 +1,358 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "ProjectileManager.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Audio.h"
+#include "CallbackManager.h"
+#include "Constants.h"
+#include "ProfileCache.h"
+#include "StaticActor.h"
+#include "character/Character.h"
+#include "util/AxUtil.h"
+#include "util/Logger.h"
+#include "util/Profiler.h"
+
+using namespace std;
+USING_NS_AX;
+
+namespace vigilante {
+
+namespace {
+
+constexpr size_t kInitialCapacity = 256;
+
+constexpr float kKnockBackForceX = 3.5f;
+constexpr float kKnockBackForceY = 1.0f;
+
+constexpr auto kProjectileMaskBits = category_bits::kPlayer | category_bits::kEnemy;
+
+// The half extents (in pixels, before content scaling) of a projectile's hitbox.
+constexpr float kHalfWidth = 10.0f;
+constexpr float kHalfHeight = 2.0f;
+
+// Finds the nearest character body which overlaps the box swept by a projectile.
+// A single instance is reused for all the projectiles, so there's no
+// allocation (e.g., std::function) per query.
+class SweepQueryCallback final : public b2QueryCallback {
+ public:
+  void reset(const b2AABB& sweptBox, const Character* user, const float fromX, const bool isMovingRight) {
+    _sweptBox = sweptBox;
+    _user = user;
+    _fromX = fromX;
+    _isMovingRight = isMovingRight;
+    _target = nullptr;
+    _distance = 0;
+  }
+
+  virtual bool ReportFixture(b2Fixture* fixture) override {
+    if (!(fixture->GetFilterData().categoryBits & kProjectileMaskBits)) {
+      return true;
+    }
+
+    Character* c = reinterpret_cast<Character*>(fixture->GetUserData().pointer);
+    if (!c || c == _user) {
+      return true;
+    }
+
+    // The AABBs reported by the broadphase are fattened,
+    // so test against the fixture's actual AABB.
+    const b2AABB& aabb = fixture->GetAABB(0);
+    if (!b2TestOverlap(aabb, _sweptBox)) {
+      return true;
+    }
+
+    const float distance = _isMovingRight ? aabb.lowerBound.x - _fromX : _fromX - aabb.upperBound.x;
+    if (!_target || distance < _distance) {
+      _target = c;
+      _distance = distance;
+    }
+    return true;
+  }
+
+  inline Character* getTarget() const { return _target; }
+
+ private:
+  b2AABB _sweptBox{};
+  const Character* _user{};
+  float _fromX{};
+  bool _isMovingRight{};
+  Character* _target{};
+  float _distance{};
+};
+
+SweepQueryCallback sweepQueryCallback;
+
+}  // namespace
+
+int ProjectileManager::Frames::at(const float elapsed) const {
+  if (!animation || animation->getFrames().empty()) {
+    return -1;
+  }
+
+  const int numFrames = static_cast<int>(animation->getFrames().size());
+  const int idx = static_cast<int>(elapsed / animation->getDelayPerUnit());
+  return std::clamp(idx, 0, numFrames - 1);
+}
+
+float ProjectileManager::Frames::getDuration() const {
+  return animation ? animation->getDuration() : 0;
+}
+
+ProjectileManager::ProjectileManager(b2World* world, Layer* layer)
+    : _world{world},
+      _layer{layer} {
+  _x.reserve(kInitialCapacity);
+  _y.reserve(kInitialCapacity);
+  _vx.reserve(kInitialCapacity);
+  _elapsed.reserve(kInitialCapacity);
+  _hitTime.reserve(kInitialCapacity);
+  _states.reserve(kInitialCapacity);
+  _typeIdx.reserve(kInitialCapacity);
+  _users.reserve(kInitialCapacity);
+  _sprites.reserve(kInitialCapacity);
+  _launchFxSprites.reserve(kInitialCapacity);
+  _frameIndices.reserve(kInitialCapacity);
+  _launchFxFrameIndices.reserve(kInitialCapacity);
+}
+
+ProjectileManager::~ProjectileManager() {
+  // The animations are retained by StaticActor::createAnimation().
+  for (const auto& type : _types) {
+    for (Animation* animation : {type.launchFxFrames.animation,
+                                 type.flyingFrames.animation,
+                                 type.onHitFrames.animation}) {
+      if (animation) {
+        animation->release();
+      }
+    }
+  }
+}
+
+int ProjectileManager::getTypeId(const string& skillJsonFilePath) {
+  auto it = _typeIds.find(skillJsonFilePath);
+  if (it != _typeIds.end()) {
+    return it->second;
+  }
+
+  const int typeId = static_cast<int>(_types.size());
+  _types.emplace_back(loadType(skillJsonFilePath));
+  _typeIds.emplace(skillJsonFilePath, typeId);
+  return typeId;
+}
+
+ProjectileManager::Type ProjectileManager::loadType(const string& skillJsonFilePath) const {
+  Type type;
+  type.profile = ProfileCache<Skill::Profile>::get(skillJsonFilePath);
+
+  const string& textureResDir = type.profile->textureResDir;
+  type.spritesheet = SpriteBatchNode::create(StaticActor::getSpritesheetFilePath(textureResDir));
+  type.spritesheet->getTexture()->setAliasTexParameters();
+  ax_util::addChildWithParentCameraMask(_layer, type.spritesheet, z_order::kSpell);
+
+  type.launchFxFrames.animation = StaticActor::createAnimation(textureResDir, "launch", 5.0f / kPpm);
+  type.flyingFrames.animation = StaticActor::createAnimation(textureResDir, "flying", 1.0f / kPpm);
+  type.onHitFrames.animation = StaticActor::createAnimation(textureResDir, "on_hit", 8.0f / kPpm);
+
+  return type;
+}
+
+void ProjectileManager::spawn(const int typeId, Character* user, const float x, const float y,
+                              const bool isFacingRight) {
+  if (typeId < 0 || typeId >= static_cast<int>(_types.size())) {
+    VGLOG(LOG_ERR, "Failed to spawn projectile, invalid type id: [%d].", typeId);
+    return;
+  }
+
+  Type& type = _types[typeId];
+  const Skill::Profile& profile = *type.profile;
+
+  Sprite* sprite = acquireSprite(type);
+  sprite->setScale(profile.spriteScaleX, profile.spriteScaleY);
+  sprite->setFlippedX(!isFacingRight);
+
+  Sprite* launchFxSprite{};
+  if (type.launchFxFrames.animation) {
+    launchFxSprite = acquireSprite(type);
+    launchFxSprite->setScale(1.0f);
+    launchFxSprite->setFlippedX(!isFacingRight);
+    launchFxSprite->setPosition(x, y);
+  }
+
+  const float speed = kFlyingSpeed * kPpm;
+  _x.push_back(x);
+  _y.push_back(y);
+  _vx.push_back(isFacingRight ? speed : -speed);
+  _elapsed.push_back(0);
+  _hitTime.push_back(0);
+  _states.push_back(State::FLYING);
+  _typeIdx.push_back(static_cast<uint16_t>(typeId));
+  _users.push_back(user);
+  _sprites.push_back(sprite);
+  _launchFxSprites.push_back(launchFxSprite);
+  _frameIndices.push_back(-1);
+  _launchFxFrameIndices.push_back(-1);
+
+  syncSprites(_x.size() - 1);
+}
+
+void ProjectileManager::update(const float delta, const Size& mapSize) {
+  VGPROFILE_ZONE("ProjectileManager::update");
+
+  for (size_t i = 0; i < _x.size();) {
+    const float fromX = _x[i];
+    _x[i] += _vx[i] * delta;
+    _elapsed[i] += delta;
+
+    if (_states[i] == State::FLYING) {
+      if (Character* target = sweep(i, fromX)) {
+        onHit(i, target);
+      } else if (_x[i] < 0 || _y[i] < 0 || _x[i] > mapSize.width || _y[i] > mapSize.height) {
+        onHit(i, nullptr);
+      }
+    } else if (_elapsed[i] - _hitTime[i] >= _types[_typeIdx[i]].onHitFrames.getDuration()) {
+      remove(i);
+      continue;
+    }
+
+    syncSprites(i);
+    i++;
+  }
+}
+
+void ProjectileManager::clear() {
+  while (!_x.empty()) {
+    remove(_x.size() - 1);
+  }
+}
+
+void ProjectileManager::onUserRemoved(const Character* user) {
+  for (auto& u : _users) {
+    if (u == user) {
+      u = nullptr;
+    }
+  }
+}
+
+Sprite* ProjectileManager::acquireSprite(Type& type) {
+  if (!type.freeSprites.empty()) {
+    Sprite* sprite = type.freeSprites.back();
+    type.freeSprites.pop_back();
+    sprite->setVisible(true);
+    return sprite;
+  }
+
+  const string frameNamePrefix = StaticActor::getLastDirName(type.profile->textureResDir);
+  Sprite* sprite = Sprite::createWithSpriteFrameName(frameNamePrefix + "_flying/0.png");
+  ax_util::addChildWithParentCameraMask(type.spritesheet, sprite);
+  return sprite;
+}
+
+void ProjectileManager::releaseSprite(Type& type, Sprite* sprite) {
+  sprite->setVisible(false);
+  type.freeSprites.push_back(sprite);
+}
+
+Character* ProjectileManager::sweep(const size_t i, const float fromX) const {
+  const float scaleFactor = Director::getInstance()->getContentScaleFactor();
+  const float halfWidth = kHalfWidth / scaleFactor;
+  const float halfHeight = kHalfHeight / scaleFactor;
+
+  b2AABB sweptBox;
+  sweptBox.lowerBound = {(std::min(fromX, _x[i]) - halfWidth) / kPpm, (_y[i] - halfHeight) / kPpm};
+  sweptBox.upperBound = {(std::max(fromX, _x[i]) + halfWidth) / kPpm, (_y[i] + halfHeight) / kPpm};
+
+  sweepQueryCallback.reset(sweptBox, _users[i], fromX / kPpm, _vx[i] > 0);
+  _world->QueryAABB(&sweepQueryCallback, sweptBox);
+  return sweepQueryCallback.getTarget();
+}
+
+void ProjectileManager::onHit(const size_t i, Character* target) {
+  _states[i] = State::HIT;
+  _hitTime[i] = _elapsed[i];
+  _frameIndices[i] = -1;
+
+  // The knock back direction is determined before slowing it down,
+  // and the user callbacks below may spawn more projectiles,
+  // so don't hold references into the arrays across them.
+  const bool isMovingRight = _vx[i] > 0;
+  _vx[i] /= 2;
+
+  const shared_ptr<const Skill::Profile> profile = _types[_typeIdx[i]].profile;
+  Character* user = _users[i];
+
+  if (target && user) {
+    const float knockBackForceX = isMovingRight ? kKnockBackForceX : -kKnockBackForceX;
+    user->knockBack(target, knockBackForceX, kKnockBackForceY);
+    user->inflictDamage(target, profile->physicalDamage + profile->magicalDamage);
+
+    target->setStunned(true);
+    CallbackManager::the().runAfter([target](const CallbackManager::CallbackId) {
+      target->setStunned(false);
+    }, kStunDuration);
+  }
+
+  // Play sound effect.
+  Audio::the().playSfx(profile->sfxHit);
+}
+
+void ProjectileManager::syncSprites(const size_t i) {
+  const Type& type = _types[_typeIdx[i]];
+  const Skill::Profile& profile = *type.profile;
+
+  const bool isFlying = _states[i] == State::FLYING;
+  const Frames& frames = isFlying ? type.flyingFrames : type.onHitFrames;
+  const int frameIdx = frames.at(isFlying ? _elapsed[i] : _elapsed[i] - _hitTime[i]);
+  if (frameIdx >= 0 && frameIdx != _frameIndices[i]) {
+    _sprites[i]->setSpriteFrame(frames.animation->getFrames().at(frameIdx)->getSpriteFrame());
+    _frameIndices[i] = static_cast<int16_t>(frameIdx);
+  }
+  _sprites[i]->setPosition(_x[i] + profile.spriteOffsetX, _y[i] + profile.spriteOffsetY);
+
+  Sprite* launchFxSprite = _launchFxSprites[i];
+  if (!launchFxSprite) {
+    return;
+  }
+
+  if (_elapsed[i] >= type.launchFxFrames.getDuration()) {
+    releaseSprite(_types[_typeIdx[i]], launchFxSprite);
+    _launchFxSprites[i] = nullptr;
+    return;
+  }
+
+  const int launchFxFrameIdx = type.launchFxFrames.at(_elapsed[i]);
+  if (launchFxFrameIdx >= 0 && launchFxFrameIdx != _launchFxFrameIndices[i]) {
+    launchFxSprite->setSpriteFrame(type.launchFxFrames.animation->getFrames().at(launchFxFrameIdx)->getSpriteFrame());
+    _launchFxFrameIndices[i] = static_cast<int16_t>(launchFxFrameIdx);
+  }
+}
+
+void ProjectileManager::remove(const size_t i) {
+  Type& type = _types[_typeIdx[i]];
+  releaseSprite(type, _sprites[i]);
+  if (_launchFxSprites[i]) {
+    releaseSprite(type, _launchFxSprites[i]);
+  }
+
+  // Keep the live projectiles packed by moving the last one into this slot.
+  auto removeAt = [i](auto& v) {
+    v[i] = v.back();
+    v.pop_back();
+  };
+  removeAt(_x);
+  removeAt(_y);
+  removeAt(_vx);
+  removeAt(_elapsed);
+  removeAt(_hitTime);
+  removeAt(_states);
+  removeAt(_typeIdx);
+  removeAt(_users);
+  removeAt(_sprites);
+  removeAt(_launchFxSprites);
+  removeAt(_frameIndices);
+  removeAt(_launchFxFrameIndices);
+}
+
+}  // namespace vigilante
@@ -0,0 +1,111 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_SKILL_PROJECTILE_MANAGER_H_
+#define VIGILANTE_SKILL_PROJECTILE_MANAGER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <axmol.h>
+#include <box2d/box2d.h>
+
+#include "skill/Skill.h"
+
+namespace vigilante {
+
+class Character;
+
+// Simulates all the projectiles (e.g., magical missiles) in the game map.
+//
+// Projectiles don't have their own b2Body. They move analytically along
+// a straight line, and each frame the segment a projectile has swept
+// is tested against the bodies of the characters via an AABB query.
+//
+// The projectiles are stored as parallel arrays (live projectiles are kept
+// packed at the front), and each projectile type owns a SpriteBatchNode,
+// a pool of sprites and the sprite frames shared by all its projectiles,
+// so spawning a projectile allocates nothing once the pools are warm.
+class ProjectileManager final {
+ public:
+  static inline constexpr float kFlyingSpeed = 4.0f;  // m/s
+  static inline constexpr float kStunDuration = 2.0f;
+
+  explicit ProjectileManager(b2World* world, ax::Layer* layer);
+  ~ProjectileManager();
+
+  // @return the id of the projectile type defined by the skill json,
+  //         which is loaded on first use.
+  int getTypeId(const std::string& skillJsonFilePath);
+
+  // @param x, y: the launch position in pixels.
+  void spawn(const int typeId, Character* user, const float x, const float y,
+             const bool isFacingRight);
+  void update(const float delta, const ax::Size& mapSize);
+  void clear();
+
+  // Projectiles already in flight stay in flight, but will no longer
+  // inflict damage on behalf of `user`.
+  void onUserRemoved(const Character* user);
+
+  inline int getNumProjectiles() const { return static_cast<int>(_x.size()); }
+
+ private:
+  enum class State : uint8_t {
+    FLYING,
+    HIT
+  };
+
+  // The frames of an ax::Animation, which are picked by elapsed time
+  // instead of running an ax::Animate action on each sprite.
+  struct Frames final {
+    ax::Animation* animation{};
+
+    // @return the index of the frame to show, or -1 if there are no frames.
+    //         The last frame is held once the animation has finished.
+    int at(const float elapsed) const;
+    float getDuration() const;
+  };
+
+  struct Type final {
+    std::shared_ptr<const Skill::Profile> profile;
+    ax::SpriteBatchNode* spritesheet{};
+    Frames launchFxFrames;
+    Frames flyingFrames;
+    Frames onHitFrames;
+    std::vector<ax::Sprite*> freeSprites;
+  };
+
+  Type loadType(const std::string& skillJsonFilePath) const;
+  ax::Sprite* acquireSprite(Type& type);
+  void releaseSprite(Type& type, ax::Sprite* sprite);
+  Character* sweep(const size_t i, const float fromX) const;
+  void onHit(const size_t i, Character* target);
+  void syncSprites(const size_t i);
+  void remove(const size_t i);
+
+  b2World* _world;
+  ax::Layer* _layer;
+  std::vector<Type> _types;
+  std::unordered_map<std::string, int> _typeIds;
+
+  // Per projectile data, indexed by the projectile's slot.
+  std::vector<float> _x;
+  std::vector<float> _y;
+  std::vector<float> _vx;
+  std::vector<float> _elapsed;  // since spawned
+  std::vector<float> _hitTime;  // the value of `_elapsed` when it hit something
+  std::vector<State> _states;
+  std::vector<uint16_t> _typeIdx;
+  std::vector<Character*> _users;
+  std::vector<ax::Sprite*> _sprites;
+  std::vector<ax::Sprite*> _launchFxSprites;
+  std::vector<int16_t> _frameIndices;
+  std::vector<int16_t> _launchFxFrameIndices;
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_SKILL_PROJECTILE_MANAGER_H_
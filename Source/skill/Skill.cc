@@ -36,35 +36,7 @@ shared_ptr<Skill> Skill::create(const string& jsonFilePath, Character* user) {
 }
 
 Skill::Profile::Profile(const string& jsonFilePath) : jsonFilePath(jsonFilePath), hotkey() {
-  rapidjson::Document json = json_util::loadFromFile(jsonFilePath);
-
-  skillType = static_cast<Skill::Type>(json["skillType"].GetInt());
-  characterFramesName = json["characterFramesName"].GetString();
-
-  textureResDir = json["textureResDir"].GetString();
-  spriteOffsetX = json["spriteOffsetX"].GetFloat();
-  spriteOffsetY = json["spriteOffsetY"].GetFloat();
-  spriteScaleX = json["spriteScaleX"].GetFloat();
-  spriteScaleY = json["spriteScaleY"].GetFloat();
-  framesDuration = json["framesDuration"].GetFloat();
-
-  name = json["name"].GetString();
-  desc = json["desc"].GetString();
-  isToggleable = json["isToggleable"].GetBool();
-  shouldForkInstance = json["shouldForkInstance"].GetBool();
-  requiredLevel = json["requiredLevel"].GetInt();
-  cooldown = json["cooldown"].GetFloat();
-
-  physicalDamage = json["physicalDamage"].GetInt();
-  magicalDamage = json["magicalDamage"].GetInt();
-  deltaHealth = json["deltaHealth"].GetInt();
-  deltaMagicka = json["deltaMagicka"].GetInt();
-  deltaStamina = json["deltaStamina"].GetInt();
-  numTimesInflictDamage = json["numTimesInflictDamage"].GetInt();
-  damageInflictionInterval = json["damageInflictionInterval"].GetFloat();
-
-  sfxActivate = json["sfxActivate"].GetString();
-  sfxHit = json["sfxHit"].GetString();
+  json_util::parseFileInto(jsonFilePath, *this);
 }
 
 }  // namespace vigilante
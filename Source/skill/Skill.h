@@ -10,6 +10,7 @@
 
 #include "Importable.h"
 #include "input/Keybindable.h"
+#include "util/Reflection.h"
 
 namespace vigilante {
 
@@ -61,6 +62,31 @@ class Skill : public Importable, public Keybindable, public std::enable_shared_f
     std::string sfxHit;
 
     ax::EventKeyboard::KeyCode hotkey;
+
+    static constexpr auto kFields = reflection::fields(
+      reflection::field("skillType", &Profile::skillType),
+      reflection::field("characterFramesName", &Profile::characterFramesName),
+      reflection::field("textureResDir", &Profile::textureResDir),
+      reflection::field("spriteOffsetX", &Profile::spriteOffsetX),
+      reflection::field("spriteOffsetY", &Profile::spriteOffsetY),
+      reflection::field("spriteScaleX", &Profile::spriteScaleX),
+      reflection::field("spriteScaleY", &Profile::spriteScaleY),
+      reflection::field("framesDuration", &Profile::framesDuration),
+      reflection::field("name", &Profile::name),
+      reflection::field("desc", &Profile::desc),
+      reflection::field("isToggleable", &Profile::isToggleable),
+      reflection::field("shouldForkInstance", &Profile::shouldForkInstance),
+      reflection::field("requiredLevel", &Profile::requiredLevel),
+      reflection::field("cooldown", &Profile::cooldown),
+      reflection::field("physicalDamage", &Profile::physicalDamage),
+      reflection::field("magicalDamage", &Profile::magicalDamage),
+      reflection::field("deltaHealth", &Profile::deltaHealth),
+      reflection::field("deltaMagicka", &Profile::deltaMagicka),
+      reflection::field("deltaStamina", &Profile::deltaStamina),
+      reflection::field("numTimesInflictDamage", &Profile::numTimesInflictDamage),
+      reflection::field("damageInflictionInterval", &Profile::damageInflictionInterval),
+      reflection::field("sfxActivate", &Profile::sfxActivate),
+      reflection::field("sfxHit", &Profile::sfxHit));
   };
 
   // Create a skill by automatically deducing its concrete type
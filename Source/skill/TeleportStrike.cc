@@ -7,7 +7,7 @@
 #include "CallbackManager.h"
 #include "character/Character.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/CameraUtil.h"
 
 using namespace std;
@@ -41,7 +41,7 @@ bool isTargetFarEnoughFromWall(Character* target, const float minDistRequired, c
     dst.x += target->isFacingRight() ? minDistRequired : -minDistRequired;
   }
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   return !gmMgr->rayCast(src, dst, category_bits::kWall | category_bits::kGround);
 }
 
@@ -122,7 +122,7 @@ Character* TeleportStrike::getClosestEnemyWithinDist(const float maxEuclideanDis
     return _user->getLockedOnTarget();
   }
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   float minDist = std::numeric_limits<float>::max();
   Character* target = nullptr;
   for (const auto& dynamicActor : gmMgr->getGameMap()->getDynamicActors()) {
@@ -3,6 +3,7 @@
 #include "TimedLabelService.h"
 
 #include "Assets.h"
+#include "util/Profiler.h"
 
 using namespace std;
 using namespace vigilante::assets;
@@ -21,6 +22,8 @@ TimedLabelService::TimedLabelService(const float startingX, const float starting
       _kAlignment{alignment} {}
 
 void TimedLabelService::update(const float delta) {
+  VGPROFILE_ZONE("TimedLabelService::update");
+
   for (auto& notification : _labelQueue) {
     notification.timer += delta;
 
@@ -4,6 +4,7 @@
 
 #include "Constants.h"
 #include "util/Logger.h"
+#include "util/Profiler.h"
 
 using namespace std;
 using namespace vigilante::z_order;
@@ -14,6 +15,8 @@ namespace vigilante {
 WindowManager::WindowManager() : _kMaxWindowCount{kWindowTop - kWindowBottom + 1} {}
 
 void WindowManager::update(const float delta) {
+  VGPROFILE_ZONE("WindowManager::update");
+
   for (auto& w : _windows) {
     w->update(delta);
   }
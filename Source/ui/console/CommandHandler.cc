@@ -2,19 +2,30 @@
 
 #include "CommandHandler.h"
 
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
 #include <memory>
 
 #include "Audio.h"
+#include "bench/Simulation.h"
 #include "character/Player.h"
 #include "character/Npc.h"
 #include "gameplay/DialogueTree.h"
 #include "item/Item.h"
 #include "item/Key.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
+#include "ui/console/ConsoleScript.h"
+#include "util/ByteUtil.h"
 #include "util/JsonUtil.h"
 #include "util/StringUtil.h"
 #include "util/Logger.h"
+#include "util/Profiler.h"
 
 using namespace std;
 USING_NS_AX;
@@ -23,68 +34,296 @@ namespace vigilante {
 
 namespace {
 
-using CmdTable = unordered_map<string, void (CommandHandler::*)(const vector<string>&)>;
-
 constexpr char kDefaultErrMsg[] = "Unable to parse this line";
 
+enum class ArgType : uint8_t {
+  STRING,
+  INT,
+  FLOAT
+};
+
+struct Param final {
+  string_view name;
+  ArgType type;
+};
+
+struct CmdSignature final {
+  array<Param, CompiledCmd::kMaxNumTypedArgs> params{};
+  size_t numParams{};
+  size_t numRequiredParams{};
+  bool isVariadic{};  // the last param takes the remaining args
+  bool isValid{};
+};
+
+// Parses a usage such as "<quest> <stage_idx:int> [amount:int]" (see CommandHandler.h).
+constexpr CmdSignature parseUsage(const string_view usage) {
+  CmdSignature signature{};
+  size_t i = 0;
+  while (i < usage.size()) {
+    if (usage[i] == ' ') {
+      i++;
+      continue;
+    }
+
+    const char open = usage[i];
+    const char close = (open == '<') ? '>' : (open == '[') ? ']' : '\0';
+    const size_t end = close ? usage.find(close, i) : string_view::npos;
+    if (end == string_view::npos ||
+        signature.isVariadic ||
+        signature.numParams == signature.params.size() ||
+        (open == '<' && signature.numRequiredParams < signature.numParams)) {
+      return signature;  // invalid
+    }
+
+    Param param{usage.substr(i + 1, end - i - 1), ArgType::STRING};
+    if (param.name.ends_with("...")) {
+      param.name.remove_suffix(3);
+      signature.isVariadic = true;
+    } else if (const size_t colon = param.name.find(':'); colon != string_view::npos) {
+      const string_view type = param.name.substr(colon + 1);
+      param.name = param.name.substr(0, colon);
+      if (type == "int") {
+        param.type = ArgType::INT;
+      } else if (type == "float") {
+        param.type = ArgType::FLOAT;
+      } else {
+        return signature;  // invalid
+      }
+    }
+
+    signature.params[signature.numParams++] = param;
+    signature.numRequiredParams += (open == '<');
+    i = end + 1;
+  }
+
+  signature.isValid = true;
+  return signature;
+}
+
+// FNV-1a, perturbed by `seed`.
+constexpr uint32_t hashCmdName(const string_view name, const uint32_t seed) {
+  const uint32_t h = byte_util::fnv1a32(name, byte_util::kFnv1a32OffsetBasis ^ seed);
+  return h ^ (h >> 16);
+}
+
+// Maps each of the N cmd names to a distinct slot, so that a lookup
+// is one hash and one string comparison.
+template <size_t N>
+struct PerfectHashTable final {
+  static inline constexpr size_t kNumSlots = std::bit_ceil(N * 4);
+  static inline constexpr uint32_t kMaxSeed = 1 << 16;
+
+  uint32_t seed{};
+  array<uint8_t, kNumSlots> slots{};
+  bool isValid{};
+};
+
+// Tries one seed after another until none of the names collide.
+template <size_t N>
+constexpr PerfectHashTable<N> makePerfectHashTable(const array<string_view, N>& names) {
+  PerfectHashTable<N> table{};
+  for (table.seed = 0; table.seed < table.kMaxSeed; table.seed++) {
+    table.slots.fill(CompiledCmd::kInvalidOpcode);
+    table.isValid = true;
+    for (size_t i = 0; i < N && table.isValid; i++) {
+      auto& slot = table.slots[hashCmdName(names[i], table.seed) & (table.kNumSlots - 1)];
+      table.isValid = slot == CompiledCmd::kInvalidOpcode;
+      slot = static_cast<uint8_t>(i);
+    }
+    if (table.isValid) {
+      break;
+    }
+  }
+  return table;
+}
+
 }  // namespace
 
+// The index of each command is its opcode.
+constexpr CommandHandler::CmdTableEntry CommandHandler::kCmdTable[] = {
+  {cmd::kSetBgmVolume,       "<volume:float>",                                                &CommandHandler::setBgmVolume       },
+  {cmd::kStartQuest,         "<quest>",                                                       &CommandHandler::startQuest         },
+  {cmd::kSetStage,           "<quest> <stage_idx:int>",                                       &CommandHandler::setStage           },
+  {cmd::kAddItem,            "<itemName> [amount:int]",                                       &CommandHandler::addItem            },
+  {cmd::kRemoveItem,         "<itemName> [amount:int]",                                       &CommandHandler::removeItem         },
+  {cmd::kAddGold,            "<amount:int>",                                                  &CommandHandler::addGold            },
+  {cmd::kRemoveGold,         "<amount:int>",                                                  &CommandHandler::removeGold         },
+  {cmd::kUpdateDialogueTree, "<npcJson> <dialogueTreeJson>",                                  &CommandHandler::updateDialogueTree },
+  {cmd::kJoinPlayerParty,    "",                                                              &CommandHandler::joinPlayerParty    },
+  {cmd::kLeavePlayerParty,   "",                                                              &CommandHandler::leavePlayerParty   },
+  {cmd::kPartyMemberWait,    "",                                                              &CommandHandler::partyMemberWait    },
+  {cmd::kPartyMemberFollow,  "",                                                              &CommandHandler::partyMemberFollow  },
+  {cmd::kTrade,              "",                                                              &CommandHandler::trade              },
+  {cmd::kKill,               "",                                                              &CommandHandler::kill               },
+  {cmd::kInteract,           "",                                                              &CommandHandler::interact           },
+  {cmd::kNarrate,            "<narratives...>",                                               &CommandHandler::narrate            },
+  {cmd::kRest,               "<innTmxMapFilePath>",                                           &CommandHandler::rest               },
+  {cmd::kRentRoomCheckIn,    "<innTmxMapFilePath> <bedroomKeyJsonFilePath> <gold:int>",       &CommandHandler::rentRoomCheckIn    },
+  {cmd::kRentRoomCheckOut,   "<innTmxMapFilePath> <bedroomKeyJsonFilePath>",                  &CommandHandler::rentRoomCheckOut   },
+  {cmd::kBeginBossFight,     "<bossStageProfileJsonPath>",                                    &CommandHandler::beginBossFight     },
+  {cmd::kEndBossFight,       "<bossStageProfileJsonPath>",                                    &CommandHandler::endBossFight       },
+  {cmd::kSetInGameTime,      "<hour:int> <minute:int> <second:int>",                          &CommandHandler::setInGameTime      },
+  {cmd::kCullStats,          "",                                                              &CommandHandler::cullStats          },
+  {cmd::kSoak,               "<numTicks:int> [numExtraNpcs:int]",                             &CommandHandler::soak               },
+  {cmd::kDumpTrace,          "<seconds:float> [filePath]",                                    &CommandHandler::dumpTrace          },
+  {cmd::kRunScript,          "<scriptFilePath>",                                              &CommandHandler::runScript          },
+};
+
+uint8_t CommandHandler::getOpcode(const string_view name) {
+  static_assert(std::size(kCmdTable) < CompiledCmd::kInvalidOpcode);
+  static constexpr auto hashTable = makePerfectHashTable([]() {
+    array<string_view, std::size(kCmdTable)> names;
+    for (size_t i = 0; i < names.size(); i++) {
+      names[i] = kCmdTable[i].name;
+    }
+    return names;
+  }());
+  static_assert(hashTable.isValid, "unable to find a perfect hash for the cmd names");
+
+  const uint8_t opcode = hashTable.slots[hashCmdName(name, hashTable.seed) & (hashTable.kNumSlots - 1)];
+  return (opcode != CompiledCmd::kInvalidOpcode && kCmdTable[opcode].name == name) ? opcode
+                                                                                  : CompiledCmd::kInvalidOpcode;
+}
+
+size_t CommandHandler::getNumCmds() {
+  return std::size(kCmdTable);
+}
+
+const char* CommandHandler::getCmdName(const uint8_t opcode) {
+  return (opcode < std::size(kCmdTable)) ? kCmdTable[opcode].name.data() : nullptr;
+}
+
+void CommandHandler::parseArgs(CompiledCmd& cmd) {
+  static constexpr auto signatures = []() {
+    array<CmdSignature, std::size(kCmdTable)> signatures;
+    for (size_t i = 0; i < signatures.size(); i++) {
+      signatures[i] = parseUsage(kCmdTable[i].usage);
+    }
+    return signatures;
+  }();
+  static_assert(std::all_of(signatures.begin(), signatures.end(), [](const auto& s) { return s.isValid; }),
+                "malformed cmd usage");
+
+  const CmdTableEntry& entry = kCmdTable[cmd.opcode];
+  const CmdSignature& signature = signatures[cmd.opcode];
+  if (cmd.getNumArgs() < signature.numRequiredParams) {
+    cmd.errMsg = string_util::format("usage: %s %s", entry.name.data(), entry.usage.data());
+    return;
+  }
+
+  const size_t numTypedArgs = std::min(cmd.getNumArgs(), signature.numParams);
+  for (size_t i = 0; i < numTypedArgs; i++) {
+    const Param& param = signature.params[i];
+    const string& arg = cmd.getString(i);
+    const char* begin = arg.c_str() + ((arg.starts_with('+') && !arg.starts_with("+-")) ? 1 : 0);
+    const char* end = arg.c_str() + arg.size();
+
+    if (param.type == ArgType::INT) {
+      const auto [ptr, ec] = std::from_chars(begin, end, cmd.values[i].i);
+      if (ec == std::errc::result_out_of_range) {
+        cmd.errMsg = string_util::format("`%.*s` is out of range", static_cast<int>(param.name.size()), param.name.data());
+        return;
+      } else if (ec != std::errc{} || ptr != end) {
+        cmd.errMsg = string_util::format("`%.*s` must be an integer", static_cast<int>(param.name.size()), param.name.data());
+        return;
+      }
+    } else if (param.type == ArgType::FLOAT) {
+      // std::from_chars() for floating point types isn't available everywhere yet.
+      char* ptr = nullptr;
+      errno = 0;
+      cmd.values[i].f = std::strtof(begin, &ptr);
+      if (errno == ERANGE) {
+        cmd.errMsg = string_util::format("`%.*s` is out of range", static_cast<int>(param.name.size()), param.name.data());
+        return;
+      } else if (ptr == begin || ptr != end) {
+        cmd.errMsg = string_util::format("`%.*s` must be a number", static_cast<int>(param.name.size()), param.name.data());
+        return;
+      }
+    }
+  }
+}
+
+CompiledCmd CommandHandler::compile(const string& cmd) {
+  CompiledCmd compiledCmd;
+  compiledCmd.tokens = string_util::parseArgs(cmd);
+  if (compiledCmd.tokens.empty()) {
+    return compiledCmd;
+  }
+
+  compiledCmd.opcode = getOpcode(compiledCmd.getName());
+  if (compiledCmd.opcode != CompiledCmd::kInvalidOpcode) {
+    parseArgs(compiledCmd);
+  }
+
+  // Load and validate the script now rather than when it's run.
+  if (compiledCmd.opcode == getOpcode(cmd::kRunScript) && compiledCmd.errMsg.empty() &&
+      !ConsoleScript::load(compiledCmd.getString(0))) {
+    compiledCmd.errMsg = string_util::format("failed to load script [%s]", compiledCmd.getString(0).c_str());
+  }
+  return compiledCmd;
+}
+
+vector<CompiledCmd> CommandHandler::compile(const vector<string>& cmds) {
+  vector<CompiledCmd> compiledCmds;
+  compiledCmds.reserve(cmds.size());
+
+  for (const auto& cmd : cmds) {
+    compiledCmds.push_back(compile(cmd));
+    const CompiledCmd& compiledCmd = compiledCmds.back();
+    if (compiledCmd.opcode == CompiledCmd::kInvalidOpcode) {
+      VGLOG(LOG_WARN, "Unknown cmd: [%s], it will fail when executed.", cmd.c_str());
+    } else if (!compiledCmd.errMsg.empty()) {
+      VGLOG(LOG_WARN, "Malformed cmd: [%s] (%s), it will fail when executed.",
+            cmd.c_str(), compiledCmd.errMsg.c_str());
+    }
+  }
+  return compiledCmds;
+}
+
 bool CommandHandler::handle(const string& cmd, bool showNotification) {
   if (cmd.empty()) {
     return false;
   }
 
-  const vector<string> args = string_util::parseArgs(cmd);
-  if (args.empty()) {
+  const CompiledCmd compiledCmd = compile(cmd);
+  if (compiledCmd.tokens.empty()) {
+    return false;
+  }
+
+  VGLOG(LOG_DEBUG, "Executing cmd: [%s].", cmd.c_str());
+  execute(compiledCmd);
+
+  if (showNotification) {
+    auto notifications = ServiceRegistry::get<Notifications>();
+    notifications->show((_success) ? cmd : _errMsg);
+  }
+
+  return _success;
+}
+
+bool CommandHandler::execute(const CompiledCmd& cmd) {
+  if (cmd.tokens.empty()) {
     return false;
   }
 
   _success = false;
   _errMsg = kDefaultErrMsg;
 
-  static const CmdTable cmdTable = {
-    {cmd::kSetBgmVolume,       &CommandHandler::setBgmVolume       },
-    {cmd::kStartQuest,         &CommandHandler::startQuest         },
-    {cmd::kSetStage,           &CommandHandler::setStage           },
-    {cmd::kAddItem,            &CommandHandler::addItem            },
-    {cmd::kRemoveItem,         &CommandHandler::removeItem         },
-    {cmd::kAddGold,            &CommandHandler::addGold            },
-    {cmd::kRemoveGold,         &CommandHandler::removeGold         },
-    {cmd::kUpdateDialogueTree, &CommandHandler::updateDialogueTree },
-    {cmd::kJoinPlayerParty,    &CommandHandler::joinPlayerParty    },
-    {cmd::kLeavePlayerParty,   &CommandHandler::leavePlayerParty   },
-    {cmd::kPartyMemberWait,    &CommandHandler::partyMemberWait    },
-    {cmd::kPartyMemberFollow,  &CommandHandler::partyMemberFollow  },
-    {cmd::kTrade,              &CommandHandler::trade              },
-    {cmd::kKill,               &CommandHandler::kill               },
-    {cmd::kInteract,           &CommandHandler::interact           },
-    {cmd::kNarrate,            &CommandHandler::narrate            },
-    {cmd::kRest,               &CommandHandler::rest               },
-    {cmd::kRentRoomCheckIn,    &CommandHandler::rentRoomCheckIn    },
-    {cmd::kRentRoomCheckOut,   &CommandHandler::rentRoomCheckOut   },
-    {cmd::kBeginBossFight,     &CommandHandler::beginBossFight     },
-    {cmd::kEndBossFight,       &CommandHandler::endBossFight       },
-    {cmd::kSetInGameTime,      &CommandHandler::setInGameTime      },
-  };
-
-  // Execute the corresponding command handler from _cmdTable.
-  // The obtained value from _cmdTable is a class member function pointer.
-  CmdTable::const_iterator it = cmdTable.find(args[0]);
-  if (it != cmdTable.end()) {
-    VGLOG(LOG_INFO, "Executing cmd: [%s].", cmd.c_str());
-    (this->*((*it).second))(args);
+  // The opcode is the index of the command's handler in the cmd table,
+  // and the obtained value is a class member function pointer.
+  if (cmd.opcode < std::size(kCmdTable)) {
+    if (!cmd.errMsg.empty()) {
+      setError(cmd.errMsg);
+    } else {
+      (this->*kCmdTable[cmd.opcode].handler)(cmd);
+    }
   }
 
   if (!_success) {
-    _errMsg = args[0] + ": " + _errMsg;
+    _errMsg = cmd.getName() + ": " + _errMsg;
     VGLOG(LOG_ERR, "%s", _errMsg.c_str());
   }
 
-  if (showNotification) {
-    auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
-    notifications->show((_success) ? cmd : _errMsg);
-  }
-
   return _success;
 }
 
@@ -97,26 +336,8 @@ void CommandHandler::setError(const string& errMsg) {
   _errMsg = errMsg;
 }
 
-void CommandHandler::setBgmVolume(const std::vector<std::string> &args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <volume>", args[0].c_str()));
-    return;
-  }
-
-  float volume{0};
-  try {
-    volume = std::stof(args[1]);
-  } catch (const invalid_argument& ex) {
-    setError("invalid argument `volume`");
-    return;
-  } catch (const out_of_range& ex) {
-    setError("`volume` is too large");
-    return;
-  } catch (...) {
-    setError("unknown error");
-    return;
-  }
-
+void CommandHandler::setBgmVolume(const CompiledCmd& cmd) {
+  const float volume = cmd.getFloat(0);
   if (volume < 0 || volume > 100) {
     setError("volume must be set between [0,100]");
     return;
@@ -126,14 +347,9 @@ void CommandHandler::setBgmVolume(const std::vector<std::string> &args) {
   setSuccess();
 }
 
-void CommandHandler::startQuest(const vector<string>& args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <quest>", args[0].c_str()));
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  if (!gmMgr->getPlayer()->getQuestBook().startQuest(args[1])) {
+void CommandHandler::startQuest(const CompiledCmd& cmd) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  if (!gmMgr->getPlayer()->getQuestBook().startQuest(cmd.getString(0))) {
     setError("failed to start quest.");
     return;
   }
@@ -141,28 +357,9 @@ void CommandHandler::startQuest(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::setStage(const vector<string>& args) {
-  if (args.size() < 3) {
-    setError(string_util::format("usage: %s <quest> <stage_idx>", args[0].c_str()));
-    return;
-  }
-
-  int stageIdx = 0;
-  try {
-    stageIdx = std::stoi(args[2]);
-  } catch (const invalid_argument& ex) {
-    setError("invalid argument `stage_idx`");
-    return;
-  } catch (const out_of_range& ex) {
-    setError("`stage_idx` is too large");
-    return;
-  } catch (...) {
-    setError("unknown error");
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  if (!gmMgr->getPlayer()->getQuestBook().setStage(args[1], stageIdx)) {
+void CommandHandler::setStage(const CompiledCmd& cmd) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  if (!gmMgr->getPlayer()->getQuestBook().setStage(cmd.getString(0), cmd.getInt(1))) {
     setError("failed to set the stage of quest.");
     return;
   }
@@ -170,119 +367,42 @@ void CommandHandler::setStage(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::addItem(const vector<string>& args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <itemName> [amount]", args[0].c_str()));
-    return;
-  }
-
-  int amount = 1;
-  if (args.size() >= 3) {
-    try {
-      amount = std::stoi(args[2]);
-    } catch (const invalid_argument& ex) {
-      setError("invalid argument `amount`");
-      return;
-    } catch (const out_of_range& ex) {
-      setError("`amount` is too large");
-      return;
-    } catch (...) {
-      setError("unknown error");
-      return;
-    }
-  }
-
+void CommandHandler::addItem(const CompiledCmd& cmd) {
+  const int amount = cmd.hasArg(1) ? cmd.getInt(1) : 1;
   if (amount <= 0) {
     setError("`amount` has to be at least 1");
     return;
   }
 
-  unique_ptr<Item> item = Item::create(args[1]);
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  unique_ptr<Item> item = Item::create(cmd.getString(0));
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   gmMgr->getPlayer()->addItem(std::move(item), amount);
   setSuccess();
 }
 
-void CommandHandler::removeItem(const vector<string>& args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <itemName> [amount]", args[0].c_str()));
-    return;
-  }
-
-  int amount = 1;
-  if (args.size() >= 3) {
-    try {
-      amount = std::stoi(args[2]);
-    } catch (const invalid_argument& ex) {
-      setError("invalid argument `amount`");
-      return;
-    } catch (const out_of_range& ex) {
-      setError("`amount` is too large");
-      return;
-    } catch (...) {
-      setError("unknown error");
-      return;
-    }
-  }
-
+void CommandHandler::removeItem(const CompiledCmd& cmd) {
+  const int amount = cmd.hasArg(1) ? cmd.getInt(1) : 1;
   if (amount <= 0) {
     setError("`amount` has to be at least 1");
     return;
   }
 
-  unique_ptr<Item> item = Item::create(args[1]);
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  unique_ptr<Item> item = Item::create(cmd.getString(0));
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   gmMgr->getPlayer()->removeItem(item.get(), amount);
   setSuccess();
 }
 
-void CommandHandler::addGold(const vector<string>& args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <amount>", args[0].c_str()));
-    return;
-  }
-
-  int amount = 1;
-  try {
-    amount = std::stoi(args[1]);
-  } catch (const invalid_argument& ex) {
-    setError("invalid argument `amount`");
-    return;
-  } catch (const out_of_range& ex) {
-    setError("`amount` is too large");
-    return;
-  } catch (...) {
-    setError("unknown error");
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+void CommandHandler::addGold(const CompiledCmd& cmd) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   auto player = gmMgr->getPlayer();
-  player->addGold(amount);
+  player->addGold(cmd.getInt(0));
   setSuccess();
 }
 
-void CommandHandler::removeGold(const vector<string>& args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <amount>", args[0].c_str()));
-    return;
-  }
-
-  int amount = 1;
-  try {
-    amount = std::stoi(args[1]);
-  } catch (const invalid_argument& ex) {
-    setError("invalid argument `amount`");
-    return;
-  } catch (const out_of_range& ex) {
-    setError("`amount` is too large");
-    return;
-  } catch (...) {
-    setError("unknown error");
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+void CommandHandler::removeGold(const CompiledCmd& cmd) {
+  const int amount = cmd.getInt(0);
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   auto player = gmMgr->getPlayer();
   if (player->getGoldBalance() < amount) {
     setError("Failed to remove gold, insufficient gold.");
@@ -292,27 +412,17 @@ void CommandHandler::removeGold(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::updateDialogueTree(const vector<string>& args) {
-  if (args.size() < 3) {
-    setError(string_util::format("usage: %s <npcJson> <dialogueTreeJson>", args[0].c_str()));
-    return;
-  }
-
+void CommandHandler::updateDialogueTree(const CompiledCmd& cmd) {
   // TODO: Maybe add some argument check here?
 
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
-  dialogueMgr->setLatestNpcDialogueTree(args[1], args[2]);
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
+  dialogueMgr->setLatestNpcDialogueTree(cmd.getString(0), cmd.getString(1));
   setSuccess();
 }
 
-void CommandHandler::joinPlayerParty(const vector<string>& args) {
-  if (args.size() < 1) {
-    setError(string_util::format("usage: %s", args[0].c_str()));
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+void CommandHandler::joinPlayerParty(const CompiledCmd&) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
 
   Player* player = gmMgr->getPlayer();
   Npc* targetNpc = dialogueMgr->getTargetNpc();
@@ -327,14 +437,9 @@ void CommandHandler::joinPlayerParty(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::leavePlayerParty(const vector<string>& args) {
-  if (args.size() < 1) {
-    setError(string_util::format("usage: %s", args[0].c_str()));
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+void CommandHandler::leavePlayerParty(const CompiledCmd&) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
 
   Player* player = gmMgr->getPlayer();
   Npc* targetNpc = dialogueMgr->getTargetNpc();
@@ -349,14 +454,9 @@ void CommandHandler::leavePlayerParty(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::partyMemberWait(const vector<string>& args) {
-  if (args.size() < 1) {
-    setError(string_util::format("usage: %s", args[0].c_str()));
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+void CommandHandler::partyMemberWait(const CompiledCmd&) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
 
   Player* player = gmMgr->getPlayer();
   Npc* targetNpc = dialogueMgr->getTargetNpc();
@@ -376,14 +476,9 @@ void CommandHandler::partyMemberWait(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::partyMemberFollow(const vector<string>& args) {
-  if (args.size() < 1) {
-    setError(string_util::format("usage: %s", args[0].c_str()));
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+void CommandHandler::partyMemberFollow(const CompiledCmd&) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
 
   Player* player = gmMgr->getPlayer();
   Npc* targetNpc = dialogueMgr->getTargetNpc();
@@ -403,14 +498,9 @@ void CommandHandler::partyMemberFollow(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::trade(const vector<string>& args) {
-  if (args.size() < 1) {
-    setError(string_util::format("usage: %s", args[0].c_str()));
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+void CommandHandler::trade(const CompiledCmd&) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
 
   Player* player = gmMgr->getPlayer();
   Npc* targetNpc = dialogueMgr->getTargetNpc();
@@ -425,14 +515,9 @@ void CommandHandler::trade(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::kill(const vector<string>& args) {
-  if (args.size() < 1) {
-    setError(string_util::format("usage: %s", args[0].c_str()));
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+void CommandHandler::kill(const CompiledCmd&) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
 
   Player* player = gmMgr->getPlayer();
   Npc* targetNpc = dialogueMgr->getTargetNpc();
@@ -442,8 +527,8 @@ void CommandHandler::kill(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::interact(const vector<string>&) {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+void CommandHandler::interact(const CompiledCmd&) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   Player* player = gmMgr->getPlayer();
   if (!player) {
     setError("No player.");
@@ -462,47 +547,36 @@ void CommandHandler::interact(const vector<string>&) {
   setSuccess();
 }
 
-void CommandHandler::narrate(const vector<string>& args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <narratives...>", args[0].c_str()));
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+void CommandHandler::narrate(const CompiledCmd& cmd) {
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
   dialogueMgr->setTargetNpc(nullptr);
-  for (size_t i = 1; i < args.size(); i++) {
-    dialogueMgr->getSubtitles()->addSubtitle(args[i]);
+  for (size_t i = 0; i < cmd.getNumArgs(); i++) {
+    dialogueMgr->getSubtitles()->addSubtitle(cmd.getString(i));
   }
 
   dialogueMgr->getSubtitles()->beginSubtitles();
   setSuccess();
 }
 
-void CommandHandler::rest(const vector<string>& args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <innTmxMapFilePath>", args[0].c_str()));
-    return;
-  }
-
-  auto roomRentalTracker = SceneManager::the().getCurrentScene<GameScene>()->getRoomRentalTracker();
-  const string& tmxMapFilePath = args[1];
+void CommandHandler::rest(const CompiledCmd& cmd) {
+  auto roomRentalTracker = ServiceRegistry::get<RoomRentalTracker>();
+  const string& tmxMapFilePath = cmd.getString(0);
   if (!roomRentalTracker->hasCheckedIn(tmxMapFilePath)) {
-    auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+    auto notifications = ServiceRegistry::get<Notifications>();
     notifications->show("You cannot rest here because you haven't rented this room.");
 
     setError(string_util::format("failed to rest in [%s], haven't checked in.", tmxMapFilePath.c_str()));
     return;
   }
 
-  auto shade = SceneManager::the().getCurrentScene<GameScene>()->getShade();
+  auto shade = ServiceRegistry::get<Shade>();
   shade->getImageView()->runAction(Sequence::create(
       FadeIn::create(Shade::kFadeInTime * 3),
       CallFunc::create([]() {
-        auto inGameTime = SceneManager::the().getCurrentScene<GameScene>()->getInGameTime();
+        auto inGameTime = ServiceRegistry::get<InGameTime>();
         inGameTime->fastForward(8, 0, 0);
 
-        auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+        auto notifications = ServiceRegistry::get<Notifications>();
         notifications->show("You awaken feeling well rested.");
       }),
       FadeOut::create(Shade::kFadeOutTime * 3),
@@ -512,49 +586,31 @@ void CommandHandler::rest(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::rentRoomCheckIn(const vector<string>& args) {
-  if (args.size() < 4) {
-    setError(string_util::format("usage: %s <innTmxMapFilePath> <bedroomKeyJsonFilePath> <gold>", args[0].c_str()));
-    return;
-  }
-
-  int fee = 0;
-  try {
-    fee = std::stoi(args[3]);
-  } catch (const invalid_argument& ex) {
-    setError("invalid argument `amount`");
-    return;
-  } catch (const out_of_range& ex) {
-    setError("`amount` is too large");
-    return;
-  } catch (...) {
-    setError("unknown error");
-    return;
-  }
-
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+void CommandHandler::rentRoomCheckIn(const CompiledCmd& cmd) {
+  const int fee = cmd.getInt(2);
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   auto player = gmMgr->getPlayer();
   if (player->getGoldBalance() < fee) {
     setError("Failed to rent room, insufficient gold.");
     return;
   }
 
-  auto roomRentalTracker = SceneManager::the().getCurrentScene<GameScene>()->getRoomRentalTracker();
-  const string& tmxMapFilePath = args[1];
+  auto roomRentalTracker = ServiceRegistry::get<RoomRentalTracker>();
+  const string& tmxMapFilePath = cmd.getString(0);
   if (!roomRentalTracker->checkIn(tmxMapFilePath)) {
     VGLOG(LOG_INFO, "Already rented a room in this inn.");
     setSuccess();
     return;
   }
 
-  auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+  auto notifications = ServiceRegistry::get<Notifications>();
   notifications->show("You have successfully rented a room.");
 
-  const string& bedroomKeyJsonFilePath = args[2];
+  const string& bedroomKeyJsonFilePath = cmd.getString(1);
   player->addItem(Item::create(bedroomKeyJsonFilePath));
   player->removeGold(fee);
 
-  auto inGameTime = SceneManager::the().getCurrentScene<GameScene>()->getInGameTime();
+  auto inGameTime = ServiceRegistry::get<InGameTime>();
   inGameTime->runAfter(24, 0, 0, string_util::format("%s %s %s", cmd::kRentRoomCheckOut,
                                                                  tmxMapFilePath.c_str(),
                                                                  bedroomKeyJsonFilePath.c_str()));
@@ -562,20 +618,15 @@ void CommandHandler::rentRoomCheckIn(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::rentRoomCheckOut(const vector<string>& args) {
-  if (args.size() < 3) {
-    setError(string_util::format("usage: %s <innTmxMapFilePath> <bedroomKeyJsonFilePath>", args[0].c_str()));
-    return;
-  }
-
-  const string& tmxMapFilePath = args[1];
-  auto roomRentalTracker = SceneManager::the().getCurrentScene<GameScene>()->getRoomRentalTracker();
+void CommandHandler::rentRoomCheckOut(const CompiledCmd& cmd) {
+  const string& tmxMapFilePath = cmd.getString(0);
+  auto roomRentalTracker = ServiceRegistry::get<RoomRentalTracker>();
   if (!roomRentalTracker->checkOut(tmxMapFilePath)) {
     setError("Failed to check out.");
     return;
   }
 
-  const string& bedroomKeyJsonFilePath = args[2];
+  const string& bedroomKeyJsonFilePath = cmd.getString(1);
   unique_ptr<Item> item = Item::create(bedroomKeyJsonFilePath);
   if (!item) {
     setError(string_util::format("Failed to create item [%s].", bedroomKeyJsonFilePath.c_str()));
@@ -587,7 +638,7 @@ void CommandHandler::rentRoomCheckOut(const vector<string>& args) {
     return;
   }
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   gmMgr->setOpened(tmxMapFilePath,
                    GameMap::OpenableObjectType::PORTAL,
                    bedroomKey->getKeyProfile().targetPortalId,
@@ -599,89 +650,112 @@ void CommandHandler::rentRoomCheckOut(const vector<string>& args) {
   setSuccess();
 }
 
-void CommandHandler::beginBossFight(const vector<string>& args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <bossStageProfileJsonPath>", args[0].c_str()));
-    return;
-  }
-
-  const rapidjson::Document json = json_util::loadFromFile(args[1]);
+void CommandHandler::beginBossFight(const CompiledCmd& cmd) {
+  const rapidjson::Document json = json_util::loadFromFile(cmd.getString(0));
   const string targetNpcJsonFilePath = json["targetNpcJsonFilePath"].GetString();
   const string bgmFilePath = json["bgmFilePath"].GetString();
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   if (!gmMgr->getGameMap()->onBossFightBegin(targetNpcJsonFilePath, bgmFilePath)) {
-    setError(string_util::format("Failed to begin boss fight, bossStageProfileJsonPath: [%s]", args[1].c_str()));
+    setError(string_util::format("Failed to begin boss fight, bossStageProfileJsonPath: [%s]",
+                                 cmd.getString(0).c_str()));
     return;
   }
 
   setSuccess();
 }
 
-void CommandHandler::endBossFight(const vector<string>& args) {
-  if (args.size() < 2) {
-    setError(string_util::format("usage: %s <bossStageProfileJsonPath>", args[0].c_str()));
+void CommandHandler::endBossFight(const CompiledCmd&) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  gmMgr->getGameMap()->onBossFightEnd();
+
+  setSuccess();
+}
+
+void CommandHandler::setInGameTime(const CompiledCmd& cmd) {
+  auto inGameTime = ServiceRegistry::get<InGameTime>();
+  inGameTime->setHour(cmd.getInt(0));
+  inGameTime->setMinute(cmd.getInt(1));
+  inGameTime->setSecond(cmd.getInt(2));
+
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  gmMgr->getLighting()->syncWithInGameTime();
+
+  setSuccess();
+}
+
+void CommandHandler::cullStats(const CompiledCmd&) {
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
+  const Culling::Stats& stats = gmMgr->getCulling()->getStats();
+  const string msg = string_util::format("nodes: %d visible, %d culled; lights: %d visible, %d culled",
+                                         stats.numVisibleNodes, stats.numCulledNodes,
+                                         stats.numVisibleLightSources, stats.numCulledLightSources);
+
+  auto notifications = ServiceRegistry::get<Notifications>();
+  notifications->show(msg);
+  VGLOG(LOG_INFO, "%s", msg.c_str());
+
+  setSuccess();
+}
+
+void CommandHandler::soak(const CompiledCmd& cmd) {
+  const int numTicks = cmd.getInt(0);
+  const int numExtraNpcs = cmd.hasArg(1) ? cmd.getInt(1) : 0;
+  if (numTicks <= 0 || numExtraNpcs < 0) {
+    setError("`numTicks` must be positive and `numExtraNpcs` must not be negative");
     return;
   }
 
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
-  gmMgr->getGameMap()->onBossFightEnd();
+  bench::Simulation::spawnExtraNpcs(numExtraNpcs);
+  const auto report = bench::Simulation::run(numTicks);
+  VGLOG(LOG_INFO, "%s", bench::Simulation::format(report).c_str());
+
+  const double ticksPerSecond = (report.seconds > 0) ? report.numTicks / report.seconds : 0;
+  auto notifications = ServiceRegistry::get<Notifications>();
+  notifications->show(string_util::format("soak: %d ticks, %.1f ticks/sec", numTicks, ticksPerSecond));
 
   setSuccess();
 }
 
-void CommandHandler::setInGameTime(const vector<string>& args) {
-  if (args.size() < 4) {
-    setError(string_util::format("usage: %s <hour> <minute> <second>", args[0].c_str()));
+void CommandHandler::dumpTrace(const CompiledCmd& cmd) {
+  if (!profiler::kIsEnabled) {
+    setError("the profiler is disabled in this build");
     return;
   }
 
-  int hour = 0;
-  try {
-    hour = std::stoi(args[1]);
-  } catch (const invalid_argument& ex) {
-    setError("invalid argument `hour`");
-    return;
-  } catch (const out_of_range& ex) {
-    setError("`hour` is too large");
-    return;
-  } catch (...) {
-    setError("unknown error");
+  const float seconds = cmd.getFloat(0);
+  if (!std::isfinite(seconds) || seconds <= 0) {
+    setError(string_util::format("usage: %s <seconds:float> [filePath], `seconds` must be positive",
+                                 cmd::kDumpTrace));
     return;
   }
 
-  int minute = 0;
-  try {
-    minute = std::stoi(args[2]);
-  } catch (const invalid_argument& ex) {
-    setError("invalid argument `minute`");
-    return;
-  } catch (const out_of_range& ex) {
-    setError("`minute` is too large");
-    return;
-  } catch (...) {
-    setError("unknown error");
+  const string filePath = cmd.hasArg(1) ? cmd.getString(1) : "vigilante_trace.json";
+  const int numZones = profiler::dumpChromeTrace(filePath, seconds);
+  if (numZones < 0) {
+    setError(string_util::format("failed to write [%s]", filePath.c_str()));
     return;
   }
 
-  int second = 0;
-  try {
-    second = std::stoi(args[3]);
-  } catch (const invalid_argument& ex) {
-    setError("invalid argument `second`");
-    return;
-  } catch (const out_of_range& ex) {
-    setError("`second` is too large");
-    return;
-  } catch (...) {
-    setError("unknown error");
+  const string msg = string_util::format("dumped %d zones to %s", numZones, filePath.c_str());
+  auto notifications = ServiceRegistry::get<Notifications>();
+  notifications->show(msg);
+  VGLOG(LOG_INFO, "%s", msg.c_str());
+
+  setSuccess();
+}
+
+void CommandHandler::runScript(const CompiledCmd& cmd) {
+  auto script = ConsoleScript::load(cmd.getString(0));
+  if (!script) {
+    setError(string_util::format("failed to load script [%s]", cmd.getString(0).c_str()));
     return;
   }
 
-  auto inGameTime = SceneManager::the().getCurrentScene<GameScene>()->getInGameTime();
-  inGameTime->setHour(hour);
-  inGameTime->setMinute(minute);
-  inGameTime->setSecond(second);
+  if (!script->run()) {
+    setError(string_util::format("some cmds in [%s] have failed", cmd.getString(0).c_str()));
+    return;
+  }
 
   setSuccess();
 }
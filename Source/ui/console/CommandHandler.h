@@ -3,8 +3,10 @@
 #ifndef VIGILANTE_UI_CONSOLE_COMMAND_HANDLER_H_
 #define VIGILANTE_UI_CONSOLE_COMMAND_HANDLER_H_
 
+#include <array>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 namespace vigilante {
@@ -33,40 +35,102 @@ constexpr char kRentRoomCheckOut[] = "rentroomcheckout";
 constexpr char kBeginBossFight[] = "beginbossfight";
 constexpr char kEndBossFight[] = "endbossfight";
 constexpr char kSetInGameTime[] = "setingametime";
+constexpr char kCullStats[] = "cullstats";
+constexpr char kSoak[] = "soak";
+constexpr char kDumpTrace[] = "dumptrace";
+constexpr char kRunScript[] = "runscript";
 
 }  // namespace cmd
 
+// A command which has been tokenized, resolved to its handler and had its
+// args parsed according to the handler's signature ahead of time, i.e. when
+// the map, dialogue tree or quest containing it is loaded, so that executing
+// it doesn't have to parse it again.
+struct CompiledCmd final {
+  static inline constexpr uint8_t kInvalidOpcode = 0xff;
+  static inline constexpr size_t kMaxNumTypedArgs = 4;
+
+  union Value {
+    int i;
+    float f;
+  };
+
+  // The args don't include the name of the command, i.e. getString(0) is the first arg.
+  inline const std::string& getName() const { return tokens.front(); }
+  inline size_t getNumArgs() const { return tokens.size() - 1; }
+  inline bool hasArg(const size_t i) const { return i + 1 < tokens.size(); }
+  inline int getInt(const size_t i) const { return values[i].i; }
+  inline float getFloat(const size_t i) const { return values[i].f; }
+  inline const std::string& getString(const size_t i) const { return tokens[i + 1]; }
+
+  uint8_t opcode{kInvalidOpcode};  // the index of its handler in the cmd table
+  std::vector<std::string> tokens;  // tokens[0] is the name of the command
+  std::array<Value, kMaxNumTypedArgs> values{};  // the parsed int and float args
+  std::string errMsg;  // why the args don't match the signature, if they don't
+};
+
 class CommandHandler final {
  public:
+  static CompiledCmd compile(const std::string& cmd);
+  // Same as above, but also warns about unknown or malformed commands.
+  static std::vector<CompiledCmd> compile(const std::vector<std::string>& cmds);
+
+  // @return the opcode of the command named `name`, or CompiledCmd::kInvalidOpcode.
+  static uint8_t getOpcode(std::string_view name);
+  static size_t getNumCmds();
+  static const char* getCmdName(const uint8_t opcode);
+
   bool handle(const std::string& cmd, bool showNotification);
+  bool execute(const CompiledCmd& cmd);
 
  private:
+  using Handler = void (CommandHandler::*)(const CompiledCmd& cmd);
+
+  // The args of each command are declared by its usage, e.g.
+  //   "<quest> <stageIdx:int> [amount:float] [narratives...]"
+  // where <arg> is required, [arg] is optional, :int and :float are
+  // the arg types (string if omitted), and `...` takes the remaining args.
+  // The usage is parsed at compile time (see CommandHandler.cc).
+  struct CmdTableEntry final {
+    std::string_view name;
+    std::string_view usage;
+    Handler handler;
+  };
+
+  static const CmdTableEntry kCmdTable[];
+
+  static void parseArgs(CompiledCmd& cmd);
+
   void setSuccess();
   void setError(const std::string& errMsg);
 
   // Command handlers.
-  void setBgmVolume(const std::vector<std::string>& args);
-  void startQuest(const std::vector<std::string>& args);
-  void setStage(const std::vector<std::string>& args);
-  void addItem(const std::vector<std::string>& args);
-  void removeItem(const std::vector<std::string>& args);
-  void addGold(const std::vector<std::string>& args);
-  void removeGold(const std::vector<std::string>& args);
-  void updateDialogueTree(const std::vector<std::string>& args);
-  void joinPlayerParty(const std::vector<std::string>& args);
-  void leavePlayerParty(const std::vector<std::string>& args);
-  void partyMemberWait(const std::vector<std::string>& args);
-  void partyMemberFollow(const std::vector<std::string>& args);
-  void trade(const std::vector<std::string>& args);
-  void kill(const std::vector<std::string>& args);
-  void interact(const std::vector<std::string>& args);
-  void narrate(const std::vector<std::string>& args);
-  void rest(const std::vector<std::string>& args);
-  void rentRoomCheckIn(const std::vector<std::string>& args);
-  void rentRoomCheckOut(const std::vector<std::string>& args);
-  void beginBossFight(const std::vector<std::string>& args);
-  void endBossFight(const std::vector<std::string>& args);
-  void setInGameTime(const std::vector<std::string>& args);
+  void setBgmVolume(const CompiledCmd& cmd);
+  void startQuest(const CompiledCmd& cmd);
+  void setStage(const CompiledCmd& cmd);
+  void addItem(const CompiledCmd& cmd);
+  void removeItem(const CompiledCmd& cmd);
+  void addGold(const CompiledCmd& cmd);
+  void removeGold(const CompiledCmd& cmd);
+  void updateDialogueTree(const CompiledCmd& cmd);
+  void joinPlayerParty(const CompiledCmd& cmd);
+  void leavePlayerParty(const CompiledCmd& cmd);
+  void partyMemberWait(const CompiledCmd& cmd);
+  void partyMemberFollow(const CompiledCmd& cmd);
+  void trade(const CompiledCmd& cmd);
+  void kill(const CompiledCmd& cmd);
+  void interact(const CompiledCmd& cmd);
+  void narrate(const CompiledCmd& cmd);
+  void rest(const CompiledCmd& cmd);
+  void rentRoomCheckIn(const CompiledCmd& cmd);
+  void rentRoomCheckOut(const CompiledCmd& cmd);
+  void beginBossFight(const CompiledCmd& cmd);
+  void endBossFight(const CompiledCmd& cmd);
+  void setInGameTime(const CompiledCmd& cmd);
+  void cullStats(const CompiledCmd& cmd);
+  void soak(const CompiledCmd& cmd);
+  void dumpTrace(const CompiledCmd& cmd);
+  void runScript(const CompiledCmd& cmd);
 
   bool _success{};
   std::string _errMsg;
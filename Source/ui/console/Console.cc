@@ -4,6 +4,7 @@
 
 #include "input/InputManager.h"
 #include "util/Logger.h"
+#include "util/Profiler.h"
 
 using namespace std;
 USING_NS_AX;
@@ -51,6 +52,8 @@ Console::Console() : _layer{Layer::create()} {
 }
 
 void Console::update(const float delta) {
+  VGPROFILE_ZONE("Console::update");
+
   if (!_layer->isVisible()) {
     return;
   }
@@ -73,6 +76,10 @@ bool Console::executeCmd(const string& cmd,
   return hasSucceeded;
 }
 
+bool Console::executeCmd(const CompiledCmd& cmd) {
+  return _cmdHandler.execute(cmd);
+}
+
 bool Console::isVisible() const {
   return _layer->isVisible();
 }
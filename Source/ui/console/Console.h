@@ -22,6 +22,8 @@ class Console final {
   virtual bool executeCmd(const std::string& cmd,
                           bool showNotification=false,
                           bool saveInHistory=false);
+  // Executes a precompiled cmd, which is neither parsed nor saved in history.
+  virtual bool executeCmd(const CompiledCmd& cmd);
 
   bool isVisible() const;
   void setVisible(bool visible);
@@ -0,0 +1,136 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "ConsoleScript.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#include "CallbackManager.h"
+#include "ProfileCache.h"
+#include "scene/ServiceRegistry.h"
+#include "ui/console/Console.h"
+#include "util/Logger.h"
+#include "util/StringUtil.h"
+
+namespace fs = std::filesystem;
+using namespace std;
+
+namespace vigilante {
+
+namespace {
+
+// The scripts being loaded, used to reject scripts which run themselves.
+unordered_set<string> loadingFilePaths;
+
+}  // namespace
+
+shared_ptr<const ConsoleScript> ConsoleScript::load(const string& filePath) {
+  if (auto script = ProfileCache<ConsoleScript>::find(filePath)) {
+    return script;
+  }
+
+  const string key = fs::path{filePath}.lexically_normal().string();
+  if (loadingFilePaths.contains(key)) {
+    VGLOG(LOG_ERR, "Script [%s] runs itself recursively.", filePath.c_str());
+    return nullptr;
+  }
+
+  loadingFilePaths.insert(key);
+  auto script = std::make_shared<const ConsoleScript>(filePath);
+  loadingFilePaths.erase(key);
+
+  // Only valid scripts are cached, so that a script which has been fixed on disk is
+  // loaded again, and a recursion error doesn't stick to the other scripts in the cycle.
+  if (!script->isValid()) {
+    return nullptr;
+  }
+  ProfileCache<ConsoleScript>::insert(filePath, script);
+  return script;
+}
+
+ConsoleScript::ConsoleScript(const string& filePath) : _filePath{filePath} {
+  ifstream ifs{filePath};
+  if (!ifs.is_open()) {
+    VGLOG(LOG_ERR, "Failed to load script: [%s].", filePath.c_str());
+    return;
+  }
+
+  stringstream ss;
+  ss << ifs.rdbuf();
+  _isValid = compile(ss.str());
+}
+
+bool ConsoleScript::compile(const string& source) {
+  _blocks.push_back({0, {}});
+
+  istringstream iss{source};
+  string line;
+  for (int lineNo = 1; std::getline(iss, line); lineNo++) {
+    if (line.ends_with('\r')) {
+      line.pop_back();
+    }
+
+    const vector<string> tokens = string_util::parseArgs(line);
+    if (tokens.empty() || tokens.front().starts_with('#')) {
+      continue;
+    }
+
+    if (tokens.front() == kWaitCmd) {
+      char* end = nullptr;
+      errno = 0;
+      const float delay = (tokens.size() == 2) ? std::strtof(tokens[1].c_str(), &end) : -1;
+      if (delay < 0 || errno == ERANGE || end == tokens[1].c_str() || *end) {
+        VGLOG(LOG_ERR, "%s:%d: usage: %s <seconds>", _filePath.c_str(), lineNo, kWaitCmd);
+        return false;
+      }
+      _blocks.push_back({delay, {}});
+      continue;
+    }
+
+    CompiledCmd cmd = CommandHandler::compile(line);
+    if (cmd.opcode == CompiledCmd::kInvalidOpcode) {
+      VGLOG(LOG_ERR, "%s:%d: unknown cmd [%s].", _filePath.c_str(), lineNo, tokens.front().c_str());
+      return false;
+    }
+    if (!cmd.errMsg.empty()) {
+      VGLOG(LOG_ERR, "%s:%d: %s", _filePath.c_str(), lineNo, cmd.errMsg.c_str());
+      return false;
+    }
+    _blocks.back().cmds.push_back(std::move(cmd));
+  }
+
+  return true;
+}
+
+bool ConsoleScript::run() const {
+  return _isValid && runBlock(0);
+}
+
+bool ConsoleScript::runBlock(const size_t i) const {
+  auto console = ServiceRegistry::get<Console>();
+  if (!console) {
+    return false;
+  }
+
+  bool hasAllCmdsSucceeded = true;
+  for (const auto& cmd : _blocks[i].cmds) {
+    if (!console->executeCmd(cmd)) {
+      hasAllCmdsSucceeded = false;
+    }
+  }
+
+  if (i + 1 < _blocks.size()) {
+    // Keep this script alive until the rest of it has run.
+    CallbackManager::the().runAfter([script = shared_from_this(), i](const CallbackManager::CallbackId) {
+      script->runBlock(i + 1);
+    }, _blocks[i + 1].delay);
+  }
+
+  return hasAllCmdsSucceeded;
+}
+
+}  // namespace vigilante
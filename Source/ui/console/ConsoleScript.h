@@ -0,0 +1,65 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UI_CONSOLE_CONSOLE_SCRIPT_H_
+#define VIGILANTE_UI_CONSOLE_CONSOLE_SCRIPT_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ui/console/CommandHandler.h"
+
+namespace vigilante {
+
+// A .vgs file, i.e. a list of console commands, one per line, e.g.
+//   # Comments and blank lines are ignored.
+//   additem Resources/Database/item/key/castle_key.json
+//   narrate "The gate creaks open."
+//   wait 1.5
+//   startquest Resources/Database/quest/main/2_escape.json
+//
+// A script is compiled and validated when it's loaded, and is then cached
+// by its path if it's valid (an invalid script is loaded again next time).
+// Running a script executes its commands back to back without saving them
+// in the console's history or logging each of them.
+// `wait <seconds>` defers the rest of the script through CallbackManager,
+// so it's frozen while the game is paused, and is discarded along with
+// the GameScene.
+//
+// Maps, dialogue trees and quests can reference a script with `runscript <path>`
+// or with their `script` property, instead of repeating the same commands inline.
+class ConsoleScript final : public std::enable_shared_from_this<ConsoleScript> {
+ public:
+  static inline constexpr char kWaitCmd[] = "wait";
+
+  // @return the cached script, or nullptr if it can't be loaded or is invalid,
+  //         in which case it isn't cached.
+  static std::shared_ptr<const ConsoleScript> load(const std::string& filePath);
+
+  // Use load() instead, which caches the script.
+  explicit ConsoleScript(const std::string& filePath);
+
+  // @return whether all the commands before the first `wait` have succeeded.
+  bool run() const;
+
+  inline bool isValid() const { return _isValid; }
+  inline const std::string& getFilePath() const { return _filePath; }
+
+ private:
+  // The commands between two `wait`s.
+  struct Block final {
+    float delay;  // seconds after the previous block
+    std::vector<CompiledCmd> cmds;
+  };
+
+  bool compile(const std::string& source);
+  bool runBlock(const size_t i) const;
+
+  std::string _filePath;
+  std::vector<Block> _blocks;
+  bool _isValid{};
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_UI_CONSOLE_CONSOLE_SCRIPT_H_
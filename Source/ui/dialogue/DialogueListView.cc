@@ -6,7 +6,7 @@
 #include "Constants.h"
 #include "gameplay/DialogueTree.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "ui/dialogue/DialogueManager.h"
 #include "ui/dialogue/DialogueListView.h"
 
@@ -39,11 +39,11 @@ DialogueListView::DialogueListView(DialogueMenu* dialogMenu)
 }
 
 void DialogueListView::confirm() {
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
   auto dialogueMenu = dialogueMgr->getDialogueMenu();
   auto subtitles = dialogueMgr->getSubtitles();
 
-  auto console = SceneManager::the().getCurrentScene<GameScene>()->getConsole();
+  auto console = ServiceRegistry::get<Console>();
   bool hasAllCmdsSucceeded = true;
   for (const auto& cmd : getSelectedObject()->getCmds()) {
     if (!console->executeCmd(cmd)) {
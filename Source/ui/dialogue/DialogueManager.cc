@@ -2,6 +2,8 @@
 
 #include "DialogueManager.h"
 
+#include "util/Profiler.h"
+
 using namespace std;
 USING_NS_AX;
 
@@ -16,6 +18,8 @@ DialogueManager::DialogueManager()
 }
 
 void DialogueManager::update(const float delta) {
+  VGPROFILE_ZONE("DialogueManager::update");
+
   _subtitles->update(delta);
 }
 
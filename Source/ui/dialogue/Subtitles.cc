@@ -6,7 +6,7 @@
 
 #include "Assets.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "util/ds/Algorithm.h"
 
 using namespace std;
@@ -93,7 +93,7 @@ void Subtitles::beginSubtitles() {
     return;
   }
 
-  auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+  auto hud = ServiceRegistry::get<Hud>();
   hud->getLayer()->setVisible(false);
 
   _isTransitioning = true;
@@ -121,10 +121,10 @@ void Subtitles::endSubtitles() {
       _isTransitioning = false;
       _layer->setVisible(false);
 
-      auto hud = SceneManager::the().getCurrentScene<GameScene>()->getHud();
+      auto hud = ServiceRegistry::get<Hud>();
       hud->getLayer()->setVisible(true);
 
-      auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+      auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
       dialogueMgr->getTargetNpc()->onDialogueEnd();
     })
   ));
@@ -157,14 +157,14 @@ void Subtitles::showNextSubtitle() {
   _label->setString("");
 
   // If all subtitles has been displayed, show DialogueMenu if possible.
-  auto dialogueMgr = SceneManager::the().getCurrentScene<GameScene>()->getDialogueManager();
+  auto dialogueMgr = ServiceRegistry::get<DialogueManager>();
   Dialogue* currentDialogue = dialogueMgr->getCurrentDialogue();
   if (!currentDialogue) {
     endSubtitles();
     return;
   }
 
-  auto console = SceneManager::the().getCurrentScene<GameScene>()->getConsole();
+  auto console = ServiceRegistry::get<Console>();
   for (const auto& cmd : currentDialogue->getCmds()) {
     console->executeCmd(cmd);
   }
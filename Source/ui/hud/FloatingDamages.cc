@@ -2,12 +2,17 @@
 
 #include "FloatingDamages.h"
 
+#include <memory_resource>
+#include <vector>
+
 #include "Assets.h"
 #include "Constants.h"
 #include "character/Character.h"
 #include "character/Player.h"
 #include "character/Npc.h"
 #include "ui/Colorscheme.h"
+#include "util/FrameArena.h"
+#include "util/Profiler.h"
 
 using namespace std;
 using namespace vigilante::assets;
@@ -18,7 +23,9 @@ namespace vigilante {
 FloatingDamages::FloatingDamages() : _layer{Layer::create()} {}
 
 void FloatingDamages::update(const float delta) {
-  deque<map<Character*, deque<DamageLabel>>::iterator> trash;
+  VGPROFILE_ZONE("FloatingDamages::update");
+
+  pmr::vector<map<Character*, deque<DamageLabel>>::iterator> trash{&FrameArena::the()};
 
   auto it = _damageMap.begin();
   for (auto& characterDmgs : _damageMap) { // map<Character*, deque<FloatingDamage>>
@@ -7,7 +7,7 @@
 #include "character/Player.h"
 #include "item/Equipment.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 
 #define HUD_X 75
 #define HUD_Y ax::Director::getInstance()->getWinSize().height - 40
@@ -48,7 +48,7 @@ Hud::Hud()
 }
 
 void Hud::updateEquippedWeapon() {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   Equipment* weapon = gmMgr->getPlayer()->getEquipmentSlots()[Equipment::Type::WEAPON];
 
   if (weapon) {
@@ -65,7 +65,7 @@ void Hud::updateEquippedWeapon() {
 }
 
 void Hud::updateStatusBars() {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   Character::Profile& profile = gmMgr->getPlayer()->getCharacterProfile();
 
   _healthBar->update(profile.health, profile.fullHealth);
@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "ProfilerOverlay.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Assets.h"
+#include "Constants.h"
+#include "util/FrameArena.h"
+#include "util/Profiler.h"
+#include "util/StringUtil.h"
+
+using namespace std;
+using namespace vigilante::assets;
+USING_NS_AX;
+
+namespace vigilante {
+
+namespace {
+
+constexpr float kX = 10.0f;
+constexpr float kY = 10.0f;
+constexpr float kGraphHeight = 40.0f;
+constexpr float kGraphMaxMs = 2 * 1000.0f / kFps;  // two frames
+constexpr int kNumZonesShown = 6;
+
+const Color4F kBackgroundColor{0, 0, 0, .5f};
+const Color4F kBudgetColor{1, 1, 1, .5f};
+const Color4F kWithinBudgetColor{.3f, .8f, .4f, 1};
+const Color4F kOverBudgetColor{.9f, .3f, .3f, 1};
+
+}  // namespace
+
+ProfilerOverlay::ProfilerOverlay()
+    : _layer{Layer::create()},
+      _graph{DrawNode::create()},
+      _label{Label::createWithTTF("", string{kRegularFont}, kRegularFontSize)} {
+  _label->getFontAtlas()->setAliasTexParameters();
+  _label->setAnchorPoint({0, 0});
+  _label->setPosition(0, kGraphHeight + 4);
+
+  _layer->setPosition(kX, kY);
+  _layer->addChild(_graph);
+  _layer->addChild(_label);
+  _layer->setVisible(false);
+}
+
+void ProfilerOverlay::update() {
+  if (!isVisible()) {
+    return;
+  }
+
+  if (!profiler::kIsEnabled) {
+    _label->setString("profiler: built without VIGILANTE_PROFILER");
+    return;
+  }
+
+  // Frame time graph, one column per frame, oldest on the left.
+  const auto frameTimesMs = profiler::getFrameTimesMs();
+  const float budgetMs = 1000.0f / kFps;
+  const float graphWidth = static_cast<float>(frameTimesMs.size());
+
+  _graph->clear();
+  _graph->drawSolidRect({0, 0}, {graphWidth, kGraphHeight}, kBackgroundColor);
+  for (size_t i = 0; i < frameTimesMs.size(); i++) {
+    const float ms = std::min(frameTimesMs[i], kGraphMaxMs);
+    const float x = static_cast<float>(i) + .5f;
+    _graph->drawLine({x, 0}, {x, ms / kGraphMaxMs * kGraphHeight},
+                     (frameTimesMs[i] > budgetMs) ? kOverBudgetColor : kWithinBudgetColor);
+  }
+  const float budgetY = budgetMs / kGraphMaxMs * kGraphHeight;
+  _graph->drawLine({0, budgetY}, {graphWidth, budgetY}, kBudgetColor);
+
+  // Rolling percentiles and the slowest zones of the previous frame.
+  const auto stats = profiler::getFrameStats();
+  string s = string_util::format("frame p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms",
+                                 stats.p50Ms, stats.p95Ms, stats.p99Ms, stats.maxMs);
+
+  // The transient allocations of the previous frame, which should all fit in the arena.
+  const auto& arena = FrameArena::the();
+  const auto& arenaStats = arena.getLastFrameStats();
+  s += string_util::format("\narena %zu B / %zu allocs (capacity %zu KiB)  heap %zu B / %zu allocs",
+                           arenaStats.numBytes, arenaStats.numAllocations, arena.getCapacity() / 1024,
+                           arenaStats.numHeapBytes, arenaStats.numHeapAllocations);
+
+  const auto& zones = profiler::getLastFrameZones();
+  const int numZones = std::min(static_cast<int>(zones.size()), kNumZonesShown);
+  for (int i = numZones - 1; i >= 0; i--) {
+    s = string_util::format("%s  %.2f ms\n", zones[i].first, zones[i].second) + s;
+  }
+  _label->setString(s);
+}
+
+}  // namespace vigilante
@@ -0,0 +1,32 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UI_HUD_PROFILER_OVERLAY_H_
+#define VIGILANTE_UI_HUD_PROFILER_OVERLAY_H_
+
+#include <axmol.h>
+#include <2d/Label.h>
+
+namespace vigilante {
+
+// Shows the recent frame times as a graph, their rolling percentiles,
+// the slowest zones of the previous frame (see util/Profiler.h),
+// and how much the previous frame has allocated from the FrameArena.
+class ProfilerOverlay final {
+ public:
+  ProfilerOverlay();
+
+  void update();
+
+  inline bool isVisible() const { return _layer->isVisible(); }
+  inline void setVisible(const bool visible) { _layer->setVisible(visible); }
+  inline ax::Layer* getLayer() const { return _layer; }
+
+ private:
+  ax::Layer* _layer{};
+  ax::DrawNode* _graph{};
+  ax::Label* _label{};
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_UI_HUD_PROFILER_OVERLAY_H_
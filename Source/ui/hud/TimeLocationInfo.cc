@@ -6,7 +6,8 @@
 #include "Constants.h"
 #include "map/GameMapManager.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
+#include "util/Profiler.h"
 #include "util/StringUtil.h"
 
 using namespace std;
@@ -35,8 +36,10 @@ TimeLocationInfo::TimeLocationInfo()
 }
 
 void TimeLocationInfo::update() {
-  auto inGameTime = SceneManager::the().getCurrentScene<GameScene>()->getInGameTime();
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  VGPROFILE_ZONE("TimeLocationInfo::update");
+
+  auto inGameTime = ServiceRegistry::get<InGameTime>();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
 
   const string s = string_util::format("%02d:%02d / %s",
                                        inGameTime->getHour(), inGameTime->getMinute(),
@@ -6,7 +6,7 @@
 #include "Audio.h"
 #include "input/InputManager.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "ui/pause_menu/equipment/EquipmentPane.h"
 #include "ui/pause_menu/inventory/InventoryPane.h"
 #include "ui/pause_menu/option/OptionPane.h"
@@ -99,7 +99,7 @@ void PauseMenu::handleInput() {
     getCurrentPane()->update();
     getCurrentPane()->setVisible(true);
 
-    auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+    auto controlHints = ServiceRegistry::get<ControlHints>();
     controlHints->switchToProfile(static_cast<ControlHints::Profile>(_headerPane->getCurrentIndex()));
 
   } else if (IS_KEY_JUST_PRESSED(EventKeyboard::KeyCode::KEY_E)) {
@@ -108,7 +108,7 @@ void PauseMenu::handleInput() {
     getCurrentPane()->update();
     getCurrentPane()->setVisible(true);
 
-    auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+    auto controlHints = ServiceRegistry::get<ControlHints>();
     controlHints->switchToProfile(static_cast<ControlHints::Profile>(_headerPane->getCurrentIndex()));
   }
 
@@ -123,7 +123,7 @@ void PauseMenu::show(Pane pane) {
 }
 
 Player* PauseMenu::getPlayer() const {
-  auto gmMgr = SceneManager::the().getCurrentScene<GameScene>()->getGameMapManager();
+  auto gmMgr = ServiceRegistry::get<GameMapManager>();
   return gmMgr->getPlayer();
 }
 
@@ -135,13 +135,13 @@ void PauseMenu::setVisible(bool visible) {
   if (visible && !isVisible()) {
     _layer->setVisible(true);
     
-    auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+    auto controlHints = ServiceRegistry::get<ControlHints>();
     controlHints->pushProfile(static_cast<ControlHints::Profile>(_headerPane->getCurrentIndex()));
 
   } else if (!visible && isVisible()) {
     _layer->setVisible(false);
     
-    auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+    auto controlHints = ServiceRegistry::get<ControlHints>();
     controlHints->popProfile();
   }
 
@@ -4,7 +4,7 @@
 
 #include "Assets.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "ui/TableLayout.h"
 
 using namespace std;
@@ -80,7 +80,7 @@ void PauseMenuDialog::confirm() {
   _options[_current]->setSelected(false);
   _options[_current]->getHandler()(); // invokes a std::function<void ()>
 
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->setVisible(true);
 }
 
@@ -109,7 +109,7 @@ void PauseMenuDialog::show() {
   update();
   setVisible(true);
 
-  auto controlHints = SceneManager::the().getCurrentScene<GameScene>()->getControlHints();
+  auto controlHints = ServiceRegistry::get<ControlHints>();
   controlHints->setVisible(false);
 
   // Set the first visible option as selected.
@@ -10,7 +10,7 @@
 #include "item/Consumable.h"
 #include "ui/pause_menu/PauseMenu.h"
 #include "ui/pause_menu/PauseMenuDialog.h"
-#include "util/ds/SetVector.h"
+#include "util/ds/FlatSetVector.h"
 #include "util/KeyCodeUtil.h"
 
 using namespace std;
@@ -141,7 +141,7 @@ void ItemListView::showItemsByType(Item::Type itemType) {
 }
 
 void ItemListView::showEquipmentByType(Equipment::Type equipmentType) {
-  const SetVector<Item*>& equipments = _pauseMenu->getPlayer()->getInventory()[Item::Type::EQUIPMENT];
+  const FlatSetVector<Item*>& equipments = _pauseMenu->getPlayer()->getInventory()[Item::Type::EQUIPMENT];
   deque<Item*> objects(equipments.begin(), equipments.end());
 
   // Filter out any equipment other than the specified equipmentType.
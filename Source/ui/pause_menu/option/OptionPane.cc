@@ -7,7 +7,7 @@
 #include "gameplay/GameState.h"
 #include "input/InputManager.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 
 using namespace std;
 USING_NS_AX;
@@ -33,10 +33,15 @@ OptionPane::OptionPane(PauseMenu* pauseMenu)
 
   // Define available Options.
   _options = {{
-    {"Save Game", []() { GameState("quicksave.vgs").save(); }},
+    {"Save Game", []() {
+      GameState("quicksave.vgs").save([](const bool success) {
+        auto notifications = ServiceRegistry::get<Notifications>();
+        notifications->show(success ? "Game saved." : "Failed to save the game.");
+      });
+    }},
     {"Load Game", []() { GameState("quicksave.vgs").load(); }},
     {"Options",   []() {}},
-    {"Quit",      []() { SceneManager::the().getCurrentScene<GameScene>()->setRunning(false); }},
+    {"Quit",      []() { ServiceRegistry::get<GameScene>()->setRunning(false); }},
   }};
 
   vector<Option*> options;
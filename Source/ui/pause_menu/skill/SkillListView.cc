@@ -7,7 +7,7 @@
 #include "character/Player.h"
 #include "input/Keybindable.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "ui/pause_menu/PauseMenu.h"
 #include "ui/pause_menu/PauseMenuDialog.h"
 #include "util/KeyCodeUtil.h"
@@ -73,7 +73,7 @@ void SkillListView::confirm() {
   dialog->reset();
   dialog->setMessage("What would you like to do with " + skill->getName() + "?");
 
-  auto hotkeyMgr = SceneManager::the().getCurrentScene<GameScene>()->getHotkeyManager();
+  auto hotkeyMgr = ServiceRegistry::get<HotkeyManager>();
   dialog->setOption(0, true, "Assign", [=]() {
     dialog->reset();
     dialog->setMessage("Press a key to assign to...");
@@ -6,7 +6,7 @@
 
 #include "Assets.h"
 #include "scene/GameScene.h"
-#include "scene/SceneManager.h"
+#include "scene/ServiceRegistry.h"
 #include "ui/AmountSelectionWindow.h"
 #include "ui/WindowManager.h"
 #include "ui/hud/Notifications.h"
@@ -85,7 +85,7 @@ void TradeListView::confirm() {
       const string& buf = windowRawPtr->getTextField()->getString();
       int amount = 0;
 
-      auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+      auto notifications = ServiceRegistry::get<Notifications>();
       try {
         amount = std::stoi(buf);
       } catch (const std::invalid_argument& ex) {
@@ -102,7 +102,7 @@ void TradeListView::confirm() {
     auto onDismiss = []() {
       // Close AmountSelectionWindow which
       // should be at the top at this moment.
-      auto wm = SceneManager::the().getCurrentScene<GameScene>()->getWindowManager();
+      auto wm = ServiceRegistry::get<WindowManager>();
       wm->pop();
     };
 
@@ -110,7 +110,7 @@ void TradeListView::confirm() {
     window->getTextField()->setOnDismiss(onDismiss);
     window->getTextField()->setReceivingInput(true);
     
-    auto wm = SceneManager::the().getCurrentScene<GameScene>()->getWindowManager();
+    auto wm = ServiceRegistry::get<WindowManager>();
     wm->push(std::move(window));
   }
 }
@@ -155,7 +155,7 @@ void TradeListView::doTrade(Character* buyer,
     return;
   }
 
-  auto notifications = SceneManager::the().getCurrentScene<GameScene>()->getNotifications();
+  auto notifications = ServiceRegistry::get<Notifications>();
   const int price = item->getItemProfile().price;
 
   // Check if `amount` is valid.
@@ -0,0 +1,519 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "AssetBundle.h"
+
+#ifndef _WIN32
+extern "C" {
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <rapidjson/istreamwrapper.h>
+
+#include "util/ByteUtil.h"
+#include "util/Logger.h"
+
+using namespace std;
+
+namespace vigilante::asset_bundle {
+
+namespace {
+
+constexpr char kMagic[4] = {'V', 'G', 'A', 'B'};
+constexpr uint32_t kVersion = 2;
+
+struct Header final {
+  char magic[4];
+  uint32_t version;
+  uint32_t numEntries;
+  uint32_t entriesOffset;
+  uint32_t stringTableOffset;
+  uint32_t stringTableSize;
+  uint32_t recordsOffset;
+  uint32_t numRecords;
+  uint64_t sourceFingerprint;
+};
+
+struct Entry final {
+  uint32_t pathOffset;
+  uint32_t pathLength;
+  uint32_t rootRecordIdx;
+  uint32_t reserved;
+};
+
+enum class RecordType : uint32_t {
+  NULL_VALUE,
+  FALSE_VALUE,
+  TRUE_VALUE,
+  INT64,
+  UINT64,
+  DOUBLE,
+  STRING,  // payload: string table offset, size: string length
+  ARRAY,  // payload: first child record idx, size: number of children
+  OBJECT,  // payload: first member record idx, size: number of (key, value) pairs
+};
+
+struct Record final {
+  RecordType type;
+  uint32_t size;
+  uint64_t payload;
+};
+
+static_assert(sizeof(Header) == 40);
+static_assert(sizeof(Entry) == 16);
+static_assert(sizeof(Record) == 16);
+
+
+class BundleWriter final {
+ public:
+  void add(const string& path, const rapidjson::Value& json) {
+    const uint32_t pathOffset = intern(path);
+    const uint32_t rootRecordIdx = _records.size();
+    _records.emplace_back();
+    writeRecord(rootRecordIdx, json);
+    _entries.push_back({pathOffset, static_cast<uint32_t>(path.size()), rootRecordIdx, 0});
+  }
+
+  bool save(const fs::path& bundleFilePath, const uint64_t sourceFingerprint) {
+    std::sort(_entries.begin(), _entries.end(), [this](const Entry& e1, const Entry& e2) {
+      return string_view{&_stringTable[e1.pathOffset], e1.pathLength} <
+             string_view{&_stringTable[e2.pathOffset], e2.pathLength};
+    });
+
+    // Keep the records 8-byte aligned, since they will be read from the mapping in place.
+    while (_stringTable.size() % alignof(Record)) {
+      _stringTable.push_back('\0');
+    }
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.numEntries = _entries.size();
+    header.entriesOffset = sizeof(Header);
+    header.stringTableOffset = header.entriesOffset + _entries.size() * sizeof(Entry);
+    header.stringTableSize = _stringTable.size();
+    header.recordsOffset = header.stringTableOffset + _stringTable.size();
+    header.numRecords = _records.size();
+    header.sourceFingerprint = sourceFingerprint;
+
+    ofstream ofs{bundleFilePath, ios::binary | ios::trunc};
+    if (!ofs.is_open()) {
+      VGLOG(LOG_ERR, "Failed to open asset bundle: [%s].", bundleFilePath.c_str());
+      return false;
+    }
+
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(_entries.data()), _entries.size() * sizeof(Entry));
+    ofs.write(_stringTable.data(), _stringTable.size());
+    ofs.write(reinterpret_cast<const char*>(_records.data()), _records.size() * sizeof(Record));
+    return ofs.good();
+  }
+
+ private:
+  uint32_t intern(const string& str) {
+    auto it = _stringOffsets.find(str);
+    if (it != _stringOffsets.end()) {
+      return it->second;
+    }
+
+    const uint32_t offset = _stringTable.size();
+    _stringTable.insert(_stringTable.end(), str.begin(), str.end());
+    _stringTable.push_back('\0');
+    _stringOffsets.emplace(str, offset);
+    return offset;
+  }
+
+  // Note that `_records` may be reallocated during recursion,
+  // so records are always accessed by index here.
+  void writeRecord(const uint32_t idx, const rapidjson::Value& json) {
+    Record record{};
+
+    switch (json.GetType()) {
+      case rapidjson::kNullType:
+        record.type = RecordType::NULL_VALUE;
+        break;
+      case rapidjson::kFalseType:
+        record.type = RecordType::FALSE_VALUE;
+        break;
+      case rapidjson::kTrueType:
+        record.type = RecordType::TRUE_VALUE;
+        break;
+      case rapidjson::kNumberType:
+        if (json.IsInt64()) {
+          const int64_t value = json.GetInt64();
+          record.type = RecordType::INT64;
+          std::memcpy(&record.payload, &value, sizeof(value));
+        } else if (json.IsUint64()) {
+          record.type = RecordType::UINT64;
+          record.payload = json.GetUint64();
+        } else {
+          const double value = json.GetDouble();
+          record.type = RecordType::DOUBLE;
+          std::memcpy(&record.payload, &value, sizeof(value));
+        }
+        break;
+      case rapidjson::kStringType:
+        record.type = RecordType::STRING;
+        record.size = json.GetStringLength();
+        record.payload = intern(string{json.GetString(), json.GetStringLength()});
+        break;
+      case rapidjson::kArrayType: {
+        const uint32_t firstChildIdx = _records.size();
+        _records.resize(_records.size() + json.Size());
+        for (uint32_t i = 0; i < json.Size(); i++) {
+          writeRecord(firstChildIdx + i, json[i]);
+        }
+        record.type = RecordType::ARRAY;
+        record.size = json.Size();
+        record.payload = firstChildIdx;
+        break;
+      }
+      case rapidjson::kObjectType: {
+        const uint32_t firstMemberIdx = _records.size();
+        _records.resize(_records.size() + json.MemberCount() * 2);
+        uint32_t i = firstMemberIdx;
+        for (const auto& member : json.GetObject()) {
+          writeRecord(i++, member.name);
+          writeRecord(i++, member.value);
+        }
+        record.type = RecordType::OBJECT;
+        record.size = json.MemberCount();
+        record.payload = firstMemberIdx;
+        break;
+      }
+    }
+
+    _records[idx] = record;
+  }
+
+  vector<Entry> _entries;
+  vector<char> _stringTable;
+  unordered_map<string, uint32_t> _stringOffsets;
+  vector<Record> _records;
+};
+
+
+class MappedBundle final {
+ public:
+  ~MappedBundle() {
+    unmap();
+  }
+
+  bool map(const fs::path& bundleFilePath) {
+    unmap();
+
+#ifndef _WIN32
+    const int fd = ::open(bundleFilePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+      ::close(fd);
+      return false;
+    }
+    void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      return false;
+    }
+    _data = static_cast<const char*>(addr);
+    _size = st.st_size;
+#else
+    ifstream ifs{bundleFilePath, ios::binary | ios::ate};
+    if (!ifs.is_open()) {
+      return false;
+    }
+    _buffer.resize(ifs.tellg());
+    ifs.seekg(0);
+    ifs.read(_buffer.data(), _buffer.size());
+    _data = _buffer.data();
+    _size = _buffer.size();
+#endif
+
+    if (!validate()) {
+      unmap();
+      return false;
+    }
+    return true;
+  }
+
+  void unmap() {
+#ifndef _WIN32
+    if (_data) {
+      ::munmap(const_cast<char*>(_data), _size);
+    }
+#else
+    _buffer.clear();
+#endif
+    _data = nullptr;
+    _size = 0;
+  }
+
+  const Entry* find(const string_view path) const {
+    const Entry* begin = entries();
+    const Entry* end = begin + header().numEntries;
+    const Entry* it = std::lower_bound(begin, end, path, [this](const Entry& entry, const string_view path) {
+      return string_view{str(entry.pathOffset), entry.pathLength} < path;
+    });
+    if (it == end || string_view{str(it->pathOffset), it->pathLength} != path) {
+      return nullptr;
+    }
+    return it;
+  }
+
+  void decode(const uint32_t recordIdx, rapidjson::Value& out, rapidjson::Document::AllocatorType& allocator) const {
+    const Record& record = records()[recordIdx];
+
+    switch (record.type) {
+      case RecordType::NULL_VALUE:
+        out.SetNull();
+        break;
+      case RecordType::FALSE_VALUE:
+        out.SetBool(false);
+        break;
+      case RecordType::TRUE_VALUE:
+        out.SetBool(true);
+        break;
+      case RecordType::INT64: {
+        int64_t value;
+        std::memcpy(&value, &record.payload, sizeof(value));
+        out.SetInt64(value);
+        break;
+      }
+      case RecordType::UINT64:
+        out.SetUint64(record.payload);
+        break;
+      case RecordType::DOUBLE: {
+        double value;
+        std::memcpy(&value, &record.payload, sizeof(value));
+        out.SetDouble(value);
+        break;
+      }
+      case RecordType::STRING:
+        // The mapping outlives every Document loaded from it, so the strings are not copied.
+        out.SetString(rapidjson::StringRef(str(record.payload), record.size));
+        break;
+      case RecordType::ARRAY:
+        out.SetArray();
+        out.Reserve(record.size, allocator);
+        for (uint32_t i = 0; i < record.size; i++) {
+          rapidjson::Value child;
+          decode(record.payload + i, child, allocator);
+          out.PushBack(child, allocator);
+        }
+        break;
+      case RecordType::OBJECT:
+        out.SetObject();
+        out.MemberReserve(record.size, allocator);
+        for (uint32_t i = 0; i < record.size; i++) {
+          rapidjson::Value key;
+          rapidjson::Value value;
+          decode(record.payload + i * 2, key, allocator);
+          decode(record.payload + i * 2 + 1, value, allocator);
+          out.AddMember(key, value, allocator);
+        }
+        break;
+    }
+  }
+
+  inline bool isMapped() const { return _data != nullptr; }
+  inline const Header& header() const { return *reinterpret_cast<const Header*>(_data); }
+
+ private:
+  bool validate() const {
+    if (_size < sizeof(Header)) {
+      return false;
+    }
+
+    const Header& h = header();
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) {
+      return false;
+    }
+    const uint64_t entriesEnd = h.entriesOffset + uint64_t{h.numEntries} * sizeof(Entry);
+    const uint64_t recordsEnd = h.recordsOffset + uint64_t{h.numRecords} * sizeof(Record);
+    return entriesEnd <= _size &&
+           h.stringTableOffset + uint64_t{h.stringTableSize} <= _size &&
+           recordsEnd <= _size &&
+           h.recordsOffset % alignof(Record) == 0;
+  }
+
+  inline const Entry* entries() const { return reinterpret_cast<const Entry*>(_data + header().entriesOffset); }
+  inline const Record* records() const { return reinterpret_cast<const Record*>(_data + header().recordsOffset); }
+  inline const char* str(const uint64_t offset) const { return _data + header().stringTableOffset + offset; }
+
+  const char* _data{};
+  size_t _size{};
+#ifdef _WIN32
+  std::vector<char> _buffer;
+#endif
+};
+
+MappedBundle bundle;
+
+// The path under which a json file is keyed in the bundle, e.g., "Data/item/...".
+string getEntryPath(const fs::path& dataDirName, const fs::path& dataDir, const fs::path& jsonFilePath) {
+  const fs::path relativePath = dataDirName / fs::relative(jsonFilePath, dataDir);
+  return relativePath.lexically_normal().generic_string();
+}
+
+fs::path getDataDirName(const fs::path& dataDir) {
+  fs::path dataDirName = dataDir.lexically_normal();
+  if (!dataDirName.has_filename()) {
+    dataDirName = dataDirName.parent_path();
+  }
+  return dataDirName.filename();
+}
+
+// A hash (FNV-1a) of the path, size and contents of every json file under `dataDir`.
+// Modification times are left out, since they don't survive copying the resources
+// (e.g., installing or packaging the game). Reading the files is still cheap
+// compared to parsing them.
+bool getSourceFingerprint(const fs::path& dataDir, uint64_t& fingerprint) {
+  struct Source final {
+    string path;
+    fs::path filePath;
+  };
+
+  std::error_code ec;
+  vector<Source> sources;
+  const fs::path dataDirName = getDataDirName(dataDir);
+  for (fs::recursive_directory_iterator it{dataDir, ec}, end; !ec && it != end; it.increment(ec)) {
+    if (!it->is_regular_file(ec) || it->path().extension() != ".json") {
+      continue;
+    }
+    sources.push_back({getEntryPath(dataDirName, dataDir, it->path()), it->path()});
+  }
+  if (ec) {
+    return false;
+  }
+
+  // The order of directory entries is unspecified.
+  std::sort(sources.begin(), sources.end(), [](const Source& s1, const Source& s2) {
+    return s1.path < s2.path;
+  });
+
+  fingerprint = byte_util::kFnv1a64OffsetBasis;
+  const auto hash = [&fingerprint](const void* data, const size_t size) {
+    fingerprint = byte_util::fnv1a64({static_cast<const char*>(data), size}, fingerprint);
+  };
+  string content;
+  for (const auto& source : sources) {
+    ifstream ifs{source.filePath, ios::binary};
+    if (!ifs.is_open()) {
+      return false;
+    }
+    content.assign(istreambuf_iterator<char>{ifs}, istreambuf_iterator<char>{});
+    const uint64_t size = content.size();
+    hash(source.path.data(), source.path.size() + 1);
+    hash(&size, sizeof(size));
+    hash(content.data(), content.size());
+  }
+  return true;
+}
+
+}  // namespace
+
+bool cook(const fs::path& dataDir, const fs::path& bundleFilePath) {
+  std::error_code ec;
+  if (!fs::is_directory(dataDir, ec)) {
+    VGLOG(LOG_ERR, "Failed to cook asset bundle, [%s] is not a directory.", dataDir.c_str());
+    return false;
+  }
+
+  uint64_t sourceFingerprint{};
+  if (!getSourceFingerprint(dataDir, sourceFingerprint)) {
+    VGLOG(LOG_ERR, "Failed to cook asset bundle, failed to list the json files under [%s].", dataDir.c_str());
+    return false;
+  }
+
+  const fs::path dataDirName = getDataDirName(dataDir);
+  BundleWriter writer;
+  int numFiles = 0;
+  for (const auto& dentry : fs::recursive_directory_iterator{dataDir}) {
+    if (!dentry.is_regular_file() || dentry.path().extension() != ".json") {
+      continue;
+    }
+
+    ifstream ifs{dentry.path()};
+    rapidjson::IStreamWrapper isw{ifs};
+    rapidjson::Document doc;
+    doc.ParseStream(isw);
+    if (doc.HasParseError()) {
+      VGLOG(LOG_ERR, "Failed to parse json: [%s].", dentry.path().c_str());
+      return false;
+    }
+
+    writer.add(getEntryPath(dataDirName, dataDir, dentry.path()), doc);
+    numFiles++;
+  }
+
+  if (!writer.save(bundleFilePath, sourceFingerprint)) {
+    VGLOG(LOG_ERR, "Failed to save asset bundle: [%s].", bundleFilePath.c_str());
+    return false;
+  }
+
+  VGLOG(LOG_INFO, "Cooked [%d] json files into [%s].", numFiles, bundleFilePath.c_str());
+  return true;
+}
+
+bool open(const fs::path& bundleFilePath, const fs::path& dataDir) {
+  if (!bundle.map(bundleFilePath)) {
+    VGLOG(LOG_INFO, "Asset bundle [%s] unavailable, json files will be parsed at runtime.",
+          bundleFilePath.c_str());
+    return false;
+  }
+
+  // If the json files are shipped without the data dir, the bundle is all there is.
+  std::error_code ec;
+  uint64_t sourceFingerprint{};
+  if (fs::is_directory(dataDir, ec) &&
+      (!getSourceFingerprint(dataDir, sourceFingerprint) ||
+       sourceFingerprint != bundle.header().sourceFingerprint)) {
+    VGLOG(LOG_WARN, "Asset bundle [%s] is stale (json files under [%s] have changed), "
+          "json files will be parsed at runtime.", bundleFilePath.c_str(), dataDir.c_str());
+    bundle.unmap();
+    return false;
+  }
+
+  VGLOG(LOG_INFO, "Loaded asset bundle [%s] with [%u] json files.",
+        bundleFilePath.c_str(), bundle.header().numEntries);
+  return true;
+}
+
+void close() {
+  bundle.unmap();
+}
+
+bool isOpen() {
+  return bundle.isMapped();
+}
+
+bool load(const fs::path& jsonFilePath, rapidjson::Document& doc) {
+  if (!bundle.isMapped()) {
+    return false;
+  }
+
+  const Entry* entry = bundle.find(jsonFilePath.lexically_normal().generic_string());
+  if (!entry) {
+    return false;
+  }
+
+  bundle.decode(entry->rootRecordIdx, doc, doc.GetAllocator());
+  return true;
+}
+
+}  // namespace vigilante::asset_bundle
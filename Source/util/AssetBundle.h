@@ -0,0 +1,53 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UTIL_ASSET_BUNDLE_H_
+#define VIGILANTE_UTIL_ASSET_BUNDLE_H_
+
+#include <filesystem>
+
+#include <rapidjson/document.h>
+
+namespace fs = std::filesystem;
+
+// A cooked asset bundle contains all the json files under Resources/Data
+// pre-parsed into a compact binary form, so that they can be loaded
+// without reading and parsing each json file at runtime.
+//
+// Bundle layout (all integers are little-endian):
+//
+// +--------+-----------------------+--------------+----------------------+
+// | Header | Entry[numEntries]     | String table | Record[numRecords]   |
+// +--------+-----------------------+--------------+----------------------+
+//
+// - Entries map a json file path to its root record, sorted by path.
+// - The string table holds every (deduplicated) path, key and string value,
+//   each of which is null-terminated.
+// - Each json value is a fixed-layout record. The children of an array
+//   and the (key, value) pairs of an object are stored contiguously.
+//
+// At runtime the bundle is memory-mapped, and loading a json file from it
+// only builds the rapidjson DOM, with all strings referencing the mapping.
+//
+// The header holds a fingerprint of the json files it was cooked from
+// (their paths, sizes and contents). If the json files have changed since then,
+// the bundle is stale and is not used, so editing a json file never requires
+// re-cooking the bundle by hand. On Linux, the build re-cooks the bundle
+// whenever a json file changes (see the cook_data target in CMakeLists.txt).
+namespace vigilante::asset_bundle {
+
+// Cooks all the json files under `dataDir` into `bundleFilePath`.
+bool cook(const fs::path& dataDir, const fs::path& bundleFilePath);
+
+// Memory-maps a cooked bundle. Json files are loaded from it afterwards.
+// If `dataDir` exists and its json files don't match the bundle's fingerprint,
+// the bundle is not opened, and the json files will be parsed at runtime.
+bool open(const fs::path& bundleFilePath, const fs::path& dataDir);
+void close();
+bool isOpen();
+
+// @return true if `jsonFilePath` is in the bundle and has been loaded into `doc`.
+bool load(const fs::path& jsonFilePath, rapidjson::Document& doc);
+
+}  // namespace vigilante::asset_bundle
+
+#endif  // VIGILANTE_UTIL_ASSET_BUNDLE_H_
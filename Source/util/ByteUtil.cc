@@ -0,0 +1,146 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "ByteUtil.h"
+
+#include <bit>
+#include <cstring>
+
+using namespace std;
+
+namespace vigilante::byte_util {
+
+void Writer::writeBytes(const void* data, const size_t size) {
+  _buf.append(static_cast<const char*>(data), size);
+}
+
+void Writer::writeU8(const uint8_t value) {
+  _buf.push_back(static_cast<char>(value));
+}
+
+void Writer::writeU16(const uint16_t value) {
+  writeU8(static_cast<uint8_t>(value));
+  writeU8(static_cast<uint8_t>(value >> 8));
+}
+
+void Writer::writeU32(const uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    _buf.push_back(static_cast<char>(value >> (i * 8)));
+  }
+}
+
+void Writer::writeU64(const uint64_t value) {
+  writeU32(static_cast<uint32_t>(value));
+  writeU32(static_cast<uint32_t>(value >> 32));
+}
+
+void Writer::writeVarint(uint64_t value) {
+  while (value >= 0x80) {
+    _buf.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  _buf.push_back(static_cast<char>(value));
+}
+
+void Writer::writeFloat(const float value) {
+  writeU32(std::bit_cast<uint32_t>(value));
+}
+
+void Writer::writeString(const string_view s) {
+  writeVarint(s.size());
+  writeBytes(s.data(), s.size());
+}
+
+bool Reader::readBytes(void* data, const size_t size) {
+  if (getNumBytesLeft() < size) {
+    return false;
+  }
+  std::memcpy(data, _buf.data() + _pos, size);
+  _pos += size;
+  return true;
+}
+
+bool Reader::readU8(uint8_t& value) {
+  return readBytes(&value, 1);
+}
+
+bool Reader::readBool(bool& value) {
+  uint8_t byte;
+  if (!readU8(byte)) {
+    return false;
+  }
+  value = byte != 0;
+  return true;
+}
+
+bool Reader::readU16(uint16_t& value) {
+  uint8_t bytes[2];
+  if (!readBytes(bytes, sizeof(bytes))) {
+    return false;
+  }
+  value = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+  return true;
+}
+
+bool Reader::readU32(uint32_t& value) {
+  uint8_t bytes[4];
+  if (!readBytes(bytes, sizeof(bytes))) {
+    return false;
+  }
+  value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+  return true;
+}
+
+bool Reader::readU64(uint64_t& value) {
+  uint32_t lo;
+  uint32_t hi;
+  if (!readU32(lo) || !readU32(hi)) {
+    return false;
+  }
+  value = (static_cast<uint64_t>(hi) << 32) | lo;
+  return true;
+}
+
+bool Reader::readVarint(uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte;
+    if (!readU8(byte)) {
+      return false;
+    }
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Reader::readFloat(float& value) {
+  uint32_t bits;
+  if (!readU32(bits)) {
+    return false;
+  }
+  value = std::bit_cast<float>(bits);
+  return true;
+}
+
+bool Reader::readString(string& s) {
+  string_view view;
+  uint64_t size;
+  if (!readVarint(size) || !readView(size, view)) {
+    return false;
+  }
+  s.assign(view);
+  return true;
+}
+
+bool Reader::readView(const size_t size, string_view& view) {
+  if (getNumBytesLeft() < size) {
+    return false;
+  }
+  view = _buf.substr(_pos, size);
+  _pos += size;
+  return true;
+}
+
+}  // namespace vigilante::byte_util
@@ -0,0 +1,81 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UTIL_BYTE_UTIL_H_
+#define VIGILANTE_UTIL_BYTE_UTIL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// The building blocks of the binary file formats (save files, save journals
+// and input recordings), which are portable across hosts:
+// - Fixed-size integers are little-endian, and floats are stored as the
+//   little-endian bits of their IEEE 754 representation.
+// - Varints are LEB128, and strings are prefixed with their (varint) length.
+namespace vigilante::byte_util {
+
+inline constexpr uint32_t kFnv1a32OffsetBasis = 2166136261u;
+inline constexpr uint64_t kFnv1a64OffsetBasis = 14695981039346656037ull;
+
+// FNV-1a. To hash several pieces of data in a row, pass the hash of the previous ones as `hash`.
+constexpr uint32_t fnv1a32(const std::string_view data, uint32_t hash = kFnv1a32OffsetBasis) {
+  for (const char c : data) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return hash;
+}
+
+constexpr uint64_t fnv1a64(const std::string_view data, uint64_t hash = kFnv1a64OffsetBasis) {
+  for (const char c : data) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+class Writer final {
+ public:
+  void writeBytes(const void* data, const size_t size);
+  void writeU8(const uint8_t value);
+  void writeU16(const uint16_t value);
+  void writeU32(const uint32_t value);
+  void writeU64(const uint64_t value);
+  void writeVarint(uint64_t value);
+  void writeFloat(const float value);
+  void writeString(const std::string_view s);
+
+  inline const std::string& getBuffer() const { return _buf; }
+
+ private:
+  std::string _buf;
+};
+
+// Each read returns false if the data is truncated (or the varint is malformed),
+// after which the position is unspecified, so the reader shouldn't be used any further.
+class Reader final {
+ public:
+  explicit Reader(const std::string_view buf) : _buf{buf} {}
+
+  bool readBytes(void* data, const size_t size);
+  bool readU8(uint8_t& value);
+  bool readBool(bool& value);
+  bool readU16(uint16_t& value);
+  bool readU32(uint32_t& value);
+  bool readU64(uint64_t& value);
+  bool readVarint(uint64_t& value);
+  bool readFloat(float& value);
+  bool readString(std::string& s);
+  // Reads `size` bytes without copying them.
+  bool readView(const size_t size, std::string_view& view);
+
+  inline size_t getNumBytesLeft() const { return _buf.size() - _pos; }
+  inline bool isEof() const { return _pos == _buf.size(); }
+
+ private:
+  const std::string_view _buf;
+  size_t _pos{};
+};
+
+}  // namespace vigilante::byte_util
+
+#endif  // VIGILANTE_UTIL_BYTE_UTIL_H_
@@ -78,8 +78,8 @@ void updateShake(Camera* camera, const float delta) {
 
   if (currentTime <= duration) {
     currentPower = power * ((duration - currentTime) / duration);
-    pos.x = (rand_util::randFloat() - 0.5f) * 2 * currentPower; // camera offset X
-    pos.y = (rand_util::randFloat() - 0.5f) * 2 * currentPower; // camera offset Y
+    pos.x = (rand_util::randFloat(rand_util::Stream::CAMERA) - 0.5f) * 2 * currentPower; // camera offset X
+    pos.y = (rand_util::randFloat(rand_util::Stream::CAMERA) - 0.5f) * 2 * currentPower; // camera offset Y
     currentTime += delta;
     // Translate camera
     const Vec2& camPos = camera->getPosition();
@@ -89,4 +89,13 @@ void updateShake(Camera* camera, const float delta) {
   }
 }
 
+Rect getViewRect(const Camera* camera, const float margin) {
+  const auto winSize = Director::getInstance()->getWinSize();
+  const Vec2& position = camera->getPosition();
+  return Rect{position.x - winSize.width / 2 - margin,
+              position.y - winSize.height / 2 - margin,
+              winSize.width + margin * 2,
+              winSize.height + margin * 2};
+}
+
 }  // namespace vigilante::camera_util
@@ -18,6 +18,9 @@ void lerpToTarget(ax::Camera* camera, const b2Vec2& target);
 void shake(float rumblePower, float rumbleDuration);
 void updateShake(ax::Camera* camera, const float delta);
 
+// The rect (in world space) seen by an orthographic camera, expanded by `margin` on each side.
+ax::Rect getViewRect(const ax::Camera* camera, const float margin = 0.0f);
+
 }  // namespace vigilante::camera_util
 
 #endif  // VIGILANTE_UTIL_CAMERA_UTIL_H_
@@ -0,0 +1,66 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+using namespace std;
+
+namespace vigilante {
+
+FrameArena& FrameArena::the() {
+  static FrameArena instance{kDefaultCapacity};
+  return instance;
+}
+
+FrameArena::FrameArena(const size_t capacity)
+    : _buffer{std::make_unique<byte[]>(capacity)},
+      _capacity{capacity} {}
+
+void FrameArena::reset() {
+  // Grow the arena if the previous frame(s) didn't fit,
+  // so that the steady state doesn't touch the heap at all.
+  if (_peakNumBytes > _capacity) {
+    _capacity = std::bit_ceil(_peakNumBytes);
+    _buffer = std::make_unique<byte[]>(_capacity);
+  }
+
+  _offset = 0;
+  _peakNumBytes = 0;
+  _lastFrameStats = _stats;
+  _stats = {};
+}
+
+void* FrameArena::do_allocate(const size_t numBytes, const size_t alignment) {
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(_buffer.get());
+  const uintptr_t p = (begin + _offset + alignment - 1) & ~(alignment - 1);
+  const size_t newOffset = p - begin + numBytes;
+
+  if (newOffset > _capacity) {
+    _peakNumBytes = std::max(_peakNumBytes, newOffset);
+    _stats.numHeapBytes += numBytes;
+    _stats.numHeapAllocations++;
+    return std::pmr::new_delete_resource()->allocate(numBytes, alignment);
+  }
+
+  _offset = newOffset;
+  _peakNumBytes = std::max(_peakNumBytes, newOffset);
+  _stats.numBytes += numBytes;
+  _stats.numAllocations++;
+  return reinterpret_cast<void*>(p);
+}
+
+void FrameArena::do_deallocate(void* p, const size_t numBytes, const size_t alignment) {
+  const byte* q = static_cast<const byte*>(p);
+  if (q < _buffer.get() || q >= _buffer.get() + _capacity) {
+    std::pmr::new_delete_resource()->deallocate(p, numBytes, alignment);
+  }
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+}  // namespace vigilante
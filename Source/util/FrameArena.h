@@ -0,0 +1,60 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UTIL_FRAME_ARENA_H_
+#define VIGILANTE_UTIL_FRAME_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace vigilante {
+
+// A bump allocator for transient containers which don't outlive the current frame.
+//
+// Example usage:
+//   std::pmr::vector<Character*> targets{&FrameArena::the()};
+//
+// Deallocation is a no-op. Instead, the whole arena is rewound once per frame
+// at the beginning of GameScene::update(), so anything allocated from it
+// must be destroyed by then. If a frame needs more than the arena's capacity,
+// the rest is served by the heap, and the arena grows for the next frame.
+//
+// The arena is not synchronized, so it must only be used by the main thread.
+class FrameArena final : public std::pmr::memory_resource {
+ public:
+  struct Stats final {
+    size_t numBytes;
+    size_t numAllocations;
+    size_t numHeapBytes;  // which didn't fit in the arena
+    size_t numHeapAllocations;
+  };
+
+  static FrameArena& the();
+
+  explicit FrameArena(const size_t capacity);
+
+  // Rewinds the arena. Must be called once per frame.
+  void reset();
+
+  inline size_t getCapacity() const { return _capacity; }
+  inline const Stats& getStats() const { return _stats; }
+  inline const Stats& getLastFrameStats() const { return _lastFrameStats; }
+
+ private:
+  static inline constexpr size_t kDefaultCapacity = 64 * 1024;
+
+  void* do_allocate(size_t numBytes, size_t alignment) override;
+  void do_deallocate(void* p, size_t numBytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+  std::unique_ptr<std::byte[]> _buffer;
+  size_t _capacity;
+  size_t _offset{};
+  size_t _peakNumBytes{};  // including the heap allocations
+  Stats _stats{};
+  Stats _lastFrameStats{};
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_UTIL_FRAME_ARENA_H_
@@ -2,10 +2,22 @@
 
 #include "JsonUtil.h"
 
+#ifndef _WIN32
+extern "C" {
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+#endif
+
 #include <fstream>
+#include <limits>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 
-#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/error/en.h>
 #include <rapidjson/ostreamwrapper.h>
 #include <rapidjson/writer.h>
 
@@ -15,16 +27,213 @@ using namespace std;
 
 namespace vigilante::json_util {
 
-rapidjson::Document loadFromFile(const fs::path& jsonFilePath) {
-  ifstream ifs(jsonFilePath);
+JsonFileBuffer::JsonFileBuffer(const fs::path& jsonFilePath) {
+#ifndef _WIN32
+  const int fd = ::open(jsonFilePath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    VGLOG(LOG_ERR, "Failed to load json: [%s].", jsonFilePath.c_str());
+    return;
+  }
+  struct stat st{};
+  if (::fstat(fd, &st) < 0) {
+    ::close(fd);
+    VGLOG(LOG_ERR, "Failed to load json: [%s].", jsonFilePath.c_str());
+    return;
+  }
+
+  // The rest of the last page of a mapping is zero-filled, which null-terminates
+  // the json text, unless the file size happens to be a multiple of the page size.
+  const size_t size = st.st_size;
+  const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+  if (size > 0 && size % pageSize != 0) {
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      ::close(fd);
+      _data = static_cast<char*>(addr);
+      _size = size;
+      _mappedSize = size;
+      return;
+    }
+  }
+  ::close(fd);
+#endif
+
+  ifstream ifs{jsonFilePath, ios::binary | ios::ate};
   if (!ifs.is_open()) {
     VGLOG(LOG_ERR, "Failed to load json: [%s].", jsonFilePath.c_str());
+    return;
+  }
+  _buffer.resize(ifs.tellg());
+  ifs.seekg(0);
+  ifs.read(_buffer.data(), _buffer.size());
+  _data = _buffer.data();
+  _size = _buffer.size();
+}
+
+JsonFileBuffer::~JsonFileBuffer() {
+#ifndef _WIN32
+  if (_mappedSize) {
+    ::munmap(_data, _mappedSize);
+  }
+#endif
+}
+
+TokenReader::TokenReader(char* json) : _stream{json}, _reader{}, _handler{*this} {
+  _reader.IterativeParseInit();
+}
+
+TokenReader::TokenReader(const rapidjson::Value& json)
+    : _stream{nullptr},
+      _reader{},
+      _handler{*this},
+      _isReadingDom{true} {
+  json.Accept(_handler);
+  _value = {};
+}
+
+bool TokenReader::next() {
+  if (_isReadingDom) {
+    if (_domTokenIdx >= _domTokens.size()) {
+      _value = {};
+      return false;
+    }
+    _value = _domTokens[_domTokenIdx++];
+    return true;
+  }
+
+  _value.token = Token::NONE;
+  // The last call after the end of the root value succeeds without a token.
+  return _reader.IterativeParseNext<kParseFlags>(_stream, _handler) && _value.token != Token::NONE;
+}
+
+bool TokenReader::skipValue() {
+  if (getToken() != Token::START_OBJECT && getToken() != Token::START_ARRAY) {
+    return getToken() != Token::NONE;
+  }
+
+  int depth = 1;
+  while (depth > 0 && next()) {
+    if (getToken() == Token::START_OBJECT || getToken() == Token::START_ARRAY) {
+      depth++;
+    } else if (getToken() == Token::END_OBJECT || getToken() == Token::END_ARRAY) {
+      depth--;
+    }
+  }
+  return depth == 0;
+}
+
+double TokenReader::getDouble() const {
+  switch (getToken()) {
+    case Token::INT:
+      return static_cast<double>(_value.i);
+    case Token::UINT64:
+      return static_cast<double>(_value.u);
+    default:
+      return _value.d;
+  }
+}
+
+bool TokenReader::fail(const string_view error) {
+  if (_error.empty()) {
+    _error = error;
+  }
+  return false;
+}
+
+void TokenReader::prependErrorPath(const string_view keyOrIndex) {
+  _errorPath.insert(0, keyOrIndex);
+  _errorPath.insert(0, 1, '/');
+}
+
+bool TokenReader::Handler::Null() {
+  return emit({.token = Token::NULL_VALUE});
+}
+
+bool TokenReader::Handler::Bool(bool b) {
+  return emit({.token = Token::BOOL, .b = b});
+}
+
+bool TokenReader::Handler::Int(int i) {
+  return Int64(i);
+}
+
+bool TokenReader::Handler::Uint(unsigned u) {
+  return Int64(u);
+}
+
+bool TokenReader::Handler::Int64(int64_t i) {
+  return emit({.token = Token::INT, .i = i});
+}
+
+bool TokenReader::Handler::Uint64(uint64_t u) {
+  if (u <= static_cast<uint64_t>(numeric_limits<int64_t>::max())) {
+    return Int64(static_cast<int64_t>(u));
+  }
+  return emit({.token = Token::UINT64, .u = u});
+}
+
+bool TokenReader::Handler::Double(double d) {
+  return emit({.token = Token::DOUBLE, .d = d});
+}
+
+bool TokenReader::Handler::String(const char* str, rapidjson::SizeType length, bool) {
+  return emit({.token = Token::STRING, .str = {str, length}});
+}
+
+bool TokenReader::Handler::Key(const char* str, rapidjson::SizeType length, bool) {
+  return emit({.token = Token::KEY, .str = {str, length}});
+}
+
+bool TokenReader::Handler::StartObject() {
+  return emit({.token = Token::START_OBJECT});
+}
+
+bool TokenReader::Handler::EndObject(rapidjson::SizeType) {
+  return emit({.token = Token::END_OBJECT});
+}
+
+bool TokenReader::Handler::StartArray() {
+  return emit({.token = Token::START_ARRAY});
+}
+
+bool TokenReader::Handler::EndArray(rapidjson::SizeType) {
+  return emit({.token = Token::END_ARRAY});
+}
+
+bool TokenReader::Handler::emit(const TokenValue& value) {
+  tokenReader._value = value;
+  if (tokenReader._isReadingDom) {
+    tokenReader._domTokens.push_back(value);
+  }
+  return true;
+}
+
+void logReadError(const fs::path& jsonFilePath, const TokenReader& reader) {
+  const string& errorPath = reader.getErrorPath().empty() ? "/" : reader.getErrorPath();
+  if (reader.hasParseError()) {
+    VGLOG(LOG_ERR, "Failed to parse json: [%s] at offset [%zu] (in [%s]): %s",
+          jsonFilePath.c_str(), reader.getOffset(), errorPath.c_str(),
+          rapidjson::GetParseError_En(reader.getParseErrorCode()));
+    return;
+  }
+  VGLOG(LOG_ERR, "Invalid json: [%s] at [%s]: %s.", jsonFilePath.c_str(), errorPath.c_str(),
+        reader.getError().empty() ? "unexpected end" : reader.getError().c_str());
+}
+
+rapidjson::Document loadFromFile(const fs::path& jsonFilePath) {
+  // Prefer the cooked asset bundle (if any) over parsing the json file.
+  if (rapidjson::Document doc; asset_bundle::load(jsonFilePath, doc)) {
+    return doc;
+  }
+
+  JsonFileBuffer buffer{jsonFilePath};
+  if (!buffer.isOpen()) {
     return {};
   }
 
-  rapidjson::IStreamWrapper isw(ifs);
+  // The document outlives the buffer, so it can't be parsed in situ.
   rapidjson::Document doc;
-  doc.ParseStream(isw);
+  doc.Parse(buffer.data(), buffer.size());
   return doc;
 }
 
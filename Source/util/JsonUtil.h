@@ -3,11 +3,16 @@
 #ifndef VIGILANTE_UTIL_JSON_UTIL_H_
 #define VIGILANTE_UTIL_JSON_UTIL_H_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -15,6 +20,10 @@
 #include <vector>
 
 #include <rapidjson/document.h>
+#include <rapidjson/reader.h>
+
+#include "util/AssetBundle.h"
+#include "util/Reflection.h"
 
 namespace fs = std::filesystem;
 
@@ -81,6 +90,17 @@ makeJsonObject(rapidjson::Document::AllocatorType& allocator, T&& value) {
       ret.PushBack(v, allocator);
     }
     return ret;
+  } else if constexpr (reflection::is_reflectable<_T>) {
+    rapidjson::Value ret(rapidjson::kObjectType);
+    reflection::forEachField(_T::kFields, [&allocator, &value, &ret](const auto& field, size_t) {
+      auto v = makeJsonObject(allocator, value.*field.member);
+      ret.AddMember(rapidjson::StringRef(field.key.data(), field.key.size()), v, allocator);
+    });
+    return ret;
+  } else if constexpr (std::is_enum_v<_T>) {
+    return rapidjson::Value(static_cast<int>(value));
+  } else if constexpr (std::is_arithmetic_v<_T>) {
+    return rapidjson::Value(static_cast<_T>(value));
   } else {
     return rapidjson::Value(std::forward<_T>(value));
   }
@@ -94,6 +114,8 @@ T extractJsonObject(const rapidjson::Value& val) {
     return val.GetUint64();
   } else if constexpr (std::is_same_v<T, int>) {
     return val.GetInt();
+  } else if constexpr (std::is_enum_v<T>) {
+    return static_cast<T>(val.GetInt());
   } else if constexpr (std::is_same_v<T, float>) {
     return val.GetFloat();
   } else if constexpr (std::is_same_v<T, std::string>) {
@@ -106,6 +128,17 @@ T extractJsonObject(const rapidjson::Value& val) {
     };
   } else if constexpr (is_vector<T> || is_list<T>) {
     T ret;
+    // An object can be read into a vector of (key, value) pairs, keeping the order of its keys.
+    if constexpr (is_pair<typename T::value_type>) {
+      if (val.IsObject()) {
+        for (const auto& kv : val.GetObject()) {
+          ret.emplace_back(
+              extractJsonObject<typename T::value_type::first_type>(kv.name),
+              extractJsonObject<typename T::value_type::second_type>(kv.value));
+        }
+        return ret;
+      }
+    }
     for (const auto& element : val.GetArray()) {
       ret.emplace_back(extractJsonObject<typename T::value_type>(element));
     }
@@ -157,6 +190,388 @@ void deserialize(const rapidjson::Value& obj, KVs... kvs) {
   (deserializeImpl(obj, kvs), ...);
 }
 
+// The content of a json file, which is null-terminated and writable for in-situ
+// parsing (i.e., strings are decoded in place and are referenced rather than copied).
+// Where possible, it's memory-mapped copy-on-write instead of being read into memory.
+class JsonFileBuffer final {
+ public:
+  explicit JsonFileBuffer(const fs::path& jsonFilePath);
+  ~JsonFileBuffer();
+  JsonFileBuffer(const JsonFileBuffer&) = delete;
+  JsonFileBuffer& operator=(const JsonFileBuffer&) = delete;
+
+  inline bool isOpen() const { return _data != nullptr; }
+  inline char* data() { return _data; }
+  inline size_t size() const { return _size; }
+
+ private:
+  char* _data{};
+  size_t _size{};
+  size_t _mappedSize{};  // 0 if not memory-mapped.
+  std::string _buffer;
+};
+
+// Pulls the tokens of a json text one at a time (with rapidjson's iterative
+// SAX parser), so that a value can be read straight into its C++ counterpart
+// without building a DOM first. The json text is parsed in situ.
+//
+// The tokens of a DOM (e.g., loaded from the asset bundle) can be pulled
+// just the same, so that both are read and validated by the same code.
+class TokenReader final {
+ public:
+  enum class Token {
+    NONE,
+    NULL_VALUE,
+    BOOL,
+    INT,
+    UINT64,
+    DOUBLE,
+    STRING,
+    KEY,
+    START_OBJECT,
+    END_OBJECT,
+    START_ARRAY,
+    END_ARRAY,
+  };
+
+  explicit TokenReader(char* json);
+  // The strings of the tokens reference `json`, which must outlive the TokenReader.
+  explicit TokenReader(const rapidjson::Value& json);
+  TokenReader(const TokenReader&) = delete;
+  TokenReader& operator=(const TokenReader&) = delete;
+
+  // Advances to the next token.
+  // @return false at the end of the json text or on syntax errors.
+  bool next();
+  // Skips the current value, i.e., the whole object or array if it starts one.
+  bool skipValue();
+
+  inline Token getToken() const { return _value.token; }
+  inline bool isNumber() const { return getToken() == Token::INT || getToken() == Token::UINT64 || getToken() == Token::DOUBLE; }
+  inline bool getBool() const { return _value.b; }
+  // INT holds any integer which fits in an int64_t, and UINT64 holds the larger ones.
+  inline int64_t getInt64() const { return _value.i; }
+  inline uint64_t getUint64() const { return _value.u; }
+  double getDouble() const;
+  // For STRING and KEY, which reference the json text.
+  inline std::string_view getString() const { return _value.str; }
+
+  inline bool hasParseError() const { return _reader.HasParseError(); }
+  inline rapidjson::ParseErrorCode getParseErrorCode() const { return _reader.GetParseErrorCode(); }
+  // The offset in the json text right after the current token.
+  inline size_t getOffset() const { return _stream.Tell(); }
+
+  // Records `error` unless an error has been recorded already.
+  // @return false, so that it can be returned right away.
+  bool fail(const std::string_view error);
+  // Prepends a key (or an index) to the path of the value in error,
+  // which is built as reading the value unwinds.
+  void prependErrorPath(const std::string_view keyOrIndex);
+  inline const std::string& getError() const { return _error; }
+  inline const std::string& getErrorPath() const { return _errorPath; }
+
+ private:
+  struct TokenValue final {
+    Token token{Token::NONE};
+    bool b{};
+    int64_t i{};
+    uint64_t u{};
+    double d{};
+    std::string_view str{};
+  };
+
+  struct Handler final : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Handler> {
+    explicit Handler(TokenReader& tokenReader) : tokenReader{tokenReader} {}
+
+    bool Null();
+    bool Bool(bool b);
+    bool Int(int i);
+    bool Uint(unsigned u);
+    bool Int64(int64_t i);
+    bool Uint64(uint64_t u);
+    bool Double(double d);
+    bool String(const char* str, rapidjson::SizeType length, bool copy);
+    bool Key(const char* str, rapidjson::SizeType length, bool copy);
+    bool StartObject();
+    bool EndObject(rapidjson::SizeType memberCount);
+    bool StartArray();
+    bool EndArray(rapidjson::SizeType elementCount);
+
+    bool emit(const TokenValue& value);
+
+    TokenReader& tokenReader;
+  };
+
+  static inline constexpr unsigned kParseFlags = rapidjson::kParseInsituFlag;
+
+  mutable rapidjson::InsituStringStream _stream;  // Tell() isn't const.
+  rapidjson::Reader _reader;
+  Handler _handler;
+  TokenValue _value;
+
+  // The tokens of a DOM, which are all pulled up front.
+  bool _isReadingDom{};
+  std::vector<TokenValue> _domTokens;
+  size_t _domTokenIdx{};
+
+  std::string _error;
+  std::string _errorPath;
+};
+
+template <typename T, typename Fields, typename... KVs>
+bool readFields(TokenReader& reader, T& obj, const Fields& fields, const KVs&... kvs);
+
+// Reads the value which starts at the current token into `value`.
+// @return false if it doesn't match the type of `value` (see TokenReader::getError()).
+template <typename T>
+bool readValue(TokenReader& reader, T& value) {
+  using Token = TokenReader::Token;
+
+  if constexpr (std::is_same_v<T, bool>) {
+    if (reader.getToken() != Token::BOOL) {
+      return reader.fail("expected a bool");
+    }
+    value = reader.getBool();
+    return true;
+  } else if constexpr (std::is_enum_v<T>) {
+    std::underlying_type_t<T> underlyingValue{};
+    if (!readValue(reader, underlyingValue)) {
+      return false;
+    }
+    value = static_cast<T>(underlyingValue);
+    return true;
+  } else if constexpr (std::is_integral_v<T>) {
+    if (reader.getToken() == Token::INT && std::in_range<T>(reader.getInt64())) {
+      value = static_cast<T>(reader.getInt64());
+      return true;
+    }
+    if (reader.getToken() == Token::UINT64 && std::in_range<T>(reader.getUint64())) {
+      value = static_cast<T>(reader.getUint64());
+      return true;
+    }
+    return reader.fail(reader.isNumber() ? "expected an integer in range" : "expected an integer");
+  } else if constexpr (std::is_floating_point_v<T>) {
+    if (!reader.isNumber()) {
+      return reader.fail("expected a number");
+    }
+    value = static_cast<T>(reader.getDouble());
+    return true;
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    if (reader.getToken() != Token::STRING) {
+      return reader.fail("expected a string");
+    }
+    value = reader.getString();
+    return true;
+  } else if constexpr (is_pair<T>) {
+    if (reader.getToken() != Token::START_ARRAY) {
+      return reader.fail("expected an array of 2 values");
+    }
+    if (!reader.next() || !readValue(reader, value.first)) {
+      reader.prependErrorPath("0");
+      return false;
+    }
+    if (!reader.next() || !readValue(reader, value.second)) {
+      reader.prependErrorPath("1");
+      return false;
+    }
+    return (reader.next() && reader.getToken() == Token::END_ARRAY) || reader.fail("expected an array of 2 values");
+  } else if constexpr (is_vector<T> || is_list<T>) {
+    value.clear();
+    // An object can be read into a vector of (key, value) pairs, keeping the order of its keys.
+    if constexpr (is_pair<typename T::value_type>) {
+      if (reader.getToken() == Token::START_OBJECT) {
+        while (reader.next() && reader.getToken() == Token::KEY) {
+          auto& [k, v] = value.emplace_back();
+          k = reader.getString();
+          if (!reader.next() || !readValue(reader, v)) {
+            reader.prependErrorPath(k);
+            return false;
+          }
+        }
+        return reader.getToken() == Token::END_OBJECT;
+      }
+    }
+    if (reader.getToken() != Token::START_ARRAY) {
+      return reader.fail("expected an array");
+    }
+    while (reader.next() && reader.getToken() != Token::END_ARRAY) {
+      if (!readValue(reader, value.emplace_back())) {
+        reader.prependErrorPath(std::to_string(value.size() - 1));
+        return false;
+      }
+    }
+    return reader.getToken() == Token::END_ARRAY;
+  } else if constexpr (is_set<T> || is_unordered_set<T>) {
+    value.clear();
+    if (reader.getToken() != Token::START_ARRAY) {
+      return reader.fail("expected an array");
+    }
+    while (reader.next() && reader.getToken() != Token::END_ARRAY) {
+      typename T::value_type element{};
+      if (!readValue(reader, element)) {
+        reader.prependErrorPath(std::to_string(value.size()));
+        return false;
+      }
+      value.insert(std::move(element));
+    }
+    return reader.getToken() == Token::END_ARRAY;
+  } else if constexpr (is_map<T> || is_unordered_map<T>) {
+    static_assert(std::is_same_v<typename T::key_type, std::string>, "json object keys are strings");
+    value.clear();
+    if (reader.getToken() != Token::START_OBJECT) {
+      return reader.fail("expected an object");
+    }
+    while (reader.next() && reader.getToken() == Token::KEY) {
+      std::string key{reader.getString()};
+      typename T::mapped_type mapped{};
+      if (!reader.next() || !readValue(reader, mapped)) {
+        reader.prependErrorPath(key);
+        return false;
+      }
+      value.emplace(std::move(key), std::move(mapped));
+    }
+    return reader.getToken() == Token::END_OBJECT;
+  } else if constexpr (reflection::is_reflectable<T>) {
+    return readFields(reader, value, T::kFields);
+  } else {
+    static_assert(dependent_false_v<T>, "unsupported type");
+  }
+}
+
+// Reads the object which starts at the current token into the reflected `fields`
+// of `obj` (see util/Reflection.h), and into the extra fields given as
+// (key, pointer to field) pairs, just like deserialize().
+// - Unknown keys are skipped.
+// - A missing key is an error, unless its field is optional.
+// - The fields given as (key, pointer to field) pairs are optional.
+template <typename T, typename Fields, typename... KVs>
+bool readFields(TokenReader& reader, T& obj, const Fields& fields, const KVs&... kvs) {
+  using Token = TokenReader::Token;
+  constexpr size_t kNumFields = std::tuple_size_v<Fields>;
+
+  if (reader.getToken() != Token::START_OBJECT) {
+    return reader.fail("expected an object");
+  }
+
+  [[maybe_unused]] const auto keys = reflection::getKeys(fields);
+  std::array<bool, kNumFields> isRead{};
+  // The keys are usually in the same order as the fields, so the next
+  // field is tried first, which finds most keys with a single comparison.
+  [[maybe_unused]] size_t nextFieldIdx = 0;
+
+  while (reader.next() && reader.getToken() == Token::KEY) {
+    const std::string_view key = reader.getString();
+    if (!reader.next()) {
+      reader.prependErrorPath(key);
+      return false;
+    }
+
+    bool isKnownKey = false;
+    bool ok = true;
+    if constexpr (kNumFields > 0) {
+      size_t fieldIdx = nextFieldIdx;
+      for (size_t i = 0; i < kNumFields && keys[fieldIdx] != key; i++) {
+        fieldIdx = (fieldIdx + 1 < kNumFields) ? fieldIdx + 1 : 0;
+      }
+      if (keys[fieldIdx] == key) {
+        isKnownKey = true;
+        isRead[fieldIdx] = true;
+        nextFieldIdx = (fieldIdx + 1 < kNumFields) ? fieldIdx + 1 : 0;
+        reflection::forEachField(fields, [&](const auto& field, const size_t i) {
+          if (i == fieldIdx) {
+            ok = readValue(reader, obj.*field.member);
+          }
+        });
+      }
+    }
+    ((!isKnownKey && key == kvs.first && (isKnownKey = true) && (ok = readValue(reader, *kvs.second))), ...);
+
+    if (!ok || (!isKnownKey && !reader.skipValue())) {
+      reader.prependErrorPath(key);
+      return false;
+    }
+  }
+
+  if (reader.getToken() != Token::END_OBJECT) {
+    return false;
+  }
+
+  bool ok = true;
+  reflection::forEachField(fields, [&](const auto& field, const size_t i) {
+    if (ok && !isRead[i] && !field.isOptional) {
+      ok = reader.fail("missing");
+      reader.prependErrorPath(field.key);
+    }
+  });
+  return ok;
+}
+
+// Reads the object which starts at the current token into the fields
+// given as (key, pointer to field) pairs, just like deserialize().
+// Unknown keys are skipped, and the fields whose keys are missing are left untouched.
+template <typename... KVs>
+bool readObject(TokenReader& reader, const KVs&... kvs) {
+  struct NoFields final {} noFields;
+  return readFields(reader, noFields, std::tuple<>{}, kvs...);
+}
+
+void logReadError(const fs::path& jsonFilePath, const TokenReader& reader);
+
+// Reads the json file straight from its tokens with `read(TokenReader&)`, i.e.,
+// without building a DOM. The cooked asset bundle (if any) is preferred.
+// @return false if the json file can't be read, or `read` fails.
+template <typename ReadFn>
+bool readFile(const fs::path& jsonFilePath, ReadFn&& read) {
+  if (rapidjson::Document doc; asset_bundle::load(jsonFilePath, doc)) {
+    TokenReader reader{doc};
+    if (!reader.next() || !read(reader)) {
+      logReadError(jsonFilePath, reader);
+      return false;
+    }
+    return true;
+  }
+
+  JsonFileBuffer buffer{jsonFilePath};
+  if (!buffer.isOpen()) {
+    return false;
+  }
+
+  TokenReader reader{buffer.data()};
+  if (!reader.next() || !read(reader)) {
+    logReadError(jsonFilePath, reader);
+    return false;
+  }
+  return true;
+}
+
+// Fills the fields given as (key, pointer to field) pairs, just like deserialize(),
+// from the json file straight from its tokens, i.e., without building a DOM.
+// Unknown keys are skipped, and the fields whose keys are missing are left untouched.
+// @return false if the json file can't be read, or doesn't match the fields.
+template <typename... KVs>
+bool parseFile(const fs::path& jsonFilePath, KVs... kvs) {
+  return readFile(jsonFilePath, [&kvs...](TokenReader& reader) {
+    return readObject(reader, kvs...);
+  });
+}
+
+// Fills the reflected `fields` of `obj` (see util/Reflection.h) from the json file,
+// along with the extra fields given as (key, pointer to field) pairs (see readFields()).
+// Errors are logged with the path of the offending value.
+// @return false if the json file can't be read, or doesn't match the fields.
+template <typename T, typename Fields, typename... KVs>
+bool parseFileFields(const fs::path& jsonFilePath, T& obj, const Fields& fields, KVs... kvs) {
+  return readFile(jsonFilePath, [&obj, &fields, &kvs...](TokenReader& reader) {
+    return readFields(reader, obj, fields, kvs...);
+  });
+}
+
+// Same as above, with all the reflected fields of `obj` (T::kFields).
+template <typename T, typename... KVs>
+bool parseFileInto(const fs::path& jsonFilePath, T& obj, KVs... kvs) {
+  return parseFileFields(jsonFilePath, obj, T::kFields, kvs...);
+}
+
 rapidjson::Document loadFromFile(const fs::path& jsonFilePath);
 void saveToFile(const fs::path& jsonFilePath, const rapidjson::Document& json);
 
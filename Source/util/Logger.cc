@@ -2,24 +2,470 @@
 
 #include "Logger.h"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+
 extern "C" {
 #include <execinfo.h>  // backtrace*
 #include <signal.h>  // signal
 #include <stdlib.h>  // exit
-#include <unistd.h>  // close
+#include <unistd.h>  // close, usleep
 #include <fcntl.h>  // open
 }
 
 #define NUM_STACKTRACE_FUNC 10
 #define LOG_FILENAME "vigilante.log"
 
+using namespace std;
+
 namespace vigilante::logger {
 
+namespace {
+
+constexpr size_t kMaxLogFileSize = 4 * 1024 * 1024;
+constexpr int kNumRotatedLogFiles = 3;  // vigilante.log.1 ~ vigilante.log.3
+constexpr auto kFlushInterval = chrono::milliseconds{20};
+
+// A bounded multi-producer single-consumer queue.
+// See https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+class RingBuffer final {
+ public:
+  static inline constexpr size_t kCapacity = 4096;  // must be a power of 2
+
+  RingBuffer() {
+    for (size_t i = 0; i < kCapacity; i++) {
+      _slots[i].sequence.store(i, memory_order_relaxed);
+    }
+  }
+
+  bool tryPush(const Record& record) {
+    Slot* slot;
+    uint64_t pos = _enqueuePos.load(memory_order_relaxed);
+    for (;;) {
+      slot = &_slots[pos & (kCapacity - 1)];
+      const uint64_t seq = slot->sequence.load(memory_order_acquire);
+      const int64_t diff = static_cast<int64_t>(seq - pos);
+      if (diff == 0) {
+        if (_enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // full
+      } else {
+        pos = _enqueuePos.load(memory_order_relaxed);
+      }
+    }
+
+    // Only copy the args which are actually used.
+    std::memcpy(&slot->record, &record, offsetof(Record, args) + record.argsSize);
+    slot->sequence.store(pos + 1, memory_order_release);
+    return true;
+  }
+
+  // Must only be called by one thread at a time.
+  bool tryPop(Record& out) {
+    Slot& slot = _slots[_dequeuePos & (kCapacity - 1)];
+    if (slot.sequence.load(memory_order_acquire) != _dequeuePos + 1) {
+      return false;  // empty, or the producer hasn't finished writing it yet
+    }
+
+    std::memcpy(&out, &slot.record, offsetof(Record, args) + slot.record.argsSize);
+    slot.sequence.store(_dequeuePos + kCapacity, memory_order_release);
+    _dequeuePos++;
+    return true;
+  }
+
+ private:
+  struct Slot final {
+    atomic<uint64_t> sequence;
+    Record record;
+  };
+
+  array<Slot, kCapacity> _slots;
+  alignas(64) atomic<uint64_t> _enqueuePos{};
+  alignas(64) uint64_t _dequeuePos{};
+};
+
+class ArgReader final {
+ public:
+  union Value {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void* p;
+    const char* s;
+  };
+
+  explicit ArgReader(const Record& record) : _record{record} {}
+
+  bool next(ArgType& type, Value& value) {
+    if (_offset >= _record.argsSize) {
+      return false;
+    }
+
+    type = static_cast<ArgType>(_record.args[_offset++]);
+    const char* data = _record.args + _offset;
+    switch (type) {
+      case ArgType::INT:
+        std::memcpy(&value.i, data, sizeof(value.i));
+        _offset += sizeof(value.i);
+        break;
+      case ArgType::UINT:
+        std::memcpy(&value.u, data, sizeof(value.u));
+        _offset += sizeof(value.u);
+        break;
+      case ArgType::DOUBLE:
+        std::memcpy(&value.d, data, sizeof(value.d));
+        _offset += sizeof(value.d);
+        break;
+      case ArgType::POINTER:
+        std::memcpy(&value.p, data, sizeof(value.p));
+        _offset += sizeof(value.p);
+        break;
+      case ArgType::STRING:
+        value.s = data;
+        _offset += std::strlen(data) + 1;
+        break;
+      default:
+        _offset = _record.argsSize;
+        return false;
+    }
+    return true;
+  }
+
+ private:
+  const Record& _record;
+  size_t _offset{};
+};
+
+template <typename T>
+void appendFormatted(string& out, const char* spec, const T value) {
+  const int n = std::snprintf(nullptr, 0, spec, value);
+  if (n <= 0) {
+    return;
+  }
+  const size_t oldSize = out.size();
+  out.resize(oldSize + n + 1);
+  std::snprintf(out.data() + oldSize, n + 1, spec, value);
+  out.resize(oldSize + n);
+}
+
+// printf() the args of `record` with its format string. Since the args
+// are stored widened (int64_t, uint64_t or double), each conversion
+// spec is rewritten to match what has been stored.
+void formatMessage(const Record& record, string& out) {
+  ArgReader reader{record};
+  ArgType type;
+  ArgReader::Value value;
+
+  auto nextInt = [&reader, &type, &value]() -> int64_t {
+    if (!reader.next(type, value)) {
+      return 0;
+    }
+    return (type == ArgType::DOUBLE) ? static_cast<int64_t>(value.d) : value.i;
+  };
+
+  const char* p = record.callSite->format;
+  while (*p) {
+    if (*p != '%') {
+      const char* end = std::strchr(p, '%');
+      end = end ? end : p + std::strlen(p);
+      out.append(p, end);
+      p = end;
+      continue;
+    }
+    if (p[1] == '%') {
+      out += '%';
+      p += 2;
+      continue;
+    }
+
+    // %[flags][width][.precision][length]conversion
+    string spec = "%";
+    for (p++; *p && std::strchr("-+ #0", *p); p++) {
+      spec += *p;
+    }
+    for (int i = 0; i < 2; i++) {
+      if (i == 1) {
+        if (*p != '.') {
+          break;
+        }
+        spec += *p++;
+      }
+      if (*p == '*') {
+        spec += std::to_string(nextInt());
+        p++;
+      }
+      for (; *p >= '0' && *p <= '9'; p++) {
+        spec += *p;
+      }
+    }
+    bool isLong = false;
+    for (; *p && std::strchr("hlLqjzt", *p); p++) {
+      isLong |= (*p != 'h' && *p != 'L');
+    }
+
+    const char conversion = *p;
+    if (!conversion) {
+      break;
+    }
+    p++;
+
+    if (conversion == 'n') {
+      continue;
+    }
+    if (!reader.next(type, value)) {
+      out += "(?)";
+      continue;
+    }
+
+    switch (conversion) {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+      case 'c': {
+        const uint64_t u = (type == ArgType::DOUBLE) ? static_cast<uint64_t>(value.d)
+                         : (type == ArgType::POINTER) ? reinterpret_cast<uintptr_t>(value.p)
+                         : value.u;
+        if (type == ArgType::STRING) {
+          out += "(?)";
+        } else if (isLong && conversion != 'c') {
+          appendFormatted(out, (spec + "ll" + conversion).c_str(), u);
+        } else {
+          appendFormatted(out, (spec + conversion).c_str(), static_cast<unsigned int>(u));
+        }
+        break;
+      }
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A': {
+        const double d = (type == ArgType::DOUBLE) ? value.d
+                       : (type == ArgType::INT) ? static_cast<double>(value.i)
+                       : (type == ArgType::UINT) ? static_cast<double>(value.u)
+                       : 0.0;
+        appendFormatted(out, (spec + conversion).c_str(), d);
+        break;
+      }
+      case 's':
+        if (type == ArgType::STRING) {
+          appendFormatted(out, (spec + 's').c_str(), value.s);
+        } else {
+          out += "(?)";
+        }
+        break;
+      case 'p':
+        appendFormatted(out, "%p", (type == ArgType::POINTER) ? value.p : nullptr);
+        break;
+      default:
+        out += "(?)";
+        break;
+    }
+  }
+}
+
+string getLogFilePath(const int i) {
+  return (i == 0) ? LOG_FILENAME : string{LOG_FILENAME} + "." + std::to_string(i);
+}
+
+// vigilante.log -> vigilante.log.1 -> ... -> vigilante.log.{kNumRotatedLogFiles}
+void rotateLogFiles() {
+  std::remove(getLogFilePath(kNumRotatedLogFiles).c_str());
+  for (int i = kNumRotatedLogFiles - 1; i >= 0; i--) {
+    std::rename(getLogFilePath(i).c_str(), getLogFilePath(i + 1).c_str());
+  }
+}
+
+class Logger final {
+ public:
+  static Logger& the() {
+    // Never destroyed, so that it may still be used by static destructors.
+    static Logger* instance = new Logger();
+    return *instance;
+  }
+
+  void submit(const Record& record) {
+    if (!_ring.tryPush(record)) {
+      _numDropped.fetch_add(1, memory_order_relaxed);
+      return;
+    }
+    if (!_isRunning.load(memory_order_acquire)) {
+      flush();
+    }
+  }
+
+  void flush() {
+    lock_guard<mutex> lock{_consumerMutex};
+    drain();
+  }
+
+  // Called from a signal handler, where the background thread may be
+  // in the middle of a flush, so it doesn't wait forever.
+  void flushFromSignalHandler() {
+    unique_lock<mutex> lock{_consumerMutex, std::defer_lock};
+    for (int i = 0; i < 100 && !lock.try_lock(); i++) {
+      ::usleep(1000);
+    }
+    if (lock.owns_lock()) {
+      drain();
+    }
+  }
+
+  void shutdown() {
+    if (!_isRunning.exchange(false)) {
+      return;
+    }
+    _thread.join();
+    flush();
+  }
+
+ private:
+  Logger() {
+    FILE* file = std::fopen(LOG_FILENAME, "r");
+    if (file) {
+      std::fclose(file);
+      rotateLogFiles();  // keep the logs of the previous sessions
+    }
+    _file = std::fopen(LOG_FILENAME, "w");
+
+    _isRunning = true;
+    _thread = std::thread([this]() {
+      while (_isRunning.load(memory_order_acquire)) {
+        flush();
+        std::this_thread::sleep_for(kFlushInterval);
+      }
+    });
+    std::atexit(&logger::shutdown);
+  }
+
+  // _consumerMutex must be held.
+  void drain() {
+    bool hasWritten = false;
+
+    if (const uint64_t numDropped = _numDropped.exchange(0, memory_order_relaxed)) {
+      _line = "[WARNING] [Logger.cc] " + std::to_string(numDropped) + " messages were dropped.";
+      write(getTimeMs());
+      hasWritten = true;
+    }
+
+    while (_ring.tryPop(_record)) {
+      const CallSite& callSite = *_record.callSite;
+      _line.clear();
+      appendFormatted(_line, "[%s] ", _kSeverityStr[callSite.severity]);
+      appendFormatted(_line, "[%s: ", callSite.fileName);
+      appendFormatted(_line, "%d] ", callSite.line);
+      formatMessage(_record, _line);
+      if (_record.numSuppressed > 0) {
+        appendFormatted(_line, " (%u similar messages suppressed)", _record.numSuppressed);
+      }
+      write(_record.timeMs);
+      hasWritten = true;
+    }
+
+    if (hasWritten && _file) {
+      std::fflush(_file);
+    }
+  }
+
+  void write(const uint64_t timeMs) {
+    ax::log("%s", _line.c_str());
+
+    if (!_file) {
+      return;
+    }
+
+    const time_t t = static_cast<time_t>(timeMs / 1000);
+    struct tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    char timestamp[32];
+    const size_t n = std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &tm);
+    std::snprintf(timestamp + n, sizeof(timestamp) - n, ".%03u ", static_cast<unsigned>(timeMs % 1000));
+
+    const int ret = std::fprintf(_file, "%s%s\n", timestamp, _line.c_str());
+    _fileSize += (ret > 0) ? ret : 0;
+
+    if (_fileSize >= kMaxLogFileSize) {
+      std::fclose(_file);
+      rotateLogFiles();
+      _file = std::fopen(LOG_FILENAME, "w");
+      _fileSize = 0;
+    }
+  }
+
+  RingBuffer _ring;
+  atomic<uint64_t> _numDropped{};
+  atomic<bool> _isRunning{};
+  std::thread _thread;
+
+  // Only touched by the consumer, i.e. whoever holds _consumerMutex.
+  mutex _consumerMutex;
+  Record _record;
+  string _line;
+  FILE* _file{};
+  size_t _fileSize{};
+};
+
+}  // namespace
+
+bool CallSite::allow() {
+  const uint64_t nowMs = chrono::duration_cast<chrono::milliseconds>(
+      chrono::steady_clock::now().time_since_epoch()).count();
+
+  uint64_t windowBeginMs = _windowBeginMs.load(memory_order_relaxed);
+  if (nowMs - windowBeginMs >= 1000 &&
+      _windowBeginMs.compare_exchange_strong(windowBeginMs, nowMs, memory_order_relaxed)) {
+    _numLogged.store(0, memory_order_relaxed);
+  }
+
+  if (_numLogged.fetch_add(1, memory_order_relaxed) < kMaxLogsPerSecond) {
+    return true;
+  }
+  _numSuppressed.fetch_add(1, memory_order_relaxed);
+  return false;
+}
+
+void submit(const Record& record) {
+  Logger::the().submit(record);
+}
+
+uint64_t getTimeMs() {
+  return chrono::duration_cast<chrono::milliseconds>(
+      chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void flush() {
+  Logger::the().flush();
+}
+
+void shutdown() {
+  Logger::the().shutdown();
+}
+
 void segvHandler(int) {
-  void* array[10];
-  size_t size = backtrace(array, 10);
+  // Write out whatever has been logged before the crash first.
+  Logger::the().flushFromSignalHandler();
+
+  void* array[NUM_STACKTRACE_FUNC];
+  size_t size = backtrace(array, NUM_STACKTRACE_FUNC);
 
-  int fd = open(LOG_FILENAME, O_CREAT | O_WRONLY, 0600);
+  int fd = open(LOG_FILENAME, O_CREAT | O_WRONLY | O_APPEND, 0600);
   backtrace_symbols_fd(array + 2, size - 2, fd);
   close(fd);
 
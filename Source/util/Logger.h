@@ -4,22 +4,43 @@
 #define VIGILANTE_UTIL_LOGGER_H_
 
 #include <array>
-#include <memory>
-#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 
 #include <axmol.h>
 
 #define LOG_ERR vigilante::logger::Severity::ERROR
 #define LOG_WARN vigilante::logger::Severity::WARNING
 #define LOG_INFO vigilante::logger::Severity::INFO
+#define LOG_DEBUG vigilante::logger::Severity::DEBUG
 
-// Example usage: VGLOG(LOG_INFO, __FILE__, "test msg %d", 5);
+// The most verbose severity compiled in, e.g. -DVIGILANTE_LOG_LEVEL=0
+// compiles out everything but LOG_ERR (see VIGILANTE_LOG_LEVEL in CMakeLists.txt).
+#ifndef VIGILANTE_LOG_LEVEL
+#ifdef NDEBUG
+#define VIGILANTE_LOG_LEVEL 2  // LOG_INFO
+#else
+#define VIGILANTE_LOG_LEVEL 3  // LOG_DEBUG
+#endif
+#endif
+
+// Example usage: VGLOG(LOG_INFO, "test msg %d", 5);
+//
+// The format must be a string literal. The arguments are copied into a
+// lock-free ring buffer, and they are formatted and written to stdout and
+// vigilante.log by a background thread. Each call site is rate limited
+// to kMaxLogsPerSecond, and the number of suppressed messages is reported
+// along with the next message which gets through.
 #define VGLOG(severity, format, ...)\
-  ax::log("[%s] [%s: %d] " format,\
-      (vigilante::logger::_kSeverityStr[severity].c_str()),\
-      (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__),\
-      (__LINE__),\
-      ##__VA_ARGS__)
+  do {\
+    if constexpr ((severity) <= vigilante::logger::kMaxSeverity) {\
+      static vigilante::logger::CallSite _vglogCallSite{\
+          (severity), format, vigilante::logger::getFileName(__FILE__), __LINE__};\
+      vigilante::logger::log(_vglogCallSite, ##__VA_ARGS__);\
+    }\
+  } while (0)
 
 namespace vigilante::logger {
 
@@ -27,17 +48,155 @@ enum Severity {
   ERROR,
   WARNING,
   INFO,
+  DEBUG,
   SIZE
 };
 
-const std::array<std::string, Severity::SIZE> _kSeverityStr = {{
+inline constexpr std::array<const char*, Severity::SIZE> _kSeverityStr = {{
   "ERROR",
   "WARNING",
-  "INFO"
+  "INFO",
+  "DEBUG"
 }};
 
+inline constexpr Severity kMaxSeverity = static_cast<Severity>(VIGILANTE_LOG_LEVEL);
+inline constexpr uint32_t kMaxLogsPerSecond = 10;
+
+constexpr const char* getFileName(const char* path) {
+  const char* fileName = path;
+  for (const char* p = path; *p; p++) {
+    if (*p == '/' || *p == '\\') {
+      fileName = p + 1;
+    }
+  }
+  return fileName;
+}
+
+// The static part of a log message, one per VGLOG().
+class CallSite final {
+ public:
+  constexpr CallSite(const Severity severity, const char* format, const char* fileName, const int line)
+      : severity{severity}, format{format}, fileName{fileName}, line{line} {}
+
+  // @return whether a message may be logged from this call site now.
+  bool allow();
+  // @return the number of messages suppressed since the last call.
+  inline uint32_t takeNumSuppressed() { return _numSuppressed.exchange(0, std::memory_order_relaxed); }
+
+  const Severity severity;
+  const char* const format;
+  const char* const fileName;
+  const int line;
+
+ private:
+  std::atomic<uint64_t> _windowBeginMs{};
+  std::atomic<uint32_t> _numLogged{};
+  std::atomic<uint32_t> _numSuppressed{};
+};
+
+enum class ArgType : uint8_t {
+  INT,
+  UINT,
+  DOUBLE,
+  POINTER,
+  STRING
+};
+
+// A log message whose arguments haven't been formatted yet.
+struct Record final {
+  static inline constexpr size_t kSize = 256;
+  static inline constexpr size_t kMaxArgsSize = kSize - 2 * sizeof(uint64_t) - 2 * sizeof(uint32_t);
+
+  // Copies `arg` into `args`, or drops it (and the rest) if it doesn't fit.
+  // Strings are copied as they usually come from a temporary's c_str().
+  template <typename T>
+  void push(const T& arg);
+
+  CallSite* callSite;
+  uint64_t timeMs;
+  uint32_t numSuppressed;
+  uint32_t argsSize;
+  char args[kMaxArgsSize];
+};
+
+static_assert(sizeof(Record) == Record::kSize);
+
+// Enqueues `record`, or drops it if the ring buffer is full. Never blocks.
+void submit(const Record& record);
+
+uint64_t getTimeMs();
+
+template <typename... Args>
+void log(CallSite& callSite, const Args&... args) {
+  if (!callSite.allow()) {
+    return;
+  }
+
+  Record record;
+  record.callSite = &callSite;
+  record.timeMs = getTimeMs();
+  record.numSuppressed = callSite.takeNumSuppressed();
+  record.argsSize = 0;
+  (record.push(args), ...);
+  submit(record);
+}
+
+// Writes out all the messages enqueued so far on the calling thread.
+void flush();
+
+// Stops the background thread after flushing. Messages logged
+// afterwards are written synchronously. Called at exit.
+void shutdown();
+
 void segvHandler(int);
 
+template <typename T>
+void Record::push(const T& arg) {
+  using U = std::decay_t<T>;
+
+  auto write = [this](const ArgType type, const void* data, const size_t size) {
+    if (argsSize + 1 + size > kMaxArgsSize) {
+      argsSize = kMaxArgsSize;  // drop the remaining args as well
+      return false;
+    }
+    args[argsSize] = static_cast<char>(type);
+    std::memcpy(args + argsSize + 1, data, size);
+    argsSize += 1 + size;
+    return true;
+  };
+
+  if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+    const char* s = arg;
+    s = s ? s : "(null)";
+    // The type byte and the null terminator have to fit, even if the string is truncated to nothing.
+    if (argsSize + 2 > kMaxArgsSize) {
+      argsSize = kMaxArgsSize;  // drop the remaining args as well
+      return;
+    }
+    const size_t maxLen = kMaxArgsSize - argsSize - 2;
+    const size_t len = ::strnlen(s, maxLen);
+    if (write(ArgType::STRING, s, len)) {
+      args[argsSize++] = '\0';
+    }
+  } else if constexpr (std::is_enum_v<U>) {
+    push(static_cast<std::underlying_type_t<U>>(arg));
+  } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+    const int64_t value = arg;
+    write(ArgType::INT, &value, sizeof(value));
+  } else if constexpr (std::is_integral_v<U>) {
+    const uint64_t value = arg;
+    write(ArgType::UINT, &value, sizeof(value));
+  } else if constexpr (std::is_floating_point_v<U>) {
+    const double value = arg;
+    write(ArgType::DOUBLE, &value, sizeof(value));
+  } else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) {
+    const void* value = arg;
+    write(ArgType::POINTER, &value, sizeof(value));
+  } else {
+    static_assert(!sizeof(T), "VGLOG() only accepts printf-compatible arguments");
+  }
+}
+
 }  // namespace vigilante::logger
 
 #endif  // VIGILANTE_UTIL_LOGGER_H_
@@ -0,0 +1,182 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+
+namespace vigilante::profiler {
+
+namespace {
+
+const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+
+mutex threadBuffersMutex;
+vector<unique_ptr<ThreadBuffer>> threadBuffers;
+
+thread_local ThreadBuffer* threadBuffer;
+thread_local uint32_t zoneDepth;
+
+ThreadBuffer* mainThreadBuffer;
+
+// Per frame stats, only accessed from the main thread.
+array<float, kNumFrameSamples> frameTimesMs{};
+size_t numFrameSamples;
+uint64_t frameBeginNs;  // 0 before the first frame
+vector<pair<const char*, float>> lastFrameZones;
+
+// The buffers live until the application quits, even if their threads
+// have exited, so that their zones can still be dumped.
+ThreadBuffer& getThreadBuffer() {
+  if (!threadBuffer) {
+    lock_guard<mutex> lock{threadBuffersMutex};
+    const auto threadId = static_cast<uint32_t>(threadBuffers.size());
+    threadBuffers.push_back(std::make_unique<ThreadBuffer>(threadId));
+    threadBuffer = threadBuffers.back().get();
+  }
+  return *threadBuffer;
+}
+
+void aggregateLastFrameZones(const uint64_t beginNs) {
+  lastFrameZones.clear();
+
+  static vector<ZoneRecord> records;
+  records.clear();
+  mainThreadBuffer->collect(beginNs, records);
+
+  for (const auto& record : records) {
+    const float ms = (record.endNs - record.beginNs) / 1e6f;
+    auto it = std::find_if(lastFrameZones.begin(), lastFrameZones.end(),
+                           [&record](const auto& zone) { return zone.first == record.name; });
+    if (it != lastFrameZones.end()) {
+      it->second += ms;
+    } else {
+      lastFrameZones.emplace_back(record.name, ms);
+    }
+  }
+
+  std::sort(lastFrameZones.begin(), lastFrameZones.end(),
+            [](const auto& z1, const auto& z2) { return z1.second > z2.second; });
+}
+
+void writeJsonString(FILE* file, const char* s) {
+  std::fputc('"', file);
+  for (; *s; s++) {
+    if (*s == '"' || *s == '\\') {
+      std::fputc('\\', file);
+    }
+    std::fputc(*s, file);
+  }
+  std::fputc('"', file);
+}
+
+}  // namespace
+
+void ThreadBuffer::collect(const uint64_t sinceNs, vector<ZoneRecord>& out) const {
+  const uint64_t n = _numRecords.load(std::memory_order_acquire);
+  const uint64_t first = (n > kCapacity) ? n - kCapacity : 0;
+
+  // Zones are recorded when they end, so the records are sorted by `endNs`.
+  uint64_t i = n;
+  while (i > first && _records[(i - 1) & (kCapacity - 1)].endNs >= sinceNs) {
+    i--;
+  }
+  for (; i < n; i++) {
+    out.push_back(_records[i & (kCapacity - 1)]);
+  }
+}
+
+Zone::Zone(const char* name) : _name{name}, _beginNs{now()} {
+  zoneDepth++;
+}
+
+Zone::~Zone() {
+  zoneDepth--;
+  getThreadBuffer().push({_name, _beginNs, now(), zoneDepth});
+}
+
+uint64_t now() {
+  return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime).count();
+}
+
+void markFrame() {
+  if (!mainThreadBuffer) {
+    mainThreadBuffer = &getThreadBuffer();
+  }
+
+  const uint64_t t = now();
+  if (frameBeginNs > 0) {
+    frameTimesMs[numFrameSamples++ % kNumFrameSamples] = (t - frameBeginNs) / 1e6f;
+    aggregateLastFrameZones(frameBeginNs);
+  }
+  frameBeginNs = t;
+}
+
+FrameStats getFrameStats() {
+  const size_t n = std::min(numFrameSamples, kNumFrameSamples);
+  if (n == 0) {
+    return {};
+  }
+
+  array<float, kNumFrameSamples> sorted = getFrameTimesMs();
+  auto begin = sorted.end() - n;
+  std::sort(begin, sorted.end());
+  auto percentile = [begin, n](const float p) {
+    return *(begin + static_cast<size_t>(p * (n - 1)));
+  };
+  return {percentile(.5f), percentile(.95f), percentile(.99f), sorted.back()};
+}
+
+array<float, kNumFrameSamples> getFrameTimesMs() {
+  array<float, kNumFrameSamples> ret{};
+  for (size_t i = 0; i < kNumFrameSamples; i++) {
+    ret[i] = frameTimesMs[(numFrameSamples + i) % kNumFrameSamples];
+  }
+  return ret;
+}
+
+const vector<pair<const char*, float>>& getLastFrameZones() {
+  return lastFrameZones;
+}
+
+int dumpChromeTrace(const string& filePath, const float seconds) {
+  const uint64_t t = now();
+  // Converted only once it's known to fit, as a float -> integer overflow is undefined.
+  const double windowNs = std::max(seconds * 1e9, 0.0);
+  const uint64_t sinceNs = (windowNs < t) ? t - static_cast<uint64_t>(windowNs) : 0;
+
+  FILE* file = std::fopen(filePath.c_str(), "w");
+  if (!file) {
+    return -1;
+  }
+
+  int numZones = 0;
+  vector<ZoneRecord> records;
+  std::fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+
+  lock_guard<mutex> lock{threadBuffersMutex};
+  for (const auto& buffer : threadBuffers) {
+    records.clear();
+    buffer->collect(sinceNs, records);
+
+    for (const auto& record : records) {
+      std::fprintf(file, "%s{\"name\": ", numZones ? ",\n" : "");
+      writeJsonString(file, record.name);
+      std::fprintf(file, ", \"ph\": \"X\", \"pid\": 0, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                   buffer->getThreadId(), record.beginNs / 1e3, (record.endNs - record.beginNs) / 1e3);
+      numZones++;
+    }
+  }
+
+  std::fprintf(file, "\n]}\n");
+  const bool ok = !std::ferror(file);
+  std::fclose(file);
+  return ok ? numZones : -1;
+}
+
+}  // namespace vigilante::profiler
@@ -0,0 +1,125 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UTIL_PROFILER_H_
+#define VIGILANTE_UTIL_PROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A low-overhead scoped-zone frame profiler.
+//
+// Example usage:
+//   void GameMapManager::update(const float delta) {
+//     VGPROFILE_ZONE("GameMapManager::update");
+//     ...
+//   }
+//
+// Each zone is recorded into a ring buffer owned by the calling thread
+// when it goes out of scope, so recording never locks or allocates.
+// The zone name must be a string literal.
+//
+// The macros compile to nothing unless VIGILANTE_PROFILER is defined
+// (see the VIGILANTE_PROFILER option in CMakeLists.txt).
+#ifdef VIGILANTE_PROFILER
+#define VGPROFILE_CONCAT_IMPL(a, b) a##b
+#define VGPROFILE_CONCAT(a, b) VGPROFILE_CONCAT_IMPL(a, b)
+#define VGPROFILE_ZONE(name) \
+  const vigilante::profiler::Zone VGPROFILE_CONCAT(_vgprofileZone, __LINE__){name}
+#define VGPROFILE_FRAME() vigilante::profiler::markFrame()
+#else
+#define VGPROFILE_ZONE(name) do {} while (0)
+#define VGPROFILE_FRAME() do {} while (0)
+#endif
+
+namespace vigilante::profiler {
+
+inline constexpr bool kIsEnabled =
+#ifdef VIGILANTE_PROFILER
+    true;
+#else
+    false;
+#endif
+
+struct ZoneRecord final {
+  const char* name;
+  uint64_t beginNs;
+  uint64_t endNs;
+  uint32_t depth;
+};
+
+// The latest zones recorded by a single thread.
+class ThreadBuffer final {
+ public:
+  static inline constexpr size_t kCapacity = 1 << 16;  // must be a power of 2
+
+  explicit ThreadBuffer(const uint32_t threadId) : _threadId{threadId} {}
+
+  inline void push(const ZoneRecord& record) {
+    const uint64_t n = _numRecords.load(std::memory_order_relaxed);
+    _records[n & (kCapacity - 1)] = record;
+    _numRecords.store(n + 1, std::memory_order_release);
+  }
+
+  // Copies out the zones which ended at or after `sinceNs`, oldest first.
+  // Zones being recorded by the owner thread meanwhile may be torn.
+  void collect(const uint64_t sinceNs, std::vector<ZoneRecord>& out) const;
+
+  inline uint32_t getThreadId() const { return _threadId; }
+
+ private:
+  std::array<ZoneRecord, kCapacity> _records{};
+  std::atomic<uint64_t> _numRecords{};
+  const uint32_t _threadId;
+};
+
+class Zone final {
+ public:
+  explicit Zone(const char* name);
+  ~Zone();
+
+  Zone(const Zone&) = delete;
+  Zone& operator=(const Zone&) = delete;
+
+ private:
+  const char* _name;
+  uint64_t _beginNs;
+};
+
+// @return the number of nanoseconds since the profiler was started.
+uint64_t now();
+
+// Marks the beginning of a new frame. Must be called from the main thread.
+void markFrame();
+
+struct FrameStats final {
+  float p50Ms;
+  float p95Ms;
+  float p99Ms;
+  float maxMs;
+};
+
+inline constexpr size_t kNumFrameSamples = 240;
+
+// @return the rolling percentiles of the last kNumFrameSamples frame times.
+FrameStats getFrameStats();
+
+// @return the last kNumFrameSamples frame times in ms, oldest first.
+std::array<float, kNumFrameSamples> getFrameTimesMs();
+
+// @return the total time spent in each zone of the main thread
+//         during the previous frame, in ms, sorted by time (descending).
+const std::vector<std::pair<const char*, float>>& getLastFrameZones();
+
+// Writes the zones of all threads recorded in the last `seconds` (which must
+// be positive) to `filePath` in the Chrome trace event format, which can be
+// opened with chrome://tracing or https://ui.perfetto.dev.
+// @return the number of zones written, or -1 on failure.
+int dumpChromeTrace(const std::string& filePath, const float seconds);
+
+}  // namespace vigilante::profiler
+
+#endif  // VIGILANTE_UTIL_PROFILER_H_
@@ -2,21 +2,65 @@
 
 #include "RandUtil.h"
 
+#include <array>
 #include <ctime>
-#include <random>
 
 namespace vigilante::rand_util {
 
+namespace {
+
+uint32_t currentSeed;
+std::array<Rng, static_cast<size_t>(Stream::SIZE)> streams;
+
+uint64_t splitmix64(uint64_t& x) {
+  uint64_t z = (x += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+}  // namespace
+
+void Rng::seed(uint64_t seed) {
+  for (int i = 0; i < 4; i += 2) {
+    const uint64_t x = splitmix64(seed);
+    _s[i] = static_cast<uint32_t>(x);
+    _s[i + 1] = static_cast<uint32_t>(x >> 32);
+  }
+}
+
 void init() {
-  srand(time(nullptr));
+  init(static_cast<uint32_t>(time(nullptr)));
+}
+
+void init(uint32_t seed) {
+  currentSeed = seed;
+  for (size_t i = 0; i < streams.size(); i++) {
+    // Give each stream its own seed, so that they don't overlap.
+    streams[i].seed((static_cast<uint64_t>(i) << 32) | seed);
+  }
+}
+
+uint32_t getSeed() {
+  return currentSeed;
+}
+
+Rng& getStream(const Stream stream) {
+  return streams[static_cast<size_t>(stream)];
 }
 
-int randInt(int min, int max) {
-  return (rand() % (max + 1 - min)) + min;
+void randInts(const Stream stream, const int min, const int max, std::span<int> out) {
+  Rng& rng = getStream(stream);
+  for (auto& value : out) {
+    value = rng.randInt(min, max);
+  }
 }
 
-float randFloat(float min, float max) {
-  return (float(rand()) / (float(RAND_MAX) + 1.0)) * (max - min) + min;
+void randFloats(const Stream stream, const float min, const float max, std::span<float> out) {
+  Rng& rng = getStream(stream);
+  for (auto& value : out) {
+    value = rng.randFloat(min, max);
+  }
 }
 
 }  // namespace vigilante::rand_util
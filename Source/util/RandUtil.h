@@ -3,11 +3,83 @@
 #ifndef VIGILANTE_UTIL_RAND_UTIL_H_
 #define VIGILANTE_UTIL_RAND_UTIL_H_
 
+#include <cstdint>
+#include <span>
+
 namespace vigilante::rand_util {
 
+// Each subsystem draws from its own stream, so that e.g. a camera shake
+// doesn't perturb the AI or the loot that follows it. All streams are
+// derived from a single seed, which is saved along with the game.
+//
+// A stream is not synchronized, so it must only be used by one thread at a time.
+enum class Stream {
+  AI,
+  COMBAT,
+  LOOT,
+  FX,
+  CAMERA,
+  MISC,
+  SIZE
+};
+
+// xoshiro128** (https://prng.di.unimi.it), seeded by splitmix64.
+class Rng final {
+ public:
+  explicit Rng(const uint64_t seed = 0) { this->seed(seed); }
+
+  void seed(uint64_t seed);
+
+  inline uint32_t next() {
+    const uint32_t result = rotl(_s[1] * 5, 7) * 9;
+    const uint32_t t = _s[1] << 9;
+    _s[2] ^= _s[0];
+    _s[3] ^= _s[1];
+    _s[1] ^= _s[2];
+    _s[0] ^= _s[3];
+    _s[2] ^= t;
+    _s[3] = rotl(_s[3], 11);
+    return result;
+  }
+
+  // @return a random int in [min, max].
+  inline int randInt(const int min, const int max) {
+    const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+    return static_cast<int>(min + static_cast<int64_t>((next() * range) >> 32));
+  }
+
+  // @return a random float in [min, max).
+  inline float randFloat(const float min, const float max) {
+    return (next() >> 8) * 0x1.0p-24f * (max - min) + min;
+  }
+
+ private:
+  static inline uint32_t rotl(const uint32_t x, const int k) {
+    return (x << k) | (x >> (32 - k));
+  }
+
+  uint32_t _s[4];
+};
+
+// Seeds all the streams with the current time.
 void init();
-int randInt(int min=0, int max=1);
-float randFloat(float min=0.0f, float max=1.0f);
+// Seeds all the streams from a known seed (e.g., the one of a save or an input recording).
+void init(uint32_t seed);
+uint32_t getSeed();
+
+Rng& getStream(const Stream stream);
+
+inline int randInt(const Stream stream, const int min = 0, const int max = 1) {
+  return getStream(stream).randInt(min, max);
+}
+
+inline float randFloat(const Stream stream, const float min = 0.0f, const float max = 1.0f) {
+  return getStream(stream).randFloat(min, max);
+}
+
+// Batch versions for bulk spawns, which fill `out` in one go.
+void randInts(const Stream stream, const int min, const int max, std::span<int> out);
+void randFloats(const Stream stream, const float min, const float max, std::span<float> out);
 
 }  // namespace vigilante::rand_util
 
@@ -0,0 +1,263 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UTIL_REFLECTION_H_
+#define VIGILANTE_UTIL_REFLECTION_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Compile-time field reflection for plain structs such as the profiles.
+// A struct lists its fields once, and gets:
+// - json_util::parseFileInto(): deserialization straight from the json tokens,
+//   validated with the path of the offending value (e.g., /droppedItems/x.json/chance),
+// - json_util::makeJsonObject(): serialization,
+// - reflection::pack() and reflection::unpack(): binary packing.
+//
+//   struct Profile final {
+//     std::string name;
+//     int price;
+//
+//     static constexpr auto kFields = reflection::fields(
+//       reflection::field("name", &Profile::name),
+//       reflection::optionalField("price", &Profile::price));
+//   };
+//
+// Only the listed fields are reflected, so the fields derived from them
+// (e.g., after parsing) have to be derived again after unpacking.
+namespace vigilante::reflection {
+
+template <typename Class, typename T>
+struct Field final {
+  using ValueType = T;
+
+  std::string_view key;
+  T Class::* member;
+  bool isOptional;
+};
+
+template <typename Class, typename T>
+constexpr Field<Class, T> field(const std::string_view key, T Class::* member) {
+  return {key, member, false};
+}
+
+// An optional field is left untouched if its key is missing.
+template <typename Class, typename T>
+constexpr Field<Class, T> optionalField(const std::string_view key, T Class::* member) {
+  return {key, member, true};
+}
+
+template <typename... Fields>
+constexpr std::tuple<Fields...> fields(const Fields&... f) {
+  return {f...};
+}
+
+template <typename T, typename = void>
+inline constexpr bool is_reflectable = false;
+
+template <typename T>
+inline constexpr bool is_reflectable<T, std::void_t<decltype(T::kFields)>> = true;
+
+// Calls `fn(field, index)` for each field.
+template <typename Fields, typename Fn>
+constexpr void forEachField(const Fields& fields, Fn&& fn) {
+  [&]<size_t... Is>(std::index_sequence<Is...>) {
+    (fn(std::get<Is>(fields), Is), ...);
+  }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
+}
+
+template <typename Fields>
+constexpr std::array<std::string_view, std::tuple_size_v<Fields>> getKeys(const Fields& fields) {
+  std::array<std::string_view, std::tuple_size_v<Fields>> keys{};
+  forEachField(fields, [&keys](const auto& field, const size_t i) { keys[i] = field.key; });
+  return keys;
+}
+
+
+template <typename T>
+inline constexpr bool dependent_false_v = false;
+
+template <typename T, typename = void>
+inline constexpr bool is_map_like = false;
+
+template <typename T>
+inline constexpr bool is_map_like<T, std::void_t<typename T::mapped_type>> = true;
+
+template <typename T, typename = void>
+inline constexpr bool is_set_like = false;
+
+template <typename T>
+inline constexpr bool is_set_like<T, std::void_t<typename T::key_type>> = !is_map_like<T>;
+
+template <typename T, typename = void>
+inline constexpr bool is_sequence = false;
+
+template <typename T>
+inline constexpr bool is_sequence<T, std::void_t<decltype(std::declval<T&>().emplace_back())>> = true;
+
+template <typename T>
+inline constexpr bool is_std_array = false;
+
+template <typename T, size_t N>
+inline constexpr bool is_std_array<std::array<T, N>> = true;
+
+template <typename T>
+inline constexpr bool is_std_pair = false;
+
+template <typename T1, typename T2>
+inline constexpr bool is_std_pair<std::pair<T1, T2>> = true;
+
+
+// Packs `value` into `out`. Integers and floats are fixed-size little-endian,
+// strings and containers are prefixed with their size (u32), and reflected
+// structs are packed field by field. The layout follows the declarations,
+// so packed data is only meant to be unpacked by the same build.
+template <typename T>
+void pack(const T& value, std::string& out) {
+  if constexpr (std::is_same_v<T, bool>) {
+    out.push_back(value ? 1 : 0);
+  } else if constexpr (std::is_enum_v<T>) {
+    pack(static_cast<std::underlying_type_t<T>>(value), out);
+  } else if constexpr (std::is_integral_v<T>) {
+    auto v = static_cast<std::make_unsigned_t<T>>(value);
+    for (size_t i = 0; i < sizeof(T); i++) {
+      out.push_back(static_cast<char>(v & 0xff));
+      v = static_cast<std::make_unsigned_t<T>>(v >> 8);
+    }
+  } else if constexpr (std::is_floating_point_v<T>) {
+    using Bits = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+    static_assert(sizeof(T) == sizeof(Bits));
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    pack(bits, out);
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    pack(static_cast<uint32_t>(value.size()), out);
+    out.append(value);
+  } else if constexpr (is_std_pair<T>) {
+    pack(value.first, out);
+    pack(value.second, out);
+  } else if constexpr (is_std_array<T>) {
+    for (const auto& element : value) {
+      pack(element, out);
+    }
+  } else if constexpr (is_map_like<T>) {
+    pack(static_cast<uint32_t>(value.size()), out);
+    for (const auto& [k, v] : value) {
+      pack(k, out);
+      pack(v, out);
+    }
+  } else if constexpr (is_set_like<T> || is_sequence<T>) {
+    pack(static_cast<uint32_t>(value.size()), out);
+    for (const auto& element : value) {
+      pack(element, out);
+    }
+  } else if constexpr (is_reflectable<T>) {
+    forEachField(T::kFields, [&value, &out](const auto& field, size_t) {
+      pack(value.*field.member, out);
+    });
+  } else {
+    static_assert(dependent_false_v<T>, "unsupported type");
+  }
+}
+
+// Unpacks `value` from the front of `in`, which is advanced past it.
+// @return false if `in` is truncated.
+template <typename T>
+bool unpack(std::string_view& in, T& value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    if (in.empty()) {
+      return false;
+    }
+    value = in.front() != 0;
+    in.remove_prefix(1);
+    return true;
+  } else if constexpr (std::is_enum_v<T>) {
+    std::underlying_type_t<T> underlyingValue{};
+    if (!unpack(in, underlyingValue)) {
+      return false;
+    }
+    value = static_cast<T>(underlyingValue);
+    return true;
+  } else if constexpr (std::is_integral_v<T>) {
+    if (in.size() < sizeof(T)) {
+      return false;
+    }
+    std::make_unsigned_t<T> v{};
+    for (size_t i = 0; i < sizeof(T); i++) {
+      v |= static_cast<std::make_unsigned_t<T>>(static_cast<uint8_t>(in[i])) << (8 * i);
+    }
+    value = static_cast<T>(v);
+    in.remove_prefix(sizeof(T));
+    return true;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    using Bits = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+    Bits bits{};
+    if (!unpack(in, bits)) {
+      return false;
+    }
+    std::memcpy(&value, &bits, sizeof(bits));
+    return true;
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    uint32_t size{};
+    if (!unpack(in, size) || in.size() < size) {
+      return false;
+    }
+    value.assign(in.data(), size);
+    in.remove_prefix(size);
+    return true;
+  } else if constexpr (is_std_pair<T>) {
+    return unpack(in, value.first) && unpack(in, value.second);
+  } else if constexpr (is_std_array<T>) {
+    for (auto& element : value) {
+      if (!unpack(in, element)) {
+        return false;
+      }
+    }
+    return true;
+  } else if constexpr (is_map_like<T> || is_set_like<T> || is_sequence<T>) {
+    uint32_t size{};
+    // Every element takes at least a byte, which rules out bogus sizes before allocating.
+    if (!unpack(in, size) || in.size() < size) {
+      return false;
+    }
+    value.clear();
+    for (uint32_t i = 0; i < size; i++) {
+      if constexpr (is_map_like<T>) {
+        std::pair<typename T::key_type, typename T::mapped_type> kv{};
+        if (!unpack(in, kv)) {
+          return false;
+        }
+        value.emplace(std::move(kv));
+      } else if constexpr (is_set_like<T>) {
+        typename T::value_type element{};
+        if (!unpack(in, element)) {
+          return false;
+        }
+        value.insert(std::move(element));
+      } else {
+        if (!unpack(in, value.emplace_back())) {
+          return false;
+        }
+      }
+    }
+    return true;
+  } else if constexpr (is_reflectable<T>) {
+    bool ok = true;
+    forEachField(T::kFields, [&in, &value, &ok](const auto& field, size_t) {
+      ok = ok && unpack(in, value.*field.member);
+    });
+    return ok;
+  } else {
+    static_assert(dependent_false_v<T>, "unsupported type");
+  }
+}
+
+}  // namespace vigilante::reflection
+
+#endif  // VIGILANTE_UTIL_REFLECTION_H_
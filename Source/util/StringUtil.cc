@@ -22,24 +22,19 @@ vector<string> split(const string& s, const char delimiter) {
 }
 
 vector<string> parseArgs(const string& s) {
-  stringstream ss{s};
   vector<string> tokens;
-  string token;
-  unsigned counter = 0;
-
-  while (std::getline(ss, token, '\"')) {
-    ++counter;
-    if (counter % 2 == 0) {
-      if (!token.empty()) {
-        tokens.emplace_back(std::move(token));
-      }
-    } else {
-      stringstream token_ss{token};
-      while (std::getline(token_ss, token, ' ')) {
-        if (!token.empty()) {
-          tokens.emplace_back(std::move(token));
-        }
+  bool isQuoted = false;
+  size_t tokenBegin = 0;
+
+  // Quoted args are kept as a whole, and unquoted ones are split by spaces.
+  for (size_t i = 0; i <= s.size(); i++) {
+    const bool isEnd = i == s.size();
+    if (isEnd || s[i] == '"' || (s[i] == ' ' && !isQuoted)) {
+      if (i > tokenBegin) {
+        tokens.emplace_back(s, tokenBegin, i - tokenBegin);
       }
+      tokenBegin = i + 1;
+      isQuoted ^= !isEnd && s[i] == '"';
     }
   }
   return tokens;
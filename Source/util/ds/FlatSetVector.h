@@ -0,0 +1,373 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UTIL_DS_FLAT_SET_VECTOR_H_
+#define VIGILANTE_UTIL_DS_FLAT_SET_VECTOR_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vigilante {
+
+// Erase policies of FlatSetVector.
+//
+// StableErase: an erased key leaves a tombstone behind, so the order of
+// iteration is always the order of insertion. The tombstones are compacted
+// once they outnumber the live keys.
+//
+// SwapErase: the last key is moved into the erased key's slot, so erasing
+// never leaves any tombstone, but the order of iteration changes.
+struct StableErase final {};
+struct SwapErase final {};
+
+// A drop-in replacement of SetVector which stores each key only once.
+//
+// The keys are stored contiguously, and a key is mapped to its index
+// by an open-addressing (linear probing) hash table, so insert(), erase()
+// and contains() are all O(1) on average.
+//
+// Tiny sets (up to kInlineCapacity keys) are stored in an inline buffer
+// without a hash table, where a linear scan beats hashing anyway.
+// Erasing from the inline buffer shifts (or swaps) the keys right away,
+// so tombstones only exist once the keys have spilled to the heap.
+//
+// `Key` must be default constructible and equality comparable.
+template <typename Key, typename ErasePolicy = StableErase, typename Hash = std::hash<Key>>
+class FlatSetVector final {
+  // Iterates over the keys, skipping the tombstones (if any).
+  template <typename ValueType>
+  class Iterator final {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Key;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ValueType*;
+    using reference = ValueType&;
+
+    Iterator() = default;
+    Iterator(ValueType* it, ValueType* end, const uint8_t* isErased)
+        : _it{it}, _end{end}, _isErased{isErased} {
+      skipErased();
+    }
+
+    reference operator*() const { return *_it; }
+    pointer operator->() const { return _it; }
+
+    Iterator& operator++() {
+      ++_it;
+      if (_isErased) {
+        ++_isErased;
+        skipErased();
+      }
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator old = *this;
+      ++(*this);
+      return old;
+    }
+
+    bool operator==(const Iterator& other) const { return _it == other._it; }
+    bool operator!=(const Iterator& other) const { return _it != other._it; }
+
+   private:
+    void skipErased() {
+      if (!_isErased) {
+        return;
+      }
+      while (_it != _end && *_isErased) {
+        ++_it;
+        ++_isErased;
+      }
+    }
+
+    ValueType* _it{};
+    ValueType* _end{};
+    const uint8_t* _isErased{};  // null if there are no tombstones
+  };
+
+ public:
+  static inline constexpr std::size_t kInlineCapacity = 8;
+
+  using size_type = std::size_t;
+  using iterator = Iterator<Key>;
+  using const_iterator = Iterator<const Key>;
+
+  FlatSetVector() = default;
+
+  FlatSetVector(std::initializer_list<Key> init_list) : FlatSetVector() {
+    for (const auto& element : init_list) {
+      insert(element);
+    }
+  }
+
+  FlatSetVector(const FlatSetVector& other) = default;
+  FlatSetVector& operator=(const FlatSetVector& other) = default;
+
+  FlatSetVector(FlatSetVector&& other) noexcept
+      : _inline(std::move(other._inline)),
+        _keys(std::move(other._keys)),
+        _isErased(std::move(other._isErased)),
+        _table(std::move(other._table)),
+        _numKeys(other._numKeys),
+        _numErased(other._numErased),
+        _numTableSlotsUsed(other._numTableSlotsUsed) {
+    other.clear();
+  }
+
+  FlatSetVector& operator=(FlatSetVector&& other) noexcept {
+    if (this != &other) {
+      _inline = std::move(other._inline);
+      _keys = std::move(other._keys);
+      _isErased = std::move(other._isErased);
+      _table = std::move(other._table);
+      _numKeys = other._numKeys;
+      _numErased = other._numErased;
+      _numTableSlotsUsed = other._numTableSlotsUsed;
+      other.clear();
+    }
+    return *this;
+  }
+
+  void insert(Key key) {
+    if (contains(key)) {
+      return;
+    }
+
+    if (isInline() && _numKeys < kInlineCapacity) {
+      _inline[_numKeys++] = std::move(key);
+      return;
+    }
+
+    if (isInline()) {
+      spill();
+    }
+
+    if ((_numTableSlotsUsed + 1) * 2 > _table.size()) {
+      // The deleted slots are dropped by rehashing, so the table
+      // only grows if it's mostly occupied by live keys.
+      rehash(tableSizeFor(size() + 1));
+    }
+    _keys.push_back(std::move(key));
+    _isErased.push_back(false);
+    _numKeys++;
+    insertToTable(static_cast<uint32_t>(_numKeys - 1));
+  }
+
+  size_type erase(const Key& key) {
+    if (isInline()) {
+      const std::size_t idx = findInline(key);
+      if (idx == kNotFound) {
+        return 0;
+      }
+      if constexpr (std::is_same_v<ErasePolicy, SwapErase>) {
+        _inline[idx] = std::move(_inline[_numKeys - 1]);
+      } else {
+        std::move(_inline.begin() + idx + 1, _inline.begin() + _numKeys, _inline.begin() + idx);
+      }
+      _numKeys--;
+      return 1;
+    }
+
+    const std::size_t slot = findSlot(key);
+    if (slot == kNotFound) {
+      return 0;
+    }
+
+    const std::size_t idx = _table[slot];
+    const std::size_t lastIdx = _numKeys - 1;
+    _table[slot] = kDeletedSlot;
+
+    if constexpr (std::is_same_v<ErasePolicy, SwapErase>) {
+      if (idx != lastIdx) {
+        _table[findSlot(_keys[lastIdx])] = static_cast<uint32_t>(idx);
+        _keys[idx] = std::move(_keys[lastIdx]);
+      }
+      popBack();
+    } else {
+      if (idx == lastIdx) {
+        popBack();
+      } else {
+        _isErased[idx] = true;
+        _numErased++;
+        if (_numErased > kInlineCapacity && _numErased * 2 > _numKeys) {
+          compact();
+        }
+      }
+    }
+    return 1;
+  }
+
+  bool contains(const Key& key) const {
+    return isInline() ? findInline(key) != kNotFound : findSlot(key) != kNotFound;
+  }
+
+  void clear() {
+    _keys.clear();
+    _keys.shrink_to_fit();
+    _isErased.clear();
+    _isErased.shrink_to_fit();
+    _table.clear();
+    _table.shrink_to_fit();
+    _numKeys = 0;
+    _numErased = 0;
+    _numTableSlotsUsed = 0;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  size_type size() const {
+    return _numKeys - _numErased;
+  }
+
+  iterator begin() {
+    return iterator{data(), data() + _numKeys, tombstones()};
+  }
+
+  iterator end() {
+    return iterator{data() + _numKeys, data() + _numKeys, nullptr};
+  }
+
+  const_iterator begin() const {
+    return const_iterator{data(), data() + _numKeys, tombstones()};
+  }
+
+  const_iterator end() const {
+    return const_iterator{data() + _numKeys, data() + _numKeys, nullptr};
+  }
+
+  Key& front() {
+    return *begin();
+  }
+
+  Key& back() {
+    // The last key is never a tombstone, see popBack().
+    return data()[_numKeys - 1];
+  }
+
+ private:
+  static inline constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+  static inline constexpr uint32_t kEmptySlot = UINT32_MAX;
+  static inline constexpr uint32_t kDeletedSlot = UINT32_MAX - 1;
+  static inline constexpr std::size_t kMinTableSize = kInlineCapacity * 4;
+
+  inline bool isInline() const { return _keys.empty(); }
+  inline Key* data() { return isInline() ? _inline.data() : _keys.data(); }
+  inline const Key* data() const { return isInline() ? _inline.data() : _keys.data(); }
+  inline const uint8_t* tombstones() const { return _numErased ? _isErased.data() : nullptr; }
+
+  std::size_t findInline(const Key& key) const {
+    for (std::size_t i = 0; i < _numKeys; i++) {
+      if (_inline[i] == key) {
+        return i;
+      }
+    }
+    return kNotFound;
+  }
+
+  // @return the table slot which holds the index of `key`, or kNotFound.
+  std::size_t findSlot(const Key& key) const {
+    const std::size_t mask = _table.size() - 1;
+    for (std::size_t slot = Hash{}(key) & mask; ; slot = (slot + 1) & mask) {
+      const uint32_t idx = _table[slot];
+      if (idx == kEmptySlot) {
+        return kNotFound;
+      }
+      if (idx != kDeletedSlot && _keys[idx] == key) {
+        return slot;
+      }
+    }
+  }
+
+  void insertToTable(const uint32_t idx) {
+    const std::size_t mask = _table.size() - 1;
+    std::size_t slot = Hash{}(_keys[idx]) & mask;
+    while (_table[slot] != kEmptySlot && _table[slot] != kDeletedSlot) {
+      slot = (slot + 1) & mask;
+    }
+    if (_table[slot] == kEmptySlot) {
+      _numTableSlotsUsed++;
+    }
+    _table[slot] = idx;
+  }
+
+  // @return the smallest power of two which keeps the load factor under 1/4.
+  static std::size_t tableSizeFor(const std::size_t numKeys) {
+    std::size_t tableSize = kMinTableSize;
+    while (tableSize < numKeys * 4) {
+      tableSize *= 2;
+    }
+    return tableSize;
+  }
+
+  void rehash(const std::size_t tableSize) {
+    _table.assign(tableSize, kEmptySlot);
+    _numTableSlotsUsed = 0;
+    for (std::size_t i = 0; i < _numKeys; i++) {
+      if (!_isErased[i]) {
+        insertToTable(static_cast<uint32_t>(i));
+      }
+    }
+  }
+
+  // Moves the inline keys to the heap and builds the hash table.
+  void spill() {
+    _keys.reserve(kInlineCapacity * 2);
+    _keys.assign(std::make_move_iterator(_inline.begin()),
+                 std::make_move_iterator(_inline.begin() + _numKeys));
+    _isErased.assign(_numKeys, false);
+    rehash(tableSizeFor(_numKeys));
+  }
+
+  // Removes the last heap key, along with the tombstones right before it.
+  void popBack() {
+    _keys.pop_back();
+    _isErased.pop_back();
+    while (!_keys.empty() && _isErased.back()) {
+      _keys.pop_back();
+      _isErased.pop_back();
+      _numErased--;
+    }
+    _numKeys = _keys.size();
+    if (_keys.empty()) {
+      clear();
+    }
+  }
+
+  // Removes all the heap tombstones while preserving the order of the live keys.
+  void compact() {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < _numKeys; i++) {
+      if (!_isErased[i]) {
+        _keys[n++] = std::move(_keys[i]);
+      }
+    }
+    _keys.resize(n);
+    _isErased.assign(n, false);
+    _numKeys = n;
+    _numErased = 0;
+    rehash(tableSizeFor(_numKeys));
+  }
+
+  std::array<Key, kInlineCapacity> _inline{};
+  std::vector<Key> _keys;  // empty if the keys are stored inline
+  std::vector<uint8_t> _isErased;  // the tombstones of `_keys`
+  std::vector<uint32_t> _table;
+  std::size_t _numKeys{};  // including the tombstones
+  std::size_t _numErased{};
+  std::size_t _numTableSlotsUsed{};  // including the deleted slots
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_UTIL_DS_FLAT_SET_VECTOR_H_
@@ -0,0 +1,126 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UTIL_DS_SMALL_FUNCTION_H_
+#define VIGILANTE_UTIL_DS_SMALL_FUNCTION_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace vigilante {
+
+template <typename Signature, std::size_t Capacity = 48>
+class SmallFunction;
+
+// A move-only std::function replacement which stores callables of up to
+// `Capacity` bytes inline (i.e., no heap allocation). Larger callables
+// are still supported, but they will be heap allocated.
+template <typename R, typename... Args, std::size_t Capacity>
+class SmallFunction<R (Args...), Capacity> final {
+ public:
+  SmallFunction() = default;
+
+  // Only callables are accepted, so that overloads taking a SmallFunction and
+  // e.g. a std::string aren't ambiguous for a string literal.
+  template <typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, SmallFunction> &&
+                                                     std::is_invocable_r_v<R, std::decay_t<Fn>&, Args...>>>
+  SmallFunction(Fn&& fn) {
+    using F = std::decay_t<Fn>;
+    if constexpr (kFitsInline<F>) {
+      new (&_storage) F(std::forward<Fn>(fn));
+      _ops = &kInlineOps<F>;
+    } else {
+      *reinterpret_cast<F**>(&_storage) = new F(std::forward<Fn>(fn));
+      _ops = &kHeapOps<F>;
+    }
+  }
+
+  SmallFunction(const SmallFunction&) = delete;
+  SmallFunction& operator=(const SmallFunction&) = delete;
+
+  SmallFunction(SmallFunction&& other) noexcept {
+    moveFrom(other);
+  }
+
+  SmallFunction& operator=(SmallFunction&& other) noexcept {
+    if (this != &other) {
+      reset();
+      moveFrom(other);
+    }
+    return *this;
+  }
+
+  ~SmallFunction() {
+    reset();
+  }
+
+  R operator()(Args... args) {
+    return _ops->invoke(&_storage, std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const {
+    return _ops != nullptr;
+  }
+
+  void reset() {
+    if (_ops) {
+      _ops->destroy(&_storage);
+      _ops = nullptr;
+    }
+  }
+
+ private:
+  struct Ops final {
+    R (*invoke)(void* storage, Args&&... args);
+    void (*move)(void* dst, void* src);
+    void (*destroy)(void* storage);
+  };
+
+  template <typename F>
+  static inline constexpr bool kFitsInline = sizeof(F) <= Capacity &&
+                                             alignof(F) <= alignof(std::max_align_t) &&
+                                             std::is_nothrow_move_constructible_v<F>;
+
+  template <typename F>
+  static inline constexpr Ops kInlineOps = {
+    [](void* storage, Args&&... args) -> R {
+      return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+    },
+    [](void* dst, void* src) {
+      new (dst) F(std::move(*static_cast<F*>(src)));
+      static_cast<F*>(src)->~F();
+    },
+    [](void* storage) {
+      static_cast<F*>(storage)->~F();
+    },
+  };
+
+  template <typename F>
+  static inline constexpr Ops kHeapOps = {
+    [](void* storage, Args&&... args) -> R {
+      return (**static_cast<F**>(storage))(std::forward<Args>(args)...);
+    },
+    [](void* dst, void* src) {
+      *static_cast<F**>(dst) = *static_cast<F**>(src);
+    },
+    [](void* storage) {
+      delete *static_cast<F**>(storage);
+    },
+  };
+
+  void moveFrom(SmallFunction& other) {
+    if (other._ops) {
+      other._ops->move(&_storage, &other._storage);
+      _ops = other._ops;
+      other._ops = nullptr;
+    }
+  }
+
+  alignas(std::max_align_t) std::byte _storage[Capacity];
+  const Ops* _ops{};
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_UTIL_DS_SMALL_FUNCTION_H_
@@ -0,0 +1,99 @@
+// Copyright (c) 2024 Marco Wang <m.aesophor@gmail.com>. All rights reserved.
+
+#ifndef VIGILANTE_UTIL_DS_UNIFORM_GRID_H_
+#define VIGILANTE_UTIL_DS_UNIFORM_GRID_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vigilante {
+
+// A uniform grid which buckets objects of type T by the cell
+// their position falls into, so that range queries only have to
+// look at the cells overlapping the queried rect instead of testing
+// every object.
+template <typename T>
+class UniformGrid final {
+ public:
+  explicit UniformGrid(const float cellSize) : _cellSize{cellSize}, _cells() {}
+
+  void insert(const float x, const float y, T value) {
+    insertAt(toCell(x), toCell(y), std::move(value));
+  }
+
+  void insertAt(const int cellX, const int cellY, T value) {
+    _cells[toKey(cellX, cellY)].push_back(std::move(value));
+  }
+
+  // Removes `value` from the cell (cellX, cellY). The order of the objects
+  // in that cell isn't preserved.
+  // @return false if `value` isn't in that cell.
+  bool eraseAt(const int cellX, const int cellY, const T& value) {
+    auto it = _cells.find(toKey(cellX, cellY));
+    if (it == _cells.end()) {
+      return false;
+    }
+
+    std::vector<T>& values = it->second;
+    for (size_t i = 0; i < values.size(); i++) {
+      if (values[i] == value) {
+        values[i] = std::move(values.back());
+        values.pop_back();
+        if (values.empty()) {
+          _cells.erase(it);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Visits every object in the cells overlapping [minX, maxX] x [minY, maxY].
+  // Objects near the boundary of the rect may lie slightly outside it,
+  // so callers should treat this as a conservative (broad-phase) query.
+  template <typename Fn>
+  void query(const float minX, const float minY, const float maxX, const float maxY, Fn&& fn) const {
+    const int beginCellX = toCell(minX);
+    const int beginCellY = toCell(minY);
+    const int endCellX = toCell(maxX);
+    const int endCellY = toCell(maxY);
+
+    for (int cellX = beginCellX; cellX <= endCellX; cellX++) {
+      for (int cellY = beginCellY; cellY <= endCellY; cellY++) {
+        auto it = _cells.find(toKey(cellX, cellY));
+        if (it == _cells.end()) {
+          continue;
+        }
+        for (const auto& value : it->second) {
+          fn(value);
+        }
+      }
+    }
+  }
+
+  void clear() {
+    _cells.clear();
+  }
+
+  inline int toCell(const float coord) const {
+    return static_cast<int>(std::floor(coord / _cellSize));
+  }
+
+  inline float getCellSize() const { return _cellSize; }
+
+ private:
+  static inline uint64_t toKey(const int cellX, const int cellY) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+  }
+
+  float _cellSize;
+  std::unordered_map<uint64_t, std::vector<T>> _cells;
+};
+
+}  // namespace vigilante
+
+#endif  // VIGILANTE_UTIL_DS_UNIFORM_GRID_H_
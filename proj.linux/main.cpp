@@ -24,16 +24,116 @@
 
 #include "AppDelegate.h"
 
+#include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <string>
 
+#include "bench/Benchmark.h"
+#include "bench/SelfTest.h"
+#include "bench/Simulation.h"
+#include "gameplay/GameState.h"
+#include "input/InputRecording.h"
+#include "util/AssetBundle.h"
+
 USING_NS_AX;
 
 int main(int argc, char** argv)
 {
+    // Offline asset cooking: vigilante --cook-data [dataDir] [bundleFilePath]
+    if (argc >= 2 && std::string{argv[1]} == "--cook-data")
+    {
+        const char* dataDir = (argc >= 3) ? argv[2] : "Resources/Data";
+        const char* bundleFilePath = (argc >= 4) ? argv[3] : "Resources/Data.vgab";
+        return vigilante::asset_bundle::cook(dataDir, bundleFilePath) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Save file conversion: vigilante --convert-save <inputFilePath> <outputFilePath>
+    // The output is json if outputFilePath ends with .json, or binary otherwise.
+    if (argc >= 4 && std::string{argv[1]} == "--convert-save")
+    {
+        return vigilante::GameState::convert(argv[2], argv[3]) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Microbenchmarks: vigilante --bench [filter] [--json <outputFilePath>]
+    if (argc >= 2 && std::string{argv[1]} == "--bench")
+    {
+        std::string filter;
+        std::string jsonFilePath;
+        for (int i = 2; i < argc; i++)
+        {
+            if (std::string{argv[i]} == "--json" && i + 1 < argc)
+                jsonFilePath = argv[++i];
+            else
+                filter = argv[i];
+        }
+        return vigilante::bench::runAll(filter, jsonFilePath);
+    }
+
+    // Self-tests: vigilante --selftest [filter]
+    if (argc >= 2 && std::string{argv[1]} == "--selftest")
+    {
+        return vigilante::bench::runAllSelfTests((argc >= 3) ? argv[2] : "");
+    }
+
+    // Soak test: vigilante --soak <numTicks> [numExtraNpcs] [tmxMapFilePath]
+    if (argc >= 2 && std::string{argv[1]} == "--soak")
+    {
+        char* end = nullptr;
+        const unsigned long long numTicks = (argc >= 3 && argv[2][0] != '-') ? strtoull(argv[2], &end, 10) : 0;
+        const bool isNumTicksValid = end && end != argv[2] && *end == '\0' && numTicks > 0;
+
+        long numExtraNpcs = 0;
+        bool isNumExtraNpcsValid = true;
+        if (argc >= 4)
+        {
+            numExtraNpcs = strtol(argv[3], &end, 10);
+            isNumExtraNpcsValid = end != argv[3] && *end == '\0' && numExtraNpcs >= 0 && numExtraNpcs <= INT_MAX;
+        }
+
+        if (!isNumTicksValid || !isNumExtraNpcsValid || argc > 5)
+        {
+            fprintf(stderr, "usage: %s --soak <numTicks> [numExtraNpcs] [tmxMapFilePath]\n"
+                            "  numTicks must be a positive integer, and numExtraNpcs a non-negative one.\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        vigilante::bench::Simulation::options = vigilante::bench::Simulation::Options{
+            numTicks,
+            static_cast<int>(numExtraNpcs),
+            (argc >= 5) ? argv[4] : "",
+        };
+    }
+#ifdef VIGILANTE_HEADLESS
+    else
+    {
+        fprintf(stderr, "usage: %s --soak <numTicks> [numExtraNpcs] [tmxMapFilePath]\n"
+                        "  (vigilante_headless only runs soak tests)\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+#endif
+
+    // Input recording: vigilante --record <outputFilePath> [saveFilePath]
+    if (argc >= 3 && std::string{argv[1]} == "--record")
+    {
+        vigilante::InputRecorder::options = vigilante::InputRecorder::Options{
+            argv[2],
+            (argc >= 4) ? argv[3] : "",
+        };
+    }
+
+    // Input replay: vigilante --replay <inputFilePath>
+    if (argc >= 3 && std::string{argv[1]} == "--replay")
+    {
+        vigilante::InputReplayer::inputFilePath = argv[2];
+    }
+
     // create the application instance
     AppDelegate app;
-    return Application::getInstance()->run();
+    const int ret = Application::getInstance()->run();
+
+    // The session being recorded (if any) ends when the application quits.
+    vigilante::InputRecorder::the().stop();
+    return ret;
 }